@@ -52,6 +52,23 @@ DEFINE_int32(pserver_connect_timeout_ms, 10000,
 
 DEFINE_int32(pserver_sparse_merge_thread, 1, "pserver sparse merge thread num");
 
+DEFINE_int32(pserver_sparse_cache_capacity, 0,
+             "rows of each sparse table cached in the trainer to serve "
+             "pull_sparse locally, 0 disables the cache");
+
+DEFINE_int32(pserver_sparse_cache_max_staleness_steps, 10,
+             "pull_sparse calls of a table a cached row may be served "
+             "for before it is pulled again, <= 0 means unbounded");
+
+DEFINE_int32(pserver_sparse_cache_max_staleness_ms, 0,
+             "milliseconds a cached sparse row may be served for before it "
+             "is pulled again, <= 0 means unbounded");
+
+DEFINE_bool(pserver_skip_unchanged_dense_pull, false,
+            "pull_dense leaves the regions of a shard untouched if its dense "
+            "version has not changed since the last pull of the table, only "
+            "valid when a table is always pulled into the same regions");
+
 namespace paddle {
 namespace framework {
 class Scope;
@@ -392,6 +409,13 @@ std::future<int32_t> BrpcPsClient::flush() {
 
 void BrpcPsClient::finalize_worker() {
   flush();
+  {
+    std::lock_guard<std::mutex> lock(_sparse_caches_mutex);
+    for (auto &cache : _sparse_caches) {
+      LOG(INFO) << "sparse value cache of table " << cache.first << ", "
+                << cache.second->GetStat().ToString();
+    }
+  }
   _running = false;
   _server.Stop(1000);
   _server.Join();
@@ -500,6 +524,16 @@ std::future<int32_t> BrpcPsClient::push_sparse_param(
   return fut;
 }
 
+std::shared_ptr<BrpcPsClient::DenseVersions>
+BrpcPsClient::dense_pull_versions(size_t table_id, size_t shard_num) {
+  std::lock_guard<std::mutex> lock(_dense_pull_versions_mutex);
+  auto &versions = _dense_pull_versions[table_id];
+  if (versions == nullptr || versions->size() != shard_num) {
+    versions = std::make_shared<DenseVersions>(shard_num);
+  }
+  return versions;
+}
+
 std::future<int32_t> BrpcPsClient::pull_dense(Region *regions,
                                               size_t region_num,
                                               size_t table_id) {
@@ -507,15 +541,20 @@ std::future<int32_t> BrpcPsClient::pull_dense(Region *regions,
   size_t request_call_num = _server_channels.size();
   uint32_t num_per_shard =
       dense_dim_per_shard(accessor->fea_dim(), request_call_num);
+  std::shared_ptr<DenseVersions> known_versions;
+  if (FLAGS_pserver_skip_unchanged_dense_pull) {
+    known_versions = dense_pull_versions(table_id, request_call_num);
+  }
   // callback 将各shard结果，顺序填入region
   DownpourBrpcClosure *closure = new DownpourBrpcClosure(
       request_call_num, [request_call_num, num_per_shard, regions, region_num,
-                         accessor](void *done) {
+                         accessor, known_versions](void *done) {
         int ret = 0;
         size_t region_idx = 0;       // 当前填充的region偏移
         size_t region_data_idx = 0;  // 当前填充的region内data偏移
         auto *closure = (DownpourBrpcClosure *)done;
         size_t shard_data_size = num_per_shard * accessor->select_size();
+        std::vector<uint64_t> versions(request_call_num, 0);
         for (size_t i = 0; i < request_call_num; ++i) {
           if (closure->check_response(i, PS_PULL_DENSE_TABLE) != 0) {
             ret = -1;
@@ -525,6 +564,17 @@ std::future<int32_t> BrpcPsClient::pull_dense(Region *regions,
 
           butil::IOBufBytesIterator io_buffer_itr(res_io_buffer);
           size_t shard_buffer_remain = res_io_buffer.size();
+          std::string version = closure->get_response(i, PS_PULL_DENSE_TABLE);
+          if (version.size() == sizeof(uint64_t)) {
+            versions[i] = *(const uint64_t *)version.c_str();
+          }
+          // an empty response means the regions already hold this version
+          bool unchanged = known_versions != nullptr &&
+                           shard_buffer_remain == 0 && versions[i] != 0 &&
+                           versions[i] == (*known_versions)[i].load();
+          if (unchanged) {
+            shard_buffer_remain = shard_data_size;
+          }
           if (shard_buffer_remain != shard_data_size) {
             LOG(ERROR) << "expect res_size:" << shard_data_size
                        << ", but size:" << shard_buffer_remain
@@ -536,8 +586,11 @@ std::future<int32_t> BrpcPsClient::pull_dense(Region *regions,
             auto &region = regions[region_idx];
             if (region.size - region_data_idx >= shard_buffer_remain) {
               // region待填充空间 >= 分片buffer数据, 直接拷贝置入
-              io_buffer_itr.copy_and_forward(
-                  (void *)(region.data + region_data_idx), shard_buffer_remain);
+              if (!unchanged) {
+                io_buffer_itr.copy_and_forward(
+                    (void *)(region.data + region_data_idx),
+                    shard_buffer_remain);
+              }
               region_data_idx += shard_buffer_remain;
               shard_buffer_remain = 0;
             } else if (region.size - region_data_idx == 0) {
@@ -546,15 +599,22 @@ std::future<int32_t> BrpcPsClient::pull_dense(Region *regions,
               region_data_idx = 0;
             } else {
               // region不足以容纳所有数据，则能放多少 拷贝多少
-              io_buffer_itr.copy_and_forward(
-                  (void *)(region.data + region_data_idx),
-                  region.size - region_data_idx);
+              if (!unchanged) {
+                io_buffer_itr.copy_and_forward(
+                    (void *)(region.data + region_data_idx),
+                    region.size - region_data_idx);
+              }
               shard_buffer_remain -= (region.size - region_data_idx);
               ++region_idx;
               region_data_idx = 0;
             }
           }
         }
+        if (ret == 0 && known_versions != nullptr) {
+          for (size_t i = 0; i < request_call_num; ++i) {
+            (*known_versions)[i].store(versions[i]);
+          }
+        }
         closure->set_promise_value(ret);
       });
   auto promise = std::make_shared<std::promise<int32_t>>();
@@ -566,6 +626,11 @@ std::future<int32_t> BrpcPsClient::pull_dense(Region *regions,
     closure->request(i)->set_client_id(_client_id);
     closure->request(i)->add_params((char *)&num_per_shard,
                                     sizeof(num_per_shard));
+    if (known_versions != nullptr) {
+      uint64_t known_version = (*known_versions)[i].load();
+      closure->request(i)->add_params((char *)&known_version,
+                                      sizeof(known_version));
+    }
     PsService_Stub rpc_stub(get_dense_channel(i));
     rpc_stub.service(closure->cntl(i), closure->request(i),
                      closure->response(i), closure);
@@ -766,10 +831,55 @@ std::future<int32_t> BrpcPsClient::push_global_step(int table_id,
   return fut;
 }
 
+std::shared_ptr<SparseValueCache> BrpcPsClient::sparse_value_cache(
+    size_t table_id) {
+  if (FLAGS_pserver_sparse_cache_capacity <= 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(_sparse_caches_mutex);
+  auto &cache = _sparse_caches[table_id];
+  if (cache == nullptr) {
+    auto *accessor = table_accessor(table_id);
+    cache = std::make_shared<SparseValueCache>(
+        FLAGS_pserver_sparse_cache_capacity,
+        accessor->select_size() / sizeof(float),
+        FLAGS_pserver_sparse_cache_max_staleness_steps,
+        FLAGS_pserver_sparse_cache_max_staleness_ms);
+  }
+  return cache;
+}
+
 std::future<int32_t> BrpcPsClient::pull_sparse(float **select_values,
                                                size_t table_id,
                                                const uint64_t *keys,
                                                size_t num) {
+  auto cache = sparse_value_cache(table_id);
+  if (cache == nullptr) {
+    return pull_sparse_from_server(select_values, table_id, keys, num,
+                                   nullptr);
+  }
+
+  auto miss_keys = std::make_shared<std::vector<uint64_t>>();
+  auto miss_values = std::make_shared<std::vector<float *>>();
+  cache->Lookup(keys, select_values, num, miss_keys.get(), miss_values.get());
+  if (miss_keys->empty()) {
+    std::promise<int32_t> promise;
+    promise.set_value(0);
+    return promise.get_future();
+  }
+  // only the misses and expired rows go out, they refill the cache once
+  // they arrive
+  return pull_sparse_from_server(
+      miss_values->data(), table_id, miss_keys->data(), miss_keys->size(),
+      [cache, miss_keys, miss_values]() {
+        cache->Insert(miss_keys->data(), miss_values->data(),
+                      miss_keys->size());
+      });
+}
+
+std::future<int32_t> BrpcPsClient::pull_sparse_from_server(
+    float **select_values, size_t table_id, const uint64_t *keys, size_t num,
+    std::function<void()> on_pulled) {
   size_t request_call_num = _server_channels.size();
 
   auto shard_sorted_kvs = std::make_shared<
@@ -785,7 +895,7 @@ std::future<int32_t> BrpcPsClient::pull_sparse(float **select_values,
   size_t value_size = accessor->select_size();
 
   DownpourBrpcClosure *closure = new DownpourBrpcClosure(
-      request_call_num, [shard_sorted_kvs, value_size](void *done) {
+      request_call_num, [shard_sorted_kvs, value_size, on_pulled](void *done) {
         int ret = 0;
         auto *closure = (DownpourBrpcClosure *)done;
         for (size_t i = 0; i < shard_sorted_kvs->size(); ++i) {
@@ -818,6 +928,9 @@ std::future<int32_t> BrpcPsClient::pull_sparse(float **select_values,
             }
           }
         }
+        if (ret == 0 && on_pulled) {
+          on_pulled();
+        }
         closure->set_promise_value(ret);
       });
 
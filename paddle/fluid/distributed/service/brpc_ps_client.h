@@ -14,8 +14,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "brpc/channel.h"
@@ -23,6 +27,7 @@
 #include "brpc/server.h"
 #include "paddle/fluid/distributed/service/brpc_utils.h"
 #include "paddle/fluid/distributed/service/ps_client.h"
+#include "paddle/fluid/distributed/service/sparse_value_cache.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/framework/tensor_util.h"
@@ -150,6 +155,10 @@ class BrpcPsClient : public PSClient {
                                            size_t table_id,
                                            const uint64_t *keys, size_t num);
 
+  // The trainer side cache of the table, nullptr when
+  // FLAGS_pserver_sparse_cache_capacity is not set.
+  std::shared_ptr<SparseValueCache> sparse_value_cache(size_t table_id);
+
   virtual std::future<int32_t> print_table_stat(uint32_t table_id);
 
   virtual std::future<int32_t> barrier(size_t table_id, uint32_t barrier_type);
@@ -181,6 +190,17 @@ class BrpcPsClient : public PSClient {
   std::future<int32_t> send_cmd(uint32_t table_id, int cmd_id,
                                 const std::vector<std::string> &param);
 
+  // the dense version each server shard returned by the last pull_dense of
+  // a table, 0 before the first successful pull
+  using DenseVersions = std::vector<std::atomic<uint64_t>>;
+  std::shared_ptr<DenseVersions> dense_pull_versions(size_t table_id,
+                                                     size_t shard_num);
+
+  // on_pulled runs after the values were written, if the pull succeeded
+  std::future<int32_t> pull_sparse_from_server(
+      float **select_values, size_t table_id, const uint64_t *keys, size_t num,
+      std::function<void()> on_pulled);
+
   std::future<int32_t> send_save_cmd(uint32_t table_id, int cmd_id,
                                      const std::vector<std::string> &param);
 
@@ -202,6 +222,15 @@ class BrpcPsClient : public PSClient {
       _client_channels;  // client2client
   std::vector<std::array<std::shared_ptr<brpc::Channel>, 3>>
       _server_channels;  // client2server
+
+  std::mutex _sparse_caches_mutex;
+  std::unordered_map<size_t, std::shared_ptr<SparseValueCache>>
+      _sparse_caches;
+
+  std::mutex _dense_pull_versions_mutex;
+  std::unordered_map<size_t, std::shared_ptr<DenseVersions>>
+      _dense_pull_versions;
+
   virtual std::future<int32_t> push_dense_raw_gradient(
       int table_id, float *total_send_data, size_t total_send_data_size,
       void *done) override;
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/service/brpc_ps_server.h"
+#include <algorithm>
 #include <thread>  // NOLINT
 #include "paddle/fluid/distributed/table/table.h"
 #include "paddle/fluid/framework/archive.h"
@@ -197,13 +198,43 @@ int32_t BrpcPsService::pull_dense(Table *table, const PsRequestMessage &request,
     return 0;
   }
 
-  std::vector<float> res_data;
-  res_data.resize(num * table->value_accesor()->select_size() / sizeof(float));
-  table->pull_dense(res_data.data(), num);
+  size_t res_size = num * table->value_accesor()->select_size();
+  DenseSnapshot *snapshot = table->pull_dense_snapshot();
+  if (snapshot == nullptr) {
+    std::vector<float> res_data;
+    res_data.resize(res_size / sizeof(float));
+    table->pull_dense(res_data.data(), num);
+
+    cntl->response_attachment().append((char *)res_data.data(),
+                                       res_data.size() * sizeof(float));
+    return 0;
+  }
 
+  // the version is always returned, the values are omitted when the client
+  // already holds this version
+  uint64_t version = snapshot->version();
+  response.set_data((const char *)&version, sizeof(version));
+  if (request.params_size() > 1 &&
+      request.params(1).size() == sizeof(uint64_t) &&
+      *(const uint64_t *)request.params(1).c_str() == version) {
+    snapshot->Unref();
+    return 0;
+  }
+
+  // zero copy, brpc drops the reference once the response is sent. brpc
+  // never calls the deleter when the append fails, in which case the values
+  // are copied and the reference is dropped here.
+  if (snapshot->numel() * sizeof(float) == res_size &&
+      cntl->response_attachment().append_user_data(
+          snapshot->data(), res_size, DenseSnapshot::UnrefData) == 0) {
+    return 0;
+  }
+  std::vector<float> res_data(res_size / sizeof(float), 0);
+  std::copy_n(snapshot->data(), std::min(snapshot->numel(), res_data.size()),
+              res_data.begin());
+  snapshot->Unref();
   cntl->response_attachment().append((char *)res_data.data(),
                                      res_data.size() * sizeof(float));
-
   return 0;
 }
 
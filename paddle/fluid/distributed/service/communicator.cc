@@ -98,7 +98,9 @@ void Communicator::InitBrpcClient(
 
 void Communicator::RpcRecvDense(const std::vector<std::string> &varnames,
                                 int table_id, Scope *scope) {
-  platform::RecordEvent record_event("Communicator->RpcRecvDense");
+  platform::RecordEvent record_event(
+      "Communicator->RpcRecvDense", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   std::vector<paddle::distributed::Region> regions;
   regions.reserve(varnames.size());
   for (auto &t : varnames) {
@@ -149,7 +151,9 @@ void Communicator::RpcRecvDense(const std::vector<std::string> &varnames,
 
 void Communicator::RpcSendDenseParam(const std::vector<std::string> &varnames,
                                      int table_id, const Scope &scope) {
-  platform::RecordEvent record_event("Communicator->RpcSendDenseParam");
+  platform::RecordEvent record_event(
+      "Communicator->RpcSendDenseParam", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   auto place = platform::CPUPlace();
   std::vector<paddle::distributed::Region> regions;
   for (auto &t : varnames) {
@@ -186,7 +190,9 @@ void Communicator::RpcSendDenseParam(const std::vector<std::string> &varnames,
 }
 
 void Communicator::RpcSendDense(const CommContext &ctx, const Scope &scope) {
-  platform::RecordEvent record_event("Communicator->RpcSendDense");
+  platform::RecordEvent record_event(
+      "Communicator->RpcSendDense", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   auto &var_names = ctx.origin_varnames;
   auto &table_id = ctx.table_id;
   auto dense_data = std::make_shared<std::vector<float>>();
@@ -230,7 +236,9 @@ void Communicator::RpcSendDense(const CommContext &ctx, const Scope &scope) {
 
 void Communicator::RpcSendSparseParam(const std::string &varname, int table_id,
                                       const Scope &scope) {
-  platform::RecordEvent record_event("Communicator->RpcSendSparseParam");
+  platform::RecordEvent record_event(
+      "Communicator->RpcSendSparseParam", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   size_t request_call_num = _worker_ptr->get_server_nums();
   std::vector<float *> push_g_vec;
 
@@ -267,7 +275,9 @@ void Communicator::RpcSendSparseParam(const std::string &varname, int table_id,
 
 void Communicator::RpcSendSparse(const std::string &var_name, int table_id,
                                  const Scope &scope) {
-  platform::RecordEvent record_event("Communicator->RpcSendSparse");
+  platform::RecordEvent record_event(
+      "Communicator->RpcSendSparse", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   size_t request_call_num = _worker_ptr->get_server_nums();
   std::vector<uint64_t> sparse_push_keys;
   std::vector<float *> push_g_vec;
@@ -306,7 +316,9 @@ void Communicator::RpcSendSparse(const std::string &var_name, int table_id,
 
 void Communicator::RpcRecvSparse(const std::string &varname, int table_id,
                                  Scope *scope) {
-  platform::RecordEvent record_event("Communicator->RpcRecvSparse");
+  platform::RecordEvent record_event(
+      "Communicator->RpcRecvSparse", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   auto *send_var = scope->Var(varname);
   auto *tensor = send_var->GetMutable<framework::LoDTensor>();
   auto dim = tensor->dims()[1];
@@ -372,7 +384,9 @@ void Communicator::SendGlobalStep(const CommContext &ctx, int batches,
   if (batches == 0) {
     return;
   }
-  platform::RecordEvent record_event("Communicator->SendGlobalStep");
+  platform::RecordEvent record_event(
+      "Communicator->SendGlobalStep", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   auto &table_id = ctx.table_id;
   size_t request_call_num = _worker_ptr->get_server_nums();
 
@@ -776,7 +790,9 @@ void SyncCommunicator::BarrierRecv() {
 
 void GeoCommunicator::Send(const std::vector<std::string> &var_names,
                            const framework::Scope &scope) {
-  platform::RecordEvent record_event("GeoCommunicator->Send");
+  platform::RecordEvent record_event(
+      "GeoCommunicator->Send", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   waiting_ = false;
   auto before_send = GetCurrentUS();
   auto table_name = var_names[0];
@@ -913,7 +929,9 @@ void GeoCommunicator::InitDense(std::vector<std::string> &varnames,
 }
 
 void GeoCommunicator::SendDense(const CommContext &send_ctx) {
-  platform::RecordEvent record_event("GeoCommunicator->SendDense");
+  platform::RecordEvent record_event(
+      "GeoCommunicator->SendDense", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   auto &var_names = send_ctx.origin_varnames;
   auto &table_id = send_ctx.table_id;
   for (auto &varname : var_names) {
@@ -954,7 +972,9 @@ void GeoCommunicator::SendDense(const CommContext &send_ctx) {
 }
 
 void GeoCommunicator::RecvDense(const CommContext &send_ctx) {
-  platform::RecordEvent record_event("GeoCommunicator->RecvDense");
+  platform::RecordEvent record_event(
+      "GeoCommunicator->RecvDense", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   auto &table_id = send_ctx.table_id;
   auto &varnames = recv_varname_to_ctx_.at(table_id);
   // 1. recv from pserver
@@ -1013,7 +1033,9 @@ void GeoCommunicator::InitSparse(const std::string &var_name, int table_id) {
 
 std::vector<int64_t> GeoCommunicator::MergeSparseIds(
     const std::string &send_varname) {
-  platform::RecordEvent record_event("GeoCommunicator->MergeSparseIds");
+  platform::RecordEvent record_event(
+      "GeoCommunicator->MergeSparseIds", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   size_t merge_num = 0, wait_times = 0;
   std::unordered_set<int64_t> sparse_ids;
   while (merge_num < static_cast<size_t>(max_merge_var_num_)) {
@@ -1045,7 +1067,9 @@ std::vector<int64_t> GeoCommunicator::MergeSparseIds(
 void GeoCommunicator::SendSparse(const std::string &varname,
                                  std::vector<int64_t> &sparse_ids, int table_id,
                                  int ep_idx) {
-  platform::RecordEvent record_event("GeoCommunicator->SendSparse");
+  platform::RecordEvent record_event(
+      "GeoCommunicator->SendSparse", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   std::string param_name = SplitedGradToParam(varname);
   VLOG(1) << "In GeoCommunicator::SendSparse(" << varname << " " << param_name
           << ", ids.size = " << sparse_ids.size() << ", table_id: " << table_id
@@ -1115,7 +1139,9 @@ void GeoCommunicator::SendSparse(const std::string &varname,
 
 void GeoCommunicator::RecvSparse(const std::string &varname, int table_id,
                                  int ep_idx) {
-  platform::RecordEvent record_event("GeoCommunicator->RecvSparse");
+  platform::RecordEvent record_event(
+      "GeoCommunicator->RecvSparse", platform::EventRole::kOrdinary,
+      platform::TraceCategory::kCommunication);
   // 1. recv from pserver
   std::vector<uint64_t> keys;
   std::vector<float> values;
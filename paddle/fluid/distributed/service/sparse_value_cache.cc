@@ -0,0 +1,203 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/service/sparse_value_cache.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <sstream>
+
+#include "glog/logging.h"
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+
+uint64_t Mix(uint64_t key) {
+  // splitmix64 finalizer
+  key += 0x9e3779b97f4a7c15ULL;
+  key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+  return key ^ (key >> 31);
+}
+
+int64_t NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+constexpr int FrequencySketch::kDepth;
+constexpr uint8_t FrequencySketch::kMaxCount;
+
+FrequencySketch::FrequencySketch(size_t capacity) {
+  size_t width = 64;
+  while (width < capacity) {
+    width <<= 1;
+  }
+  table_.resize(width * kDepth, 0);
+  mask_ = width - 1;
+  sample_size_ = 10 * std::max<size_t>(capacity, 64);
+}
+
+size_t FrequencySketch::Index(uint64_t key, int row) const {
+  uint64_t hash = Mix(key ^ (static_cast<uint64_t>(row) << 56));
+  return row * (mask_ + 1) + (hash & mask_);
+}
+
+void FrequencySketch::Increment(uint64_t key) {
+  for (int row = 0; row < kDepth; ++row) {
+    auto& counter = table_[Index(key, row)];
+    if (counter < kMaxCount) ++counter;
+  }
+  if (++additions_ >= sample_size_) {
+    Age();
+  }
+}
+
+uint32_t FrequencySketch::Estimate(uint64_t key) const {
+  uint32_t freq = kMaxCount;
+  for (int row = 0; row < kDepth; ++row) {
+    freq = std::min<uint32_t>(freq, table_[Index(key, row)]);
+  }
+  return freq;
+}
+
+void FrequencySketch::Age() {
+  for (auto& counter : table_) {
+    counter >>= 1;
+  }
+  additions_ /= 2;
+}
+
+std::string SparseValueCache::Stat::ToString() const {
+  std::stringstream ss;
+  ss << "lookups: " << lookups << ", hits: " << hits << ", misses: " << misses
+     << ", expired: " << expired << ", evictions: " << evictions
+     << ", rejections: " << rejections << ", hit rate: " << HitRate()
+     << ", saved bytes: " << saved_bytes;
+  return ss.str();
+}
+
+SparseValueCache::SparseValueCache(size_t capacity, size_t value_dim,
+                                   int64_t max_staleness_steps,
+                                   int64_t max_staleness_ms)
+    : capacity_(capacity),
+      value_dim_(value_dim),
+      max_staleness_steps_(max_staleness_steps),
+      max_staleness_ms_(max_staleness_ms),
+      sketch_(capacity) {
+  entries_.reserve(capacity);
+}
+
+bool SparseValueCache::IsFresh(const Entry& entry, int64_t now_ms) const {
+  if (max_staleness_steps_ > 0 && step_ - entry.step > max_staleness_steps_) {
+    return false;
+  }
+  if (max_staleness_ms_ > 0 && now_ms - entry.time_ms > max_staleness_ms_) {
+    return false;
+  }
+  return true;
+}
+
+void SparseValueCache::Lookup(const uint64_t* keys, float** values,
+                              size_t num, std::vector<uint64_t>* miss_keys,
+                              std::vector<float*>* miss_values) {
+  int64_t now_ms = NowMs();
+  size_t row_bytes = value_dim_ * sizeof(float);
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++step_;
+  uint64_t hits = 0;
+  for (size_t i = 0; i < num; ++i) {
+    sketch_.Increment(keys[i]);
+    auto it = entries_.find(keys[i]);
+    if (it != entries_.end() && IsFresh(it->second, now_ms)) {
+      auto& entry = it->second;
+      std::memcpy(values[i], SlotData(entry.slot), row_bytes);
+      lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+      ++hits;
+      continue;
+    }
+    if (it != entries_.end()) {
+      ++stat_.expired;
+    }
+    miss_keys->push_back(keys[i]);
+    miss_values->push_back(values[i]);
+  }
+  stat_.lookups += num;
+  stat_.hits += hits;
+  stat_.misses += num - hits;
+  stat_.saved_bytes += hits * (sizeof(uint64_t) + row_bytes);
+  if (step_ % 1000 == 0) {
+    VLOG(1) << "SparseValueCache " << stat_.ToString();
+  }
+}
+
+void SparseValueCache::Insert(const uint64_t* keys, float* const* values,
+                              size_t num) {
+  if (capacity_ == 0) return;
+  int64_t now_ms = NowMs();
+  size_t row_bytes = value_dim_ * sizeof(float);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < num; ++i) {
+    auto it = entries_.find(keys[i]);
+    if (it != entries_.end()) {
+      auto& entry = it->second;
+      std::memcpy(SlotData(entry.slot), values[i], row_bytes);
+      entry.step = step_;
+      entry.time_ms = now_ms;
+      lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+      continue;
+    }
+
+    size_t slot = 0;
+    if (entries_.size() < capacity_) {
+      // slots are never released, only handed over on eviction
+      slot = entries_.size();
+      values_.resize((slot + 1) * value_dim_);
+    } else {
+      uint64_t victim = lru_.back();
+      if (sketch_.Estimate(keys[i]) <= sketch_.Estimate(victim)) {
+        ++stat_.rejections;
+        continue;
+      }
+      auto victim_it = entries_.find(victim);
+      slot = victim_it->second.slot;
+      lru_.pop_back();
+      entries_.erase(victim_it);
+      ++stat_.evictions;
+    }
+
+    std::memcpy(SlotData(slot), values[i], row_bytes);
+    lru_.push_front(keys[i]);
+    entries_[keys[i]] = Entry{slot, step_, now_ms, lru_.begin()};
+  }
+}
+
+SparseValueCache::Stat SparseValueCache::GetStat() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stat_;
+}
+
+size_t SparseValueCache::Size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+}  // namespace distributed
+}  // namespace paddle
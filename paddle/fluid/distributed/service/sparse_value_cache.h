@@ -0,0 +1,120 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <list>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace paddle {
+namespace distributed {
+
+// Count-min sketch of 4 rows of saturating counters that estimates how often
+// a key was looked up recently. All counters are halved once sample_size
+// increments were recorded, so that old popularity fades out (TinyLFU).
+class FrequencySketch {
+ public:
+  explicit FrequencySketch(size_t capacity);
+
+  void Increment(uint64_t key);
+  uint32_t Estimate(uint64_t key) const;
+
+ private:
+  size_t Index(uint64_t key, int row) const;
+  void Age();
+
+  static constexpr int kDepth = 4;
+  static constexpr uint8_t kMaxCount = 15;
+
+  std::vector<uint8_t> table_;
+  size_t mask_;
+  size_t sample_size_;
+  size_t additions_ = 0;
+};
+
+// SparseValueCache keeps the hot rows of one sparse table in the trainer, so
+// that pull_sparse only has to ask the pservers for misses and for rows whose
+// cached copy exceeds the staleness bound. New rows are only admitted into a
+// full cache when the sketch estimates them more frequent than the least
+// recently used victim.
+class SparseValueCache {
+ public:
+  struct Stat {
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
+    // misses include the rows which were cached but expired
+    uint64_t misses = 0;
+    uint64_t expired = 0;
+    uint64_t evictions = 0;
+    uint64_t rejections = 0;
+    // the keys and values not transferred thanks to hits
+    uint64_t saved_bytes = 0;
+
+    double HitRate() const {
+      return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+    }
+    std::string ToString() const;
+  };
+
+  // value_dim is the number of floats of a row. A staleness bound <= 0 is
+  // not checked, with both unset cached rows never expire.
+  SparseValueCache(size_t capacity, size_t value_dim,
+                   int64_t max_staleness_steps, int64_t max_staleness_ms);
+
+  // Starts a new step and copies the fresh cached rows of keys into values.
+  // The keys and value pointers not served by the cache are appended to
+  // miss_keys and miss_values, they should be pulled from the pservers and
+  // then handed to Insert.
+  void Lookup(const uint64_t* keys, float** values, size_t num,
+              std::vector<uint64_t>* miss_keys,
+              std::vector<float*>* miss_values);
+
+  // Stores the rows pulled from the pservers, subject to admission.
+  void Insert(const uint64_t* keys, float* const* values, size_t num);
+
+  Stat GetStat();
+  size_t Size();
+
+ private:
+  struct Entry {
+    size_t slot;
+    int64_t step;
+    int64_t time_ms;
+    std::list<uint64_t>::iterator lru_pos;
+  };
+
+  bool IsFresh(const Entry& entry, int64_t now_ms) const;
+  float* SlotData(size_t slot) { return values_.data() + slot * value_dim_; }
+
+  const size_t capacity_;
+  const size_t value_dim_;
+  const int64_t max_staleness_steps_;
+  const int64_t max_staleness_ms_;
+
+  std::mutex mutex_;
+  int64_t step_ = 0;
+  std::unordered_map<uint64_t, Entry> entries_;
+  // most recently used keys first
+  std::list<uint64_t> lru_;
+  std::vector<float> values_;
+  FrequencySketch sketch_;
+  Stat stat_;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/distributed/table/common_dense_table.h"
 
+#include <thread>  // NOLINT
+
 #include "paddle/fluid/platform/enforce.h"
 
 namespace paddle {
@@ -37,6 +39,11 @@ void CommonDenseTable::create_initializer(const std::string& attr,
   }
 }
 
+CommonDenseTable::~CommonDenseTable() {
+  if (snapshot_ != nullptr) snapshot_->Unref();
+  if (spare_snapshot_ != nullptr) spare_snapshot_->Unref();
+}
+
 int32_t CommonDenseTable::initialize() {
   _shards_task_pool.resize(task_pool_size_);
   for (int i = 0; i < _shards_task_pool.size(); ++i) {
@@ -75,6 +82,9 @@ int32_t CommonDenseTable::initialize_value() {
   }
 
   pull_reservoir_ = ReservoirValue<float>(param_dim_);
+
+  std::lock_guard<std::mutex> lock(publish_mutex_);
+  publish_snapshot();
   return 0;
 }
 
@@ -104,9 +114,82 @@ int32_t CommonDenseTable::set_global_lr(float* lr) {
   return 0;
 }
 
+void CommonDenseTable::begin_update() {
+  seq_.store(seq_.load(std::memory_order_relaxed) + 1,
+             std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void CommonDenseTable::end_update() {
+  seq_.store(seq_.load(std::memory_order_relaxed) + 1,
+             std::memory_order_release);
+}
+
+void CommonDenseTable::publish_snapshot() {
+  DenseSnapshot* next = spare_snapshot_;
+  spare_snapshot_ = nullptr;
+  if (next != nullptr && !next->HasOneRef()) {
+    // still pinned by a reader, e.g. an in-flight pull_dense response
+    next->Unref();
+    next = nullptr;
+  }
+  if (next == nullptr) {
+    next = DenseSnapshot::Create(param_dim_);
+  }
+
+  // Copy the param without update_mutex_, and retry if a push updated it
+  // meanwhile, so that pushes never wait for the copy.
+  const float* param = values_[param_idx_].data();
+  uint64_t seq = 0;
+  bool consistent = false;
+  for (int i = 0; i < kMaxOptimisticCopies && !consistent; ++i) {
+    seq = seq_.load(std::memory_order_acquire);
+    if (seq & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::copy_n(param, param_dim_, next->data());
+    std::atomic_thread_fence(std::memory_order_acquire);
+    consistent = seq_.load(std::memory_order_relaxed) == seq;
+  }
+  if (!consistent) {
+    // pushes keep coming, copy under the lock to make progress
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    seq = seq_.load(std::memory_order_relaxed);
+    std::copy_n(param, param_dim_, next->data());
+  }
+  // the versions start from 1, for clients take 0 as no version known
+  next->set_version(seq / 2 + 1);
+
+  DenseSnapshot* prev = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    prev = snapshot_;
+    snapshot_ = next;
+  }
+  spare_snapshot_ = prev;
+  published_seq_.store(seq, std::memory_order_release);
+}
+
+DenseSnapshot* CommonDenseTable::pull_dense_snapshot() {
+  if (published_seq_.load(std::memory_order_acquire) !=
+      seq_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    // the pulls waiting for the lock together publish only once
+    if (published_seq_.load(std::memory_order_relaxed) !=
+        seq_.load(std::memory_order_acquire)) {
+      publish_snapshot();
+    }
+  }
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  snapshot_->Ref();
+  return snapshot_;
+}
+
 int32_t CommonDenseTable::pull_dense(float* pull_values, size_t num) {
-  std::copy(values_[param_idx_].begin(), values_[param_idx_].end(),
-            pull_values);
+  DenseSnapshot* snapshot = pull_dense_snapshot();
+  std::copy_n(snapshot->data(), snapshot->numel(), pull_values);
+  snapshot->Unref();
   return 0;
 }
 
@@ -115,7 +198,10 @@ int32_t CommonDenseTable::push_dense_param(const float* values, size_t num) {
       num, param_dim_,
       paddle::platform::errors::InvalidArgument(
           "update desne param numel expected %d, but got %d", param_dim_, num));
+  std::lock_guard<std::mutex> lock(update_mutex_);
+  begin_update();
   std::copy_n(values, param_dim_, values_[param_idx_].begin());
+  end_update();
   return 0;
 }
 
@@ -145,9 +231,11 @@ int32_t CommonDenseTable::_push_dense(const float* values, size_t num) {
       paddle::platform::errors::InvalidArgument(
           "update desne numel expected %d, but got %d", param_dim_, num));
 
+  std::lock_guard<std::mutex> lock(update_mutex_);
   std::vector<int> buckets = bucket(param_dim_, task_pool_size_);
   std::vector<std::future<int>> tasks(task_pool_size_);
 
+  begin_update();
   for (int shard_id = 0; shard_id < task_pool_size_; ++shard_id) {
     tasks[shard_id] = _shards_task_pool[shard_id]->enqueue(
         [this, shard_id, &buckets, &values]() -> int {
@@ -161,6 +249,7 @@ int32_t CommonDenseTable::_push_dense(const float* values, size_t num) {
   for (size_t shard_id = 0; shard_id < tasks.size(); ++shard_id) {
     tasks[shard_id].wait();
   }
+  end_update();
   return 0;
 }
 
@@ -17,6 +17,8 @@
 #include <ThreadPool.h>
 #include <assert.h>
 #include <pthread.h>
+#include <atomic>
+#include <mutex>  // NOLINT
 #include <string>
 #include "Eigen/Dense"
 #include "paddle/fluid/distributed/table/accessor.h"
@@ -33,7 +35,7 @@ class DenseOptimizer;
 class CommonDenseTable : public DenseTable {
  public:
   explicit CommonDenseTable() {}
-  virtual ~CommonDenseTable() {}
+  virtual ~CommonDenseTable();
   virtual int32_t initialize() override;
   virtual int32_t initialize_shard() override { return 0; }
   virtual void create_initializer(const std::string& attr,
@@ -41,6 +43,7 @@ class CommonDenseTable : public DenseTable {
   virtual int32_t initialize_value();
   virtual int32_t initialize_optimizer();
   virtual int32_t pull_dense(float* pull_values, size_t num) override;
+  virtual DenseSnapshot* pull_dense_snapshot() override;
   virtual int32_t push_dense_param(const float* values, size_t num) override;
   virtual int32_t push_dense(const float* values, size_t num) override;
   virtual int32_t pour() override;
@@ -65,6 +68,15 @@ class CommonDenseTable : public DenseTable {
 
  protected:
   int32_t _push_dense(const float* values, size_t num);
+  // Copies the param into the back buffer and swaps it in as the snapshot
+  // served to readers, publish_mutex_ must be held. The copy runs without
+  // update_mutex_ and is retried if a push updated the param meanwhile.
+  void publish_snapshot();
+  // Enclose an update of the param, update_mutex_ must be held. seq_ is odd
+  // during the update, so that a concurrent copy of the param is detected.
+  // The next pull publishes a new snapshot, so pushes never copy the param.
+  void begin_update();
+  void end_update();
 
  private:
   const int task_pool_size_ = 1;
@@ -77,6 +89,24 @@ class CommonDenseTable : public DenseTable {
   ReservoirValue<float> pull_reservoir_;
   std::unordered_map<std::string, Initializer*> initializers_;
   std::unordered_map<std::string, int> names_index_;
+
+  // the optimistic copies tried before a reader copies under update_mutex_
+  static constexpr int kMaxOptimisticCopies = 4;
+
+  // Writers serialize on update_mutex_ and never wait on readers, readers
+  // only take snapshot_mutex_ to pin the current snapshot, and
+  // publish_mutex_ to publish it once after pushes.
+  std::mutex update_mutex_;
+  std::mutex publish_mutex_;
+  std::mutex snapshot_mutex_;
+  DenseSnapshot* snapshot_ = nullptr;
+  // the previous snapshot, reused as the back buffer once no reader pins it
+  DenseSnapshot* spare_snapshot_ = nullptr;
+  // twice the number of updates of the param, plus one during an update.
+  // The version of a snapshot is the number of updates plus one.
+  std::atomic<uint64_t> seq_{0};
+  // seq_ of the param copied into the current snapshot
+  std::atomic<uint64_t> published_seq_{0};
 };
 
 }  // namespace distributed
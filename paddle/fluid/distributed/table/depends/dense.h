@@ -23,6 +23,7 @@
 #include "gflags/gflags.h"
 
 #include "paddle/fluid/distributed/common/utils.h"
+#include "paddle/fluid/operators/jit/kernels.h"
 
 namespace paddle {
 namespace distributed {
@@ -84,15 +85,11 @@ class DSGD : public DenseOptimizer {
   void update(const float* update_values, size_t num, int begin,
               int end) override {
     auto update_numel = end - begin;
-    std::vector<float> grads;
-    grads.resize(update_numel);
-
-    auto blas = GetBlas<float>();
     float lr = *(global_learning_rate_) * (*learning_rate);
     VLOG(4) << "DSGD LearningRate: " << lr;
-    blas.VCOPY(update_numel, update_values + begin, grads.data());
-    blas.SCAL(update_numel, lr, grads.data());
-    blas.VSUB(update_numel, param + begin, grads.data(), param + begin);
+    // param -= lr * grad in a single pass without temporary buffers
+    GetBlas<float>().AXPY(update_numel, -lr, update_values + begin,
+                          param + begin);
   }
 
   float* learning_rate;
@@ -130,28 +127,15 @@ class DAdam : public DenseOptimizer {
     beta1 = 0.9;
     beta2 = 0.999;
     epsilon = 1.0e-8;
+
+    adam_ = operators::jit::KernelFuncs<operators::jit::AdamTuple<float>,
+                                        platform::CPUPlace>::Cache()
+                .At(operators::jit::adam_attr_t(beta1, beta2));
   }
 
   void update(const float* update_values, size_t num, int begin,
               int end) override {
     auto update_numel = end - begin;
-    std::vector<float> grad, grad2, tmp;
-    grad.resize(update_numel);
-    grad2.resize(update_numel);
-    tmp.resize(update_numel);
-
-    auto blas = GetBlas<float>();
-    blas.VCOPY(update_numel, update_values + begin, grad.data());
-    blas.VCOPY(update_numel, update_values + begin, grad2.data());
-
-    blas.SCAL(update_numel, 1 - beta1, grad.data());
-    blas.VSQUARE(update_numel, grad2.data(), grad2.data());
-    blas.SCAL(update_numel, 1 - beta2, grad2.data());
-
-    blas.SCAL(update_numel, beta1, moment1 + begin);
-    blas.VADD(update_numel, moment1 + begin, grad.data(), moment1 + begin);
-    blas.SCAL(update_numel, beta2, moment2 + begin);
-    blas.VADD(update_numel, moment2 + begin, grad2.data(), moment2 + begin);
 
     beta1_pow[0] = beta1_pow[0] * beta1;
     beta2_pow[0] = beta2_pow[0] * beta2;
@@ -159,16 +143,12 @@ class DAdam : public DenseOptimizer {
     float lr_ = *(global_learning_rate_)*learning_rate[0];
     VLOG(4) << "DAdam LearningRate: " << lr_;
     lr_ *= sqrt(1 - beta2_pow[0]) / (1 - beta1_pow[0]);
-
-    float* tmp_ = tmp.data();
     float eps_ = epsilon * sqrt(1 - beta2_pow[0]);
 
-    SQRT<float>(update_numel, moment2 + begin, tmp_);
-    ADD<float>(update_numel, tmp_, eps_, tmp_);
-
-    blas.VDIV(update_numel, moment1 + begin, tmp_, tmp_);
-    blas.SCAL(update_numel, lr_, tmp_);
-    blas.VSUB(update_numel, param + begin, tmp_, param + begin);
+    // moments and param are updated in place by one fused pass
+    adam_(beta1, beta2, lr_, eps_, update_numel, update_values + begin,
+          moment1 + begin, moment2 + begin, param + begin, moment1 + begin,
+          moment2 + begin, param + begin);
   }
 
   float* learning_rate;
@@ -183,6 +163,8 @@ class DAdam : public DenseOptimizer {
   float beta1;
   float beta2;
   float epsilon;
+
+  operators::jit::AdamTuple<float>::func_type adam_;
 };
 
 }  // namespace distributed
@@ -0,0 +1,73 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+namespace paddle {
+namespace distributed {
+
+// An immutable, reference counted copy of a dense parameter published by a
+// dense table. The values are laid out right after the header, so the
+// snapshot can be recovered from its data pointer and handed to brpc with
+// IOBuf::append_user_data(data, size, DenseSnapshot::UnrefData) without any
+// copy.
+class DenseSnapshot {
+ public:
+  // The returned snapshot holds one reference owned by the caller.
+  static DenseSnapshot* Create(size_t numel) {
+    void* mem = ::operator new(sizeof(DenseSnapshot) + numel * sizeof(float));
+    return new (mem) DenseSnapshot(numel);
+  }
+
+  // Drops one reference of the snapshot owning data.
+  static void UnrefData(void* data) {
+    (reinterpret_cast<DenseSnapshot*>(data) - 1)->Unref();
+  }
+
+  void Ref() { refs_.fetch_add(1, std::memory_order_relaxed); }
+
+  void Unref() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      this->~DenseSnapshot();
+      ::operator delete(this);
+    }
+  }
+
+  bool HasOneRef() const { return refs_.load(std::memory_order_acquire) == 1; }
+
+  float* data() { return reinterpret_cast<float*>(this + 1); }
+  const float* data() const { return reinterpret_cast<const float*>(this + 1); }
+  size_t numel() const { return numel_; }
+
+  uint64_t version() const { return version_; }
+  void set_version(uint64_t version) { version_ = version; }
+
+ private:
+  explicit DenseSnapshot(size_t numel) : refs_(1), numel_(numel) {}
+  ~DenseSnapshot() = default;
+
+  std::atomic<int64_t> refs_;
+  size_t numel_;
+  uint64_t version_ = 0;
+};
+
+static_assert(sizeof(DenseSnapshot) % alignof(float) == 0,
+              "the values of DenseSnapshot must follow its header aligned");
+
+}  // namespace distributed
+}  // namespace paddle
@@ -14,80 +14,142 @@
 
 #pragma once
 
-#include <ThreadPool.h>
-#include <functional>
-#include <future>  // NOLINT
+#include <algorithm>
+#include <deque>
 #include <memory>
-#include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <mutex>  // NOLINT
 #include <utility>
 #include <vector>
 
+#include "glog/logging.h"
+
 namespace paddle {
 namespace distributed {
 
-class ConcurrentSet {
- public:
-  ConcurrentSet() : pool_(new ::ThreadPool(1)) {}
-  ~ConcurrentSet() {}
-
-  std::future<void> Update(const std::vector<uint64_t>& rows) {
-    auto task = [this, rows] {
-      for (auto row : rows) {
-        set_.insert(row);
-      }
-    };
-    return pool_->enqueue(std::move(task));
-  }
-
-  std::future<void> GetAndClear(std::vector<uint64_t>* result) {
-    auto task = [this, &result] {
-      result->clear();
-      for (auto& id : set_) {
-        result->push_back(id);
-      }
-      set_.clear();
-    };
-    return pool_->enqueue(std::move(task));
-  }
-
- private:
-  std::unordered_set<uint64_t> set_;
-  std::unique_ptr<::ThreadPool> pool_{nullptr};
-};
-
+// GeoRecorder keeps the rows updated by pushes in one append-only log shared
+// by all trainers, each trainer reads the log from its own cursor. Segments
+// are reclaimed once every cursor has passed them, and adjacent segments that
+// no cursor separates are merged when the log grows, so a push costs
+// O(rows) instead of O(rows x trainers).
 class GeoRecorder {
  public:
-  explicit GeoRecorder(int trainer_num) : trainer_num_(trainer_num) {
-    trainer_rows_.reserve(trainer_num);
-    for (auto i = 0; i < trainer_num; ++i) {
-      trainer_rows_.emplace_back(new ConcurrentSet());
-    }
-  }
+  explicit GeoRecorder(int trainer_num)
+      : trainer_num_(trainer_num),
+        cursors_(trainer_num, 0),
+        compact_threshold_(2 * trainer_num + 64) {}
 
   ~GeoRecorder() = default;
 
   void Update(const std::vector<uint64_t>& update_rows) {
     VLOG(3) << " row size: " << update_rows.size();
+    if (update_rows.empty()) return;
 
-    std::vector<std::future<void>> fs;
-    for (auto& set : trainer_rows_) {
-      fs.push_back(set->Update(update_rows));
-    }
-    for (auto& f : fs) {
-      f.wait();
+    auto rows = std::make_shared<std::vector<uint64_t>>(update_rows);
+    SortAndUnique(rows.get());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    log_.push_back(Segment{++next_seq_, std::move(rows)});
+    if (log_.size() > compact_threshold_) {
+      Compact();
     }
   }
 
+  // Returns the deduplicated rows updated since the last call of trainer_id,
+  // sorted in ascending order.
   void GetAndClear(uint32_t trainer_id, std::vector<uint64_t>* result) {
     VLOG(3) << "GetAndClear for trainer: " << trainer_id;
-    trainer_rows_.at(trainer_id)->GetAndClear(result).wait();
+    std::vector<std::shared_ptr<const std::vector<uint64_t>>> runs;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& cursor = cursors_.at(trainer_id);
+      for (auto& segment : log_) {
+        if (segment.end_seq > cursor) {
+          runs.push_back(segment.rows);
+        }
+      }
+      cursor = next_seq_;
+      CollectGarbage();
+    }
+
+    result->clear();
+    for (auto& run : runs) {
+      result->insert(result->end(), run->begin(), run->end());
+    }
+    SortAndUnique(result);
+  }
+
+  // The number of segments kept in the log, for tests and monitoring.
+  size_t LogSize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_.size();
   }
 
  private:
+  struct Segment {
+    // the sequence number after the last update merged into this segment
+    uint64_t end_seq;
+    std::shared_ptr<const std::vector<uint64_t>> rows;
+  };
+
+  static void SortAndUnique(std::vector<uint64_t>* rows) {
+    std::sort(rows->begin(), rows->end());
+    rows->erase(std::unique(rows->begin(), rows->end()), rows->end());
+  }
+
+  // Drops the segments all trainers have read, mutex_ must be held.
+  void CollectGarbage() {
+    uint64_t min_cursor = *std::min_element(cursors_.begin(), cursors_.end());
+    while (!log_.empty() && log_.front().end_seq <= min_cursor) {
+      log_.pop_front();
+    }
+  }
+
+  // Merges the runs of adjacent segments that are pending for the same set
+  // of trainers, mutex_ must be held. Afterwards the log has at most one
+  // segment per distinct cursor position.
+  void Compact() {
+    std::vector<uint64_t> bounds(cursors_);
+    std::sort(bounds.begin(), bounds.end());
+
+    std::deque<Segment> compacted;
+    std::shared_ptr<std::vector<uint64_t>> merged;
+    auto flush = [&]() {
+      if (merged == nullptr) return;
+      SortAndUnique(merged.get());
+      compacted.back().rows = std::move(merged);
+      merged = nullptr;
+    };
+    for (auto& segment : log_) {
+      bool separated =
+          compacted.empty() || std::binary_search(bounds.begin(), bounds.end(),
+                                                  compacted.back().end_seq);
+      if (separated) {
+        flush();
+        compacted.push_back(segment);
+        continue;
+      }
+      if (merged == nullptr) {
+        merged = std::make_shared<std::vector<uint64_t>>(
+            *compacted.back().rows);
+      }
+      merged->insert(merged->end(), segment.rows->begin(),
+                     segment.rows->end());
+      compacted.back().end_seq = segment.end_seq;
+    }
+    flush();
+    VLOG(3) << "GeoRecorder compacts " << log_.size() << " segments into "
+            << compacted.size();
+    log_.swap(compacted);
+  }
+
   const int trainer_num_;
-  std::vector<std::unique_ptr<ConcurrentSet>> trainer_rows_;
+  std::mutex mutex_;
+  // the sequence number of the latest update
+  uint64_t next_seq_ = 0;
+  std::deque<Segment> log_;
+  // every trainer has read all updates up to its cursor
+  std::vector<uint64_t> cursors_;
+  const size_t compact_threshold_;
 };
 
 }  // namespace distributed
@@ -25,6 +25,7 @@
 
 #include "paddle/fluid/distributed/common/utils.h"
 #include "paddle/fluid/distributed/table/depends/large_scale_kv.h"
+#include "paddle/fluid/operators/jit/kernels.h"
 
 namespace paddle {
 namespace distributed {
@@ -112,12 +113,8 @@ class SSGD : public SparseOptimizer {
       float learning_rate = *(global_learning_rate_) * (value + lr_offset)[0];
       VLOG(4) << "SSGD LearningRate: " << learning_rate;
       float* param = value + param_offset;
-
-      std::vector<float> grads;
-      grads.resize(update_numel);
-      blas.VCOPY(update_numel, update_values + x * update_numel, grads.data());
-      blas.SCAL(update_numel, learning_rate, grads.data());
-      blas.VSUB(update_numel, param, grads.data(), param);
+      blas.AXPY(update_numel, -learning_rate, update_values + x * update_numel,
+                param);
     }
   }
 
@@ -155,12 +152,15 @@ class SAdam : public SparseOptimizer {
     beta1 = 0.9;
     beta2 = 0.999;
     epsilon = 1.0e-8;
+
+    adam_ = operators::jit::KernelFuncs<operators::jit::AdamTuple<float>,
+                                        platform::CPUPlace>::Cache()
+                .At(operators::jit::adam_attr_t(beta1, beta2));
   }
 
   void update(const uint64_t* keys, const float* update_values, size_t num,
               const std::vector<uint64_t>& offsets,
               ValueBlock* block) override {
-    auto blas = GetBlas<float>();
     for (auto x : offsets) {
       auto id = keys[x];
       if (!block->GetEntry(id)) continue;
@@ -178,32 +178,11 @@ class SAdam : public SparseOptimizer {
 
       lr_ *= sqrt(1 - beta2_pow[0]) / (1 - beta1_pow[0]);
 
-      std::vector<float> grad, grad2, tmp;
-      grad.resize(update_numel);
-      grad2.resize(update_numel);
-      tmp.resize(update_numel);
-
-      blas.VCOPY(update_numel, update_values + x * update_numel, grad.data());
-      blas.VCOPY(update_numel, update_values + x * update_numel, grad2.data());
-
-      blas.SCAL(update_numel, 1 - beta1, grad.data());
-      blas.VSQUARE(update_numel, grad2.data(), grad2.data());
-      blas.SCAL(update_numel, 1 - beta2, grad2.data());
-
-      blas.SCAL(update_numel, beta1, moment1);
-      blas.VADD(update_numel, moment1, grad.data(), moment1);
-      blas.SCAL(update_numel, beta2, moment2);
-      blas.VADD(update_numel, moment2, grad2.data(), moment2);
-
-      float* tmp_ = tmp.data();
       float eps_ = epsilon * sqrt(1 - beta2_pow[0]);
 
-      SQRT<float>(update_numel, moment2, tmp_);
-      ADD<float>(update_numel, tmp_, eps_, tmp_);
-
-      blas.VDIV(update_numel, moment1, tmp_, tmp_);
-      blas.SCAL(update_numel, lr_, tmp_);
-      blas.VSUB(update_numel, param, tmp_, param);
+      adam_(beta1, beta2, lr_, eps_, update_numel,
+            update_values + x * update_numel, moment1, moment2, param, moment1,
+            moment2, param);
     }
   }
 
@@ -216,6 +195,8 @@ class SAdam : public SparseOptimizer {
   float beta1;
   float beta2;
   float epsilon;
+
+  operators::jit::AdamTuple<float>::func_type adam_;
 };
 
 }  // namespace distributed
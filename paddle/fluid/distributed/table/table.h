@@ -21,6 +21,7 @@
 #include <string>
 #include <utility>
 #include "paddle/fluid/distributed/table/accessor.h"
+#include "paddle/fluid/distributed/table/depends/dense_snapshot.h"
 #include "paddle/fluid/framework/program_desc.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/platform/device_context.h"
@@ -45,6 +46,10 @@ class Table {
   virtual int32_t push_dense_param(const float *values, size_t num) {
     return 0;
   }
+  // Returns a consistent, read-only snapshot of the dense values together
+  // with its version, the caller owns one reference of it. Tables which do
+  // not publish snapshots return nullptr and are read by pull_dense.
+  virtual DenseSnapshot *pull_dense_snapshot() { return nullptr; }
 
   virtual int32_t pull_sparse(float *values, const uint64_t *keys,
                               size_t num) = 0;
@@ -37,6 +37,9 @@ class Variable;
 }  // namespace framework
 }  // namespace paddle
 
+DECLARE_int32(pserver_sparse_cache_capacity);
+DECLARE_int32(pserver_sparse_cache_max_staleness_steps);
+
 namespace framework = paddle::framework;
 namespace platform = paddle::platform;
 namespace operators = paddle::operators;
@@ -282,6 +285,61 @@ void RunBrpcPushSparse() {
     EXPECT_FLOAT_EQ(fea_temp_values[idx], fea_values[idx] - 1.0);
   }
 
+  /*-----------------------Test Sparse Value Cache---------------------------*/
+
+  LOG(INFO) << "Run pull_sparse with cache";
+  FLAGS_pserver_sparse_cache_capacity = 100;
+  FLAGS_pserver_sparse_cache_max_staleness_steps = 1;
+  auto cache = std::dynamic_pointer_cast<paddle::distributed::BrpcPsClient>(
+                   worker_ptr_)
+                   ->sparse_value_cache(0);
+  ASSERT_TRUE(cache != nullptr);
+
+  // the first pull misses and fills the cache
+  auto pull_cache_status = worker_ptr_->pull_sparse(
+      fea_temp_value_ptr.data(), 0, fea_keys.data(), fea_keys.size());
+  pull_cache_status.wait();
+  ASSERT_EQ(cache->GetStat().misses, fea_keys.size());
+
+  paddle::distributed::DownpourBrpcClosure* closure_push_cache =
+      new paddle::distributed::DownpourBrpcClosure(1, [&](void* done) {
+        auto* closure = (paddle::distributed::DownpourBrpcClosure*)done;
+        closure->set_promise_value(
+            closure->check_response(
+                0, paddle::distributed::PS_PUSH_SPARSE_TABLE) != 0
+                ? -1
+                : 0);
+      });
+  auto push_cache_status = worker_ptr_->push_sparse_raw_gradient(
+      0, fea_keys.data(), (const float**)push_g_vec.data(), fea_keys.size(),
+      closure_push_cache);
+  push_cache_status.wait();
+
+  // within the staleness bound the rows are served locally, not updated yet
+  std::vector<float> cached_values(100);
+  std::vector<float*> cached_value_ptr(10);
+  for (size_t idx = 0; idx < fea_keys.size(); ++idx) {
+    cached_value_ptr[idx] = cached_values.data() + idx * 10;
+  }
+  pull_cache_status = worker_ptr_->pull_sparse(
+      cached_value_ptr.data(), 0, fea_keys.data(), fea_keys.size());
+  pull_cache_status.wait();
+  ASSERT_EQ(cache->GetStat().hits, fea_keys.size());
+  for (size_t idx = 0; idx < tensor->numel(); ++idx) {
+    EXPECT_FLOAT_EQ(cached_values[idx], fea_temp_values[idx]);
+  }
+
+  // the expired rows are pulled again
+  pull_cache_status = worker_ptr_->pull_sparse(
+      cached_value_ptr.data(), 0, fea_keys.data(), fea_keys.size());
+  pull_cache_status.wait();
+  ASSERT_EQ(cache->GetStat().expired, fea_keys.size());
+  for (size_t idx = 0; idx < tensor->numel(); ++idx) {
+    EXPECT_FLOAT_EQ(cached_values[idx], fea_temp_values[idx] - 1.0);
+  }
+  LOG(INFO) << "sparse value cache " << cache->GetStat().ToString();
+  FLAGS_pserver_sparse_cache_capacity = 0;
+
   LOG(INFO) << "Run stop_server";
   worker_ptr_->stop_server();
   LOG(INFO) << "Run finalize_worker";
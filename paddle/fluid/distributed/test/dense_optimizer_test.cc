@@ -0,0 +1,173 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps.pb.h"
+#include "paddle/fluid/distributed/table/depends/dense.h"
+
+// Run with --dense_optimizer_bench_numel=100000000 to reproduce the numbers
+// of a 100M-parameter dense table.
+DEFINE_int64(dense_optimizer_bench_numel, 1 << 20,
+             "The number of parameters updated by the optimizer benchmark.");
+DEFINE_int32(dense_optimizer_bench_repeat, 5,
+             "The repeat times of the optimizer benchmark.");
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+
+// The chained BLAS implementation the dense optimizers used before they were
+// fused, kept here as the baseline.
+void ChainedSGD(float lr, int n, const float* grad, float* param) {
+  std::vector<float> grads(n);
+  auto blas = GetBlas<float>();
+  blas.VCOPY(n, grad, grads.data());
+  blas.SCAL(n, lr, grads.data());
+  blas.VSUB(n, param, grads.data(), param);
+}
+
+void ChainedAdam(float beta1, float beta2, float lr, float eps, int n,
+                 const float* update, float* moment1, float* moment2,
+                 float* param) {
+  std::vector<float> grad(n), grad2(n), tmp(n);
+  auto blas = GetBlas<float>();
+  blas.VCOPY(n, update, grad.data());
+  blas.VCOPY(n, update, grad2.data());
+  blas.SCAL(n, 1 - beta1, grad.data());
+  blas.VSQUARE(n, grad2.data(), grad2.data());
+  blas.SCAL(n, 1 - beta2, grad2.data());
+  blas.SCAL(n, beta1, moment1);
+  blas.VADD(n, moment1, grad.data(), moment1);
+  blas.SCAL(n, beta2, moment2);
+  blas.VADD(n, moment2, grad2.data(), moment2);
+  SQRT<float>(n, moment2, tmp.data());
+  ADD<float>(n, tmp.data(), eps, tmp.data());
+  blas.VDIV(n, moment1, tmp.data(), tmp.data());
+  blas.SCAL(n, lr, tmp.data());
+  blas.VSUB(n, param, tmp.data(), param);
+}
+
+void RandomFill(std::vector<float>* vec, float lower, float upper) {
+  std::mt19937 rng(100);
+  std::uniform_real_distribution<float> dist(lower, upper);
+  for (auto& v : *vec) {
+    v = dist(rng);
+  }
+}
+
+CommonAccessorParameter MakeAccessor(const std::vector<std::string>& names) {
+  CommonAccessorParameter accessor;
+  for (auto& name : names) {
+    accessor.add_params(name);
+  }
+  return accessor;
+}
+
+template <typename Func>
+double AvgMs(Func&& func) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_dense_optimizer_bench_repeat; ++i) {
+    func();
+  }
+  std::chrono::duration<double, std::milli> cost =
+      std::chrono::steady_clock::now() - start;
+  return cost.count() / FLAGS_dense_optimizer_bench_repeat;
+}
+
+}  // namespace
+
+TEST(DenseOptimizer, SGDMatchesChainedBlas) {
+  const int numel = static_cast<int>(FLAGS_dense_optimizer_bench_numel);
+  float global_lr = 1.0;
+
+  std::vector<std::vector<float>> values(2);
+  values[0].resize(numel);
+  RandomFill(&values[0], -1.f, 1.f);
+  values[1].assign(1, 0.01);
+  std::vector<float> grad(numel);
+  RandomFill(&grad, -1.f, 1.f);
+  std::vector<float> param_ref(values[0]);
+
+  DSGD sgd(MakeAccessor({"Param", "LearningRate"}), &values);
+  sgd.set_global_lr(&global_lr);
+
+  double fused_ms = AvgMs([&]() { sgd.update(grad.data(), 0, 0, numel); });
+  double chained_ms = AvgMs([&]() {
+    ChainedSGD(values[1][0], numel, grad.data(), param_ref.data());
+  });
+  LOG(INFO) << "DSGD on " << numel << " params: fused " << fused_ms
+            << " ms, chained blas " << chained_ms << " ms";
+
+  for (int i = 0; i < numel; ++i) {
+    ASSERT_NEAR(values[0][i], param_ref[i], 1e-5) << " at index : " << i;
+  }
+}
+
+TEST(DenseOptimizer, AdamMatchesChainedBlas) {
+  const int numel = static_cast<int>(FLAGS_dense_optimizer_bench_numel);
+  const float beta1 = 0.9;
+  const float beta2 = 0.999;
+  const float epsilon = 1.0e-8;
+  float global_lr = 1.0;
+
+  // Param, LearningRate, Moment1, Moment2, Beta1Pow, Beta2Pow
+  std::vector<std::vector<float>> values(6);
+  values[0].resize(numel);
+  RandomFill(&values[0], -1.f, 1.f);
+  values[1].assign(1, 0.001);
+  values[2].assign(numel, 0.0);
+  values[3].assign(numel, 0.0);
+  values[4].assign(1, 1.0);
+  values[5].assign(1, 1.0);
+  std::vector<float> grad(numel);
+  RandomFill(&grad, -1.f, 1.f);
+
+  std::vector<float> param_ref(values[0]);
+  std::vector<float> moment1_ref(numel, 0.0), moment2_ref(numel, 0.0);
+  float beta1_pow_ref = 1.0, beta2_pow_ref = 1.0;
+
+  DAdam adam(MakeAccessor({"Param", "LearningRate", "Moment1", "Moment2",
+                           "Beta1Pow", "Beta2Pow"}),
+             &values);
+  adam.set_global_lr(&global_lr);
+
+  double fused_ms = AvgMs([&]() { adam.update(grad.data(), 0, 0, numel); });
+  double chained_ms = AvgMs([&]() {
+    beta1_pow_ref *= beta1;
+    beta2_pow_ref *= beta2;
+    float lr = values[1][0] * sqrt(1 - beta2_pow_ref) / (1 - beta1_pow_ref);
+    float eps = epsilon * sqrt(1 - beta2_pow_ref);
+    ChainedAdam(beta1, beta2, lr, eps, numel, grad.data(), moment1_ref.data(),
+                moment2_ref.data(), param_ref.data());
+  });
+  LOG(INFO) << "DAdam on " << numel << " params: fused " << fused_ms
+            << " ms, chained blas " << chained_ms << " ms";
+
+  ASSERT_FLOAT_EQ(values[4][0], beta1_pow_ref);
+  ASSERT_FLOAT_EQ(values[5][0], beta2_pow_ref);
+  for (int i = 0; i < numel; ++i) {
+    ASSERT_NEAR(values[2][i], moment1_ref[i], 1e-5) << " at index : " << i;
+    ASSERT_NEAR(values[3][i], moment2_ref[i], 1e-5) << " at index : " << i;
+    ASSERT_NEAR(values[0][i], param_ref[i], 1e-5) << " at index : " << i;
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include <ThreadPool.h>
+#include <atomic>
+#include <thread>  // NOLINT
 #include <vector>
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/ps.pb.h"
@@ -185,5 +187,129 @@ TEST(CommonDenseTable, SGD) {
   }
 }
 
+// CommonDenseTable snapshots stay consistent while pushes go on
+TEST(CommonDenseTable, Snapshot) {
+  int fea_dim = 10;
+
+  TableParameter table_config;
+  table_config.set_table_class("CommonDenseTable");
+  FsClientParameter fs_config;
+  Table *table = new CommonDenseTable();
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CommMergeAccessor");
+  CommonAccessorParameter *common_config = table_config.mutable_common();
+  common_config->set_name("sgd");
+  common_config->set_table_name("snapshot_test_table");
+  common_config->set_trainer_num(1);
+  common_config->add_params("Param");
+  common_config->add_dims(fea_dim);
+  common_config->add_initializers("fill_constant&1.0");
+  common_config->add_params("LearningRate");
+  common_config->add_dims(1);
+  common_config->add_initializers("fill_constant&1.0");
+  auto ret = table->initialize(table_config, fs_config);
+  ASSERT_EQ(ret, 0);
+
+  DenseSnapshot *first = table->pull_dense_snapshot();
+  ASSERT_TRUE(first != nullptr);
+  ASSERT_EQ(first->numel(), static_cast<size_t>(fea_dim));
+  uint64_t first_version = first->version();
+
+  // pulls without pushes in between see the same snapshot
+  DenseSnapshot *again = table->pull_dense_snapshot();
+  ASSERT_EQ(again, first);
+  again->Unref();
+
+  std::vector<float> gradients(fea_dim, 0.5);
+  table->push_dense(gradients.data(), gradients.size());
+  table->push_dense(gradients.data(), gradients.size());
+
+  // the pinned snapshot is neither modified nor reused by the pushes
+  for (int j = 0; j < fea_dim; j++) {
+    ASSERT_FLOAT_EQ(first->data()[j], 1.0);
+  }
+
+  DenseSnapshot *second = table->pull_dense_snapshot();
+  ASSERT_NE(second, first);
+  ASSERT_EQ(second->version(), first_version + 2);
+  for (int j = 0; j < fea_dim; j++) {
+    ASSERT_FLOAT_EQ(second->data()[j], 0.0);
+  }
+  first->Unref();
+  second->Unref();
+
+  std::vector<float> pull_values(fea_dim);
+  table->pull_dense(pull_values.data(), fea_dim);
+  for (int j = 0; j < fea_dim; j++) {
+    ASSERT_FLOAT_EQ(pull_values[j], 0.0);
+  }
+  delete table;
+}
+
+// Snapshots copied while pushes update the param hold a single push
+TEST(CommonDenseTable, SnapshotDuringPushes) {
+  int fea_dim = 1 << 16;
+
+  TableParameter table_config;
+  table_config.set_table_class("CommonDenseTable");
+  FsClientParameter fs_config;
+  Table *table = new CommonDenseTable();
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CommMergeAccessor");
+  CommonAccessorParameter *common_config = table_config.mutable_common();
+  common_config->set_name("sgd");
+  common_config->set_table_name("snapshot_push_test_table");
+  common_config->set_trainer_num(1);
+  common_config->add_params("Param");
+  common_config->add_dims(fea_dim);
+  common_config->add_initializers("fill_constant&0.0");
+  common_config->add_params("LearningRate");
+  common_config->add_dims(1);
+  common_config->add_initializers("fill_constant&1.0");
+  auto ret = table->initialize(table_config, fs_config);
+  ASSERT_EQ(ret, 0);
+
+  // the k-th push sets every value to k
+  std::atomic<bool> done{false};
+  std::thread pusher([&]() {
+    std::vector<float> values(fea_dim);
+    for (int k = 1; k <= 200; ++k) {
+      std::fill(values.begin(), values.end(), static_cast<float>(k));
+      table->push_dense_param(values.data(), values.size());
+    }
+    done = true;
+  });
+
+  std::vector<std::thread> readers;
+  std::atomic<int> torn{0};
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&]() {
+      uint64_t last_version = 0;
+      while (!done) {
+        DenseSnapshot *snapshot = table->pull_dense_snapshot();
+        const float *data = snapshot->data();
+        for (int j = 1; j < fea_dim; ++j) {
+          if (data[j] != data[0]) {
+            ++torn;
+            break;
+          }
+        }
+        // a reader never sees the versions go back
+        if (snapshot->version() < last_version) ++torn;
+        last_version = snapshot->version();
+        snapshot->Unref();
+      }
+    });
+  }
+  pusher.join();
+  for (auto &reader : readers) reader.join();
+  ASSERT_EQ(torn.load(), 0);
+
+  DenseSnapshot *last = table->pull_dense_snapshot();
+  ASSERT_FLOAT_EQ(last->data()[fea_dim - 1], 200.0);
+  last->Unref();
+  delete table;
+}
+
 }  // namespace distributed
 }  // namespace paddle
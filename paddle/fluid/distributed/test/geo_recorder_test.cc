@@ -0,0 +1,103 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <ThreadPool.h>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/table/depends/geo_recorder.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(GeoRecorder, PerTrainerCursors) {
+  GeoRecorder recorder(2);
+  recorder.Update({3, 1, 2});
+  recorder.Update({2, 5});
+
+  std::vector<uint64_t> rows;
+  recorder.GetAndClear(0, &rows);
+  ASSERT_EQ(rows, std::vector<uint64_t>({1, 2, 3, 5}));
+  recorder.GetAndClear(0, &rows);
+  ASSERT_TRUE(rows.empty());
+
+  recorder.Update({7, 1});
+  recorder.GetAndClear(0, &rows);
+  ASSERT_EQ(rows, std::vector<uint64_t>({1, 7}));
+
+  // trainer 1 has not read yet, it sees all updates
+  recorder.GetAndClear(1, &rows);
+  ASSERT_EQ(rows, std::vector<uint64_t>({1, 2, 3, 5, 7}));
+
+  // both cursors passed all segments
+  ASSERT_EQ(recorder.LogSize(), 0UL);
+}
+
+TEST(GeoRecorder, CompactSlowTrainer) {
+  const int trainers = 4;
+  GeoRecorder recorder(trainers);
+  std::vector<std::set<uint64_t>> expected(trainers);
+
+  // trainer 3 never reads, the others read after every tenth push
+  for (uint64_t step = 0; step < 1000; ++step) {
+    std::vector<uint64_t> rows = {step % 50, step % 7 + 100};
+    recorder.Update(rows);
+    for (int t = 0; t < trainers; ++t) {
+      expected[t].insert(rows.begin(), rows.end());
+    }
+    if (step % 10 == 9) {
+      for (int t = 0; t < trainers - 1; ++t) {
+        std::vector<uint64_t> got;
+        recorder.GetAndClear(t, &got);
+        ASSERT_EQ(got, std::vector<uint64_t>(expected[t].begin(),
+                                             expected[t].end()));
+        expected[t].clear();
+      }
+    }
+  }
+  ASSERT_LE(recorder.LogSize(), static_cast<size_t>(2 * trainers + 64));
+
+  std::vector<uint64_t> got;
+  recorder.GetAndClear(trainers - 1, &got);
+  ASSERT_EQ(got, std::vector<uint64_t>(expected[trainers - 1].begin(),
+                                       expected[trainers - 1].end()));
+  ASSERT_EQ(recorder.LogSize(), 0UL);
+}
+
+TEST(GeoRecorder, ConcurrentUpdate) {
+  const int trainers = 3;
+  const int pushers = 4;
+  GeoRecorder recorder(trainers);
+  ::ThreadPool pool(pushers);
+  std::vector<std::future<void>> tasks;
+  for (int p = 0; p < pushers; ++p) {
+    tasks.push_back(pool.enqueue([&recorder, p] {
+      for (uint64_t i = 0; i < 100; ++i) {
+        recorder.Update({p * 100 + i});
+      }
+    }));
+  }
+  for (auto& task : tasks) {
+    task.wait();
+  }
+  for (int t = 0; t < trainers; ++t) {
+    std::vector<uint64_t> rows;
+    recorder.GetAndClear(t, &rows);
+    ASSERT_EQ(rows.size(), static_cast<size_t>(pushers * 100));
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
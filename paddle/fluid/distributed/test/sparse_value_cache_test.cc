@@ -0,0 +1,106 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/service/sparse_value_cache.h"
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+
+// Plays the pserver: fills the misses with key + version and inserts them.
+size_t Pull(SparseValueCache* cache, const std::vector<uint64_t>& keys,
+            std::vector<float>* values, int dim, float version) {
+  values->assign(keys.size() * dim, -1);
+  std::vector<float*> ptrs;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ptrs.push_back(values->data() + i * dim);
+  }
+  std::vector<uint64_t> miss_keys;
+  std::vector<float*> miss_values;
+  cache->Lookup(keys.data(), ptrs.data(), keys.size(), &miss_keys,
+                &miss_values);
+  for (size_t i = 0; i < miss_keys.size(); ++i) {
+    for (int d = 0; d < dim; ++d) {
+      miss_values[i][d] = miss_keys[i] + version;
+    }
+  }
+  cache->Insert(miss_keys.data(), miss_values.data(), miss_keys.size());
+  return miss_keys.size();
+}
+
+}  // namespace
+
+TEST(SparseValueCache, HitAndStaleness) {
+  const int dim = 4;
+  SparseValueCache cache(16, dim, 2, 0);
+  std::vector<float> values;
+
+  ASSERT_EQ(Pull(&cache, {1, 2, 3}, &values, dim, 0.5), 3UL);
+  // served from the cache for two more steps
+  ASSERT_EQ(Pull(&cache, {1, 2, 3}, &values, dim, 10.5), 0UL);
+  ASSERT_EQ(Pull(&cache, {2, 1, 4}, &values, dim, 20.5), 1UL);
+  ASSERT_FLOAT_EQ(values[0], 2.5);
+  ASSERT_FLOAT_EQ(values[dim], 1.5);
+  ASSERT_FLOAT_EQ(values[2 * dim], 24.5);
+  // rows 1, 2 and 3 are expired now
+  ASSERT_EQ(Pull(&cache, {1, 2, 3, 4}, &values, dim, 30.5), 3UL);
+  ASSERT_FLOAT_EQ(values[0], 31.5);
+  ASSERT_FLOAT_EQ(values[3 * dim], 24.5);
+
+  auto stat = cache.GetStat();
+  ASSERT_EQ(stat.lookups, 13UL);
+  ASSERT_EQ(stat.hits, 6UL);
+  ASSERT_EQ(stat.misses, 7UL);
+  ASSERT_EQ(stat.expired, 3UL);
+  ASSERT_EQ(stat.saved_bytes, 6 * (sizeof(uint64_t) + dim * sizeof(float)));
+}
+
+TEST(SparseValueCache, FrequencyAdmission) {
+  const int dim = 2;
+  const size_t capacity = 8;
+  SparseValueCache cache(capacity, dim, 0, 0);
+  std::vector<float> values;
+
+  std::vector<uint64_t> hot;
+  for (uint64_t key = 0; key < capacity; ++key) {
+    hot.push_back(key);
+  }
+  for (int step = 0; step < 10; ++step) {
+    Pull(&cache, hot, &values, dim, 0);
+  }
+  ASSERT_EQ(cache.Size(), capacity);
+
+  // a scan of one-off keys must not flush the hot rows
+  for (uint64_t key = 1000; key < 1100; ++key) {
+    Pull(&cache, {key}, &values, dim, 0);
+  }
+  ASSERT_EQ(Pull(&cache, hot, &values, dim, 0), 0UL);
+  ASSERT_EQ(cache.GetStat().rejections, 100UL);
+  ASSERT_EQ(cache.GetStat().evictions, 0UL);
+
+  // a key which becomes hot replaces the least recently used row
+  for (int step = 0; step < 20; ++step) {
+    Pull(&cache, {2000}, &values, dim, 0);
+  }
+  ASSERT_EQ(Pull(&cache, {2000}, &values, dim, 0), 0UL);
+  ASSERT_EQ(cache.GetStat().evictions, 1UL);
+  ASSERT_EQ(cache.Size(), capacity);
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,359 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/async_checkpointer.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+#include <utility>
+
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/platform/port.h"
+#include "paddle/fluid/platform/timer.h"
+
+DECLARE_bool(async_save_fsync);
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+// the size of the pieces of a file written by different threads
+constexpr size_t kChunkBytes = 16UL << 20;
+constexpr size_t kMaxWriteThreads = 4;
+// saves wait when this many writes are queued, to bound the host memory
+// held by the staging buffers
+constexpr size_t kMaxPendingJobs = 2;
+
+// Runs fn(i) for every i in [0, n) on up to kMaxWriteThreads threads and
+// rethrows the first error.
+template <typename Fn>
+void ParallelFor(size_t n, Fn fn) {
+  size_t num_threads = std::min<size_t>(
+      {kMaxWriteThreads,
+       std::max<size_t>(std::thread::hardware_concurrency(), 1), n});
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < n; ++i) fn(i);
+    return;
+  }
+
+  std::atomic<size_t> next{0};
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  auto worker = [&] {
+    for (size_t i = next++; i < n; i = next++) {
+      try {
+        fn(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (error) std::rethrow_exception(error);
+}
+
+// Writes buffers[i] at offsets[i] of a new file at path.
+void WriteFile(const std::string &path, const std::vector<std::string> &buffers,
+               const std::vector<size_t> &offsets, bool sync) {
+#if !defined(_WIN32)
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  PADDLE_ENFORCE_GE(fd, 0, platform::errors::Unavailable(
+                               "Cannot open %s to save variables, %s.", path,
+                               std::strerror(errno)));
+  // (buffer index, begin in the buffer, length)
+  std::vector<std::tuple<size_t, size_t, size_t>> chunks;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    for (size_t begin = 0; begin < buffers[i].size(); begin += kChunkBytes) {
+      chunks.emplace_back(
+          i, begin, std::min(kChunkBytes, buffers[i].size() - begin));
+    }
+  }
+  try {
+    ParallelFor(chunks.size(), [&](size_t i) {
+      size_t buffer, begin, length;
+      std::tie(buffer, begin, length) = chunks[i];
+      const char *data = buffers[buffer].data() + begin;
+      off_t offset = static_cast<off_t>(offsets[buffer] + begin);
+      while (length > 0) {
+        ssize_t written = pwrite(fd, data, length, offset);
+        if (written < 0 && errno == EINTR) continue;
+        PADDLE_ENFORCE_GT(written, 0, platform::errors::Unavailable(
+                                          "Failed to write %s, %s.", path,
+                                          std::strerror(errno)));
+        data += written;
+        offset += written;
+        length -= written;
+      }
+    });
+    if (sync) {
+      PADDLE_ENFORCE_EQ(fsync(fd), 0, platform::errors::Unavailable(
+                                          "Failed to sync %s to disk, %s.",
+                                          path, std::strerror(errno)));
+    }
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  PADDLE_ENFORCE_EQ(close(fd), 0,
+                    platform::errors::Unavailable("Failed to close %s, %s.",
+                                                  path, std::strerror(errno)));
+#else
+  // the buffers are laid out back to back, write them in order
+  std::ofstream fout(path, std::ios::binary);
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(fout), true,
+      platform::errors::Unavailable("Cannot open %s to save variables.", path));
+  for (auto &buffer : buffers) {
+    fout.write(buffer.data(), buffer.size());
+  }
+  fout.close();
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fout), true,
+                    platform::errors::Unavailable("Failed to write %s.", path));
+#endif
+}
+
+// Replaces path by the complete file tmp_path.
+void Publish(const std::string &tmp_path, const std::string &path) {
+#if defined(_WIN32)
+  std::remove(path.c_str());
+#endif
+  PADDLE_ENFORCE_EQ(std::rename(tmp_path.c_str(), path.c_str()), 0,
+                    platform::errors::Unavailable(
+                        "Failed to rename %s to %s.", tmp_path, path));
+}
+
+}  // namespace
+
+AsyncCheckpointer &AsyncCheckpointer::Instance() {
+  static AsyncCheckpointer instance;
+  return instance;
+}
+
+AsyncCheckpointer::AsyncCheckpointer() : writer_([this] { WriterLoop(); }) {}
+
+AsyncCheckpointer::~AsyncCheckpointer() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  // the queued checkpoints are still written
+  writer_.join();
+  for (auto &file_error : errors_) {
+    try {
+      std::rethrow_exception(file_error.second);
+    } catch (std::exception &e) {
+      LOG(ERROR) << "Failed to save " << file_error.first
+                 << " asynchronously, the error was never reported: "
+                 << e.what();
+    } catch (...) {
+      LOG(ERROR) << "Failed to save " << file_error.first
+                 << " asynchronously, the error was never reported.";
+    }
+  }
+}
+
+void AsyncCheckpointer::SaveCombine(
+    const std::string &file_path, const std::vector<std::string> &names,
+    const std::vector<const LoDTensor *> &tensors,
+    const platform::DeviceContext &dev_ctx) {
+  PADDLE_ENFORCE_EQ(names.size(), tensors.size(),
+                    platform::errors::InvalidArgument(
+                        "The number of names (%d) and tensors (%d) to save "
+                        "should be equal.",
+                        names.size(), tensors.size()));
+  std::unique_ptr<Job> job(new Job);
+  job->file_path = file_path;
+  job->names = names;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] {
+      if (writing_ == file_path || jobs_.size() >= kMaxPendingJobs) {
+        return false;
+      }
+      for (auto &pending : jobs_) {
+        if (pending->file_path == file_path) return false;
+      }
+      return true;
+    });
+    // report the failures of earlier writes as soon as possible, the
+    // waiters of the other files may never come
+    RethrowError("");
+    size_t num_reused = std::min(tensors.size(), staging_pool_.size());
+    job->tensors.assign(
+        std::make_move_iterator(staging_pool_.end() - num_reused),
+        std::make_move_iterator(staging_pool_.end()));
+    staging_pool_.resize(staging_pool_.size() - num_reused);
+  }
+
+  platform::Timer timer;
+  timer.Start();
+  job->tensors.resize(tensors.size());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    // reuses the memory of the staging tensor when it is large enough
+    TensorCopy(*tensors[i], platform::CPUPlace(), dev_ctx, &job->tensors[i]);
+    job->tensors[i].set_lod(tensors[i]->lod());
+  }
+  dev_ctx.Wait();
+  VLOG(3) << "Snapshot " << tensors.size() << " variables for " << file_path
+          << " in " << timer.ElapsedMS() << "ms";
+
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    jobs_.emplace_back(std::move(job));
+  }
+  cv_.notify_all();
+}
+
+void AsyncCheckpointer::Wait(const std::string &file_path) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&] {
+    if (file_path.empty()) {
+      return writing_.empty() && jobs_.empty();
+    }
+    if (writing_ == file_path) return false;
+    for (auto &pending : jobs_) {
+      if (pending->file_path == file_path) return false;
+    }
+    return true;
+  });
+  RethrowError(file_path);
+}
+
+void AsyncCheckpointer::RethrowError(const std::string &file_path) {
+  if (!file_path.empty()) {
+    auto it = errors_.find(file_path);
+    if (it == errors_.end()) return;
+    auto error = it->second;
+    errors_.erase(it);
+    std::rethrow_exception(error);
+  }
+
+  if (errors_.empty()) return;
+  if (errors_.size() == 1) {
+    auto error = errors_.begin()->second;
+    errors_.clear();
+    std::rethrow_exception(error);
+  }
+  std::ostringstream messages;
+  for (auto &file_error : errors_) {
+    messages << "\n" << file_error.first << ": ";
+    try {
+      std::rethrow_exception(file_error.second);
+    } catch (std::exception &e) {
+      messages << e.what();
+    } catch (...) {
+      messages << "unknown error";
+    }
+  }
+  size_t num_errors = errors_.size();
+  errors_.clear();
+  PADDLE_THROW(platform::errors::Unavailable(
+      "Failed to save %d files asynchronously:%s", num_errors,
+      messages.str()));
+}
+
+void AsyncCheckpointer::WriterLoop() {
+  while (true) {
+    std::unique_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+      if (jobs_.empty()) break;
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+      writing_ = job->file_path;
+    }
+
+    try {
+      Write(*job);
+    } catch (...) {
+      LOG(WARNING) << "Failed to save " << job->file_path << " asynchronously";
+      std::lock_guard<std::mutex> guard(mutex_);
+      errors_[job->file_path] = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      writing_.clear();
+      for (auto &tensor : job->tensors) {
+        staging_pool_.emplace_back(std::move(tensor));
+      }
+    }
+    cv_.notify_all();
+  }
+}
+
+void AsyncCheckpointer::Write(const Job &job) {
+  platform::Timer timer;
+  timer.Start();
+  auto &cpu_ctx =
+      *platform::DeviceContextPool::Instance().Get(platform::CPUPlace());
+  size_t num_vars = job.tensors.size();
+  std::vector<std::string> buffers(num_vars);
+  ParallelFor(num_vars, [&](size_t i) {
+    std::ostringstream os;
+    SerializeToStream(os, job.tensors[i], cpu_ctx);
+    buffers[i] = os.str();
+  });
+
+  std::vector<size_t> offsets(num_vars);
+  size_t total_bytes = 0;
+  for (size_t i = 0; i < num_vars; ++i) {
+    offsets[i] = total_bytes;
+    total_bytes += buffers[i].size();
+  }
+
+  auto &path = job.file_path;
+  MkDirRecursively(DirName(path).c_str());
+  WriteFile(path + ".tmp", buffers, offsets, FLAGS_async_save_fsync);
+  Publish(path + ".tmp", path);
+
+  std::ostringstream manifest;
+  manifest << "file_path " << path << "\n";
+  manifest << "bytes " << total_bytes << "\n";
+  manifest << "vars " << num_vars << "\n";
+  for (size_t i = 0; i < num_vars; ++i) {
+    manifest << job.names[i] << " " << offsets[i] << " " << buffers[i].size()
+             << "\n";
+  }
+  WriteFile(path + ".manifest.tmp", {manifest.str()}, {0},
+            FLAGS_async_save_fsync);
+  Publish(path + ".manifest.tmp", path + ".manifest");
+
+  VLOG(3) << "Saved " << num_vars << " variables of " << total_bytes
+          << " bytes to " << path << " in " << timer.ElapsedMS() << "ms";
+}
+
+}  // namespace framework
+}  // namespace paddle
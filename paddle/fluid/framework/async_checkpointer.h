@@ -0,0 +1,93 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/platform/device_context.h"
+
+namespace paddle {
+namespace framework {
+
+// AsyncCheckpointer writes the files of save_combine in the background, so
+// that training only stalls for copying the tensors to host memory instead
+// of for the whole write.
+//
+// A file is written in the format of save_combine to "<file>.tmp" by
+// several threads in parallel, optionally synced to disk, and renamed to
+// its final name when complete. A manifest "<file>.manifest" listing the
+// offset and size of every variable is published the same way afterwards,
+// so a reader never sees a partially written checkpoint.
+class AsyncCheckpointer {
+ public:
+  static AsyncCheckpointer &Instance();
+
+  ~AsyncCheckpointer();
+
+  // Copies the tensors into host staging buffers and returns. A save to a
+  // file whose previous write is still pending waits for it first, and so
+  // does a save while too many writes are queued. Rethrows the errors of the
+  // earlier failed writes of any file, without saving.
+  void SaveCombine(const std::string &file_path,
+                   const std::vector<std::string> &names,
+                   const std::vector<const LoDTensor *> &tensors,
+                   const platform::DeviceContext &dev_ctx);
+
+  // Waits for the pending write of file_path, or of all files when it is
+  // empty, and rethrows the error of a failed write of file_path, or of all
+  // the failed writes when it is empty.
+  void Wait(const std::string &file_path = "");
+
+ private:
+  struct Job {
+    std::string file_path;
+    std::vector<std::string> names;
+    std::vector<LoDTensor> tensors;
+  };
+
+  AsyncCheckpointer();
+
+  void WriterLoop();
+  void Write(const Job &job);
+  // Rethrows and forgets the errors of file_path, or of all files when it is
+  // empty. Must be called with mutex_ held.
+  void RethrowError(const std::string &file_path);
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<Job>> jobs_;
+  // the file being written by the writer thread
+  std::string writing_;
+  // the host tensors of the finished writes, reused by the next snapshots
+  std::vector<LoDTensor> staging_pool_;
+  // the errors of the failed writes not reported yet, by file
+  std::map<std::string, std::exception_ptr> errors_;
+  bool stop_{false};
+  std::thread writer_;
+
+  DISABLE_COPY_AND_ASSIGN(AsyncCheckpointer);
+};
+
+}  // namespace framework
+}  // namespace paddle
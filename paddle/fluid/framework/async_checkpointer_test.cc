@@ -0,0 +1,173 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/async_checkpointer.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/platform/port.h"
+#include "paddle/fluid/platform/timer.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+void FillTensor(LoDTensor *tensor, int64_t numel, float value) {
+  float *data = tensor->mutable_data<float>({numel}, platform::CPUPlace());
+  for (int64_t i = 0; i < numel; ++i) {
+    data[i] = value + i;
+  }
+}
+
+std::vector<LoDTensor> LoadCombined(const std::string &path, size_t num) {
+  auto &dev_ctx =
+      *platform::DeviceContextPool::Instance().Get(platform::CPUPlace());
+  std::ifstream fin(path, std::ios::binary);
+  std::vector<LoDTensor> tensors(num);
+  for (auto &tensor : tensors) {
+    DeserializeFromStream(fin, &tensor, dev_ctx);
+  }
+  return tensors;
+}
+
+}  // namespace
+
+TEST(AsyncCheckpointer, SnapshotAndPublish) {
+  auto &dev_ctx =
+      *platform::DeviceContextPool::Instance().Get(platform::CPUPlace());
+  std::string path = "async_checkpointer_test/snapshot/params";
+  LoDTensor a, b;
+  FillTensor(&a, 100, 1);
+  FillTensor(&b, 10, 1000);
+  b.set_lod({{0, 4, 10}});
+
+  auto &checkpointer = AsyncCheckpointer::Instance();
+  checkpointer.SaveCombine(path, {"a", "b"}, {&a, &b}, dev_ctx);
+  // training updates the parameters while the file is written
+  FillTensor(&a, 100, -1);
+  checkpointer.Wait(path);
+
+  EXPECT_FALSE(FileExists(path + ".tmp"));
+  auto loaded = LoadCombined(path, 2);
+  EXPECT_EQ(loaded[0].numel(), 100);
+  EXPECT_EQ(loaded[0].data<float>()[10], 11);
+  EXPECT_EQ(loaded[1].lod(), b.lod());
+  EXPECT_EQ(loaded[1].data<float>()[9], 1009);
+
+  std::ifstream manifest(path + ".manifest");
+  std::string key, name;
+  size_t value, offset, bytes;
+  manifest >> key >> name;
+  EXPECT_EQ(name, path);
+  manifest >> key >> value >> key >> value;
+  EXPECT_EQ(value, 2UL);
+  manifest >> name >> offset >> bytes;
+  EXPECT_EQ(name, "a");
+  EXPECT_EQ(offset, 0UL);
+  manifest >> name >> offset >> bytes;
+  EXPECT_EQ(name, "b");
+  EXPECT_GT(offset, 0UL);
+
+  // the next save of the same file waits for the first one
+  checkpointer.SaveCombine(path, {"a", "b"}, {&a, &b}, dev_ctx);
+  checkpointer.SaveCombine(path, {"b", "a"}, {&b, &a}, dev_ctx);
+  checkpointer.Wait();
+  loaded = LoadCombined(path, 2);
+  EXPECT_EQ(loaded[1].data<float>()[10], -1 + 10);
+}
+
+TEST(AsyncCheckpointer, ReportWriteError) {
+  auto &dev_ctx =
+      *platform::DeviceContextPool::Instance().Get(platform::CPUPlace());
+  std::string dir = "async_checkpointer_test/error";
+  MkDirRecursively(dir.c_str());
+  // a regular file where the directory of the checkpoint should be
+  std::ofstream(dir + "/file") << "not a directory";
+  LoDTensor a;
+  FillTensor(&a, 10, 0);
+
+  auto &checkpointer = AsyncCheckpointer::Instance();
+  checkpointer.SaveCombine(dir + "/file/params", {"a"}, {&a}, dev_ctx);
+  EXPECT_ANY_THROW(checkpointer.Wait());
+  // the error is only reported once
+  checkpointer.Wait();
+
+  // the next save of any file reports the error, the writes run in order,
+  // so the failed one is done once the save queued after it is
+  std::string failed = dir + "/file/failed";
+  std::string saved = dir + "/saved";
+  checkpointer.SaveCombine(failed, {"a"}, {&a}, dev_ctx);
+  int num_saves = 0;
+  bool reported = false;
+  while (!reported && num_saves < 2) {
+    try {
+      ++num_saves;
+      checkpointer.SaveCombine(saved, {"a"}, {&a}, dev_ctx);
+      // only reports the errors of saved
+      checkpointer.Wait(saved);
+    } catch (...) {
+      reported = true;
+    }
+  }
+  EXPECT_TRUE(reported);
+  checkpointer.Wait();
+  checkpointer.Wait(failed);
+
+  // and so does the wait for all files, whichever comes first
+  reported = false;
+  try {
+    checkpointer.SaveCombine(failed, {"a"}, {&a}, dev_ctx);
+    checkpointer.SaveCombine(dir + "/file/failed_too", {"a"}, {&a}, dev_ctx);
+    checkpointer.Wait();
+  } catch (...) {
+    reported = true;
+  }
+  EXPECT_TRUE(reported);
+  checkpointer.Wait();
+  checkpointer.Wait(failed);
+}
+
+TEST(AsyncCheckpointer, TrainingContinuesDuringWrite) {
+  auto &dev_ctx =
+      *platform::DeviceContextPool::Instance().Get(platform::CPUPlace());
+  std::string path = "async_checkpointer_test/large/params";
+  std::vector<LoDTensor> tensors(8);
+  std::vector<const LoDTensor *> inputs;
+  std::vector<std::string> names;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    FillTensor(&tensors[i], 4 << 20, i);
+    inputs.push_back(&tensors[i]);
+    names.push_back("w" + std::to_string(i));
+  }
+
+  auto &checkpointer = AsyncCheckpointer::Instance();
+  platform::Timer timer;
+  timer.Start();
+  checkpointer.SaveCombine(path, names, inputs, dev_ctx);
+  double stall_ms = timer.ElapsedMS();
+  checkpointer.Wait(path);
+  double total_ms = timer.ElapsedMS();
+  LOG(INFO) << "Save 128MB, training stalled " << stall_ms
+            << "ms, the write took " << total_ms << "ms";
+
+  auto loaded = LoadCombined(path, tensors.size());
+  EXPECT_EQ(loaded[7].data<float>()[5], 7 + 5);
+}
+
+}  // namespace framework
+}  // namespace paddle
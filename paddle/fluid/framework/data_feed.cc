@@ -25,6 +25,7 @@ limitations under the License. */
 #endif
 #include "io/fs.h"
 #include "paddle/fluid/platform/monitor.h"
+#include "paddle/fluid/platform/profiler.h"
 #include "paddle/fluid/platform/timer.h"
 
 USE_INT_STAT(STAT_total_feasign_num_in_mem);
@@ -190,6 +191,9 @@ void PrivateQueueDataFeed<T>::ReadThread() {
     int err_no = 0;
     fp_ = fs_open_read(filename, &err_no, pipe_command_);
     __fsetlocking(&*fp_, FSETLOCKING_BYCALLER);
+    platform::RecordEvent record_event("DataFeed::ReadFile",
+                                       platform::EventRole::kOrdinary,
+                                       platform::TraceCategory::kDataFeed);
     T instance;
     while (ParseOneInstanceFromPipe(&instance)) {
       queue_->Put(instance);
@@ -203,6 +207,9 @@ template <typename T>
 int PrivateQueueDataFeed<T>::Next() {
 #ifdef _LINUX
   CheckStart();
+  platform::RecordEvent record_event("DataFeed::Next",
+                                     platform::EventRole::kOrdinary,
+                                     platform::TraceCategory::kDataFeed);
   int index = 0;
   T ins_vec;
   while (index < default_batch_size_) {
@@ -214,6 +221,9 @@ int PrivateQueueDataFeed<T>::Next() {
   }
   batch_size_ = index;
   if (batch_size_ != 0) {
+    platform::RecordEvent record_event("DataFeed::PutToFeedVec",
+                                       platform::EventRole::kOrdinary,
+                                       platform::TraceCategory::kDataFeed);
     PutToFeedVec(ins_vec);
   }
   return batch_size_;
@@ -262,6 +272,9 @@ int InMemoryDataFeed<T>::Next() {
   this->CheckStart();
   CHECK(output_channel_ != nullptr);
   CHECK(consume_channel_ != nullptr);
+  platform::RecordEvent record_event("DataFeed::Next",
+                                     platform::EventRole::kOrdinary,
+                                     platform::TraceCategory::kDataFeed);
   VLOG(3) << "output_channel_ size=" << output_channel_->Size()
           << ", consume_channel_ size=" << consume_channel_->Size()
           << ", thread_id=" << thread_id_;
@@ -282,6 +295,9 @@ int InMemoryDataFeed<T>::Next() {
   VLOG(3) << "batch_size_=" << this->batch_size_
           << ", thread_id=" << thread_id_;
   if (this->batch_size_ != 0) {
+    platform::RecordEvent record_event("DataFeed::PutToFeedVec",
+                                       platform::EventRole::kOrdinary,
+                                       platform::TraceCategory::kDataFeed);
     PutToFeedVec(ins_vec);
   } else {
     VLOG(3) << "finish reading, output_channel_ size="
@@ -385,6 +401,9 @@ void InMemoryDataFeed<T>::LoadIntoMemory() {
     CHECK(this->fp_ != nullptr);
     __fsetlocking(&*(this->fp_), FSETLOCKING_BYCALLER);
     paddle::framework::ChannelWriter<T> writer(input_channel_);
+    platform::RecordEvent record_event("DataFeed::LoadFile",
+                                       platform::EventRole::kOrdinary,
+                                       platform::TraceCategory::kDataFeed);
     T instance;
     platform::Timer timeline;
     timeline.Start();
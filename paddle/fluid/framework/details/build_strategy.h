@@ -100,6 +100,10 @@ struct BuildStrategy {
   // while running.
   bool cache_runtime_context_{false};
 
+  // Merge the identical forward ops, see redundant_op_elimination_pass.
+  // The outputs of the removed ops cannot be fetched anymore.
+  bool eliminate_redundant_ops_{false};
+
   // Operator fusion
   // TODO(dev-paddle): fuse_elewise_add_act_ops may cause some models have
   // cycle.
@@ -0,0 +1,148 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/details/critical_path.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+#include "paddle/fluid/framework/details/op_handle_base.h"
+#include "paddle/fluid/framework/details/var_handle.h"
+#include "paddle/fluid/framework/ir/graph_helper.h"
+#include "paddle/fluid/platform/profiler.h"
+
+namespace paddle {
+namespace framework {
+namespace details {
+
+namespace {
+// the cost of an op neither timed nor profiled
+constexpr double kDefaultCostMs = 1.0;
+// weight of the latest run in the recorded cost of an op
+constexpr double kCostDecay = 0.2;
+}  // namespace
+
+constexpr size_t CriticalPathPriority::kUpdateInterval;
+
+std::unordered_map<std::string, double> ProfiledOpCostsMs() {
+  std::unordered_map<std::string, double> costs;
+  if (!platform::IsProfileEnabled()) return costs;
+
+  std::unordered_map<std::string, size_t> counts;
+  for (auto &thread_events : platform::GetAllEvents()) {
+    // the ranges of a thread are nested, a pop closes the latest push
+    std::vector<const platform::Event *> pushed;
+    for (auto &event : thread_events) {
+      if (event.type() == platform::EventType::kPushRange) {
+        pushed.push_back(&event);
+      } else if (event.type() == platform::EventType::kPopRange &&
+                 !pushed.empty()) {
+        const platform::Event *push = pushed.back();
+        pushed.pop_back();
+        costs[push->name()] += push->CpuElapsedMs(event);
+        ++counts[push->name()];
+      }
+    }
+  }
+  for (auto &pair : costs) {
+    pair.second /= counts[pair.first];
+  }
+  return costs;
+}
+
+CriticalPathPriority::CriticalPathPriority(const ir::Graph &graph) {
+  auto all_ops = ir::FilterByNodeWrapper<OpHandleBase>(graph);
+  ops_.reserve(all_ops.size());
+
+  // iterative post-order DFS along the consumers, so that every op is
+  // appended after all the ops depending on it
+  std::unordered_set<OpHandleBase *> visited;
+  std::vector<std::pair<OpHandleBase *, std::vector<OpHandleBase *>>> stack;
+  auto consumers = [](OpHandleBase *op) {
+    std::vector<OpHandleBase *> result;
+    for (auto *out : op->Outputs()) {
+      for (auto *pending_op : out->PendingOps()) {
+        result.push_back(pending_op);
+      }
+    }
+    return result;
+  };
+  for (auto *root : all_ops) {
+    if (!visited.insert(root).second) continue;
+    stack.emplace_back(root, consumers(root));
+    while (!stack.empty()) {
+      auto &top = stack.back();
+      if (top.second.empty()) {
+        ops_.push_back(top.first);
+        stack.pop_back();
+        continue;
+      }
+      OpHandleBase *next = top.second.back();
+      top.second.pop_back();
+      if (visited.insert(next).second) {
+        stack.emplace_back(next, consumers(next));
+      }
+    }
+  }
+
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    index_[ops_[i]] = i;
+  }
+  costs_.assign(ops_.size(), -1.0);
+  priorities_.assign(ops_.size(), 0.0);
+  Update();
+}
+
+void CriticalPathPriority::RecordCost(OpHandleBase *op, double ms) {
+  auto it = index_.find(op);
+  if (it == index_.end()) return;
+  double &cost = costs_[it->second];
+  cost = cost < 0 ? ms : (1 - kCostDecay) * cost + kCostDecay * ms;
+}
+
+void CriticalPathPriority::Update() {
+  auto profiled_costs = ProfiledOpCostsMs();
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    OpHandleBase *op = ops_[i];
+    double cost = costs_[i];
+    if (cost < 0) {
+      auto it = profiled_costs.find(op->Name());
+      cost = it != profiled_costs.end() ? it->second : kDefaultCostMs;
+    }
+    double longest_tail = 0;
+    for (auto *out : op->Outputs()) {
+      for (auto *pending_op : out->PendingOps()) {
+        auto it = index_.find(pending_op);
+        if (it != index_.end()) {
+          longest_tail = std::max(longest_tail, priorities_[it->second]);
+        }
+      }
+    }
+    priorities_[i] = cost + longest_tail;
+  }
+  VLOG(10) << "Update the critical path priorities of " << ops_.size()
+           << " ops";
+}
+
+void CriticalPathPriority::Sort(std::vector<OpHandleBase *> *ops) const {
+  std::stable_sort(ops->begin(), ops->end(),
+                   [this](OpHandleBase *a, OpHandleBase *b) {
+                     return Get(a) > Get(b);
+                   });
+}
+
+}  // namespace details
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,86 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+namespace ir {
+class Graph;
+}  // namespace ir
+
+namespace details {
+class OpHandleBase;
+
+// Returns the mean CPU time in ms of every event name recorded by the
+// profiler so far, empty when the profiler is disabled. The events of
+// operators are named after their type, like the op handles running them.
+std::unordered_map<std::string, double> ProfiledOpCostsMs();
+
+// CriticalPathPriority ranks the op handles of an SSA graph by the length
+// of the longest path from the op to the end of the graph, the op itself
+// included. Running the ops on long paths first keeps long chains, e.g. an
+// optimizer update feeding a send, from starting late behind short branches.
+//
+// The cost of an op is the time it took in the previous runs, as recorded
+// by the executor. Ops not timed yet use the cost the profiler recorded for
+// their type, or 1ms.
+class CriticalPathPriority {
+ public:
+  explicit CriticalPathPriority(const ir::Graph &graph);
+
+  // Only ops of the graph are recorded. Each op may be recorded by the
+  // thread running it, as long as Update is not called at the same time.
+  void RecordCost(OpHandleBase *op, double ms);
+
+  // Computes the priorities from the recorded costs.
+  void Update();
+
+  // Called by the executor before every run. Updates the priorities after
+  // the first run, which timed all ops, and then every kUpdateInterval runs.
+  void BeginRun() {
+    if (num_runs_++ % kUpdateInterval == 1) {
+      Update();
+    }
+  }
+
+  // The ops not in the graph, like the fetch ops, have the lowest priority.
+  double Get(OpHandleBase *op) const {
+    auto it = index_.find(op);
+    return it == index_.end() ? 0 : priorities_[it->second];
+  }
+
+  // Sorts ops by descending priority, ops of equal priority keep their
+  // order.
+  void Sort(std::vector<OpHandleBase *> *ops) const;
+
+ private:
+  static constexpr size_t kUpdateInterval = 100;
+
+  size_t num_runs_{0};
+  // in reverse topological order, each op comes after all its consumers
+  std::vector<OpHandleBase *> ops_;
+  std::unordered_map<OpHandleBase *, size_t> index_;
+  // negative when the op was not timed yet
+  std::vector<double> costs_;
+  std::vector<double> priorities_;
+};
+
+}  // namespace details
+}  // namespace framework
+}  // namespace paddle
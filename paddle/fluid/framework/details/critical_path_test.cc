@@ -0,0 +1,180 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/details/critical_path.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/details/op_handle_base.h"
+#include "paddle/fluid/framework/details/var_handle.h"
+#include "paddle/fluid/framework/ir/graph.h"
+#include "paddle/fluid/framework/program_desc.h"
+
+namespace paddle {
+namespace framework {
+namespace details {
+
+class DummyOpHandle : public OpHandleBase {
+ public:
+  DummyOpHandle(ir::Node *node, const std::string &name)
+      : OpHandleBase(node), name_(name) {}
+
+  std::string Name() const override { return name_; }
+
+ protected:
+  void RunImpl() override {}
+  std::vector<Scope *> GetLocalScopes() override { return {}; }
+
+ private:
+  std::string name_;
+};
+
+class CriticalPathTest : public ::testing::Test {
+ protected:
+  CriticalPathTest() : graph_(ProgramDesc()) {}
+
+  OpHandleBase *AddOp(const std::string &name) {
+    auto *node = graph_.CreateEmptyNode(name, ir::Node::Type::kOperation);
+    ops_.push_back(new DummyOpHandle(node, name));
+    return ops_.back();
+  }
+
+  void Connect(OpHandleBase *from, OpHandleBase *to) {
+    auto *node = graph_.CreateEmptyNode("dep", ir::Node::Type::kVariable);
+    auto *var = new DummyVarHandle(node);
+    from->AddOutput(var);
+    to->AddInput(var);
+  }
+
+  // Simulates running the graph with num_workers threads, which take the
+  // ready ops in the order of the ready list, sorted by priority if given.
+  // Returns the time all ops finished.
+  double Simulate(const std::unordered_map<OpHandleBase *, double> &costs,
+                  size_t num_workers, const CriticalPathPriority *priority) {
+    std::unordered_map<OpHandleBase *, size_t> deps;
+    std::vector<OpHandleBase *> ready;
+    for (auto *op : ops_) {
+      deps[op] = op->Inputs().size();
+      if (deps[op] == 0) ready.push_back(op);
+    }
+    // the ops running and the time they finish
+    std::vector<std::pair<double, OpHandleBase *>> running;
+    double now = 0;
+    while (!ready.empty() || !running.empty()) {
+      if (priority != nullptr) priority->Sort(&ready);
+      while (!ready.empty() && running.size() < num_workers) {
+        running.emplace_back(now + costs.at(ready.front()), ready.front());
+        ready.erase(ready.begin());
+      }
+      auto first = std::min_element(running.begin(), running.end());
+      now = first->first;
+      OpHandleBase *done = first->second;
+      running.erase(first);
+      for (auto *out : done->Outputs()) {
+        for (auto *pending_op : out->PendingOps()) {
+          if (--deps[pending_op] == 0) ready.push_back(pending_op);
+        }
+      }
+    }
+    return now;
+  }
+
+  ir::Graph graph_;
+  std::vector<OpHandleBase *> ops_;
+};
+
+TEST_F(CriticalPathTest, LongestPathToEnd) {
+  // a -> b -> c -> d
+  //  \-> e ------/
+  auto *a = AddOp("a");
+  auto *b = AddOp("b");
+  auto *c = AddOp("c");
+  auto *d = AddOp("d");
+  auto *e = AddOp("e");
+  Connect(a, b);
+  Connect(b, c);
+  Connect(c, d);
+  Connect(a, e);
+  Connect(e, d);
+
+  // without timings every op costs the same
+  CriticalPathPriority priority(graph_);
+  EXPECT_DOUBLE_EQ(priority.Get(d), 1);
+  EXPECT_DOUBLE_EQ(priority.Get(c), 2);
+  EXPECT_DOUBLE_EQ(priority.Get(e), 2);
+  EXPECT_DOUBLE_EQ(priority.Get(b), 3);
+  EXPECT_DOUBLE_EQ(priority.Get(a), 4);
+
+  priority.RecordCost(e, 10);
+  priority.Update();
+  EXPECT_DOUBLE_EQ(priority.Get(e), 11);
+  EXPECT_DOUBLE_EQ(priority.Get(b), 3);
+  EXPECT_DOUBLE_EQ(priority.Get(a), 12);
+
+  std::vector<OpHandleBase *> ready = {b, e};
+  priority.Sort(&ready);
+  EXPECT_EQ(ready[0], e);
+
+  // ops not in the graph come last
+  auto *fetch = new DummyOpHandle(
+      graph_.CreateEmptyNode("fetch", ir::Node::Type::kOperation), "fetch");
+  EXPECT_DOUBLE_EQ(priority.Get(fetch), 0);
+}
+
+TEST_F(CriticalPathTest, RecordedCostsDecay) {
+  auto *a = AddOp("a");
+  CriticalPathPriority priority(graph_);
+  priority.RecordCost(a, 10);
+  priority.Update();
+  EXPECT_DOUBLE_EQ(priority.Get(a), 10);
+  priority.RecordCost(a, 20);
+  priority.Update();
+  EXPECT_GT(priority.Get(a), 10);
+  EXPECT_LT(priority.Get(a), 20);
+}
+
+TEST_F(CriticalPathTest, ImbalancedBranches) {
+  // four short independent ops become ready before the head of a long
+  // chain, e.g. the optimizer updates of the next send
+  std::unordered_map<OpHandleBase *, double> costs;
+  for (int i = 0; i < 4; ++i) {
+    costs[AddOp("short")] = 5;
+  }
+  OpHandleBase *prev = nullptr;
+  for (int i = 0; i < 4; ++i) {
+    auto *op = AddOp("chain");
+    costs[op] = 5;
+    if (prev != nullptr) Connect(prev, op);
+    prev = op;
+  }
+
+  CriticalPathPriority priority(graph_);
+  for (auto &pair : costs) {
+    priority.RecordCost(pair.first, pair.second);
+  }
+  priority.Update();
+
+  double fifo_time = Simulate(costs, 2, nullptr);
+  double priority_time = Simulate(costs, 2, &priority);
+  EXPECT_DOUBLE_EQ(fifo_time, 30);
+  EXPECT_DOUBLE_EQ(priority_time, 20);
+}
+
+}  // namespace details
+}  // namespace framework
+}  // namespace paddle
@@ -13,11 +13,14 @@
 // limitations under the License.
 #include "paddle/fluid/framework/details/fast_threaded_ssa_graph_executor.h"
 
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
 #include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/framework/details/computation_op_handle.h"
@@ -26,10 +29,40 @@
 #include "paddle/fluid/framework/ir/graph_helper.h"
 #include "paddle/fluid/platform/profiler.h"
 
+DECLARE_bool(use_work_stealing_executor);
+DECLARE_bool(use_critical_path_priority);
+
 namespace paddle {
 namespace framework {
 namespace details {
 
+struct FastThreadedSSAGraphExecutor::RunState {
+  // the tasks not finished yet, plus one held by Run while bootstrapping
+  std::atomic<int> num_running{1};
+  std::atomic<size_t> num_complete{0};
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool finished{false};
+
+  void Retain() { num_running.fetch_add(1, std::memory_order_relaxed); }
+
+  // Only the last task to finish takes the lock to wake up Run, the others
+  // just decrement the counter.
+  void Release() {
+    if (num_running.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard<std::mutex> guard(mutex);
+      finished = true;
+      cv.notify_one();
+    }
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return finished; });
+  }
+};
+
 FastThreadedSSAGraphExecutor::FastThreadedSSAGraphExecutor(
     const ExecutionStrategy &strategy, const std::vector<Scope *> &local_scopes,
     const std::vector<Scope *> &local_exec_scopes,
@@ -40,9 +73,14 @@ FastThreadedSSAGraphExecutor::FastThreadedSSAGraphExecutor(
       places_(places),
       graph_(graph),
       fetch_ctxs_(places),
-      pool_(strategy.num_threads_),
       // add one more thread for generate op_deps
       prepare_pool_(1) {
+  if (FLAGS_use_work_stealing_executor) {
+    work_stealing_pool_.reset(
+        new WorkStealingThreadPool(strategy.num_threads_));
+  } else {
+    pool_.reset(new ::ThreadPool(strategy.num_threads_));
+  }
   for (auto &op : ir::FilterByNodeWrapper<OpHandleBase>(*graph_)) {
     int dep = static_cast<int>(op->NotReadyInputSize());
     op_deps_.emplace(op, dep);
@@ -53,6 +91,9 @@ FastThreadedSSAGraphExecutor::FastThreadedSSAGraphExecutor(
   PADDLE_ENFORCE_GT(op_deps_.size(), 0,
                     platform::errors::PreconditionNotMet(
                         "The graph doesn't have operators."));
+  if (FLAGS_use_critical_path_priority) {
+    priority_.reset(new CriticalPathPriority(*graph_));
+  }
   PrepareAtomicOpDeps();
 }
 
@@ -93,35 +134,25 @@ FetchResultType FastThreadedSSAGraphExecutor::Run(
     }
   } else {
     traced_ops_.clear();
-    remaining_ = 0;
-    auto complete_q = std::make_shared<BlockingQueue<size_t>>();
-    for (auto op : bootstrap_ops_) {
-      RunOpAsync(op_deps.get(), op, complete_q);
+    if (priority_) {
+      priority_->BeginRun();
+      priority_->Sort(&bootstrap_ops_);
     }
-    for (auto op : ready_fetch_ops) {
-      RunOpAsync(op_deps.get(), op, complete_q);
-    }
-
-    size_t num_complete = 0;
-    while (num_complete != op_deps->size()) {
-      size_t num_comp = complete_q->Pop();
-      if (num_comp == -1UL) {
-        int remaining = 0;
-        while (true) {
-          remaining = remaining_;
-          if (remaining == 0) {
-            break;
-          }
-          for (int i = 0; i < remaining; ++i) {
-            complete_q->Pop();
-          }
-        }
-        if (exception_.IsCaught()) {
-          ExecutionFinal(&fetch_ops);
-        }
-      }
-      num_complete += num_comp;
+    auto state = std::make_shared<RunState>();
+    RunOpsAsync(op_deps.get(), bootstrap_ops_, 0, state);
+    RunOpsAsync(op_deps.get(), ready_fetch_ops, 0, state);
+    // A task only finishes after scheduling the ops it made ready, so no
+    // task is running any more once the count drops to zero.
+    state->Release();
+    state->Wait();
+
+    if (exception_.IsCaught()) {
+      ExecutionFinal(&fetch_ops);
     }
+    PADDLE_ENFORCE_EQ(
+        state->num_complete.load(), op_deps->size(),
+        platform::errors::Fatal("Only %d of %d operators were run.",
+                                state->num_complete.load(), op_deps->size()));
   }
   // Wait FetchOps.
   ClearFetchOp(graph_, &fetch_ops);
@@ -200,9 +231,7 @@ void FastThreadedSSAGraphExecutor::InsertFetchOps(
   }
 }
 
-bool FastThreadedSSAGraphExecutor::RunOp(
-    OpHandleBase *op, const std::shared_ptr<BlockingQueue<size_t>> &complete_q,
-    size_t *complete) {
+bool FastThreadedSSAGraphExecutor::RunOp(OpHandleBase *op, size_t *complete) {
   RunOpSync(op);
   if (LIKELY(!exception_.IsCaught())) {
     if (LIKELY(!strategy_.dry_run_)) {
@@ -211,20 +240,18 @@ bool FastThreadedSSAGraphExecutor::RunOp(
     ++(*complete);
     return true;
   } else {
-    --remaining_;
-    complete_q->Push(-1UL);
     return false;
   }
 }
 
 void FastThreadedSSAGraphExecutor::RunOpAsync(
     std::unordered_map<OpHandleBase *, std::atomic<int>> *op_deps,
-    OpHandleBase *op,
-    const std::shared_ptr<BlockingQueue<size_t>> &complete_q) {
-  ++remaining_;
-  this->pool_.enqueue([=] {
+    OpHandleBase *op, const std::shared_ptr<RunState> &state) {
+  state->Retain();
+  auto task = [=] {
     std::deque<OpHandleBase *> op_queue;
     op_queue.push_front(op);
+    std::vector<OpHandleBase *> ready_ops;
 
     size_t complete = 0;
     while (!op_queue.empty()) {
@@ -244,16 +271,16 @@ void FastThreadedSSAGraphExecutor::RunOpAsync(
         while (!op_queue.empty()) {
           OpHandleBase *post_op = op_queue.back();
           op_queue.pop_back();
-          RunOpAsync(op_deps, post_op, complete_q);
+          RunOpAsync(op_deps, post_op, state);
         }
       }
 
-      if (!RunOp(op_to_run, complete_q, &complete)) {
-        return;
+      if (!RunOp(op_to_run, &complete)) {
+        break;
       }
 
       auto &outputs = op_to_run->Outputs();
-      op_to_run = nullptr;
+      ready_ops.clear();
       for (auto &output : outputs) {
         for (auto &pending_op : output->PendingOps()) {
           std::atomic<int> &deps = op_deps->at(pending_op);
@@ -267,22 +294,45 @@ void FastThreadedSSAGraphExecutor::RunOpAsync(
             // multi device ops should be scheduled prior to computing ops
             op_queue.push_front(pending_op);
           } else {
-            if (op_to_run == nullptr) {
-              op_to_run = pending_op;
-            } else {
-              RunOpAsync(op_deps, pending_op, complete_q);
-            }
+            ready_ops.push_back(pending_op);
           }
         }
       }
 
-      if (op_to_run != nullptr) {
-        op_queue.push_front(op_to_run);
+      if (!ready_ops.empty()) {
+        if (priority_) {
+          priority_->Sort(&ready_ops);
+        }
+        // the first ready op continues on this thread, the others are
+        // scheduled
+        op_queue.push_front(ready_ops[0]);
+        RunOpsAsync(op_deps, ready_ops, 1, state);
       }
     }
-    --remaining_;
-    complete_q->Push(complete);
-  });
+    state->num_complete.fetch_add(complete, std::memory_order_relaxed);
+    state->Release();
+  };
+  if (work_stealing_pool_) {
+    work_stealing_pool_->Enqueue(std::move(task));
+  } else {
+    pool_->enqueue(std::move(task));
+  }
+}
+
+void FastThreadedSSAGraphExecutor::RunOpsAsync(
+    std::unordered_map<OpHandleBase *, std::atomic<int>> *op_deps,
+    const std::vector<OpHandleBase *> &ops, size_t begin,
+    const std::shared_ptr<RunState> &state) {
+  if (work_stealing_pool_) {
+    // a worker pops the latest task of its own deque first
+    for (size_t i = ops.size(); i > begin; --i) {
+      RunOpAsync(op_deps, ops[i - 1], state);
+    }
+  } else {
+    for (size_t i = begin; i < ops.size(); ++i) {
+      RunOpAsync(op_deps, ops[i], state);
+    }
+  }
 }
 
 void FastThreadedSSAGraphExecutor::PrepareAtomicOpDeps() {
@@ -330,7 +380,15 @@ bool FastThreadedSSAGraphExecutor::RunOpSync(OpHandleBase *op) {
   try {
     VLOG(10) << op << " " << op->Name() << " : " << op->DebugString();
     if (LIKELY(!strategy_.dry_run_)) {
-      op->Run(strategy_.use_device_);
+      if (priority_) {
+        auto start = std::chrono::steady_clock::now();
+        op->Run(strategy_.use_device_);
+        priority_->RecordCost(op, std::chrono::duration<double, std::milli>(
+                                      std::chrono::steady_clock::now() - start)
+                                      .count());
+      } else {
+        op->Run(strategy_.use_device_);
+      }
     }
     VLOG(10) << op << " " << op->Name() << " Done ";
     return true;
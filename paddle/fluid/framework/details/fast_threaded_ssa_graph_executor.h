@@ -18,10 +18,11 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
-#include "paddle/fluid/framework/blocking_queue.h"
+#include "paddle/fluid/framework/details/critical_path.h"
 #include "paddle/fluid/framework/details/exception_holder.h"
 #include "paddle/fluid/framework/details/execution_strategy.h"
 #include "paddle/fluid/framework/details/ssa_graph_executor.h"
+#include "paddle/fluid/framework/details/work_stealing_thread_pool.h"
 
 namespace paddle {
 namespace framework {
@@ -51,27 +52,37 @@ class FastThreadedSSAGraphExecutor : public SSAGraphExecutor {
 
   std::unordered_map<OpHandleBase *, int> op_deps_;
   std::vector<OpHandleBase *> bootstrap_ops_;
+  // set when FLAGS_use_critical_path_priority is enabled
+  std::unique_ptr<CriticalPathPriority> priority_;
 
   platform::DeviceContextPool fetch_ctxs_;
-  std::atomic<int> remaining_;
 
   std::future<
       std::unique_ptr<std::unordered_map<OpHandleBase *, std::atomic<int>>>>
       atomic_op_deps_;
   ExceptionHolder exception_;
 
-  ::ThreadPool pool_;
+  // Only one of pool_ and work_stealing_pool_ is created, depending on
+  // FLAGS_use_work_stealing_executor.
+  std::unique_ptr<::ThreadPool> pool_;
+  std::unique_ptr<WorkStealingThreadPool> work_stealing_pool_;
   ::ThreadPool prepare_pool_;
 
   std::vector<OpHandleBase *> traced_ops_;
 
-  bool RunOp(OpHandleBase *op,
-             const std::shared_ptr<BlockingQueue<size_t>> &complete_q,
-             size_t *complete);
+  // Counts the ops completed in one run and the tasks still running.
+  struct RunState;
+
+  bool RunOp(OpHandleBase *op, size_t *complete);
 
   void RunOpAsync(std::unordered_map<OpHandleBase *, std::atomic<int>> *op_deps,
-                  OpHandleBase *op,
-                  const std::shared_ptr<BlockingQueue<size_t>> &complete_q);
+                  OpHandleBase *op, const std::shared_ptr<RunState> &state);
+
+  // Schedules ops[begin:] so that the pool picks them up in their order.
+  void RunOpsAsync(
+      std::unordered_map<OpHandleBase *, std::atomic<int>> *op_deps,
+      const std::vector<OpHandleBase *> &ops, size_t begin,
+      const std::shared_ptr<RunState> &state);
 
   void PrepareAtomicOpDeps();
 
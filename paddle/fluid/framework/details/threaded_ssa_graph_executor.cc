@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/framework/details/threaded_ssa_graph_executor.h"
 
+#include <chrono>  // NOLINT
+
 #include "paddle/fluid/framework/ir/graph_helper.h"
 #include "paddle/fluid/platform/profiler.h"
 
@@ -21,6 +23,8 @@
 #include "paddle/fluid/distributed/service/communicator.h"
 #endif
 
+DECLARE_bool(use_critical_path_priority);
+
 namespace paddle {
 namespace framework {
 namespace details {
@@ -49,6 +53,9 @@ ThreadedSSAGraphExecutor::ThreadedSSAGraphExecutor(
                       "should use pyreader to feed data!";
     }
   }
+  if (FLAGS_use_critical_path_priority) {
+    priority_.reset(new CriticalPathPriority(*graph_));
+  }
   PrepareOpDeps();
   CopyOpDeps();
 }
@@ -98,12 +105,25 @@ inline FetchResultType ThreadedSSAGraphExecutor::RunImpl(
     }
   } else {
     traced_ops_.clear();
+    std::vector<OpHandleBase *> sorted_ops;
     auto run_all_ops = [&](std::unordered_set<OpHandleBase *> &set) {
-      for (auto *op : set) {
-        RunOp(ready_vars, op);
+      if (priority_) {
+        // the pool runs the ops on the longest paths first
+        sorted_ops.assign(set.begin(), set.end());
+        priority_->Sort(&sorted_ops);
+        for (auto *op : sorted_ops) {
+          RunOp(ready_vars, op);
+        }
+      } else {
+        for (auto *op : set) {
+          RunOp(ready_vars, op);
+        }
       }
       set.clear();
     };
+    if (priority_) {
+      priority_->BeginRun();
+    }
     // Clean run context
     run_op_futures_.clear();
 
@@ -348,7 +368,15 @@ bool ThreadedSSAGraphExecutor::RunOpSync(OpHandleBase *op) {
   try {
     VLOG(10) << op << " " << op->Name() << " : " << op->DebugString();
     if (LIKELY(!strategy_.dry_run_)) {
-      op->Run(strategy_.use_device_);
+      if (priority_) {
+        auto start = std::chrono::steady_clock::now();
+        op->Run(strategy_.use_device_);
+        priority_->RecordCost(op, std::chrono::duration<double, std::milli>(
+                                      std::chrono::steady_clock::now() - start)
+                                      .count());
+      } else {
+        op->Run(strategy_.use_device_);
+      }
     }
     VLOG(10) << op << " " << op->Name() << " Done ";
     return true;
@@ -27,6 +27,7 @@
 #include <vector>
 
 #include "paddle/fluid/framework/blocking_queue.h"
+#include "paddle/fluid/framework/details/critical_path.h"
 #include "paddle/fluid/framework/details/exception_holder.h"
 #include "paddle/fluid/framework/details/execution_strategy.h"
 #include "paddle/fluid/framework/details/fetch_op_handle.h"
@@ -87,6 +88,8 @@ class ThreadedSSAGraphExecutor : public SSAGraphExecutor {
   ::ThreadPool prepare_pool_;
   std::unique_ptr<::ThreadPool> pool_;
   std::vector<OpHandleBase *> traced_ops_;
+  // set when FLAGS_use_critical_path_priority is enabled
+  std::unique_ptr<CriticalPathPriority> priority_;
 
   void InsertPendingOp(std::unordered_map<OpHandleBase *, size_t> *pending_ops,
                        OpHandleBase *op_instance) const;
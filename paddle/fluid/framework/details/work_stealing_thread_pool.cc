@@ -0,0 +1,131 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/details/work_stealing_thread_pool.h"
+
+#include <utility>
+
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace framework {
+namespace details {
+
+namespace {
+// the pool and the index of the worker the current thread belongs to
+thread_local WorkStealingThreadPool *t_pool = nullptr;
+thread_local size_t t_worker_id = 0;
+
+// rounds an idle worker tries to steal before going to sleep
+constexpr int kSpinRounds = 64;
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t num_threads) {
+  PADDLE_ENFORCE_GT(num_threads, 0,
+                    platform::errors::InvalidArgument(
+                        "The number of threads of WorkStealingThreadPool "
+                        "should be larger than 0, but received %d.",
+                        num_threads));
+  workers_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(new Worker);
+  }
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(sleep_mutex_);
+    stop_ = true;
+  }
+  sleep_cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkStealingThreadPool::Enqueue(Task task) {
+  size_t id = t_pool == this ? t_worker_id
+                             : next_worker_.fetch_add(1) % workers_.size();
+  // count the task before it becomes visible, so that pending_ never drops
+  // below the number of queued tasks
+  pending_.fetch_add(1);
+  {
+    std::lock_guard<std::mutex> guard(workers_[id]->mutex);
+    workers_[id]->tasks.emplace_back(std::move(task));
+  }
+  // pairs with the increment of num_sleeping_ before a worker checks
+  // pending_, one of both sides always sees the other
+  if (num_sleeping_.load() > 0) {
+    std::lock_guard<std::mutex> guard(sleep_mutex_);
+    sleep_cv_.notify_one();
+  }
+}
+
+bool WorkStealingThreadPool::PopLocal(size_t id, Task *task) {
+  auto &worker = *workers_[id];
+  std::lock_guard<std::mutex> guard(worker.mutex);
+  if (worker.tasks.empty()) return false;
+  *task = std::move(worker.tasks.back());
+  worker.tasks.pop_back();
+  pending_.fetch_sub(1);
+  return true;
+}
+
+bool WorkStealingThreadPool::Steal(size_t id, Task *task) {
+  size_t num_workers = workers_.size();
+  for (size_t i = 1; i < num_workers; ++i) {
+    auto &victim = *workers_[(id + i) % num_workers];
+    std::lock_guard<std::mutex> guard(victim.mutex);
+    if (victim.tasks.empty()) continue;
+    // steal the oldest task, the owner keeps the ones close to its cache
+    *task = std::move(victim.tasks.front());
+    victim.tasks.pop_front();
+    pending_.fetch_sub(1);
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::WorkerLoop(size_t id) {
+  t_pool = this;
+  t_worker_id = id;
+  Task task;
+  while (true) {
+    bool found = PopLocal(id, &task) || Steal(id, &task);
+    for (int i = 0; !found && i < kSpinRounds; ++i) {
+      std::this_thread::yield();
+      found = pending_.load() > 0 && (PopLocal(id, &task) || Steal(id, &task));
+    }
+    if (found) {
+      task();
+      task = nullptr;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    ++num_sleeping_;
+    sleep_cv_.wait(lock, [this] { return stop_ || pending_.load() > 0; });
+    --num_sleeping_;
+    if (stop_ && pending_.load() == 0) break;
+  }
+  t_pool = nullptr;
+}
+
+}  // namespace details
+}  // namespace framework
+}  // namespace paddle
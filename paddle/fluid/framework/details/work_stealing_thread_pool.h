@@ -0,0 +1,81 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "paddle/fluid/platform/cpu_helper.h"
+
+namespace paddle {
+namespace framework {
+namespace details {
+
+// WorkStealingThreadPool gives every worker its own task deque instead of
+// sharing one queue among all threads. A task enqueued by a worker goes to
+// the back of its own deque and is popped from there again (LIFO), so that
+// the consumers of an op usually run on the thread which produced their
+// inputs. Idle workers steal from the front of the other deques. The deques
+// are guarded by one mutex each, which are only contended when stealing.
+class WorkStealingThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingThreadPool(size_t num_threads);
+  ~WorkStealingThreadPool();
+
+  // Tasks enqueued from a worker of this pool are pushed to its own deque,
+  // the others are distributed round robin.
+  void Enqueue(Task task);
+
+  size_t NumThreads() const { return threads_.size(); }
+
+ private:
+  // The workers are allocated one by one, the padding keeps their hot
+  // fields off the cache lines of the neighbouring allocations. alignas
+  // would need an over-aligned operator new, which C++11 lacks.
+  struct Worker {
+    char padding_front[platform::kCacheLineSize];
+    std::mutex mutex;
+    std::deque<Task> tasks;
+    char padding_back[platform::kCacheLineSize];
+  };
+
+  void WorkerLoop(size_t id);
+  bool PopLocal(size_t id, Task *task);
+  bool Steal(size_t id, Task *task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+
+  // the number of tasks in all deques
+  std::atomic<size_t> pending_{0};
+  std::atomic<size_t> next_worker_{0};
+
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  std::atomic<int> num_sleeping_{0};
+  bool stop_{false};
+};
+
+}  // namespace details
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,144 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/details/work_stealing_thread_pool.h"
+
+#include <ThreadPool.h>
+#include <chrono>  // NOLINT
+#include <set>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace framework {
+namespace details {
+
+namespace {
+
+// Runs a binary tree of tiny tasks, every task schedules its two children,
+// like an op making two consumers ready. Returns when all tasks are done.
+template <typename Schedule>
+void RunTaskTree(Schedule schedule, int depth, std::atomic<int> *num_done) {
+  std::atomic<int> num_running{1};
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool finished = false;
+  auto release = [&] {
+    if (num_running.fetch_sub(1) == 1) {
+      std::lock_guard<std::mutex> guard(mutex);
+      finished = true;
+      cv.notify_one();
+    }
+  };
+
+  std::function<void(int)> spawn = [&](int level) {
+    num_running.fetch_add(1);
+    schedule([&, level] {
+      num_done->fetch_add(1);
+      if (level + 1 < depth) {
+        spawn(level + 1);
+        spawn(level + 1);
+      }
+      release();
+    });
+  };
+  spawn(0);
+  release();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&] { return finished; });
+}
+
+}  // namespace
+
+TEST(WorkStealingThreadPool, RunAllTasks) {
+  WorkStealingThreadPool pool(4);
+  EXPECT_EQ(pool.NumThreads(), 4UL);
+  std::atomic<int> num_done{0};
+  RunTaskTree([&](std::function<void()> task) { pool.Enqueue(task); }, 12,
+              &num_done);
+  EXPECT_EQ(num_done.load(), (1 << 12) - 1);
+}
+
+TEST(WorkStealingThreadPool, StealFromBusyWorker) {
+  WorkStealingThreadPool pool(4);
+  std::mutex mutex;
+  std::set<std::thread::id> thread_ids;
+  std::atomic<int> num_done{0};
+  // all tasks are enqueued by one worker, the others have to steal them
+  pool.Enqueue([&] {
+    for (int i = 0; i < 64; ++i) {
+      pool.Enqueue([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard<std::mutex> guard(mutex);
+        thread_ids.insert(std::this_thread::get_id());
+        ++num_done;
+      });
+    }
+  });
+  while (num_done.load() < 64) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_GT(thread_ids.size(), 1UL);
+}
+
+TEST(WorkStealingThreadPool, DrainOnDestruction) {
+  std::atomic<int> num_done{0};
+  {
+    WorkStealingThreadPool pool(2);
+    for (int i = 0; i < 100; ++i) {
+      pool.Enqueue([&] { ++num_done; });
+    }
+  }
+  EXPECT_EQ(num_done.load(), 100);
+}
+
+TEST(WorkStealingThreadPool, CompareWithSharedQueue) {
+  const size_t kNumThreads = 8;
+  const int kDepth = 14;
+  const int kRepeat = 5;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  ::ThreadPool shared_pool(kNumThreads);
+  std::atomic<int> num_done{0};
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepeat; ++i) {
+    RunTaskTree(
+        [&](std::function<void()> task) { shared_pool.enqueue(task); },
+        kDepth, &num_done);
+  }
+  ms shared_time = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(num_done.load(), kRepeat * ((1 << kDepth) - 1));
+
+  WorkStealingThreadPool stealing_pool(kNumThreads);
+  num_done = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepeat; ++i) {
+    RunTaskTree(
+        [&](std::function<void()> task) { stealing_pool.Enqueue(task); },
+        kDepth, &num_done);
+  }
+  ms stealing_time = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(num_done.load(), kRepeat * ((1 << kDepth) - 1));
+
+  LOG(INFO) << "Run " << (1 << kDepth) - 1 << " tasks with " << kNumThreads
+            << " threads, shared queue: " << shared_time.count() / kRepeat
+            << "ms, work stealing: " << stealing_time.count() / kRepeat
+            << "ms";
+}
+
+}  // namespace details
+}  // namespace framework
+}  // namespace paddle
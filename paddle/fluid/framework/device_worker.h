@@ -256,9 +256,15 @@ class HogwildWorker : public CPUWorkerBase {
  protected:
   void CreateThreadOperators(const ProgramDesc& program);
   void CreateThreadScope(const ProgramDesc& program);
+  // Reads and pulls sparse parameters of the next pipeline_depth batches in
+  // a prefetch thread while the current batch computes and pushes.
+  void TrainFilesPipelined();
+  void PrintFetchVarsInScope(Scope* scope);
 
   std::vector<std::string> op_names_;
   std::vector<OperatorBase*> ops_;
+  // non-persistable vars created in every thread (and pipeline slot) scope
+  std::vector<std::pair<std::string, proto::VarType::Type>> local_vars_;
   bool thread_barrier_;
   // Scope* thread_scope_;
   HogwildWorkerParameter param_;
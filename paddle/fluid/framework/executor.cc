@@ -29,6 +29,7 @@ limitations under the License. */
 
 DECLARE_bool(benchmark);
 DECLARE_bool(use_mkldnn);
+DECLARE_bool(cache_runtime_context);
 
 namespace paddle {
 namespace framework {
@@ -62,6 +63,45 @@ void ExecutorPrepareContext::PrepareUnusedVars(
   unused_vars_ = GetUnusedVars(prog_.Block(block_id_), ops_, keep_vars);
 }
 
+void ExecutorPrepareContext::SetCacheRuntimeContext(bool enable) {
+  if (enable == cache_runtime_context_) {
+    return;
+  }
+  for (auto& op : ops_) {
+    op->SetCacheRuntimeContext(enable);
+  }
+  cache_runtime_context_ = enable;
+  unused_vars_scope_ = nullptr;
+  resolved_unused_vars_.clear();
+}
+
+const std::vector<Variable*>& ExecutorPrepareContext::UnusedVars(
+    const Scope& scope, const OperatorBase* op) {
+  uint64_t vars_epoch = scope.VarsEpoch();
+  if (unused_vars_scope_ != &scope || unused_vars_scope_id_ != scope.ID() ||
+      unused_vars_epoch_ != vars_epoch) {
+    resolved_unused_vars_.clear();
+    unused_vars_scope_ = &scope;
+    unused_vars_scope_id_ = scope.ID();
+    unused_vars_epoch_ = vars_epoch;
+  }
+  auto it = resolved_unused_vars_.find(op);
+  if (it != resolved_unused_vars_.end()) {
+    return it->second;
+  }
+  auto& vars = resolved_unused_vars_[op];
+  auto names_it = unused_vars_.find(op);
+  if (names_it != unused_vars_.end()) {
+    for (auto& name : names_it->second) {
+      auto* var = scope.FindVar(name);
+      if (var != nullptr) {
+        vars.push_back(var);
+      }
+    }
+  }
+  return vars;
+}
+
 ExecutorPrepareContext::~ExecutorPrepareContext() {
   VLOG(5) << "destroy ExecutorPrepareContext";
 }
@@ -457,11 +497,19 @@ void Executor::RunPartialPreparedContext(ExecutorPrepareContext* ctx,
     }
   }
 
+  // a new local scope is released after this run, nothing to reuse
+  ctx->SetCacheRuntimeContext(FLAGS_cache_runtime_context &&
+                              local_scope == scope);
   for (int64_t i = start_op_index; i < end_op_index; ++i) {
     auto& op = ctx->ops_[i];
     op->Run(*local_scope, place_);
     if (gc) {
-      DeleteUnusedTensors(*local_scope, op.get(), ctx->unused_vars_, gc.get());
+      if (ctx->cache_runtime_context_) {
+        DeleteUnusedTensors(ctx->UnusedVars(*local_scope, op.get()), gc.get());
+      } else {
+        DeleteUnusedTensors(*local_scope, op.get(), ctx->unused_vars_,
+                            gc.get());
+      }
     }
   }
 
@@ -46,6 +46,15 @@ struct ExecutorPrepareContext {
   void PrepareUnusedVars(const std::vector<std::string>& keep_vars,
                          bool force_disable_gc = false);
 
+  // Caches the variables of the ops and of eager deletion per scope, see
+  // FLAGS_cache_runtime_context.
+  void SetCacheRuntimeContext(bool enable);
+
+  // The unused variables of op resolved in scope, valid until the scope or
+  // the vars epoch of its scope chain changes.
+  const std::vector<Variable*>& UnusedVars(const Scope& scope,
+                                           const OperatorBase* op);
+
   const framework::ProgramDesc& prog_;
   const size_t block_id_;
 
@@ -54,6 +63,13 @@ struct ExecutorPrepareContext {
   std::unordered_map<const OperatorBase*, std::vector<std::string>>
       unused_vars_;
   bool force_disable_gc_{false};
+
+  bool cache_runtime_context_{false};
+  const Scope* unused_vars_scope_{nullptr};
+  uint64_t unused_vars_scope_id_{0};
+  uint64_t unused_vars_epoch_{0};
+  std::unordered_map<const OperatorBase*, std::vector<Variable*>>
+      resolved_unused_vars_;
 };
 
 class Executor {
@@ -143,6 +143,27 @@ GetUnusedVars(const BlockDesc &block,
   return result;
 }
 
+static void CollectVarGarbage(
+    Variable *var, const std::string &var_name,
+    std::deque<std::shared_ptr<memory::Allocation>> *garbages) {
+  VLOG(2) << "Erase variable " << var_name;
+  if (var->IsType<LoDTensor>()) {
+    garbages->emplace_back(var->GetMutable<LoDTensor>()->MoveMemoryHolder());
+  } else if (var->IsType<SelectedRows>()) {
+    garbages->emplace_back(
+        var->GetMutable<SelectedRows>()->mutable_value()->MoveMemoryHolder());
+  } else if (var->IsType<LoDTensorArray>()) {
+    auto *lod_tensor_arr = var->GetMutable<LoDTensorArray>();
+    for (auto &t : *lod_tensor_arr) {
+      garbages->emplace_back(t.MoveMemoryHolder());
+    }
+  } else {
+    PADDLE_THROW(platform::errors::Unimplemented(
+        "Type %s of variable %s is not supported eager deletion.",
+        framework::ToTypeName(var->Type()), var_name));
+  }
+}
+
 void DeleteUnusedTensors(
     const Scope &scope, const OperatorBase *op,
     const std::unordered_map<const OperatorBase *, std::vector<std::string>>
@@ -162,23 +183,19 @@ void DeleteUnusedTensors(
     if (var == nullptr) {
       continue;
     }
+    CollectVarGarbage(var, var_name, &garbages);
+  }
 
-    VLOG(2) << "Erase variable " << var_name;
-    if (var->IsType<LoDTensor>()) {
-      garbages.emplace_back(var->GetMutable<LoDTensor>()->MoveMemoryHolder());
-    } else if (var->IsType<SelectedRows>()) {
-      garbages.emplace_back(
-          var->GetMutable<SelectedRows>()->mutable_value()->MoveMemoryHolder());
-    } else if (var->IsType<LoDTensorArray>()) {
-      auto *lod_tensor_arr = var->GetMutable<LoDTensorArray>();
-      for (auto &t : *lod_tensor_arr) {
-        garbages.emplace_back(t.MoveMemoryHolder());
-      }
-    } else {
-      PADDLE_THROW(platform::errors::Unimplemented(
-          "Type %s of variable %s is not supported eager deletion.",
-          framework::ToTypeName(var->Type()), var_name));
-    }
+  if (!garbages.empty()) {
+    gc->Add(std::move(garbages));
+  }
+}
+
+void DeleteUnusedTensors(const std::vector<Variable *> &delete_vars,
+                         GarbageCollector *gc) {
+  std::deque<std::shared_ptr<memory::Allocation>> garbages;
+  for (auto *var : delete_vars) {
+    CollectVarGarbage(var, "", &garbages);
   }
 
   if (!garbages.empty()) {
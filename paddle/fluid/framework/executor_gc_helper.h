@@ -43,5 +43,9 @@ void DeleteUnusedTensors(
         &delete_vars_map,
     GarbageCollector *gc);
 
+// Collect the tensors of already resolved unused variables after op runs
+void DeleteUnusedTensors(const std::vector<Variable *> &delete_vars,
+                         GarbageCollector *gc);
+
 }  // namespace framework
 }  // namespace paddle
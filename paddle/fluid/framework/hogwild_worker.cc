@@ -12,19 +12,72 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <exception>
+#include <unordered_set>
+
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/device_worker.h"
 #include "paddle/fluid/operators/controlflow/conditional_block_op_helper.h"
 #include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/lodtensor_printer.h"
+#include "paddle/fluid/string/printf.h"
 
 #if defined PADDLE_WITH_PSCORE
 #include "paddle/fluid/distributed/service/communicator.h"
 #endif
 
+DECLARE_bool(cache_runtime_context);
+
 namespace paddle {
 namespace framework {
 
+namespace {
+
+// ops which only depend on the fed ids and can run ahead of the batch being
+// computed
+const std::unordered_set<std::string> &PipelinePullOps() {
+  static const std::unordered_set<std::string> ops = {
+      "distributed_lookup_table", "pull_sparse", "pull_sparse_v2"};
+  return ops;
+}
+
+const std::unordered_set<std::string> &PipelinePushOps() {
+  static const std::unordered_set<std::string> ops = {
+      "send", "push_dense", "push_sparse", "push_sparse_v2"};
+  return ops;
+}
+
+struct PipelineStat {
+  // prefetch thread
+  std::atomic<uint64_t> read_us{0};
+  std::atomic<uint64_t> pull_us{0};
+  // time the prefetch thread waits for a free slot, i.e. compute bound
+  std::atomic<uint64_t> stall_us{0};
+  // compute thread, wait_us is the time spent waiting for a prefetched batch
+  uint64_t wait_us = 0;
+  uint64_t compute_us = 0;
+  uint64_t push_us = 0;
+};
+
+void PrintPipelineStat(const PipelineStat &stat, int batch_cnt,
+                       uint64_t total_inst, double total_sec) {
+  double read = static_cast<double>(stat.read_us.load()) / batch_cnt;
+  double pull = static_cast<double>(stat.pull_us.load()) / batch_cnt;
+  double compute = static_cast<double>(stat.compute_us) / batch_cnt;
+  double push = static_cast<double>(stat.push_us) / batch_cnt;
+  VLOG(1) << string::Sprintf(
+      "pipeline mean time per batch: read:[%.1fus], pull:[%.1fus], "
+      "stall:[%.1fus], wait:[%.1fus], compute:[%.1fus], push:[%.1fus]",
+      read, pull, static_cast<double>(stat.stall_us.load()) / batch_cnt,
+      static_cast<double>(stat.wait_us) / batch_cnt, compute, push);
+  VLOG(1) << string::Sprintf(
+      "pipeline bound by %s stage, %6.2f instances/s",
+      read + pull > compute + push ? "read and pull" : "compute and push",
+      total_inst / total_sec);
+}
+
+}  // namespace
+
 void HogwildWorker::Initialize(const TrainerDesc &desc) {
   fetch_config_ = desc.fetch_config();
   param_ = desc.hogwild_param();
@@ -45,6 +98,10 @@ void HogwildWorker::CreateThreadOperators(const ProgramDesc &program) {
   op_names_.clear();
   for (auto &op_desc : block.AllOps()) {
     std::unique_ptr<OperatorBase> local_op = OpRegistry::CreateOp(*op_desc);
+    // the ops run in the thread scope (or the pipeline slots) every batch
+    if (FLAGS_cache_runtime_context) {
+      local_op->SetCacheRuntimeContext(true);
+    }
     op_names_.push_back(op_desc->Type());
     OperatorBase *local_op_ptr = local_op.release();
     ops_.push_back(local_op_ptr);
@@ -89,6 +146,7 @@ void HogwildWorker::CreateThreadScope(const ProgramDesc &program) {
     } else {
       auto *ptr = thread_scope_->Var(var->Name());
       InitializeVariable(ptr, var->GetType());
+      local_vars_.emplace_back(var->Name(), var->GetType());
     }
   }
 }
@@ -193,6 +251,10 @@ void HogwildWorker::TrainFilesWithProfiler() {
 }
 
 void HogwildWorker::TrainFiles() {
+  if (param_.pipeline_depth() > 0) {
+    TrainFilesPipelined();
+    return;
+  }
   platform::SetNumThreads(1);
 
   // how to accumulate fetched values here
@@ -222,7 +284,179 @@ void HogwildWorker::TrainFiles() {
 #endif
 }
 
-void HogwildWorker::PrintFetchVars() {
+void HogwildWorker::TrainFilesPipelined() {
+  platform::SetNumThreads(1);
+  const int depth = param_.pipeline_depth();
+
+  // Hoist the pull ops whose inputs are not written by any op running
+  // before them, they run in the prefetch thread on the slot of the batch.
+  std::vector<OperatorBase *> pull_ops;
+  std::vector<OperatorBase *> compute_ops;
+  std::unordered_set<std::string> extra_pull_ops(
+      param_.pipeline_pull_ops().begin(), param_.pipeline_pull_ops().end());
+  std::unordered_set<std::string> written;
+  std::unordered_set<std::string> touched;
+  for (auto *op : ops_) {
+    bool need_skip = false;
+    for (auto t = 0u; t < skip_ops_.size(); ++t) {
+      if (op->Type().find(skip_ops_[t]) != std::string::npos) {
+        need_skip = true;
+        break;
+      }
+    }
+    if (need_skip) continue;
+    bool hoist = PipelinePullOps().count(op->Type()) > 0 ||
+                 extra_pull_ops.count(op->Type()) > 0;
+    for (auto &in : op->Inputs()) {
+      for (auto &name : in.second) {
+        if (hoist && written.count(name)) hoist = false;
+      }
+    }
+    for (auto &out : op->Outputs()) {
+      for (auto &name : out.second) {
+        if (hoist && touched.count(name)) hoist = false;
+      }
+    }
+    if (hoist) {
+      pull_ops.push_back(op);
+      continue;
+    }
+    compute_ops.push_back(op);
+    for (auto &in : op->Inputs()) {
+      touched.insert(in.second.begin(), in.second.end());
+    }
+    for (auto &out : op->Outputs()) {
+      written.insert(out.second.begin(), out.second.end());
+      touched.insert(out.second.begin(), out.second.end());
+    }
+  }
+  VLOG(3) << "thread " << thread_id_ << " pipeline depth " << depth << ", "
+          << pull_ops.size() << " pull ops prefetched, " << compute_ops.size()
+          << " ops computed";
+
+  // every batch in flight owns a slot scope shadowing the local vars
+  std::vector<Scope *> slots(depth + 1);
+  auto free_slots = MakeChannel<Scope *>();
+  auto ready_slots = MakeChannel<std::pair<Scope *, int>>(depth);
+  for (auto &slot : slots) {
+    slot = &thread_scope_->NewScope();
+    for (auto &var : local_vars_) {
+      InitializeVariable(slot->Var(var.first), var.second);
+    }
+    free_slots->Put(slot);
+  }
+  const std::vector<std::string> &input_feed =
+      device_reader_->GetUseSlotAlias();
+
+  PipelineStat stat;
+  std::exception_ptr prefetch_error = nullptr;
+  device_reader_->Start();
+  std::thread prefetcher([&] {
+    try {
+      platform::SetNumThreads(1);
+      platform::Timer timer;
+      Scope *slot = nullptr;
+      while (true) {
+        timer.Start();
+        bool got = free_slots->Get(slot);
+        timer.Pause();
+        stat.stall_us += static_cast<uint64_t>(timer.ElapsedUS());
+        if (!got) break;
+
+        timer.Start();
+        for (auto &name : input_feed) {
+          device_reader_->AddFeedVar(slot->FindVar(name), name);
+        }
+        int cur_batch = device_reader_->Next();
+        timer.Pause();
+        stat.read_us += static_cast<uint64_t>(timer.ElapsedUS());
+        if (cur_batch <= 0) break;
+
+        timer.Start();
+        for (auto *op : pull_ops) {
+          op->Run(*slot, place_);
+        }
+        timer.Pause();
+        stat.pull_us += static_cast<uint64_t>(timer.ElapsedUS());
+        if (!ready_slots->Put(std::make_pair(slot, cur_batch))) break;
+      }
+    } catch (...) {
+      prefetch_error = std::current_exception();
+    }
+    ready_slots->Close();
+  });
+
+  auto stop_prefetcher = [&] {
+    free_slots->Close();
+    ready_slots->Close();
+    prefetcher.join();
+    for (auto *slot : slots) {
+      thread_scope_->DeleteScope(slot);
+    }
+    // restore the binding of the non pipelined mode
+    BindingDataFeedMemory();
+  };
+
+  platform::Timer timeline;
+  platform::Timer timer;
+  int batch_cnt = 0;
+  uint64_t total_inst = 0;
+  timeline.Start();
+  try {
+    std::pair<Scope *, int> batch;
+    while (true) {
+      timer.Start();
+      bool got = ready_slots->Get(batch);
+      timer.Pause();
+      stat.wait_us += static_cast<uint64_t>(timer.ElapsedUS());
+      if (!got) break;
+
+      Scope *slot = batch.first;
+      for (auto *op : compute_ops) {
+        timer.Start();
+        op->Run(*slot, place_);
+        timer.Pause();
+        if (PipelinePushOps().count(op->Type())) {
+          stat.push_us += static_cast<uint64_t>(timer.ElapsedUS());
+        } else {
+          stat.compute_us += static_cast<uint64_t>(timer.ElapsedUS());
+        }
+      }
+      PrintFetchVarsInScope(slot);
+      slot->DropKids();
+      free_slots->Put(slot);
+
+      total_inst += batch.second;
+      ++batch_cnt;
+      if (thread_id_ == 0 && batch_cnt % 100 == 0 && VLOG_IS_ON(1)) {
+        timeline.Pause();
+        PrintPipelineStat(stat, batch_cnt, total_inst, timeline.ElapsedSec());
+        timeline.Resume();
+      }
+    }
+  } catch (...) {
+    stop_prefetcher();
+    throw;
+  }
+  timeline.Pause();
+  stop_prefetcher();
+  if (prefetch_error) {
+    std::rethrow_exception(prefetch_error);
+  }
+  if (thread_id_ == 0 && batch_cnt > 0 && VLOG_IS_ON(1)) {
+    PrintPipelineStat(stat, batch_cnt, total_inst, timeline.ElapsedSec());
+  }
+
+#if defined PADDLE_WITH_PSCORE
+  if (thread_barrier_) {
+    paddle::distributed::Communicator::GetInstance()->BarrierTriggerDecrement();
+  }
+#endif
+}
+
+void HogwildWorker::PrintFetchVars() { PrintFetchVarsInScope(thread_scope_); }
+
+void HogwildWorker::PrintFetchVarsInScope(Scope *scope) {
   // call count
   batch_num_++;
   int batch_per_print = fetch_config_.print_period();
@@ -230,7 +464,7 @@ void HogwildWorker::PrintFetchVars() {
     if (batch_num_ % batch_per_print == 0) {
       int fetch_var_num = fetch_config_.fetch_var_names_size();
       for (int i = 0; i < fetch_var_num; ++i) {
-        platform::PrintVar(thread_scope_, fetch_config_.fetch_var_names(i),
+        platform::PrintVar(scope, fetch_config_.fetch_var_names(i),
                            fetch_config_.fetch_var_str_format(i));
       }
     }
@@ -0,0 +1,181 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/ir/constant_folding_pass.h"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/fluid/framework/ir/graph_helper.h"
+#include "paddle/fluid/framework/ir/graph_pattern_detector.h"
+#include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/framework/op_registry.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+namespace {
+
+// The ops without inputs that create constants.
+const std::unordered_set<std::string> kConstantSourceOps = {"fill_constant",
+                                                            "assign_value"};
+
+// The ops with random results or effects besides their outputs. The random
+// ops with a "seed" attribute are recognized by it.
+const std::unordered_set<std::string> kUnfoldableOps = {
+    "feed",         "fetch",     "dropout",      "randperm",
+    "sampling_id",  "bernoulli", "multinomial",  "print",
+    "save",         "load",      "save_combine", "load_combine",
+    "read",         "py_func",   "assert",       "increment"};
+
+}  // namespace
+
+bool ConstantFoldingPass::IsFoldable(const Node* node) const {
+  auto* op = node->Op();
+  if (op == nullptr || kUnfoldableOps.count(op->Type()) ||
+      op->HasAttr("seed") || !OpInfoMap::Instance().Has(op->Type())) {
+    return false;
+  }
+  for (auto& attr : op->GetAttrMap()) {
+    if (attr.second.type() == typeid(BlockDesc*) ||
+        attr.second.type() == typeid(std::vector<BlockDesc*>)) {
+      return false;
+    }
+  }
+  if (node->inputs.empty() && !kConstantSourceOps.count(op->Type())) {
+    return false;
+  }
+  for (auto* out : node->outputs) {
+    if (out->Var() == nullptr || out->Var()->Persistable() ||
+        out->Var()->GetType() != proto::VarType::LOD_TENSOR) {
+      return false;
+    }
+  }
+  return !node->outputs.empty();
+}
+
+void ConstantFoldingPass::ApplyImpl(Graph* graph) const {
+  PADDLE_ENFORCE_NOT_NULL(
+      graph, platform::errors::InvalidArgument("Graph cannot be nullptr."));
+  Init("constant_folding_pass", graph);
+  if (!graph->Has(kParamScopeAttr)) {
+    VLOG(3) << "constant_folding_pass is skipped without a parameter scope.";
+    return;
+  }
+  Scope* scope = param_scope();
+
+  // A variable written by several ops, or a persistable one written at all,
+  // changes during the run.
+  std::unordered_map<std::string, int> num_writes;
+  for (auto* node : graph->Nodes()) {
+    if (!node->IsOp()) continue;
+    for (auto* out : node->outputs) {
+      ++num_writes[out->Name()];
+    }
+  }
+  std::unordered_set<const Node*> constants;
+  for (auto* node : graph->Nodes()) {
+    if (!node->IsVar() || node->Var() == nullptr ||
+        !node->Var()->Persistable() || num_writes.count(node->Name())) {
+      continue;
+    }
+    auto* var = scope->FindVar(node->Name());
+    if (var != nullptr && var->IsType<LoDTensor>() &&
+        var->Get<LoDTensor>().IsInitialized()) {
+      constants.insert(node);
+    }
+  }
+
+  // the consumers of every variable that are not folded
+  std::unordered_map<const Node*, size_t> num_consumers;
+  std::unordered_set<const Node*> folded_vars;
+  std::unordered_set<const Node*> nodes_to_remove;
+  int num_folded = 0;
+  for (auto* node : TopologySortOperations(*graph)) {
+    if (!IsFoldable(node)) continue;
+    bool all_constant = true;
+    for (auto* in : node->inputs) {
+      all_constant = all_constant && constants.count(in);
+    }
+    for (auto* out : node->outputs) {
+      all_constant = all_constant && num_writes[out->Name()] == 1;
+    }
+    if (!all_constant) continue;
+
+    auto& local_scope = scope->NewScope();
+    for (auto* out : node->outputs) {
+      local_scope.Var(out->Name())->GetMutable<LoDTensor>();
+    }
+    bool done = true;
+    try {
+      auto op = OpRegistry::CreateOp(*node->Op());
+      op->Run(local_scope, platform::CPUPlace());
+    } catch (const std::exception& e) {
+      VLOG(3) << "Cannot fold " << node->Op()->Type() << ", " << e.what();
+      done = false;
+    }
+    // the outputs nobody reads are dropped
+    for (auto* out : node->outputs) {
+      done = done && (out->outputs.empty() ||
+                      local_scope.FindLocalVar(out->Name())
+                          ->Get<LoDTensor>()
+                          .IsInitialized());
+    }
+    if (!done) {
+      scope->DeleteScope(&local_scope);
+      continue;
+    }
+
+    for (auto* out : node->outputs) {
+      if (out->outputs.empty()) {
+        nodes_to_remove.insert(out);
+        continue;
+      }
+      auto& result = local_scope.FindLocalVar(out->Name())->Get<LoDTensor>();
+      *scope->Var(out->Name())->GetMutable<LoDTensor>() = result;
+      out->Var()->SetShape(vectorize(result.dims()));
+      out->Var()->SetPersistable(true);
+      constants.insert(out);
+      folded_vars.insert(out);
+      num_consumers[out] = out->outputs.size();
+    }
+    scope->DeleteScope(&local_scope);
+    for (auto* in : node->inputs) {
+      if (folded_vars.count(in) && --num_consumers[in] == 0) {
+        nodes_to_remove.insert(in);
+      }
+    }
+    nodes_to_remove.insert(node);
+    ++num_folded;
+  }
+
+  // the folded variables all of whose consumers are folded too
+  std::vector<std::string> unused_vars;
+  for (auto* node : nodes_to_remove) {
+    if (folded_vars.count(node)) unused_vars.push_back(node->Name());
+  }
+  scope->EraseVars(unused_vars);
+  GraphSafeRemoveNodes(graph, nodes_to_remove);
+  AddStatis(num_folded);
+}
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
+
+REGISTER_PASS(constant_folding_pass,
+              paddle::framework::ir::ConstantFoldingPass);
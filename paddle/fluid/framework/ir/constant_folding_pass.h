@@ -0,0 +1,50 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/fluid/framework/ir/fuse_pass_base.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+class Graph;
+class Node;
+
+/*
+ * Evaluates the ops whose inputs are all constant once on CPU, and replaces
+ * their outputs by persistable variables holding the results in the
+ * parameter scope. The inputs are constant if they are persistable or the
+ * outputs of folded ops, so fill_constant and assign_value start chains of
+ * constants, e.g. the shape computations, casts, reshapes and scales of
+ * weights that would otherwise run on every inference.
+ *
+ * Ops with random results, side effects or sub-blocks are never folded.
+ */
+class ConstantFoldingPass : public FusePassBase {
+ public:
+  virtual ~ConstantFoldingPass() {}
+
+ protected:
+  void ApplyImpl(Graph* graph) const override;
+
+ private:
+  // Whether op can be folded when all its inputs are constant.
+  bool IsFoldable(const Node* op) const;
+};
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
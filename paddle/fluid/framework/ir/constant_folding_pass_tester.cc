@@ -0,0 +1,169 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/ir/constant_folding_pass.h"
+
+#include <gtest/gtest.h>
+#include "paddle/fluid/framework/ir/pass_tester_helper.h"
+#include "paddle/fluid/framework/naive_executor.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/platform/timer.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+namespace {
+
+void SetTensor(Scope* scope, const std::string& name,
+               const std::vector<int64_t>& shape) {
+  auto* tensor = scope->Var(name)->GetMutable<LoDTensor>();
+  auto* data =
+      tensor->mutable_data<float>(make_ddim(shape), platform::CPUPlace());
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = i % 7;
+  }
+}
+
+}  // namespace
+
+TEST(ConstantFoldingPass, basic) {
+  // inputs                     operator            output
+  // --------------------------------------------------------
+  // (w)                        scale            -> w_scaled
+  // (w_scaled)                 reshape2         -> w_reshaped, xshape
+  // ()                         fill_constant    -> c
+  // (x, w_reshaped)            mul              -> mul_out
+  // (mul_out, c)               elementwise_add  -> add_out
+  // ()                         gaussian_random  -> noise
+  // (add_out, noise)           elementwise_add  -> out
+  Layers layers;
+  auto* x = layers.data("x", {2, 4});
+  auto* w = layers.data("w", {8}, true);
+  auto* w_scaled = layers.scale(w, 2.0f, 1.0f, true);
+  auto* w_reshaped = layers.reshape2(w_scaled, {4, 2}, true);
+  auto* c = layers.fill_constant({2}, 3.0f);
+  auto* mul_out = layers.mul(x, w_reshaped);
+  auto* add_out = layers.elementwise_add(mul_out, c);
+  auto* noise = layers.data("noise", {2, 2});
+  ProgramDesc program(layers.main_program());
+  auto* random_op = program.MutableBlock(0)->AppendOp();
+  random_op->SetType("gaussian_random");
+  random_op->SetAttr("seed", 0);
+  random_op->SetOutput("Out", {noise->Name()});
+  auto* add_op = program.MutableBlock(0)->AppendOp();
+  add_op->SetType("elementwise_add");
+  add_op->SetInput("X", {add_out->Name()});
+  add_op->SetInput("Y", {noise->Name()});
+  add_op->SetOutput("Out", {"out"});
+  program.MutableBlock(0)->Var("out");
+
+  std::unique_ptr<ir::Graph> graph(new ir::Graph(program));
+  Scope scope;
+  SetTensor(&scope, "w", {8});
+  graph->SetNotOwned(kParamScopeAttr, &scope);
+  auto pass = PassRegistry::Instance().Get("constant_folding_pass");
+  int num_nodes_before = graph->Nodes().size();
+  VLOG(3) << DebugString(graph);
+
+  graph.reset(pass->Apply(graph.release()));
+  int num_nodes_after = graph->Nodes().size();
+  VLOG(3) << DebugString(graph);
+
+  // scale, reshape2, fill_constant, w_scaled and xshape are removed
+  EXPECT_EQ(num_nodes_before, num_nodes_after + 5);
+  EXPECT_EQ(GetNumOpNodes(graph, "scale"), 0);
+  EXPECT_EQ(GetNumOpNodes(graph, "reshape2"), 0);
+  EXPECT_EQ(GetNumOpNodes(graph, "fill_constant"), 0);
+  EXPECT_EQ(GetNumOpNodes(graph, "gaussian_random"), 1);
+  EXPECT_EQ(scope.FindVar(w_scaled->Name()), nullptr);
+
+  for (auto* node : graph->Nodes()) {
+    if (node->IsVar() && node->Name() == w_reshaped->Name()) {
+      EXPECT_TRUE(node->Var()->Persistable());
+    }
+  }
+  auto& folded_w = scope.FindVar(w_reshaped->Name())->Get<LoDTensor>();
+  EXPECT_EQ(folded_w.dims(), make_ddim({4, 2}));
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_FLOAT_EQ(folded_w.data<float>()[i], 2.0f * (i % 7) + 1.0f);
+  }
+  auto& folded_c = scope.FindVar(c->Name())->Get<LoDTensor>();
+  EXPECT_FLOAT_EQ(folded_c.data<float>()[1], 3.0f);
+}
+
+TEST(ConstantFoldingPass, RunFoldedProgram) {
+  // a chain of scales on a weight before the mul of every run
+  const int64_t size = 512;
+  const int num_scales = 8;
+  Layers layers;
+  auto* x = layers.data("x", {1, size});
+  auto* w = layers.data("w", {size, size}, true);
+  VarDesc* scaled_w = w;
+  for (int i = 0; i < num_scales; ++i) {
+    scaled_w = layers.scale(scaled_w, 0.5f, 0.1f, true);
+  }
+  auto* out = layers.mul(x, scaled_w);
+
+  auto place = platform::CPUPlace();
+  Scope scope;
+  SetTensor(&scope, "w", {size, size});
+  SetTensor(&scope, "x", {1, size});
+  const int num_runs = 20;
+  auto run = [&](const ProgramDesc& program, Tensor* result) {
+    NaiveExecutor exe(place);
+    exe.CreateVariables(program, 0, false, &scope);
+    exe.Prepare(&scope, program, 0, false);
+    exe.Run();
+    platform::Timer timer;
+    timer.Start();
+    for (int i = 0; i < num_runs; ++i) {
+      exe.Run();
+    }
+    TensorCopySync(*exe.FindTensor(out->Name()), place, result);
+    return timer.ElapsedMS() / num_runs;
+  };
+
+  Tensor original_result;
+  double original_ms = run(layers.main_program(), &original_result);
+
+  std::unique_ptr<ir::Graph> graph(new ir::Graph(layers.main_program()));
+  graph->SetNotOwned(kParamScopeAttr, &scope);
+  auto pass = PassRegistry::Instance().Get("constant_folding_pass");
+  graph.reset(pass->Apply(graph.release()));
+  EXPECT_EQ(GetNumOpNodes(graph, "scale"), 0);
+  ProgramDesc folded_program;
+  auto graph_to_program = PassRegistry::Instance().Get("graph_to_program_pass");
+  graph_to_program->SetNotOwned<ProgramDesc>("program", &folded_program);
+  graph_to_program->Apply(graph.get());
+
+  Tensor folded_result;
+  double folded_ms = run(folded_program, &folded_result);
+  LOG(INFO) << "Run " << num_scales << " scales of a " << size << "x" << size
+            << " weight and a mul: " << original_ms << "ms, with the scales "
+            << "folded: " << folded_ms << "ms";
+
+  ASSERT_EQ(original_result.numel(), folded_result.numel());
+  for (int64_t i = 0; i < original_result.numel(); ++i) {
+    EXPECT_FLOAT_EQ(original_result.data<float>()[i],
+                    folded_result.data<float>()[i]);
+  }
+}
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
+
+USE_PASS(constant_folding_pass);
+USE_PASS(graph_to_program_pass);
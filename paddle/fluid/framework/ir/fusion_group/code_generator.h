@@ -32,7 +32,8 @@ class SubGraph;
 
 class CodeGenerator {
  public:
-  CodeGenerator();
+  // Generate CUDA code by default, or C++ code for CPU when is_cpu is true.
+  explicit CodeGenerator(bool is_cpu = false);
 
   std::string Generate(std::string func_name,
                        const std::vector<OperationExpression>& expressions);
@@ -57,6 +58,12 @@ class CodeGenerator {
       const std::set<int>& intermediate_ids,
       const std::unordered_map<int, std::string>& dtypes) const;
 
+  // we unpack the arguments of the CPU kernel from the void** args
+  std::string EmitCPUParameters(
+      const std::set<int>& input_ids, const std::set<int>& output_ids,
+      const std::set<int>& intermediate_ids,
+      const std::unordered_map<int, std::string>& dtypes) const;
+
   std::string EmitComputeBody(
       const std::vector<OperationExpression>& expressions,
       const std::set<int>& input_ids, const std::set<int>& output_ids,
@@ -67,6 +74,7 @@ class CodeGenerator {
   std::unordered_map<Node*, int> EncodeVarNodes(SubGraph* subgraph);
 
  private:
+  bool is_cpu_{false};
   std::vector<CodeTemplate> code_templates_;
 };
 
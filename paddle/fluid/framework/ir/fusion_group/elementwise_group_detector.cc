@@ -69,10 +69,11 @@ bool GroupDetector::CheckPrecondition(const Node* n) {
           return false;
         }
 
+        // FP16 is not supported in the generated CPU code.
         proto::VarType::Type data_type_i = n->Var()->GetDataType();
         if (data_type_i == proto::VarType::FP32 ||
             data_type_i == proto::VarType::FP64 ||
-            data_type_i == proto::VarType::FP16) {
+            (use_gpu_ && data_type_i == proto::VarType::FP16)) {
           if (is_first) {
             data_type_0 = data_type_i;
             is_first = false;
@@ -103,7 +104,8 @@ bool GroupDetector::CheckPrecondition(const Node* n) {
     return false;
   };
 
-  return n && n->IsOp() && n->Op() && !check_running_on_cpu(n) &&
+  return n && n->IsOp() && n->Op() &&
+         (!use_gpu_ || !check_running_on_cpu(n)) &&
          check_data_type(n->inputs) && check_data_type(n->outputs);
 }
 
@@ -33,12 +33,20 @@ namespace ir {
 namespace fusion_group {
 
 class GroupDetector {
+ public:
+  explicit GroupDetector(bool use_gpu = true) : use_gpu_(use_gpu) {}
+
  protected:
   bool CheckPrecondition(const Node* n);
+
+  bool use_gpu_;
 };
 
 class ElementwiseGroupDetector : GroupDetector {
  public:
+  explicit ElementwiseGroupDetector(bool use_gpu = true)
+      : GroupDetector(use_gpu) {}
+
   std::vector<std::vector<Node*>> operator()(Graph* graph);
 
  private:
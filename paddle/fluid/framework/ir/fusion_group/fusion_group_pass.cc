@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "paddle/fluid/framework/ir/fusion_group/fusion_group_pass.h"
+#include <sstream>
 #include "paddle/fluid/framework/ir/fusion_group/code_generator.h"
 #include "paddle/fluid/framework/ir/fusion_group/elementwise_group_detector.h"
 #include "paddle/fluid/framework/ir/graph_pattern_detector.h"
@@ -34,6 +35,7 @@ class Node;
 void FusionGroupPass::ApplyImpl(ir::Graph* graph) const {
   FusePassBase::Init("fusion_group_pass", graph);
   if (Get<bool>("use_gpu")) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
     // TODO(liuyiqun): open this check.
     // if (!platform::CUDADeviceCode::IsAvailable()) {
     //   LOG(WARNING)
@@ -43,20 +45,41 @@ void FusionGroupPass::ApplyImpl(ir::Graph* graph) const {
     // }
 
     fusion_group::OperationMap::Init();
-    int num_elementwise_groups = DetectFusionGroup(graph, 0);
+    // TODO(liuyiqun): supported different places
+    int num_elementwise_groups =
+        DetectFusionGroup(graph, platform::CUDAPlace(0), 0);
     AddStatis(num_elementwise_groups);
     LOG(INFO) << "Detect " << num_elementwise_groups
               << " elementwise fusion groups.";
+#else
+    LOG(WARNING) << "Disable fusion_group on GPU because PaddlePaddle is not "
+                    "compiled with CUDA or ROCM.";
+#endif
+  } else {
+    platform::CPUPlace place;
+    platform::DeviceCodePool::Init({place});
+    if (!platform::CPUDeviceCode::IsAvailable()) {
+      LOG(WARNING) << "Disable fusion_group because the host compiler for "
+                      "JIT compiling of CPU code is not available.";
+      return;
+    }
+
+    fusion_group::OperationMap::Init();
+    int num_elementwise_groups = DetectFusionGroup(graph, place, 0);
+    AddStatis(num_elementwise_groups);
+    LOG(INFO) << "Detect " << num_elementwise_groups
+              << " elementwise fusion groups on CPU.";
   }
 }
 
-int FusionGroupPass::DetectFusionGroup(Graph* graph, int type) const {
-  // TODO(liuyiqun): supported different places
-  platform::CUDAPlace place = platform::CUDAPlace(0);
+int FusionGroupPass::DetectFusionGroup(Graph* graph,
+                                       const platform::Place& place,
+                                       int type) const {
+  bool use_gpu = platform::is_gpu_place(place);
   int index = platform::DeviceCodePool::Init({place}).size(place);
 
   std::vector<std::vector<Node*>> subgraphs =
-      fusion_group::ElementwiseGroupDetector()(graph);
+      fusion_group::ElementwiseGroupDetector(use_gpu)(graph);
 
   int num_subgraphs = 0;
   size_t min_subgraph_size = 2;
@@ -68,9 +91,18 @@ int FusionGroupPass::DetectFusionGroup(Graph* graph, int type) const {
     VLOG(3) << "subgraph: {\n" << DebugString(subgraph.SortedNodes()) << "}\n";
 
     if (subgraph.IsValid(min_subgraph_size)) {
-      subgraph.SetFuncName("fused_elementwise_" + std::to_string(index++));
-      if (GenerateCode(&subgraph)) {
-        InsertFusionGroupOp(graph, &subgraph);
+      bool is_generated = false;
+      // The CPU kernels are saved in the op, so that they can be compiled
+      // again when the program is serialized and loaded in another process.
+      std::string func_code;
+      if (use_gpu) {
+        subgraph.SetFuncName("fused_elementwise_" + std::to_string(index++));
+        is_generated = GenerateCode(&subgraph, place);
+      } else {
+        is_generated = GenerateCPUCode(&subgraph, place, &func_code);
+      }
+      if (is_generated) {
+        InsertFusionGroupOp(graph, &subgraph, func_code);
         num_subgraphs++;
       }
     }
@@ -78,13 +110,13 @@ int FusionGroupPass::DetectFusionGroup(Graph* graph, int type) const {
   return num_subgraphs;
 }
 
-bool FusionGroupPass::GenerateCode(fusion_group::SubGraph* subgraph) const {
+bool FusionGroupPass::GenerateCode(fusion_group::SubGraph* subgraph,
+                                   const platform::Place& place) const {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   fusion_group::CodeGenerator code_generator;
   std::string code_str = code_generator.Generate(subgraph);
   VLOG(4) << code_str;
 
-  // TODO(liuyiqun): supported different places
-  platform::CUDAPlace place = platform::CUDAPlace(0);
   std::unique_ptr<platform::CUDADeviceCode> device_code(
       new platform::CUDADeviceCode(place, subgraph->GetFuncName(), code_str));
   bool is_compiled = device_code->Compile();
@@ -93,6 +125,42 @@ bool FusionGroupPass::GenerateCode(fusion_group::SubGraph* subgraph) const {
     pool.Set(std::move(device_code));
   }
   return is_compiled;
+#else
+  return false;
+#endif
+}
+
+bool FusionGroupPass::GenerateCPUCode(fusion_group::SubGraph* subgraph,
+                                      const platform::Place& place,
+                                      std::string* code_str) const {
+  // The CPU kernels are cached on the signature of the subgraph, that is the
+  // code generated with a fixed function name. Subgraphs with the same
+  // signature, in one graph or in graphs of different predictors, share one
+  // compiled kernel.
+  const std::string prefix = "fused_elementwise_cpu";
+  fusion_group::CodeGenerator code_generator(/* is_cpu= */ true);
+  subgraph->SetFuncName(prefix);
+  std::ostringstream func_name;
+  func_name << prefix << "_" << std::hex
+            << std::hash<std::string>()(code_generator.Generate(subgraph));
+  subgraph->SetFuncName(func_name.str());
+
+  *code_str = code_generator.Generate(subgraph);
+  VLOG(4) << *code_str;
+
+  platform::DeviceCodePool& pool = platform::DeviceCodePool::Init({place});
+  if (pool.Has(place, func_name.str())) {
+    VLOG(3) << "Reuse the compiled CPU kernel " << func_name.str();
+    return true;
+  }
+
+  std::unique_ptr<platform::CPUDeviceCode> device_code(
+      new platform::CPUDeviceCode(place, func_name.str(), *code_str));
+  bool is_compiled = device_code->Compile();
+  if (is_compiled) {
+    pool.Set(std::move(device_code));
+  }
+  return is_compiled;
 }
 
 static int ExtractOpRole(fusion_group::SubGraph* subgraph) {
@@ -113,7 +181,8 @@ static int ExtractOpRole(fusion_group::SubGraph* subgraph) {
 }
 
 void FusionGroupPass::InsertFusionGroupOp(
-    Graph* graph, fusion_group::SubGraph* subgraph) const {
+    Graph* graph, fusion_group::SubGraph* subgraph,
+    const std::string& func_code) const {
   const std::vector<Node*>& input_vars = subgraph->GetInputVarNodes();
   const std::vector<Node*>& output_vars =
       subgraph->GetOutputVarNodes(subgraph->SaveIntermediateOut());
@@ -150,6 +219,7 @@ void FusionGroupPass::InsertFusionGroupOp(
   op_desc.SetAttr("outs_dtype", output_dtypes);
   op_desc.SetAttr("type", subgraph->GetType());
   op_desc.SetAttr("func_name", subgraph->GetFuncName());
+  op_desc.SetAttr("func_code", func_code);
   op_desc.SetAttr(OpProtoAndCheckerMaker::OpRoleAttrName(),
                   ExtractOpRole(subgraph));
 
@@ -0,0 +1,211 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/ir/gemm_weight_pack_pass.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/framework/ir/graph_helper.h"
+#include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/operators/math/gemm_pack.h"
+#include "paddle/fluid/platform/device_context.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+namespace {
+
+template <typename T>
+void PackWeight(const LoDTensor& weight, bool trans, LoDTensor* packed) {
+  auto* dev_ctx = static_cast<platform::CPUDeviceContext*>(
+      platform::DeviceContextPool::Instance().Get(platform::CPUPlace()));
+  operators::math::PackGemmWeight<T>(*dev_ctx, weight, trans,
+                                     static_cast<T>(1), packed);
+}
+
+}  // namespace
+
+std::string PackableGemmWeightSlot(const OpDesc& op) {
+  if (op.GetAttrIfExists<bool>("use_mkldnn")) return "";
+  const std::string& type = op.Type();
+  if (type == "fc") {
+    if (op.GetAttrIfExists<bool>("padding_weights")) return "";
+    return "W";
+  }
+  if (type == "mul") {
+    if (op.HasAttr("y_num_col_dims") &&
+        BOOST_GET_CONST(int, op.GetAttr("y_num_col_dims")) != 1) {
+      return "";
+    }
+    return "Y";
+  }
+  if (type == "matmul") {
+    if (op.GetAttrIfExists<bool>("transpose_X")) return "";
+    if (op.HasAttr("alpha") &&
+        BOOST_GET_CONST(float, op.GetAttr("alpha")) != 1.0f) {
+      return "";
+    }
+    if (op.HasAttr("head_number") &&
+        BOOST_GET_CONST(int, op.GetAttr("head_number")) > 1) {
+      return "";
+    }
+    for (auto* attr : {"fused_reshape_X", "fused_reshape_Y",
+                       "fused_transpose_X", "fused_transpose_Y",
+                       "fused_reshape_Out", "fused_transpose_Out"}) {
+      if (!op.GetAttrIfExists<std::vector<int>>(attr).empty()) return "";
+    }
+    return "Y";
+  }
+  return "";
+}
+
+namespace {
+
+// Packs the weight of `op` in `scope`, unless it is packed already, and
+// returns the name of the packed variable, or "" if the weight cannot be
+// packed.
+std::string PackWeightOf(const OpDesc& op, const std::string& weight_name,
+                         Scope* scope) {
+  auto* weight_var = scope->FindVar(weight_name);
+  if (weight_var == nullptr || !weight_var->IsType<LoDTensor>()) return "";
+  const auto& weight = weight_var->Get<LoDTensor>();
+  if (!weight.IsInitialized() || weight.dims().size() != 2 ||
+      !platform::is_cpu_place(weight.place())) {
+    return "";
+  }
+  auto dtype = weight.type();
+  if (dtype != proto::VarType::FP32 && dtype != proto::VarType::FP64) {
+    return "";
+  }
+
+  bool trans =
+      op.Type() == "matmul" && op.GetAttrIfExists<bool>("transpose_Y");
+  std::string packed_name = weight_name +
+                            operators::math::kGemmPackedWeightSuffix +
+                            (trans ? "_T" : "");
+  // The weight may be shared by several ops, or the scope by several
+  // predictors, so only pack it once.
+  if (scope->FindLocalVar(packed_name) == nullptr) {
+    auto* packed = scope->Var(packed_name)->GetMutable<LoDTensor>();
+    if (dtype == proto::VarType::FP32) {
+      PackWeight<float>(weight, trans, packed);
+    } else {
+      PackWeight<double>(weight, trans, packed);
+    }
+  }
+  return packed_name;
+}
+
+}  // namespace
+
+void GemmWeightPackPass::ApplyImpl(Graph* graph) const {
+  PADDLE_ENFORCE_NOT_NULL(
+      graph, platform::errors::InvalidArgument("Graph cannot be nullptr."));
+  Init("gemm_weight_pack_pass", graph);
+  if (!operators::math::GemmPackSupported()) {
+    VLOG(3) << "gemm_weight_pack_pass is skipped without MKLML.";
+    return;
+  }
+  if (!graph->Has(kParamScopeAttr)) {
+    VLOG(3) << "gemm_weight_pack_pass is skipped without a parameter scope.";
+    return;
+  }
+  Scope* scope = param_scope();
+
+  int num_packed = 0;
+  for (auto* node : TopologySortOperations(*graph)) {
+    auto* op = node->Op();
+    std::string slot = PackableGemmWeightSlot(*op);
+    if (slot.empty()) continue;
+    if (op->Input(slot).size() != 1) continue;
+    const std::string& weight_name = op->Input(slot)[0];
+
+    const Node* weight_node = nullptr;
+    for (auto* in : node->inputs) {
+      if (in->IsVar() && in->Name() == weight_name) weight_node = in;
+    }
+    if (weight_node == nullptr || weight_node->Var() == nullptr ||
+        !weight_node->Var()->Persistable()) {
+      continue;
+    }
+    std::string packed_name = PackWeightOf(*op, weight_name, scope);
+    if (packed_name.empty()) continue;
+    op->SetAttr(operators::math::kPackedWeightAttr, packed_name);
+    ++num_packed;
+  }
+  AddStatis(num_packed);
+}
+
+void PackGemmWeights(const ProgramDesc& program, Scope* scope) {
+  if (!operators::math::GemmPackSupported()) return;
+  for (size_t i = 0; i < program.Size(); ++i) {
+    for (auto* op : program.Block(i).AllOps()) {
+      if (op->GetAttrIfExists<std::string>(operators::math::kPackedWeightAttr)
+              .empty()) {
+        continue;
+      }
+      std::string slot = PackableGemmWeightSlot(*op);
+      if (slot.empty() || op->Input(slot).size() != 1) continue;
+      PackWeightOf(*op, op->Input(slot)[0], scope);
+    }
+  }
+}
+
+void ReleasePackedGemmWeights(const ProgramDesc& program, Scope* scope) {
+  // whether every op reading a variable reads its packed copy instead
+  std::unordered_map<std::string, bool> read_packed;
+  for (size_t i = 0; i < program.Size(); ++i) {
+    for (auto* op : program.Block(i).AllOps()) {
+      std::string weight_name;
+      const auto& packed_name =
+          op->GetAttrIfExists<std::string>(operators::math::kPackedWeightAttr);
+      std::string slot = PackableGemmWeightSlot(*op);
+      if (!packed_name.empty() && !slot.empty() &&
+          op->Input(slot).size() == 1 &&
+          scope->FindLocalVar(packed_name) != nullptr) {
+        weight_name = op->Input(slot)[0];
+      }
+      for (auto& name : op->InputArgumentNames()) {
+        auto iter = read_packed.emplace(name, true).first;
+        iter->second = iter->second && name == weight_name;
+      }
+      for (auto& name : op->OutputArgumentNames()) {
+        read_packed[name] = false;
+      }
+    }
+  }
+
+  int64_t num_released = 0;
+  for (auto& var : read_packed) {
+    if (!var.second) continue;
+    auto* weight_var = scope->FindLocalVar(var.first);
+    if (weight_var == nullptr || !weight_var->IsType<LoDTensor>()) continue;
+    auto* weight = weight_var->GetMutable<LoDTensor>();
+    if (!weight->IsInitialized()) continue;
+    num_released += weight->memory_size();
+    weight->clear();
+  }
+  VLOG(3) << "Release " << num_released
+          << " bytes of the weights replaced by packed copies";
+}
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
+
+REGISTER_PASS(gemm_weight_pack_pass,
+              paddle::framework::ir::GemmWeightPackPass);
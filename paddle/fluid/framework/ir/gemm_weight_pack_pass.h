@@ -0,0 +1,67 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <string>
+
+#include "paddle/fluid/framework/ir/fuse_pass_base.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/fluid/framework/scope.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+class Graph;
+class Node;
+
+/*
+ * Pre-packs the persistable weights of fc, mul and matmul ops into the MKL
+ * packed GEMM layout, so that the kernels skip packing the constant matrix
+ * on every run. The packed buffer is stored next to the weight in the
+ * parameter scope as "<weight>@GEMM_PACKED" and its name is recorded in
+ * the op's "packed_weight" attribute. Predictors cloned from the same
+ * scope share the packed buffers.
+ *
+ * The weights must not change after the pass runs, which holds for
+ * inference. A later pass may still turn an op into one that reads the
+ * original weight, so the weights are only released by
+ * ReleasePackedGemmWeights once the program is final.
+ */
+class GemmWeightPackPass : public FusePassBase {
+ public:
+  virtual ~GemmWeightPackPass() {}
+
+ protected:
+  void ApplyImpl(Graph* graph) const override;
+};
+
+// Returns the input slot of the weight if the op can use a packed weight,
+// or an empty string. The kernels check the same conditions at run time.
+std::string PackableGemmWeightSlot(const OpDesc& op);
+
+// Packs the weights of the ops tagged by the pass whose packed copies are
+// not in `scope`, e.g. for a program loaded with its persistables from the
+// optim cache of a predictor.
+void PackGemmWeights(const ProgramDesc& program, Scope* scope);
+
+// Releases the memory of the weights that are only read through their
+// packed copies, so that a weight is not held twice. The released tensors
+// keep their dims for the shape inference of the ops.
+void ReleasePackedGemmWeights(const ProgramDesc& program, Scope* scope);
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,154 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/ir/gemm_weight_pack_pass.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "paddle/fluid/framework/ir/pass_tester_helper.h"
+#include "paddle/fluid/operators/math/gemm_pack.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+static float* AddVarToScope(Scope* param_scope, const std::string& name,
+                            const DDim& dims) {
+  auto* tensor = param_scope->Var(name)->GetMutable<LoDTensor>();
+  tensor->Resize(dims);
+  auto* data = tensor->mutable_data<float>(platform::CPUPlace());
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (int64_t i = 0; i < tensor->numel(); ++i) data[i] = dist(rng);
+  return data;
+}
+
+static const OpDesc* FindOp(const Graph& graph, const std::string& type) {
+  for (auto* node : graph.Nodes()) {
+    if (node->IsOp() && node->Op()->Type() == type) return node->Op();
+  }
+  return nullptr;
+}
+
+TEST(GemmWeightPackPass, basic) {
+  // inputs                     operator            output
+  // --------------------------------------------------------
+  // (a, weights_0, bias_0)     fc               -> fc_out
+  // (fc_out, weights_1)        mul              -> mul_out
+  // (mul_out, b)               matmul           -> matmul_out
+  const int M = 3, K = 16, N = 8;
+  Layers layers;
+  auto* a = layers.data("a", {M, K});
+  auto* weights_0 = layers.data("weights_0", {K, N}, true);
+  auto* bias_0 = layers.data("bias_0", {N}, true);
+  auto* fc_out = layers.fc(a, weights_0, bias_0);
+  auto* weights_1 = layers.data("weights_1", {N, N}, true);
+  auto* mul_out = layers.mul(fc_out, weights_1);
+  auto* b = layers.data("b", {N, N});
+  layers.matmul(mul_out, b);
+
+  Scope param_scope;
+  const float* w0 = AddVarToScope(&param_scope, "weights_0", {K, N});
+  AddVarToScope(&param_scope, "bias_0", {N});
+  AddVarToScope(&param_scope, "weights_1", {N, N});
+
+  std::unique_ptr<ir::Graph> graph(new ir::Graph(layers.main_program()));
+  graph->SetNotOwned(kParamScopeAttr, &param_scope);
+  auto pass = PassRegistry::Instance().Get("gemm_weight_pack_pass");
+  graph.reset(pass->Apply(graph.release()));
+
+  auto packed_attr = [&](const std::string& type) {
+    return FindOp(*graph, type)->GetAttrIfExists<std::string>(
+        operators::math::kPackedWeightAttr);
+  };
+  // The non-persistable Y of matmul is never packed.
+  EXPECT_EQ(packed_attr("matmul"), "");
+  if (!operators::math::GemmPackSupported()) {
+    EXPECT_EQ(packed_attr("fc"), "");
+    EXPECT_EQ(packed_attr("mul"), "");
+    return;
+  }
+  EXPECT_EQ(packed_attr("fc"), "weights_0@GEMM_PACKED");
+  EXPECT_EQ(packed_attr("mul"), "weights_1@GEMM_PACKED");
+
+  // The packed weight gives the same product as the plain one.
+  auto* packed_var = param_scope.FindLocalVar("weights_0@GEMM_PACKED");
+  ASSERT_NE(packed_var, nullptr);
+  const float* packed = packed_var->Get<LoDTensor>().data<float>();
+  std::vector<float> x(M * K), y(M * N);
+  for (int i = 0; i < M * K; ++i) x[i] = static_cast<float>(i % 7) - 3.f;
+  auto* dev_ctx = static_cast<platform::CPUDeviceContext*>(
+      platform::DeviceContextPool::Instance().Get(platform::CPUPlace()));
+  operators::math::PackedGemm<float>(*dev_ctx, M, N, K, x.data(), packed,
+                                     y.data());
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      float ref = 0.f;
+      for (int k = 0; k < K; ++k) ref += x[i * K + k] * w0[k * N + j];
+      EXPECT_NEAR(y[i * N + j], ref, 1e-4);
+    }
+  }
+}
+
+TEST(GemmWeightPackPass, PackAndReleaseProgramWeights) {
+  // inputs                     operator            output
+  // --------------------------------------------------------
+  // (a, weights_0, bias_0)     fc               -> fc_out
+  // (fc_out, weights_1)        mul              -> mul_out
+  // (mul_out, weights_1)       matmul           -> matmul_out
+  const int M = 3, K = 16, N = 8;
+  Layers layers;
+  auto* a = layers.data("a", {M, K});
+  auto* weights_0 = layers.data("weights_0", {K, N}, true);
+  auto* bias_0 = layers.data("bias_0", {N}, true);
+  auto* fc_out = layers.fc(a, weights_0, bias_0);
+  auto* weights_1 = layers.data("weights_1", {N, N}, true);
+  auto* mul_out = layers.mul(fc_out, weights_1);
+  layers.matmul(mul_out, weights_1);
+
+  Scope param_scope;
+  AddVarToScope(&param_scope, "weights_0", {K, N});
+  AddVarToScope(&param_scope, "bias_0", {N});
+  AddVarToScope(&param_scope, "weights_1", {N, N});
+  if (!operators::math::GemmPackSupported()) return;
+
+  // The program is tagged as by the pass, and the matmul scaled by a later
+  // pass, so it reads the original weights_1 at run time.
+  auto* program = layers.main_program();
+  for (auto* op : program->MutableBlock(0)->AllOps()) {
+    std::string weight = op->Type() == "fc" ? "weights_0" : "weights_1";
+    op->SetAttr(operators::math::kPackedWeightAttr,
+                weight + operators::math::kGemmPackedWeightSuffix);
+    if (op->Type() == "matmul") op->SetAttr("alpha", 2.0f);
+  }
+  PackGemmWeights(*program, &param_scope);
+  EXPECT_NE(param_scope.FindLocalVar("weights_0@GEMM_PACKED"), nullptr);
+  EXPECT_NE(param_scope.FindLocalVar("weights_1@GEMM_PACKED"), nullptr);
+
+  ReleasePackedGemmWeights(*program, &param_scope);
+  auto& released = param_scope.FindLocalVar("weights_0")->Get<LoDTensor>();
+  EXPECT_FALSE(released.IsInitialized());
+  EXPECT_EQ(released.dims(), make_ddim({K, N}));
+  EXPECT_TRUE(
+      param_scope.FindLocalVar("weights_1")->Get<LoDTensor>().IsInitialized());
+  EXPECT_TRUE(
+      param_scope.FindLocalVar("bias_0")->Get<LoDTensor>().IsInitialized());
+}
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
+
+USE_PASS(gemm_weight_pack_pass);
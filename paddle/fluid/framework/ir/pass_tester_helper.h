@@ -327,6 +327,19 @@ struct Layers {
     return out;
   }
 
+  VarDesc* fill_constant(
+      std::vector<int64_t> shape, float value,
+      proto::VarType::Type data_type = proto::VarType::FP32) {
+    VarDesc* out = lod_tensor(unique_name(), shape, false, data_type);
+    OpDesc* op = program_.MutableBlock(0)->AppendOp();
+    op->SetType("fill_constant");
+    op->SetAttr("shape", shape);
+    op->SetAttr("value", value);
+    op->SetAttr("dtype", static_cast<int>(data_type));
+    op->SetOutput("Out", {out->Name()});
+    return out;
+  }
+
   std::vector<VarDesc*> batch_norm(VarDesc* x, VarDesc* scale, VarDesc* bias,
                                    VarDesc* mean, VarDesc* variance) {
     VarDesc* y = lod_tensor(unique_name());
@@ -0,0 +1,253 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/ir/redundant_op_elimination_pass.h"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/framework/ir/graph_helper.h"
+#include "paddle/fluid/framework/op_proto_maker.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+namespace {
+
+// The ops with random results or effects besides their outputs. The random
+// ops with a "seed" attribute and the collective ops with a "ring_id"
+// attribute are recognized by it.
+const std::unordered_set<std::string> kImpureOps = {
+    "feed",          "fetch",           "dropout",       "randperm",
+    "sampling_id",   "bernoulli",       "multinomial",   "print",
+    "save",          "load",            "save_combine",  "load_combine",
+    "read",          "py_func",         "assert",        "increment",
+    "send",          "recv",            "send_barrier",  "fetch_barrier",
+    "enqueue",       "dequeue",         "share_buffer",  "share_data",
+    "coalesce_tensor", "listen_and_serv"};
+
+// The attributes that do not change the results of an op.
+const std::unordered_set<std::string> kIgnoredAttrs = {
+    OpProtoAndCheckerMaker::OpCreationCallstackAttrName(),
+    OpProtoAndCheckerMaker::OpNamescopeAttrName(),
+    OpProtoAndCheckerMaker::OpRoleVarAttrName()};
+
+bool HasBlockAttr(const OpDesc& op) {
+  for (auto& attr : op.GetAttrMap()) {
+    if (attr.second.type() == typeid(BlockDesc*) ||
+        attr.second.type() == typeid(std::vector<BlockDesc*>)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Node* FindVarNode(const std::vector<Node*>& nodes, const std::string& name) {
+  for (auto* node : nodes) {
+    if (node->Name() == name) return node;
+  }
+  return nullptr;
+}
+
+void RemoveLink(std::vector<Node*>* nodes, const Node* node) {
+  nodes->erase(std::remove(nodes->begin(), nodes->end(), node), nodes->end());
+}
+
+}  // namespace
+
+bool RedundantOpEliminationPass::IsPure(const Node* node) const {
+  auto* op = node->Op();
+  if (op == nullptr || kImpureOps.count(op->Type()) || op->HasAttr("seed") ||
+      op->HasAttr("ring_id") || HasBlockAttr(*op)) {
+    return false;
+  }
+  return !node->outputs.empty();
+}
+
+std::string RedundantOpEliminationPass::OpKey(const Node* node) const {
+  auto* op = node->Op();
+  std::ostringstream key;
+  key << op->Type();
+  // the inputs are told apart by their nodes, i.e. the versions of the
+  // variables
+  for (auto& slot : op->Inputs()) {
+    key << "|" << slot.first << ":";
+    for (auto& name : slot.second) {
+      auto* var = FindVarNode(node->inputs, name);
+      if (var != nullptr) {
+        key << var->id() << ",";
+      } else {
+        key << "#" << name << ",";
+      }
+    }
+  }
+  for (auto& slot : op->Outputs()) {
+    key << "|" << slot.first << ":" << slot.second.size();
+  }
+  std::map<std::string, std::string> attrs;
+  for (auto& attr : op->Proto()->attrs()) {
+    if (!kIgnoredAttrs.count(attr.name())) {
+      attrs[attr.name()] = attr.SerializeAsString();
+    }
+  }
+  for (auto& attr : attrs) {
+    key << "|" << attr.first << ":" << attr.second.size() << ":"
+        << attr.second;
+  }
+  return key.str();
+}
+
+int RedundantOpEliminationPass::EliminateCommonOps(Graph* graph) const {
+  std::unordered_map<std::string, int> num_writes;
+  for (auto* node : graph->Nodes()) {
+    if (!node->IsOp()) continue;
+    for (auto* out : node->outputs) {
+      ++num_writes[out->Name()];
+    }
+  }
+  // An op can only be merged when nothing else writes its outputs.
+  auto has_own_outputs = [&](const Node* node) {
+    for (auto* out : node->outputs) {
+      if (out->Var() == nullptr || out->Var()->Persistable() ||
+          num_writes[out->Name()] != 1) {
+        return false;
+      }
+    }
+    return true;
+  };
+  // The readers of the outputs are switched to other variables, which the
+  // fetch ops and the sub-blocks referring to the outputs by name do not
+  // allow.
+  auto can_rename_outputs = [](const Node* node) {
+    for (auto* out : node->outputs) {
+      for (auto* reader : out->outputs) {
+        if (reader->Op() == nullptr || reader->Op()->Type() == "fetch" ||
+            HasBlockAttr(*reader->Op())) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+
+  std::unordered_map<std::string, Node*> first_ops;
+  int num_removed = 0;
+  for (auto* node : TopologySortOperations(*graph)) {
+    if (!IsPure(node) || !has_own_outputs(node) ||
+        node->Op()->GetAttrIfExists<int>(
+            OpProtoAndCheckerMaker::OpRoleAttrName()) !=
+            static_cast<int>(OpRole::kForward)) {
+      continue;
+    }
+    // the key is computed after the inputs of node are merged
+    auto it = first_ops.emplace(OpKey(node), node).first;
+    Node* first = it->second;
+    if (first == node || !can_rename_outputs(node)) continue;
+
+    // (output of node, the same output of first)
+    std::vector<std::pair<Node*, Node*>> outputs;
+    for (auto& slot : node->Op()->Outputs()) {
+      auto& first_names = first->Op()->Output(slot.first);
+      for (size_t i = 0; i < slot.second.size(); ++i) {
+        outputs.emplace_back(FindVarNode(node->outputs, slot.second[i]),
+                             FindVarNode(first->outputs, first_names[i]));
+      }
+    }
+    bool found = outputs.size() == node->outputs.size();
+    for (auto& pair : outputs) {
+      found = found && pair.first != nullptr && pair.second != nullptr;
+    }
+    if (!found) continue;
+
+    VLOG(4) << "Replace the outputs of " << node->Op()->Type() << " by those of"
+            << " the identical op before it.";
+    for (auto& pair : outputs) {
+      Node* out = pair.first;
+      Node* first_out = pair.second;
+      for (auto* reader : out->outputs) {
+        reader->Op()->RenameInput(out->Name(), first_out->Name());
+        RemoveLink(&reader->inputs, out);
+        if (std::find(reader->inputs.begin(), reader->inputs.end(),
+                      first_out) == reader->inputs.end()) {
+          reader->inputs.push_back(first_out);
+          first_out->outputs.push_back(reader);
+        }
+      }
+      graph->RemoveNode(out);
+    }
+    for (auto* in : node->inputs) {
+      RemoveLink(&in->outputs, node);
+    }
+    graph->RemoveNode(node);
+    ++num_removed;
+  }
+  return num_removed;
+}
+
+int RedundantOpEliminationPass::EliminateDeadOps(Graph* graph) const {
+  int num_removed = 0;
+  auto ops = TopologySortOperations(*graph);
+  // the readers are removed before the ops writing their inputs
+  for (auto it = ops.rbegin(); it != ops.rend(); ++it) {
+    Node* node = *it;
+    if (!IsPure(node)) continue;
+    bool dead = true;
+    for (auto* out : node->outputs) {
+      dead = dead && out->Var() != nullptr && !out->Var()->Persistable() &&
+             out->outputs.empty();
+    }
+    if (!dead) continue;
+
+    VLOG(4) << "Remove " << node->Op()->Type() << " whose outputs are unused.";
+    for (auto* out : node->outputs) {
+      graph->RemoveNode(out);
+    }
+    for (auto* in : node->inputs) {
+      RemoveLink(&in->outputs, node);
+    }
+    graph->RemoveNode(node);
+    ++num_removed;
+  }
+  return num_removed;
+}
+
+void RedundantOpEliminationPass::ApplyImpl(Graph* graph) const {
+  PADDLE_ENFORCE_NOT_NULL(
+      graph, platform::errors::InvalidArgument("Graph cannot be nullptr."));
+  Init("redundant_op_elimination_pass", graph);
+
+  int num_common = EliminateCommonOps(graph);
+  bool has_fetch = false;
+  for (auto* node : graph->Nodes()) {
+    has_fetch = has_fetch || (node->IsOp() && node->Op() != nullptr &&
+                              node->Op()->Type() == "fetch");
+  }
+  int num_dead = has_fetch ? EliminateDeadOps(graph) : 0;
+  VLOG(3) << "redundant_op_elimination_pass removes " << num_common
+          << " common ops and " << num_dead << " dead ops.";
+  AddStatis(num_common + num_dead);
+}
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
+
+REGISTER_PASS(redundant_op_elimination_pass,
+              paddle::framework::ir::RedundantOpEliminationPass);
@@ -0,0 +1,65 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "paddle/fluid/framework/ir/fuse_pass_base.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+class Graph;
+class Node;
+
+/*
+ * Removes the ops whose results are already computed or never used.
+ *
+ * Common-subexpression elimination: two forward ops of the same type, with
+ * the same attributes and reading the same versions of the same variables,
+ * compute the same outputs, so the consumers of the later one are switched
+ * to the outputs of the earlier one and the later one is removed. The
+ * outputs fetched by name are kept.
+ *
+ * Dead-op elimination: the ops none of whose outputs are read are removed,
+ * from the last op to the first. It only runs when the graph contains the
+ * fetch ops, i.e. when every result the user can ask for is known, which is
+ * the case for inference programs but not for the graphs of
+ * ParallelExecutor.
+ *
+ * Ops with random results, side effects or sub-blocks are never removed.
+ */
+class RedundantOpEliminationPass : public FusePassBase {
+ public:
+  virtual ~RedundantOpEliminationPass() {}
+
+ protected:
+  void ApplyImpl(Graph* graph) const override;
+
+ private:
+  // Whether the outputs of op only depend on its inputs and attributes, and
+  // it has no other effect than writing them.
+  bool IsPure(const Node* op) const;
+  // The key of op that is equal for the ops computing the same outputs.
+  std::string OpKey(const Node* op) const;
+
+  int EliminateCommonOps(Graph* graph) const;
+  int EliminateDeadOps(Graph* graph) const;
+};
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
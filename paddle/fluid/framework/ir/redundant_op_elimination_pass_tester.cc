@@ -0,0 +1,126 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/ir/redundant_op_elimination_pass.h"
+
+#include <gtest/gtest.h>
+#include "paddle/fluid/framework/ir/pass_tester_helper.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+namespace {
+
+void AddFetch(ProgramDesc* program, VarDesc* var, int col) {
+  auto* block = program->MutableBlock(0);
+  block->Var("fetch")->SetType(proto::VarType::FETCH_LIST);
+  auto* op = block->AppendOp();
+  op->SetType("fetch");
+  op->SetInput("X", {var->Name()});
+  op->SetOutput("Out", {"fetch"});
+  op->SetAttr("col", col);
+}
+
+int GetStatis(const std::unique_ptr<Graph>& graph) {
+  return graph->Get<std::unordered_map<std::string, int>>(
+      kFuseStatisAttr)["redundant_op_elimination_pass"];
+}
+
+}  // namespace
+
+TEST(RedundantOpEliminationPass, common_ops) {
+  // inputs                     operator            output
+  // --------------------------------------------------------
+  // (x)                        scale            -> a
+  // (x)                        scale            -> b, same as a
+  // (x)                        scale            -> c, another scale
+  // (a)                        relu             -> e
+  // (b)                        relu             -> f, same as e
+  // (e, f)                     elementwise_add  -> g
+  // (x)                        dropout          -> d1
+  // (x)                        dropout          -> d2, random
+  Layers layers;
+  auto* x = layers.data("x", {2, 4});
+  auto* a = layers.scale(x, 2.0f, 0.0f, true);
+  auto* b = layers.scale(x, 2.0f, 0.0f, true);
+  layers.scale(x, 3.0f, 0.0f, true);
+  auto* e = layers.relu(a);
+  auto* f = layers.relu(b);
+  layers.elementwise_add(e, f);
+  layers.dropout(x, 0.5f, "upscale_in_train");
+  layers.dropout(x, 0.5f, "upscale_in_train");
+
+  std::unique_ptr<ir::Graph> graph(new ir::Graph(layers.main_program()));
+  auto pass = PassRegistry::Instance().Get("redundant_op_elimination_pass");
+  int num_nodes_before = graph->Nodes().size();
+  VLOG(3) << DebugString(graph);
+
+  graph.reset(pass->Apply(graph.release()));
+  int num_nodes_after = graph->Nodes().size();
+  VLOG(3) << DebugString(graph);
+
+  // the second scale and relu, b and f are removed, nothing is dead
+  // without the fetch ops
+  EXPECT_EQ(num_nodes_before, num_nodes_after + 4);
+  EXPECT_EQ(GetNumOpNodes(graph, "scale"), 2);
+  EXPECT_EQ(GetNumOpNodes(graph, "relu"), 1);
+  EXPECT_EQ(GetNumOpNodes(graph, "dropout"), 2);
+  EXPECT_EQ(GetStatis(graph), 2);
+  for (auto* node : graph->Nodes()) {
+    if (node->IsOp() && node->Op()->Type() == "elementwise_add") {
+      EXPECT_EQ(node->Op()->Input("X"), std::vector<std::string>{e->Name()});
+      EXPECT_EQ(node->Op()->Input("Y"), std::vector<std::string>{e->Name()});
+      ASSERT_EQ(node->inputs.size(), 1UL);
+      EXPECT_EQ(node->inputs[0]->Name(), e->Name());
+    }
+  }
+}
+
+TEST(RedundantOpEliminationPass, dead_ops) {
+  // inputs                     operator            output
+  // --------------------------------------------------------
+  // (x)                        scale            -> a
+  // (x)                        scale            -> b, same as a, fetched
+  // (a)                        relu             -> c, unused
+  // (c)                        sigmoid          -> d, unused
+  // (a, b)                     elementwise_add  -> out, fetched
+  Layers layers;
+  auto* x = layers.data("x", {2, 4});
+  auto* a = layers.scale(x, 2.0f, 0.0f, true);
+  auto* b = layers.scale(x, 2.0f, 0.0f, true);
+  layers.sigmoid(layers.relu(a));
+  auto* out = layers.elementwise_add(a, b);
+  ProgramDesc program(layers.main_program());
+  AddFetch(&program, out, 0);
+  AddFetch(&program, b, 1);
+
+  std::unique_ptr<ir::Graph> graph(new ir::Graph(program));
+  auto pass = PassRegistry::Instance().Get("redundant_op_elimination_pass");
+  graph.reset(pass->Apply(graph.release()));
+  VLOG(3) << DebugString(graph);
+
+  EXPECT_EQ(GetNumOpNodes(graph, "scale"), 2);
+  EXPECT_EQ(GetNumOpNodes(graph, "relu"), 0);
+  EXPECT_EQ(GetNumOpNodes(graph, "sigmoid"), 0);
+  EXPECT_EQ(GetNumOpNodes(graph, "elementwise_add"), 1);
+  EXPECT_EQ(GetNumOpNodes(graph, "fetch"), 2);
+  EXPECT_EQ(GetStatis(graph), 2);
+}
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
+
+USE_PASS(redundant_op_elimination_pass);
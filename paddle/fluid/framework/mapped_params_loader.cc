@@ -0,0 +1,134 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/mapped_params_loader.h"
+
+#include <cstring>
+#include <memory>
+
+#include "paddle/fluid/framework/version.h"
+#include "paddle/fluid/memory/allocation/mmap_allocator.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+// Reads the fields of a mapped file in order.
+class MappedFileReader {
+ public:
+  explicit MappedFileReader(
+      const memory::allocation::MemoryMapFileAllocation &file)
+      : data_(static_cast<const char *>(file.ptr())),
+        size_(file.size()),
+        path_(file.path()) {}
+
+  // Returns the next size bytes and moves past them.
+  const char *Skip(size_t size) {
+    PADDLE_ENFORCE_LE(
+        size, size_ - offset_,
+        platform::errors::Unavailable(
+            "An error occurred while loading model parameters from %s. "
+            "Please check whether the model file is complete or damaged.",
+            path_));
+    const char *data = data_ + offset_;
+    offset_ += size;
+    return data;
+  }
+
+  template <typename T>
+  T Read() {
+    T value;
+    std::memcpy(&value, Skip(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  size_t offset() const { return offset_; }
+  bool eof() const { return offset_ == size_; }
+
+ private:
+  const char *data_;
+  size_t size_;
+  std::string path_;
+  size_t offset_{0};
+};
+
+}  // namespace
+
+size_t LoadCombinedFromMappedFile(const std::string &file_path,
+                                  const std::vector<LoDTensor *> &tensors) {
+  auto file = memory::allocation::AllocateMemoryMapFileAllocation(file_path);
+  MappedFileReader reader(*file);
+  size_t num_shared = 0;
+  for (auto *tensor : tensors) {
+    // the fields written by SerializeToStream and TensorToStream
+    uint32_t version = reader.Read<uint32_t>();
+    PADDLE_ENFORCE_EQ(IsTensorVersionSupported(version), true,
+                      platform::errors::InvalidArgument(
+                          "Tensor version %u is not supported.", version));
+    uint64_t lod_level = reader.Read<uint64_t>();
+    auto &lod = *tensor->mutable_lod();
+    lod.resize(lod_level);
+    for (uint64_t i = 0; i < lod_level; ++i) {
+      uint64_t size = reader.Read<uint64_t>();
+      const char *data = reader.Skip(size);
+      lod[i].resize(size / sizeof(size_t));
+      std::memcpy(lod[i].data(), data, lod[i].size() * sizeof(size_t));
+    }
+
+    version = reader.Read<uint32_t>();
+    PADDLE_ENFORCE_EQ(
+        version, 0U,
+        platform::errors::InvalidArgument(
+            "tensor version %u is not supported, Only version 0 is supported",
+            version));
+    int32_t desc_size = reader.Read<int32_t>();
+    PADDLE_ENFORCE_GE(desc_size, 0, platform::errors::InvalidArgument(
+                                        "Cannot parse tensor desc"));
+    proto::VarType::TensorDesc desc;
+    PADDLE_ENFORCE_EQ(
+        desc.ParseFromArray(reader.Skip(desc_size), desc_size), true,
+        platform::errors::InvalidArgument("Cannot parse tensor desc"));
+
+    std::vector<int64_t> dims(desc.dims().begin(), desc.dims().end());
+    tensor->clear();
+    tensor->Resize(make_ddim(dims));
+    size_t size_of_type = SizeOfType(desc.data_type());
+    size_t bytes = tensor->numel() * size_of_type;
+    size_t offset = reader.offset();
+    const char *data = reader.Skip(bytes);
+    if (bytes > 0 && offset % size_of_type == 0) {
+      tensor->ResetHolderWithType(
+          std::make_shared<memory::allocation::MemoryMapRegionAllocation>(
+              file, offset, bytes),
+          desc.data_type());
+      ++num_shared;
+    } else {
+      // misaligned data is copied, the kernels expect aligned elements
+      void *dst = tensor->mutable_data(platform::CPUPlace(), desc.data_type());
+      std::memcpy(dst, data, bytes);
+    }
+  }
+  PADDLE_ENFORCE_EQ(reader.eof(), true,
+                    platform::errors::Unavailable(
+                        "Not allowed to load partial data from %s, it has "
+                        "more variables than the %d to load.",
+                        file_path, tensors.size()));
+  VLOG(3) << "Load " << tensors.size() << " variables from " << file_path
+          << ", " << num_shared << " of them share the mapped file";
+  return num_shared;
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,37 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/lod_tensor.h"
+
+namespace paddle {
+namespace framework {
+
+// Loads the variables saved by save_combine in file_path into the CPU
+// tensors, in order. The file is mapped into memory instead of read, and a
+// tensor whose data is aligned in the file shares the memory of the mapping
+// rather than holding a copy, so the predictors of one model on a host
+// share the page cache for its weights. A tensor written later gets private
+// copies of the pages it writes.
+//
+// Returns the number of tensors sharing the mapping.
+size_t LoadCombinedFromMappedFile(const std::string &file_path,
+                                  const std::vector<LoDTensor *> &tensors);
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,126 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/mapped_params_loader.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/platform/timer.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+std::string SaveCombined(const std::string &path,
+                         const std::vector<LoDTensor> &tensors) {
+  auto &dev_ctx =
+      *platform::DeviceContextPool::Instance().Get(platform::CPUPlace());
+  std::ofstream fout(path, std::ios::binary);
+  for (auto &tensor : tensors) {
+    SerializeToStream(fout, tensor, dev_ctx);
+  }
+  return path;
+}
+
+}  // namespace
+
+TEST(LoadCombinedFromMappedFile, ShareAlignedTensors) {
+  std::vector<LoDTensor> saved(3);
+  float *w = saved[0].mutable_data<float>({4, 8}, platform::CPUPlace());
+  for (int i = 0; i < 32; ++i) w[i] = i;
+  saved[0].set_lod({{0, 1, 4}});
+  int64_t *ids = saved[1].mutable_data<int64_t>({3}, platform::CPUPlace());
+  ids[0] = 7;
+  ids[1] = 8;
+  ids[2] = 9;
+  saved[2].mutable_data<float>({0}, platform::CPUPlace());
+  auto path = SaveCombined("mapped_params_loader_test_params", saved);
+
+  std::vector<LoDTensor> loaded(3);
+  size_t num_shared = LoadCombinedFromMappedFile(
+      path, {&loaded[0], &loaded[1], &loaded[2]});
+  EXPECT_LE(num_shared, 2UL);
+  EXPECT_EQ(loaded[0].dims(), make_ddim({4, 8}));
+  EXPECT_EQ(loaded[0].lod(), saved[0].lod());
+  EXPECT_EQ(loaded[0].data<float>()[31], 31);
+  EXPECT_EQ(loaded[1].data<int64_t>()[2], 9);
+  EXPECT_EQ(loaded[2].numel(), 0);
+
+  // writes go to private pages, the file is unchanged
+  loaded[0].mutable_data<float>(platform::CPUPlace())[31] = -1;
+  loaded[1].mutable_data<int64_t>(platform::CPUPlace())[2] = -1;
+  std::vector<LoDTensor> reloaded(3);
+  LoadCombinedFromMappedFile(path, {&reloaded[0], &reloaded[1], &reloaded[2]});
+  EXPECT_EQ(reloaded[0].data<float>()[31], 31);
+  EXPECT_EQ(reloaded[1].data<int64_t>()[2], 9);
+
+  // the tensors keep the mapping alive
+  loaded.clear();
+  EXPECT_EQ(reloaded[1].data<int64_t>()[0], 7);
+}
+
+TEST(LoadCombinedFromMappedFile, RejectDamagedFile) {
+  std::vector<LoDTensor> saved(2);
+  saved[0].mutable_data<float>({16}, platform::CPUPlace());
+  saved[1].mutable_data<float>({16}, platform::CPUPlace());
+  auto path = SaveCombined("mapped_params_loader_test_damaged", saved);
+
+  LoDTensor a, b, c;
+  // more variables than saved
+  EXPECT_ANY_THROW(LoadCombinedFromMappedFile(path, {&a, &b, &c}));
+  // fewer variables than saved
+  EXPECT_ANY_THROW(LoadCombinedFromMappedFile(path, {&a}));
+  EXPECT_ANY_THROW(LoadCombinedFromMappedFile("not_exist_params", {&a}));
+}
+
+TEST(LoadCombinedFromMappedFile, CompareWithStream) {
+  const int num_params = 16;
+  std::vector<LoDTensor> saved(num_params);
+  for (auto &tensor : saved) {
+    tensor.mutable_data<float>({1024, 1024}, platform::CPUPlace());
+  }
+  auto path = SaveCombined("mapped_params_loader_test_large", saved);
+
+  auto &dev_ctx =
+      *platform::DeviceContextPool::Instance().Get(platform::CPUPlace());
+  platform::Timer timer;
+  timer.Start();
+  std::vector<LoDTensor> streamed(num_params);
+  std::ifstream fin(path, std::ios::binary);
+  for (auto &tensor : streamed) {
+    DeserializeFromStream(fin, &tensor, dev_ctx);
+  }
+  double stream_ms = timer.ElapsedMS();
+
+  timer.Reset();
+  timer.Start();
+  std::vector<LoDTensor> mapped(num_params);
+  std::vector<LoDTensor *> outputs;
+  for (auto &tensor : mapped) {
+    outputs.push_back(&tensor);
+  }
+  size_t num_shared = LoadCombinedFromMappedFile(path, outputs);
+  double mapped_ms = timer.ElapsedMS();
+  LOG(INFO) << "Load 64MB of parameters, " << stream_ms << "ms from stream, "
+            << mapped_ms << "ms by mapping with " << num_shared << " of "
+            << num_params << " tensors shared";
+  EXPECT_GT(num_shared, 0UL);
+}
+
+}  // namespace framework
+}  // namespace paddle
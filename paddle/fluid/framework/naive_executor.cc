@@ -21,6 +21,8 @@
 #include "paddle/fluid/platform/mkldnn_helper.h"
 #endif
 
+DECLARE_bool(cache_runtime_context);
+
 namespace paddle {
 namespace framework {
 void NaiveExecutor::Prepare(Scope *scope, const ProgramDesc &program_desc,
@@ -100,6 +102,10 @@ void NaiveExecutor::CreateOps(const ProgramDesc &desc, int block_id,
       continue;
     }
     ops_.emplace_back(OpRegistry::CreateOp(*op_desc));
+    // the ops always run in scope_
+    if (FLAGS_cache_runtime_context) {
+      ops_.back()->SetCacheRuntimeContext(true);
+    }
   }
 }
 
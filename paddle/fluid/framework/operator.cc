@@ -15,6 +15,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/operator.h"
 
 #include <glog/logging.h>
+#include <chrono>  // NOLINT
 #include <sstream>
 #include <string>
 
@@ -29,6 +30,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/var_type.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/profiler.h"
+#include "paddle/fluid/platform/roofline.h"
 
 namespace paddle {
 namespace framework {
@@ -61,6 +63,21 @@ std::vector<std::tuple<platform::Place, LibraryType>> kKernelPriority = {
     std::make_tuple(platform::CPUPlace(), LibraryType::kPlain),
 };
 
+// The bytes of the initialized LoDTensors in vars.
+static double TensorBytes(const VariableValueMap& vars) {
+  double bytes = 0;
+  for (auto& pair : vars) {
+    for (auto* var : pair.second) {
+      if (var == nullptr || !var->IsType<LoDTensor>()) continue;
+      auto& tensor = var->Get<LoDTensor>();
+      if (tensor.IsInitialized()) {
+        bytes += tensor.numel() * SizeOfType(tensor.type());
+      }
+    }
+  }
+  return bytes;
+}
+
 static DDim GetDimsDebug(const Scope& scope, const std::string& name,
                          bool get_actual_dim = false) {
   Variable* var = scope.FindVar(name);
@@ -1065,6 +1082,13 @@ void OperatorWithKernel::RuntimeInferShape(const Scope& scope,
   this->InferShape(&infer_shape_ctx);
 }
 
+void OperatorWithKernel::SetCacheRuntimeContext(bool enable) {
+  std::lock_guard<std::mutex> lock(cache_update_mutex_);
+  enable_cache_runtime_context_ = enable;
+  runtime_ctx_.reset();
+  pre_scope_ = nullptr;
+}
+
 void OperatorWithKernel::RunImpl(const Scope& scope,
                                  const platform::Place& place) const {
   // To reduce the elapsed time of HasAttr, we use bool variable to record the
@@ -1080,11 +1104,21 @@ void OperatorWithKernel::RunImpl(const Scope& scope,
     RunImpl(scope, place, &ctx);
     pre_scope_ = cur_scope;
   } else {
-    if (runtime_ctx_.get() == nullptr || pre_scope_ != cur_scope) {
+    // the address of a released scope may be reused, the cached variables
+    // are gone once erased or renamed and may be shadowed by new ones, hence
+    // also check the ID and epoch
+    uint64_t vars_epoch = scope.VarsEpoch();
+    auto is_cached = [&] {
+      return runtime_ctx_.get() != nullptr && pre_scope_ == cur_scope &&
+             pre_scope_id_ == scope.ID() && pre_vars_epoch_ == vars_epoch;
+    };
+    if (!is_cached()) {
       std::lock_guard<std::mutex> lock(cache_update_mutex_);
-      if (runtime_ctx_.get() == nullptr || pre_scope_ != cur_scope) {
+      if (!is_cached()) {
         runtime_ctx_.reset(new RuntimeContext(Inputs(), Outputs(), scope));
         pre_scope_ = cur_scope;
+        pre_scope_id_ = scope.ID();
+        pre_vars_epoch_ = vars_epoch;
       }
     }
     RunImpl(scope, place, runtime_ctx_.get());
@@ -1136,8 +1170,25 @@ void OperatorWithKernel::RunImpl(const Scope& scope,
   {
     platform::RecordEvent record_event("compute",
                                        platform::EventRole::kInnerOp);
-    (*kernel_func_)(
-        ExecutionContext(*this, exec_scope, *dev_ctx, *runtime_ctx));
+    ExecutionContext exe_ctx(*this, exec_scope, *dev_ctx, *runtime_ctx);
+    if (platform::IsRooflineReportEnabled() &&
+        platform::is_cpu_place(place)) {
+      auto start = std::chrono::steady_clock::now();
+      (*kernel_func_)(exe_ctx);
+      double elapsed_ms = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+      OpCost cost;
+      cost.bytes =
+          TensorBytes(runtime_ctx->inputs) + TensorBytes(runtime_ctx->outputs);
+      if (!GetOpCost(exe_ctx, &cost)) {
+        cost.flops = cost.bytes = -1;
+      }
+      platform::RooflineRecorder::Instance().Record(Type(), elapsed_ms,
+                                                    cost.flops, cost.bytes);
+    } else {
+      (*kernel_func_)(exe_ctx);
+    }
   }
 
   if (!transfered_inplace_vars.empty()) {
@@ -205,6 +205,12 @@ class OperatorBase {
 
   void SetIsCalledByExecutor(bool x) { run_by_executor_ = x; }
 
+  // Resolve the input and output variables once per scope and reuse them on
+  // the following runs in the same scope instead of looking them up by name.
+  // They are resolved again when the op runs in another scope or variables
+  // were created, erased or renamed. Calling it drops the cached variables.
+  virtual void SetCacheRuntimeContext(bool enable) {}
+
   virtual void RuntimeInferShape(const Scope& scope,
                                  const platform::Place& place,
                                  const RuntimeContext& ctx) const {}
@@ -462,6 +468,14 @@ class OpKernel : public OpKernelBase {
   using ELEMENT_TYPE = T;
 };
 
+// The analytic cost of running an op once, counted from the shapes of its
+// inputs and outputs.
+struct OpCost {
+  double flops{0};
+  // the bytes the op reads and writes at least
+  double bytes{0};
+};
+
 class OperatorWithKernel : public OperatorBase {
  public:
   using OpKernelFunc = std::function<void(const ExecutionContext&)>;
@@ -497,9 +511,20 @@ class OperatorWithKernel : public OperatorBase {
 
   virtual void InferShape(InferShapeContext* ctx) const = 0;
 
+  // Fills the cost of the kernel that has just run in ctx, and returns false
+  // if the op cannot tell it. It is called on CPU by the profiler with the
+  // roofline report enabled. cost->bytes is preset to the size of all the
+  // LoDTensor inputs and outputs, i.e. reading every input and writing every
+  // output once.
+  virtual bool GetOpCost(const ExecutionContext& ctx, OpCost* cost) const {
+    return false;
+  }
+
   void RuntimeInferShape(const Scope& scope, const platform::Place& place,
                          const RuntimeContext& ctx) const override;
 
+  void SetCacheRuntimeContext(bool enable) override;
+
   proto::VarType::Type IndicateVarDataType(const ExecutionContext& ctx,
                                            const std::string& name) const;
 
@@ -563,6 +588,10 @@ class OperatorWithKernel : public OperatorBase {
   mutable std::unique_ptr<OpKernelFunc> kernel_func_;
   mutable std::unique_ptr<RuntimeContext> runtime_ctx_;
   mutable const Scope* pre_scope_ = nullptr;
+  // the ID and the vars epoch of the scope chain of pre_scope_ when
+  // runtime_ctx_ was cached
+  mutable uint64_t pre_scope_id_ = 0;
+  mutable uint64_t pre_vars_epoch_ = 0;
   mutable bool need_prepare_data_ = true;
   mutable bool enable_cache_runtime_context_ = false;
   mutable bool all_kernels_must_compute_runtime_shape_ = false;
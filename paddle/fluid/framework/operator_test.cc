@@ -11,6 +11,8 @@ distributed under the License is distributed on an "AS IS" BASIS,
 WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
+#include <chrono>  // NOLINT
+
 #include "gtest/gtest.h"
 
 #include "paddle/fluid/framework/op_info.h"
@@ -746,3 +748,92 @@ TEST(OpWithoutUnusedVar, all) {
   ASSERT_NO_THROW(op->Run(scope, cpu_place));
   FLAGS_enable_unused_var_check = false;
 }
+
+namespace paddle {
+namespace framework {
+
+static const Variable* recorded_output_var = nullptr;
+
+template <typename T>
+class RecordOutputVarKernelTest : public OpKernel<T> {
+ public:
+  void Compute(const ExecutionContext& ctx) const {
+    recorded_output_var = ctx.OutputVar("Y");
+  }
+};
+
+}  // namespace framework
+}  // namespace paddle
+
+REGISTER_OP_WITHOUT_GRADIENT(
+    op_record_output_var, paddle::framework::OpUnusedVarTest,
+    paddle::framework::OpUnusedVarTestProtoAndCheckerMaker);
+
+REGISTER_OP_CPU_KERNEL(op_record_output_var,
+                       paddle::framework::RecordOutputVarKernelTest<float>);
+
+TEST(OpWithKernel, CacheRuntimeContext) {
+  paddle::framework::InitDevices();
+  paddle::framework::proto::OpDesc op_desc;
+  op_desc.set_type("op_record_output_var");
+  BuildVar("X", {"X"}, op_desc.add_inputs());
+  BuildVar("Y", {"Y"}, op_desc.add_outputs());
+
+  // the variables live in the root of a chain of scopes, as the parameters
+  paddle::platform::CPUPlace cpu_place;
+  paddle::framework::Scope root;
+  auto* x = root.Var("X")->GetMutable<paddle::framework::LoDTensor>();
+  x->mutable_data<float>({32, 64}, cpu_place);
+  root.Var("Y")->GetMutable<paddle::framework::LoDTensor>();
+  const paddle::framework::Scope* scope = &root;
+  for (int depth = 0; depth < 3; ++depth) {
+    scope = &scope->NewScope();
+    for (int i = 0; i < 200; ++i) {
+      const_cast<paddle::framework::Scope*>(scope)->Var(
+          "var_" + std::to_string(depth) + "_" + std::to_string(i));
+    }
+  }
+
+  auto op = paddle::framework::OpRegistry::CreateOp(op_desc);
+  const int kRepeat = 100000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepeat; ++i) {
+    op->Run(*scope, cpu_place);
+  }
+  auto uncached = std::chrono::steady_clock::now() - start;
+
+  op->SetCacheRuntimeContext(true);
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepeat; ++i) {
+    op->Run(*scope, cpu_place);
+  }
+  auto cached = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(paddle::framework::recorded_output_var, root.FindVar("Y"));
+
+  using ns = std::chrono::nanoseconds;
+  LOG(INFO) << "per-op overhead, variables looked up by name: "
+            << std::chrono::duration_cast<ns>(uncached).count() / kRepeat
+            << "ns, cached runtime context: "
+            << std::chrono::duration_cast<ns>(cached).count() / kRepeat
+            << "ns";
+
+  // erasing variables invalidates the cached ones
+  root.EraseVars({"Y"});
+  root.Var("Y")->GetMutable<paddle::framework::LoDTensor>();
+  op->Run(*scope, cpu_place);
+  EXPECT_EQ(paddle::framework::recorded_output_var, root.FindVar("Y"));
+
+  // and so does creating a variable that shadows a cached one
+  const_cast<paddle::framework::Scope*>(scope)
+      ->Var("Y")
+      ->GetMutable<paddle::framework::LoDTensor>();
+  op->Run(*scope, cpu_place);
+  EXPECT_EQ(paddle::framework::recorded_output_var, scope->FindVar("Y"));
+  EXPECT_NE(paddle::framework::recorded_output_var, root.FindVar("Y"));
+
+  // so does running in another scope
+  auto& other = root.NewScope();
+  other.Var("Y")->GetMutable<paddle::framework::LoDTensor>();
+  op->Run(other, cpu_place);
+  EXPECT_EQ(paddle::framework::recorded_output_var, other.FindVar("Y"));
+}
@@ -14,6 +14,8 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/scope.h"
 
+#include <atomic>
+
 #include "glog/logging.h"
 #include "paddle/fluid/framework/threadpool.h"
 
@@ -43,8 +45,25 @@ DEFINE_bool(
 namespace paddle {
 namespace framework {
 
+static std::atomic<uint64_t> g_scope_id{0};
+
 Scope::~Scope() { DropKids(); }
 
+uint64_t Scope::NewID() { return ++g_scope_id; }
+
+uint64_t Scope::VarsEpoch() const {
+  // every local epoch only grows, so does the sum
+  uint64_t epoch = 0;
+  for (const Scope* s = this; s != nullptr; s = s->parent_) {
+    epoch += s->LocalVarsEpoch();
+  }
+  return epoch;
+}
+
+void Scope::BumpVarsEpoch() const {
+  vars_epoch_.fetch_add(1, std::memory_order_release);
+}
+
 Scope& Scope::NewScope() const {
   Scope* child = new Scope(this);
   {
@@ -141,6 +160,7 @@ void Scope::DeleteScope(Scope* scope) const {
 
 void Scope::EraseVars(const std::vector<std::string>& var_names) {
   std::set<std::string> var_set(var_names.begin(), var_names.end());
+  BumpVarsEpoch();
   SCOPE_VARS_WRITER_LOCK
   for (auto it = vars_.begin(); it != vars_.end();) {
     if (var_set.find(it->first) != var_set.end()) {
@@ -169,6 +189,8 @@ Variable* Scope::VarInternal(const std::string& name) {
   if (v != nullptr) return v;
   v = new Variable();
   vars_.emplace(name, std::unique_ptr<Variable>(v));
+  // the new variable may shadow one of the same name in an ancestor scope
+  BumpVarsEpoch();
   VLOG(3) << "Create variable " << name;
   return v;
 }
@@ -204,6 +226,7 @@ void Scope::RenameInternal(const std::string& origin_name,
           "The variable with name %s already exists in the scope.", new_name));
   vars_[new_name].reset(origin_it->second.release());
   vars_.erase(origin_it);
+  BumpVarsEpoch();
 }
 
 Variable* Scope::FindVarInternal(const std::string& name) const {
@@ -223,6 +246,7 @@ Variable* Scope::FindVarLocally(const std::string& name) const {
 }
 
 void Scope::EraseVarsExcept(const std::unordered_set<Variable*>& vars) {
+  BumpVarsEpoch();
   SCOPE_VARS_WRITER_LOCK
   for (auto iter = vars_.begin(); iter != vars_.end();) {
     if (vars.count(iter->second.get()) != 0) {
@@ -18,6 +18,7 @@ extern "C" {
 #include <xxhash.h>
 }
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <string>
@@ -118,6 +119,22 @@ class Scope {
   // Rename variable to a new name and return the new name
   std::string Rename(const std::string& origin_name) const;
 
+  /// A process-wide unique id, unlike the address of the scope it is never
+  /// reused after the scope is released.
+  uint64_t ID() const { return id_; }
+
+  /// Increased whenever variables are created, erased or renamed in this
+  /// scope.
+  uint64_t LocalVarsEpoch() const {
+    return vars_epoch_.load(std::memory_order_acquire);
+  }
+
+  /// The sum of the local vars epochs of this scope and its ancestors, in
+  /// which FindVar resolves names. The Variable pointers resolved from a
+  /// scope of unchanged ID stay valid as long as it is unchanged. Variables
+  /// created in kid or sibling scopes leave it unchanged.
+  uint64_t VarsEpoch() const;
+
  protected:
   struct KeyHasher {
     std::size_t operator()(const std::string& key) const {
@@ -151,9 +168,14 @@ class Scope {
   // Called by FindVarInternal and Var.
   Variable* FindVarLocally(const std::string& name) const;
 
+  static uint64_t NewID();
+  void BumpVarsEpoch() const;
+
   // Scope in `kids_` are owned by this class.
   mutable std::list<Scope*> kids_;
   const Scope* parent_{nullptr};
+  const uint64_t id_{NewID()};
+  mutable std::atomic<uint64_t> vars_epoch_{0};
 
   DISABLE_COPY_AND_ASSIGN(Scope);
 
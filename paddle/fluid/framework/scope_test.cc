@@ -77,3 +77,41 @@ TEST(Scope, GetAllNames) {
 
   EXPECT_STREQ("a", str.c_str());
 }
+
+TEST(Scope, IDAndVarsEpoch) {
+  Scope s;
+  Scope& ss = s.NewScope();
+  EXPECT_NE(s.ID(), ss.ID());
+  uint64_t released_id = ss.ID();
+  s.DropKids();
+  EXPECT_NE(s.NewScope().ID(), released_id);
+
+  s.Var("a");
+  uint64_t epoch = s.VarsEpoch();
+  s.Var("a");
+  EXPECT_EQ(s.VarsEpoch(), epoch);
+  s.Var("b");
+  EXPECT_GT(s.VarsEpoch(), epoch);
+  epoch = s.VarsEpoch();
+  s.Rename("a", "c");
+  EXPECT_GT(s.VarsEpoch(), epoch);
+  epoch = s.VarsEpoch();
+  s.EraseVars({"b"});
+  EXPECT_GT(s.VarsEpoch(), epoch);
+
+  // changes in a kid leave the parent and the siblings of the kid unchanged
+  Scope& kid = s.NewScope();
+  Scope& sibling = s.NewScope();
+  epoch = s.VarsEpoch();
+  uint64_t sibling_epoch = sibling.VarsEpoch();
+  kid.Var("d");
+  EXPECT_EQ(s.VarsEpoch(), epoch);
+  EXPECT_EQ(sibling.VarsEpoch(), sibling_epoch);
+
+  // changes in the parent change the epoch of every kid
+  uint64_t kid_epoch = kid.VarsEpoch();
+  s.Var("e");
+  EXPECT_GT(kid.VarsEpoch(), kid_epoch);
+  EXPECT_GT(sibling.VarsEpoch(), sibling_epoch);
+  EXPECT_EQ(kid.LocalVarsEpoch() + s.LocalVarsEpoch(), kid.VarsEpoch());
+}
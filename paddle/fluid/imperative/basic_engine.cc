@@ -15,7 +15,11 @@
 #include "paddle/fluid/imperative/basic_engine.h"
 
 #include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <queue>
 #include <sstream>
 #include <string>
@@ -24,6 +28,7 @@
 #include <utility>
 #include <vector>
 
+#include "paddle/fluid/framework/threadpool.h"
 #include "paddle/fluid/imperative/gradient_accumulator.h"
 #include "paddle/fluid/imperative/layer.h"
 #include "paddle/fluid/imperative/op_base.h"
@@ -32,10 +37,29 @@
 #include "paddle/fluid/platform/profiler.h"
 
 DECLARE_bool(sort_sum_gradient);
+DECLARE_int32(dygraph_backward_num_threads);
 
 namespace paddle {
 namespace imperative {
 
+namespace {
+
+// The threads running the grad ops of the parallel backward, recreated when
+// FLAGS_dygraph_backward_num_threads changes.
+framework::ThreadPool* GetBackwardThreadPool(int num_threads) {
+  static std::mutex mutex;
+  static std::unique_ptr<framework::ThreadPool> pool;
+  static int pool_size = 0;
+  std::lock_guard<std::mutex> guard(mutex);
+  if (pool == nullptr || pool_size != num_threads) {
+    pool.reset(new framework::ThreadPool(num_threads));
+    pool_size = num_threads;
+  }
+  return pool.get();
+}
+
+}  // namespace
+
 void BasicEngine::Init(VarBase* var, bool retain_graph) {
   retain_graph_ = retain_graph;
   init_node_ = var->GradVarBase()->GradNode();
@@ -151,6 +175,10 @@ void BasicEngine::PrepareGradAccumulators(
                   "Only leaf Tensor's gradient can append hook to "
                   "Gradientaccumulator."));
           accumulator->SetPostHooks(var->GetLeafHooks());
+          for (auto& hook : var->GetLeafHooks()->backward_hooks()) {
+            run_sequentially_ =
+                run_sequentially_ || hook->NeedsSequentialBackward();
+          }
         }
       } else {
         // Because Inplace op overwrites the grad_node of the input grad_var. So
@@ -268,164 +296,277 @@ void BasicEngine::Execute() {
   }
 
   PrepareDeps();
-  // Start execute Computation graph
-  std::queue<std::shared_ptr<GradOpNode>> q;
-  q.push(std::move(init_node_));
 
   size_t op_num = 0;
+  // The grad ops of another device share its stream, so only the grad ops on
+  // CPU run in parallel.
+  if (FLAGS_dygraph_backward_num_threads > 1 && !run_sequentially_ &&
+      !init_node_->empty() &&
+      platform::is_cpu_place(init_node_->begin()->place())) {
+    op_num = ExecuteInParallel(FLAGS_dygraph_backward_num_threads);
+  } else {
+    // Start execute Computation graph
+    std::queue<std::shared_ptr<GradOpNode>> q;
+    q.push(std::move(init_node_));
+
+    while (!q.empty()) {
+      auto shared_cur_node = std::move(q.front());
+      q.pop();
+
+      op_num += RunGradNode(shared_cur_node);
+
+      // Step 3: Collect ready ops
+      for (auto& grad_pending_node : shared_cur_node->GradPendingNodes()) {
+        PADDLE_ENFORCE_NOT_NULL(
+            grad_pending_node,
+            platform::errors::NotFound("Grad pending node is nullptr."));
+        auto iter = node_deps_.find(grad_pending_node.get());
+        if (iter == node_deps_.end()) {
+          continue;
+        }
 
-  while (!q.empty()) {
-    auto shared_cur_node = std::move(q.front());
-    q.pop();
+        if (--(iter->second) == 0) {
+          q.push(grad_pending_node);
+        }
+      }
+    }
+  }
+  Clear();
 
-    auto& inplace_grad_name_map = shared_cur_node->InplaceGradNameMap();
+  VLOG(1) << "Backward op number: " << op_num;
+}
 
-    for (auto& cur_op : *shared_cur_node) {
-      platform::RecordEvent op_type_record_event(cur_op.Type());
+size_t BasicEngine::ExecuteInParallel(int num_threads) {
+  auto* pool = GetBackwardThreadPool(num_threads);
 
-      ++op_num;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::shared_ptr<GradOpNode>> ready;
+  ready.push_back(std::move(init_node_));
+  size_t running = 0;
+  size_t op_num = 0;
+  std::exception_ptr error;
 
-      // CheckBackWardInput
-      CheckBackwardInputs(cur_op);
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    cv.wait(lock, [&] { return !ready.empty() || running == 0 || error; });
+    if (error || ready.empty()) {
+      break;
+    }
 
-      // Step 1: Run Backward OP
-      auto& bwd_ins = cur_op.GetInsMap();
-      auto& bwd_outs = cur_op.GetOutsMap();
+    auto node = std::move(ready.front());
+    ready.pop_front();
+    ++running;
+    // The returned future is not waited for, the grad node reports its end
+    // through running.
+    pool->Run([&, node] {
+      std::exception_ptr node_error;
+      try {
+        size_t node_op_num = RunGradNode(node);
+
+        std::lock_guard<std::mutex> guard(mutex);
+        op_num += node_op_num;
+        // Collect ready ops
+        for (auto& grad_pending_node : node->GradPendingNodes()) {
+          PADDLE_ENFORCE_NOT_NULL(
+              grad_pending_node,
+              platform::errors::NotFound("Grad pending node is nullptr."));
+          auto iter = node_deps_.find(grad_pending_node.get());
+          if (iter == node_deps_.end()) {
+            continue;
+          }
 
-      NameVarMap<VariableWrapper> tmp_outs(bwd_outs);
-      // 1. construct the temp output map, avoid to disrupt graph
-      // 2. replace the element in the map by temp var, because a
-      // var may be coresponding to several grad var in one op
-      for (auto& pair : tmp_outs) {
-        if (!pair.second.IsGrad()) {
-          continue;
+          if (--(iter->second) == 0) {
+            ready.push_back(grad_pending_node);
+          }
         }
+      } catch (...) {
+        node_error = std::current_exception();
+      }
 
-        for (auto& var : pair.second) {
-          if (!var) {
-            continue;
-          }
+      std::lock_guard<std::mutex> guard(mutex);
+      if (node_error && !error) {
+        error = node_error;
+      }
+      --running;
+      cv.notify_one();
+    });
+  }
+  // the running grad ops still use the engine after an error
+  cv.wait(lock, [&] { return running == 0; });
 
-          std::unordered_map<VariableWrapper*,
-                             std::unique_ptr<GradientAccumulator>>::iterator
-              iter;
-          if (!var->HasGradNode()) {
-            VLOG(10) << "Find gradient of var (" << var->Name()
-                     << ") with no grad_node.";
-            iter = accumulators_.find(var.get());
-            PADDLE_ENFORCE_EQ(
-                iter != accumulators_.end(), true,
-                platform::errors::NotFound(
-                    "Cannot find gradient of variable %s", var->Name()));
-          } else {
-            bool flag_find_grad = false;
-            VLOG(10) << "Find gradient of var (" << var->Name()
-                     << ") with grad_node.";
-            for (auto& grad_pending_node :
-                 shared_cur_node->GradPendingNodes()) {
-              const auto& iter_grad_node =
-                  accumulators_with_grad_node_.find(grad_pending_node);
-              if (iter_grad_node != accumulators_with_grad_node_.end()) {
-                iter = iter_grad_node->second.find(var.get());
-                if (iter != iter_grad_node->second.end()) {
-                  flag_find_grad = true;
-                  break;
-                }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return op_num;
+}
+
+size_t BasicEngine::RunGradNode(const std::shared_ptr<GradOpNode>& node) {
+  auto& inplace_grad_name_map = node->InplaceGradNameMap();
+  size_t op_num = 0;
+
+  for (auto& cur_op : *node) {
+    ++op_num;
+    platform::RecordEvent op_type_record_event(cur_op.Type());
+
+    // The output grad var of Inplace grad op. Because Inplace grad op does
+    // not use the Inplace strategy, a new output grad var needs to be
+    // created.
+    std::vector<std::pair<std::shared_ptr<VariableWrapper>,
+                          std::shared_ptr<VariableWrapper>>>
+        inplace_output_grad_var_list;
+    std::vector<
+        std::pair<GradientAccumulator*, std::shared_ptr<VariableWrapper>>>
+        need_accu_var_list;
+    // leaf_accumulators is only for leaf tensor(hooks/accumulate grad)
+    // It should be orderly and not repeated, because multiple cards must
+    // ensure that the order of vars is the same.
+    std::vector<GradientAccumulator*> leaf_accumulators;
+
+    // CheckBackWardInput
+    CheckBackwardInputs(cur_op);
+
+    // Step 1: Run Backward OP
+    auto& bwd_ins = cur_op.GetInsMap();
+    auto& bwd_outs = cur_op.GetOutsMap();
+
+    NameVarMap<VariableWrapper> tmp_outs(bwd_outs);
+    // 1. construct the temp output map, avoid to disrupt graph
+    // 2. replace the element in the map by temp var, because a
+    // var may be coresponding to several grad var in one op
+    for (auto& pair : tmp_outs) {
+      if (!pair.second.IsGrad()) {
+        continue;
+      }
+
+      for (auto& var : pair.second) {
+        if (!var) {
+          continue;
+        }
+
+        std::unordered_map<VariableWrapper*,
+                           std::unique_ptr<GradientAccumulator>>::iterator
+            iter;
+        if (!var->HasGradNode()) {
+          VLOG(10) << "Find gradient of var (" << var->Name()
+                   << ") with no grad_node.";
+          iter = accumulators_.find(var.get());
+          PADDLE_ENFORCE_EQ(
+              iter != accumulators_.end(), true,
+              platform::errors::NotFound(
+                  "Cannot find gradient of variable %s", var->Name()));
+        } else {
+          bool flag_find_grad = false;
+          VLOG(10) << "Find gradient of var (" << var->Name()
+                   << ") with grad_node.";
+          for (auto& grad_pending_node : node->GradPendingNodes()) {
+            const auto& iter_grad_node =
+                accumulators_with_grad_node_.find(grad_pending_node);
+            if (iter_grad_node != accumulators_with_grad_node_.end()) {
+              iter = iter_grad_node->second.find(var.get());
+              if (iter != iter_grad_node->second.end()) {
+                flag_find_grad = true;
+                break;
               }
             }
-            PADDLE_ENFORCE_EQ(
-                flag_find_grad, true,
-                platform::errors::NotFound(
-                    "Cannot find gradient of variable %s", var->Name()));
           }
+          PADDLE_ENFORCE_EQ(
+              flag_find_grad, true,
+              platform::errors::NotFound(
+                  "Cannot find gradient of variable %s", var->Name()));
+        }
 
-          // leaf_accumulators_ : hooks and accumulate-grad for leaf tensor,
-          // it should be orderly and not reapeated.
-          if (var->IsLeafGrad()) {
-            if (std::find(leaf_accumulators_.begin(), leaf_accumulators_.end(),
-                          iter->second.get()) == leaf_accumulators_.end()) {
-              leaf_accumulators_.push_back(iter->second.get());
-            }
+        // leaf_accumulators : hooks and accumulate-grad for leaf tensor,
+        // it should be orderly and not reapeated.
+        if (var->IsLeafGrad()) {
+          if (std::find(leaf_accumulators.begin(), leaf_accumulators.end(),
+                        iter->second.get()) == leaf_accumulators.end()) {
+            leaf_accumulators.push_back(iter->second.get());
+          }
 
-            if (iter->second->HasInnerVar()) {
-              var = iter->second->InnerVar();
-            }
+          if (iter->second->HasInnerVar()) {
+            var = iter->second->InnerVar();
           }
+        }
 
-          if (var->OverridedStopGradient() || iter->second->RefCnt() > 1) {
-            auto tmp_var = std::make_shared<VariableWrapper>(var->Name());
-            tmp_var->SetType(var->Type());
-            tmp_var->SetForwardDataType(var->ForwardDataType());
-            var = tmp_var;
-            need_accu_var_list_.emplace_back(iter->second.get(), var);
-            VLOG(10) << "create temporary var of " << var->Name()
-                     << " for sum gradient within this graph!";
-          } else if (!inplace_grad_name_map.empty() &&
-                     inplace_grad_name_map.count(pair.first)) {
-            // When calculate Inplace grad op, create a new output var.
-            // If a tmp var has been created, there is no need to create it
-            // again.
-            for (auto& in_var :
-                 bwd_ins.at(inplace_grad_name_map.at(pair.first))) {
-              if (in_var == var) {
-                auto tmp_var = std::make_shared<VariableWrapper>(var->Name());
-                tmp_var->SetType(var->Type());
-                tmp_var->SetForwardDataType(var->ForwardDataType());
-                inplace_output_grad_var_list_.emplace_back(var, tmp_var);
-                var = tmp_var;
-                VLOG(10) << "Inplace grad op does not use the Inplace "
-                            "strategy, a temporary output var ("
-                         << var->Name() << ") will be created.";
-                break;
-              }
+        if (var->OverridedStopGradient() || iter->second->RefCnt() > 1) {
+          auto tmp_var = std::make_shared<VariableWrapper>(var->Name());
+          tmp_var->SetType(var->Type());
+          tmp_var->SetForwardDataType(var->ForwardDataType());
+          var = tmp_var;
+          need_accu_var_list.emplace_back(iter->second.get(), var);
+          VLOG(10) << "create temporary var of " << var->Name()
+                   << " for sum gradient within this graph!";
+        } else if (!inplace_grad_name_map.empty() &&
+                   inplace_grad_name_map.count(pair.first)) {
+          // When calculate Inplace grad op, create a new output var.
+          // If a tmp var has been created, there is no need to create it
+          // again.
+          for (auto& in_var :
+               bwd_ins.at(inplace_grad_name_map.at(pair.first))) {
+            if (in_var == var) {
+              auto tmp_var = std::make_shared<VariableWrapper>(var->Name());
+              tmp_var->SetType(var->Type());
+              tmp_var->SetForwardDataType(var->ForwardDataType());
+              inplace_output_grad_var_list.emplace_back(var, tmp_var);
+              var = tmp_var;
+              VLOG(10) << "Inplace grad op does not use the Inplace "
+                          "strategy, a temporary output var ("
+                       << var->Name() << ") will be created.";
+              break;
             }
           }
         }
       }
+    }
 
-      VLOG(4) << "Check whether there is any inplace operation affecting "
-                 "gradient calculation.";
-      for (auto& pair : bwd_ins) {
-        for (auto& var_wrapper : pair.second) {
-          auto wrapper_version_snapshot = var_wrapper->InplaceVersionSnapshot();
-          auto tensor_version =
-              var_wrapper->MutableVar()->CurrentInplaceVersion();
-          PADDLE_ENFORCE_EQ(
-              tensor_version, wrapper_version_snapshot,
-              platform::errors::PermissionDenied(
-                  "Tensor '%s' used in gradient computation in grad op '%s' "
-                  "has been "
-                  "modified by an inplace operation. "
-                  "Its version is %s but the expected version is %s. "
-                  "Please fix your code to void calling an inplace operator "
-                  "after using the Tensor which will used in gradient "
-                  "computation.",
-                  var_wrapper->Name(), cur_op.Type(), tensor_version,
-                  wrapper_version_snapshot));
-
-          VLOG(6) << " The version of Tensor '" << var_wrapper->Name()
-                  << "' is [ " << wrapper_version_snapshot << " ]";
-        }
+    VLOG(4) << "Check whether there is any inplace operation affecting "
+               "gradient calculation.";
+    for (auto& pair : bwd_ins) {
+      for (auto& var_wrapper : pair.second) {
+        auto wrapper_version_snapshot = var_wrapper->InplaceVersionSnapshot();
+        auto tensor_version =
+            var_wrapper->MutableVar()->CurrentInplaceVersion();
+        PADDLE_ENFORCE_EQ(
+            tensor_version, wrapper_version_snapshot,
+            platform::errors::PermissionDenied(
+                "Tensor '%s' used in gradient computation in grad op '%s' "
+                "has been "
+                "modified by an inplace operation. "
+                "Its version is %s but the expected version is %s. "
+                "Please fix your code to void calling an inplace operator "
+                "after using the Tensor which will used in gradient "
+                "computation.",
+                var_wrapper->Name(), cur_op.Type(), tensor_version,
+                wrapper_version_snapshot));
+
+        VLOG(6) << " The version of Tensor '" << var_wrapper->Name()
+                << "' is [ " << wrapper_version_snapshot << " ]";
       }
+    }
 
-      {
-        VLOG(3) << "Start to execute grad op " << cur_op.Type();
-        OpBase::Run(cur_op.InnerOp(), bwd_ins, tmp_outs, cur_op.Attrs(),
-                    cur_op.place());
-      }
+    {
+      VLOG(3) << "Start to execute grad op " << cur_op.Type();
+      OpBase::Run(cur_op.InnerOp(), bwd_ins, tmp_outs, cur_op.Attrs(),
+                  cur_op.place());
+    }
 
-      for (auto& pair : inplace_output_grad_var_list_) {
-        *pair.first = std::move(*pair.second);
-      }
+    for (auto& pair : inplace_output_grad_var_list) {
+      *pair.first = std::move(*pair.second);
+    }
 
-      // Step 2: Sum Gradient of This graph
-      for (auto& pair : need_accu_var_list_) {
-        pair.first->SumGrad(std::move(pair.second), cur_op.id());
-      }
+    // Step 2: Sum Gradient of This graph
+    for (auto& pair : need_accu_var_list) {
+      pair.first->SumGrad(std::move(pair.second), cur_op.id());
+    }
 
-      // Step 3: Call Hooks && Sum Gradient with Pre-Graph && Call BackwardHooks
-      for (auto* accumulator : leaf_accumulators_) {
-        if (!accumulator->SumGradCompleted()) {
+    // Step 3: Call Hooks && Sum Gradient with Pre-Graph && Call BackwardHooks
+    // The hooks, such as the reduce hook, are called by one thread at a time
+    // when the grad ops run in parallel.
+    {
+      std::lock_guard<std::mutex> guard(leaf_mutex_);
+      for (auto* accumulator : leaf_accumulators) {
+        if (!accumulator->TryFinishSumGrad()) {
           continue;
         }
         // 1. Call Hooks for **inner_var_**
@@ -438,35 +579,14 @@ void BasicEngine::Execute() {
           accumulator->CallBackwardPostHooks();
         }
       }
-
-      need_accu_var_list_.clear();
-      inplace_output_grad_var_list_.clear();
-      leaf_accumulators_.clear();
-
-      if (!retain_graph_) {
-        VLOG(3) << "Remove op after op " << cur_op.Type() << " runs";
-        cur_op.ClearBackwardTrace();
-      }
     }
 
-    // Step 3: Collect ready ops
-    for (auto& grad_pending_node : shared_cur_node->GradPendingNodes()) {
-      PADDLE_ENFORCE_NOT_NULL(
-          grad_pending_node,
-          platform::errors::NotFound("Grad pending node is nullptr."));
-      auto iter = node_deps_.find(grad_pending_node.get());
-      if (iter == node_deps_.end()) {
-        continue;
-      }
-
-      if (--(iter->second) == 0) {
-        q.push(grad_pending_node);
-      }
+    if (!retain_graph_) {
+      VLOG(3) << "Remove op after op " << cur_op.Type() << " runs";
+      cur_op.ClearBackwardTrace();
     }
   }
-  Clear();
-
-  VLOG(1) << "Backward op number: " << op_num;
+  return op_num;
 }
 
 void BasicEngine::Clear() {
@@ -474,8 +594,7 @@ void BasicEngine::Clear() {
   node_deps_.clear();
   accumulators_.clear();
   accumulators_with_grad_node_.clear();
-  need_accu_var_list_.clear();
-  leaf_accumulators_.clear();
+  run_sequentially_ = false;
 }
 
 }  // namespace imperative
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>  // NOLINT
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -37,6 +38,14 @@ class BasicEngine : public Engine {
  private:
   void PrepareDeps();
 
+  // Runs the ready grad nodes on num_threads threads, returns the number of
+  // grad ops run.
+  size_t ExecuteInParallel(int num_threads);
+
+  // Runs the grad ops of node and sums their gradients, returns the number
+  // of grad ops run.
+  size_t RunGradNode(const std::shared_ptr<GradOpNode>& node);
+
   void CheckBackwardInputs(const OpBase& op);
 
   void PrepareGradAccumulators(
@@ -61,17 +70,12 @@ class BasicEngine : public Engine {
   // `var` as the key.
   std::unordered_map<VariableWrapper*, std::unique_ptr<GradientAccumulator>>
       accumulators_;
-  // The output grad var of Inplace grad op. Because Inplace grad op does not
-  // use the Inplace strategy, a new output grad var needs to be created.
-  std::vector<std::pair<std::shared_ptr<VariableWrapper>,
-                        std::shared_ptr<VariableWrapper>>>
-      inplace_output_grad_var_list_;
-  std::vector<std::pair<GradientAccumulator*, std::shared_ptr<VariableWrapper>>>
-      need_accu_var_list_;
-  // leaf_accumulators_ is only for leaf tensor(hooks/accumulate grad)
-  // It should be orderly and not repeated, because multiple cards must ensure
-  // that the order of vars is the same.
-  std::vector<GradientAccumulator*> leaf_accumulators_;
+  // Serializes the hooks and the gradient accumulation of the leaf vars,
+  // which are reached by grad ops running on different threads.
+  std::mutex leaf_mutex_;
+  // Whether a leaf var has a hook that needs the grad ops to run one by one,
+  // such as the hooks of the Reducer.
+  bool run_sequentially_{false};
 
   bool retain_graph_;
 };
@@ -0,0 +1,352 @@
+//   Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/imperative/gloo_context.h"
+
+#if defined(PADDLE_WITH_GLOO)
+#include <gloo/allgather.h>
+#include <gloo/allreduce.h>
+#include <gloo/math.h>
+#include <gloo/rendezvous/context.h>
+#include <gloo/rendezvous/file_store.h>
+#include <gloo/rendezvous/http_store.h>
+#include <gloo/rendezvous/prefix_store.h>
+#include <gloo/transport/tcp/device.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <utility>
+
+#include "paddle/fluid/framework/selected_rows.h"
+#include "paddle/fluid/framework/variable.h"
+#include "paddle/fluid/string/string_helper.h"
+
+namespace paddle {
+namespace imperative {
+
+namespace {
+
+template <typename T>
+void AllReduceSum(const std::shared_ptr<gloo::Context> &context,
+                  const T *src, T *dst, size_t count) {
+  gloo::AllreduceOptions opts(context);
+  if (src != dst) {
+    opts.setInput(const_cast<T *>(src), count);
+  }
+  opts.setOutput(dst, count);
+  opts.setReduceFunction(
+      static_cast<void (*)(void *, const void *, const void *, size_t)>(
+          &gloo::sum<T>));
+  gloo::allreduce(opts);
+}
+
+// Gathers count elements of every rank into dst in the order of the ranks.
+template <typename T>
+void AllGather(const std::shared_ptr<gloo::Context> &context, const T *src,
+               T *dst, size_t count) {
+  gloo::AllgatherOptions opts(context);
+  opts.setInput(const_cast<T *>(src), count);
+  opts.setOutput(dst, count * context->size);
+  gloo::allgather(opts);
+}
+
+void AllReduce(const std::shared_ptr<gloo::Context> &context,
+               const framework::Tensor &src, framework::Tensor *dst) {
+  PADDLE_ENFORCE_EQ(
+      platform::is_cpu_place(src.place()), true,
+      platform::errors::InvalidArgument(
+          "Gloo only all-reduces the tensors on CPU, but got a tensor on %s.",
+          src.place()));
+  if (&src != dst) {
+    dst->Resize(src.dims());
+  }
+  void *dst_data = dst->mutable_data(platform::CPUPlace(), src.type());
+  const void *src_data = src.data<void>();
+  size_t numel = static_cast<size_t>(src.numel());
+  switch (src.type()) {
+    case framework::proto::VarType::FP32:
+      AllReduceSum(context, static_cast<const float *>(src_data),
+                   static_cast<float *>(dst_data), numel);
+      break;
+    case framework::proto::VarType::FP64:
+      AllReduceSum(context, static_cast<const double *>(src_data),
+                   static_cast<double *>(dst_data), numel);
+      break;
+    case framework::proto::VarType::INT32:
+      AllReduceSum(context, static_cast<const int *>(src_data),
+                   static_cast<int *>(dst_data), numel);
+      break;
+    case framework::proto::VarType::INT64:
+      AllReduceSum(context, static_cast<const int64_t *>(src_data),
+                   static_cast<int64_t *>(dst_data), numel);
+      break;
+    default:
+      PADDLE_THROW(platform::errors::Unimplemented(
+          "Data type (%s) is not supported when it allreduces over gloo.",
+          framework::DataTypeToString(src.type())));
+  }
+}
+
+// The sum of SelectedRows is the concatenation of the rows and values of
+// all the ranks. They are gathered padded to the most rows of a rank, as
+// gloo gathers the same number of elements from every rank.
+void AllReduce(const std::shared_ptr<gloo::Context> &context,
+               const framework::SelectedRows &src,
+               framework::SelectedRows *dst) {
+  const auto &src_tensor = src.value();
+  PADDLE_ENFORCE_EQ(
+      platform::is_cpu_place(src_tensor.place()), true,
+      platform::errors::InvalidArgument(
+          "Gloo only all-reduces the tensors on CPU, but got a tensor on %s.",
+          src_tensor.place()));
+  int nranks = context->size;
+  int64_t src_rows_num = static_cast<int64_t>(src.rows().size());
+  std::vector<int64_t> rows_nums(nranks);
+  AllGather(context, &src_rows_num, rows_nums.data(), 1);
+  int64_t max_rows_num = *std::max_element(rows_nums.begin(), rows_nums.end());
+  int64_t rows_num =
+      std::accumulate(rows_nums.begin(), rows_nums.end(), int64_t(0));
+  VLOG(3) << "Gather rows: " << string::join_strings(rows_nums, ',')
+          << ", total rows number: " << rows_num
+          << ", height: " << src.height();
+
+  auto dtype = src_tensor.type();
+  auto dims = src_tensor.dims();
+  size_t row_bytes =
+      framework::product(framework::slice_ddim(dims, 1, dims.size())) *
+      framework::SizeOfType(dtype);
+  std::vector<int64_t> all_rows(max_rows_num * nranks);
+  std::vector<char> all_values(max_rows_num * row_bytes * nranks);
+  if (max_rows_num > 0) {
+    std::vector<int64_t> rows(src.rows().begin(), src.rows().end());
+    rows.resize(max_rows_num);
+    std::vector<char> values(max_rows_num * row_bytes);
+    if (src_rows_num > 0) {
+      std::memcpy(values.data(), src_tensor.data<void>(),
+                  src_rows_num * row_bytes);
+    }
+    AllGather(context, rows.data(), all_rows.data(), max_rows_num);
+    AllGather(context, values.data(), all_values.data(),
+              max_rows_num * row_bytes);
+  }
+
+  std::vector<int64_t> dst_rows;
+  dst_rows.reserve(rows_num);
+  framework::Tensor dst_tensor;
+  dims[0] = rows_num;
+  dst_tensor.Resize(dims);
+  char *dst_data = static_cast<char *>(
+      dst_tensor.mutable_data(platform::CPUPlace(), dtype));
+  for (int i = 0; i < nranks; ++i) {
+    auto rows_begin = all_rows.begin() + i * max_rows_num;
+    dst_rows.insert(dst_rows.end(), rows_begin, rows_begin + rows_nums[i]);
+    std::memcpy(dst_data, all_values.data() + i * max_rows_num * row_bytes,
+                rows_nums[i] * row_bytes);
+    dst_data += rows_nums[i] * row_bytes;
+  }
+  // src may be dst, it is only changed at last
+  dst->set_height(src.height());
+  dst->set_rows(dst_rows);
+  dst->mutable_value()->ShareDataWith(dst_tensor);
+}
+
+}  // namespace
+
+GlooParallelContext::GlooParallelContext(
+    const ParallelStrategy &strategy,
+    const platform::GlooParallelStrategy &gloo_strategy)
+    : ParallelContext(strategy, platform::CPUPlace()),
+      gloo_strategy_(gloo_strategy) {
+  PADDLE_ENFORCE_EQ(
+      gloo_strategy.rank_num, strategy.nranks_,
+      platform::errors::InvalidArgument(
+          "The number of ranks of gloo (%d) and of the parallel strategy (%d) "
+          "should be equal.",
+          gloo_strategy.rank_num, strategy.nranks_));
+  PADDLE_ENFORCE_EQ(
+      gloo_strategy.rank, strategy.local_rank_,
+      platform::errors::InvalidArgument(
+          "The rank of gloo (%d) and of the parallel strategy (%d) should be "
+          "equal.",
+          gloo_strategy.rank, strategy.local_rank_));
+}
+
+GlooParallelContext::~GlooParallelContext() {
+  for (auto &ring : rings_) {
+    {
+      std::lock_guard<std::mutex> guard(ring->mutex);
+      ring->stop = true;
+    }
+    ring->cv.notify_all();
+  }
+  for (auto &ring : rings_) {
+    ring->thread.join();
+  }
+}
+
+void GlooParallelContext::Init() {
+  PADDLE_ENFORCE_EQ(rings_.empty(), true,
+                    platform::errors::AlreadyExists(
+                        "The gloo parallel context is initialized already."));
+  gloo::transport::tcp::attr attr;
+  if (!gloo_strategy_.iface.empty()) {
+    attr.iface = gloo_strategy_.iface;
+  }
+  auto dev = gloo::transport::tcp::CreateDevice(attr);
+
+  std::shared_ptr<gloo::rendezvous::Store> store;
+  std::shared_ptr<gloo::rendezvous::HTTPStore> http_store;
+  if (!gloo_strategy_.fs_path.empty()) {
+    store = std::make_shared<gloo::rendezvous::FileStore>(
+        gloo_strategy_.fs_path);
+  } else {
+    http_store = std::make_shared<gloo::rendezvous::HTTPStore>(
+        gloo_strategy_.ip_address, gloo_strategy_.ip_port,
+        "_" + gloo_strategy_.scope, gloo_strategy_.rank);
+    http_store->SetTimeoutSeconds(gloo_strategy_.init_seconds);
+    store = http_store;
+  }
+
+  for (int ring_id = 0; ring_id < strategy_.nrings_; ++ring_id) {
+    VLOG(0) << "init gloo context nranks: " << strategy_.nranks_
+            << " local rank: " << strategy_.local_rank_
+            << " ring id: " << ring_id;
+    auto context = std::make_shared<gloo::rendezvous::Context>(
+        strategy_.local_rank_, strategy_.nranks_);
+    context->setTimeout(std::chrono::seconds(gloo_strategy_.run_seconds));
+    gloo::rendezvous::PrefixStore prefix_store(
+        "dygraph_ring_" + std::to_string(ring_id), *store);
+    context->connectFullMesh(prefix_store, dev);
+
+    std::unique_ptr<Ring> ring(new Ring);
+    ring->context = std::move(context);
+    ring->dev_ctx.reset(new platform::CPUDeviceContext());
+    Ring *ring_ptr = ring.get();
+    ring->thread = std::thread([this, ring_ptr] { CommLoop(ring_ptr); });
+    rings_.emplace_back(std::move(ring));
+  }
+  if (http_store) {
+    http_store->Finalize();
+  }
+}
+
+GlooParallelContext::Ring *GlooParallelContext::GetRing(int ring_id) {
+  PADDLE_ENFORCE_EQ(
+      ring_id >= 0 && ring_id < static_cast<int>(rings_.size()), true,
+      platform::errors::OutOfRange(
+          "Ring %d is out of the %d rings of the gloo parallel context, "
+          "please initialize it first.",
+          ring_id, rings_.size()));
+  return rings_[ring_id].get();
+}
+
+void GlooParallelContext::CommLoop(Ring *ring) {
+  while (true) {
+    std::function<void()> task;
+    bool failed = false;
+    {
+      std::unique_lock<std::mutex> lock(ring->mutex);
+      ring->cv.wait(lock,
+                    [ring] { return ring->stop || !ring->tasks.empty(); });
+      if (ring->tasks.empty()) break;
+      task = std::move(ring->tasks.front());
+      ring->tasks.pop_front();
+      ring->running = true;
+      failed = ring->error != nullptr;
+    }
+
+    std::exception_ptr error;
+    if (!failed) {
+      try {
+        task();
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(ring->mutex);
+      ring->running = false;
+      if (error && !ring->error) ring->error = error;
+    }
+    ring->cv.notify_all();
+  }
+}
+
+void GlooParallelContext::RunOnCommStream(int ring_id,
+                                          std::function<void()> task) {
+  auto *ring = GetRing(ring_id);
+  {
+    std::lock_guard<std::mutex> guard(ring->mutex);
+    ring->tasks.emplace_back(std::move(task));
+  }
+  ring->cv.notify_all();
+}
+
+void GlooParallelContext::AllReduceByStream(const framework::Variable &src,
+                                            framework::Variable *dst,
+                                            int ring_id, bool use_calc_stream) {
+  auto *ring = GetRing(ring_id);
+  if (!use_calc_stream) {
+    RunOnCommStream(ring_id, [this, &src, dst, ring_id] {
+      AllReduceByStream(src, dst, ring_id, true);
+    });
+    return;
+  }
+  // a gloo context can only run one collective at a time
+  if (std::this_thread::get_id() != ring->thread.get_id()) {
+    WaitComm(ring_id);
+  }
+  if (src.IsType<framework::LoDTensor>()) {
+    AllReduce(ring->context, src.Get<framework::LoDTensor>(),
+              dst->GetMutable<framework::LoDTensor>());
+  } else if (src.IsType<framework::SelectedRows>()) {
+    AllReduce(ring->context, src.Get<framework::SelectedRows>(),
+              dst->GetMutable<framework::SelectedRows>());
+  } else {
+    PADDLE_THROW(platform::errors::InvalidArgument(
+        "Unsupported variable type %s for gloo allreduce, only LoDTensor and "
+        "SelectedRows are supported.",
+        platform::demangle(framework::ToTypeName(src.Type()))));
+  }
+}
+
+paddle::platform::DeviceContext *GlooParallelContext::GetDeviceContext(
+    int ring_id) {
+  return GetRing(ring_id)->dev_ctx.get();
+}
+
+void GlooParallelContext::WaitCompute(int ring_id) {
+  // the computation on CPU is done when the tasks are issued
+}
+
+void GlooParallelContext::WaitComm(int ring_id) {
+  auto *ring = GetRing(ring_id);
+  std::unique_lock<std::mutex> lock(ring->mutex);
+  ring->cv.wait(lock,
+                [ring] { return ring->tasks.empty() && !ring->running; });
+  if (ring->error) {
+    auto error = ring->error;
+    ring->error = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+}  //  namespace imperative
+}  //  namespace paddle
+
+#endif
@@ -0,0 +1,96 @@
+//   Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#if defined(PADDLE_WITH_GLOO)
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "paddle/fluid/imperative/parallel_context.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/fluid/platform/gloo_context.h"
+
+namespace gloo {
+class Context;
+}  // namespace gloo
+
+namespace paddle {
+namespace imperative {
+
+// GlooParallelContext all-reduces the gradients of dygraph data parallel
+// training on CPU over gloo. Every ring has its own gloo context and
+// communication thread, which runs the tasks of the ring in the order they
+// are issued, so the Reducer overlaps the all-reduce of a group with the
+// rest of the backward pass.
+//
+// The ranks rendezvous through the gloo file store at gloo_strategy.fs_path
+// if it is set, e.g. for the processes on one machine or on a shared file
+// system, and through the http store of the launcher otherwise.
+class GlooParallelContext : public ParallelContext {
+ public:
+  GlooParallelContext(const ParallelStrategy& strategy,
+                      const platform::GlooParallelStrategy& gloo_strategy);
+
+  ~GlooParallelContext() override;
+
+  void Init() override;
+
+  // Sums src of all the ranks into dst. It runs on the thread of ring_id
+  // unless use_calc_stream is true, then it runs on the calling thread after
+  // the pending tasks of the ring.
+  void AllReduceByStream(const framework::Variable& src,
+                         framework::Variable* dst, int ring_id,
+                         bool use_calc_stream) override;
+
+  paddle::platform::DeviceContext* GetDeviceContext(int ring_id) override;
+
+  void WaitCompute(int ring_id) override;
+
+  // Waits for the tasks of ring_id and rethrows the first error of them.
+  void WaitComm(int ring_id) override;
+
+  void RunOnCommStream(int ring_id, std::function<void()> task) override;
+
+ private:
+  struct Ring {
+    std::shared_ptr<gloo::Context> context;
+    std::unique_ptr<platform::CPUDeviceContext> dev_ctx;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> tasks;
+    bool running{false};
+    bool stop{false};
+    // the tasks after a failed one are dropped, as the collectives of the
+    // ranks would not match any more
+    std::exception_ptr error;
+    std::thread thread;
+  };
+
+  Ring* GetRing(int ring_id);
+  void CommLoop(Ring* ring);
+
+  platform::GlooParallelStrategy gloo_strategy_;
+  std::vector<std::unique_ptr<Ring>> rings_;
+};
+
+}  //  namespace imperative
+}  //  namespace paddle
+
+#endif
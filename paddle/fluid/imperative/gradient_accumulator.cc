@@ -434,6 +434,7 @@ void GradientAccumulator::AccumulateGrad() {
 
 void EagerGradientAccumulator::SumGrad(std::shared_ptr<VariableWrapper> var,
                                        size_t trace_id, bool unchange_input) {
+  std::lock_guard<std::mutex> guard(mutex_);
   /**
    * If var has grad node, it indicates that this var would be an input
    * of a grad op. Therefore, it should not be changed.
@@ -488,6 +489,7 @@ void EagerGradientAccumulator::SumGrad(std::shared_ptr<VariableWrapper> var,
 
 void SortedGradientAccumulator::SumGrad(std::shared_ptr<VariableWrapper> var,
                                         size_t trace_id, bool unchange_input) {
+  std::lock_guard<std::mutex> guard(mutex_);
   auto* dst_var = Var();
   platform::Place place = GetPlaceOfVar(var);
   if (!dst_var->OverridedStopGradient()) {
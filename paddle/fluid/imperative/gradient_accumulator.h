@@ -15,6 +15,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>  // NOLINT
 #include <utility>
 #include <vector>
 
@@ -84,6 +85,18 @@ class GradientAccumulator {
     return cur_cnt_ == ref_cnt_ || ref_cnt_ == 1;
   }
 
+  // Returns true only for the first call after the gradients of this graph
+  // are all summed, so that a leaf gradient reached by grad ops running on
+  // different threads is accumulated once.
+  bool TryFinishSumGrad() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (finished_ || !SumGradCompleted()) {
+      return false;
+    }
+    finished_ = true;
+    return true;
+  }
+
   std::shared_ptr<VariableWrapper>& InnerVar() { return inner_var_; }
 
   // return the var that will be calculated in this graph
@@ -138,6 +151,9 @@ class GradientAccumulator {
   size_t ref_cnt_{0};
   size_t cur_cnt_{0};
   std::weak_ptr<LeafVarHookPipeline> post_hooks_;
+  // SumGrad may be called by grad ops running in parallel
+  std::mutex mutex_;
+  bool finished_{false};
 };
 
 class EagerGradientAccumulator : public GradientAccumulator {
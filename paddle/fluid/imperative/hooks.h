@@ -73,6 +73,10 @@ class GradAccumulatorPostHook {
  public:
   virtual ~GradAccumulatorPostHook() = default;
   virtual void operator()(VariableWrapper* var) = 0;
+  // Whether the hook must see the leaf gradients in the same order on every
+  // run, then the backward pass runs its grad ops one by one even if
+  // FLAGS_dygraph_backward_num_threads > 1.
+  virtual bool NeedsSequentialBackward() const { return false; }
 };
 
 /** [ Hook for cpp functions ]
@@ -111,13 +115,20 @@ class GradAccumulatorPostHook {
 class LambdaGradAccumulatorPostHook : public GradAccumulatorPostHook {
  public:
   explicit LambdaGradAccumulatorPostHook(
-      std::function<void(VariableWrapper*)> fn)
-      : fn_(std::move(fn)) {}
+      std::function<void(VariableWrapper*)> fn,
+      bool needs_sequential_backward = false)
+      : fn_(std::move(fn)),
+        needs_sequential_backward_(needs_sequential_backward) {}
 
   void operator()(VariableWrapper* var) override { fn_(var); }
 
+  bool NeedsSequentialBackward() const override {
+    return needs_sequential_backward_;
+  }
+
  private:
   std::function<void(VariableWrapper*)> fn_;
+  bool needs_sequential_backward_;
 };
 
 /* Hooks for python function: in pybind/imperative.cc */
@@ -13,6 +13,7 @@
 // limitations under the License.
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -64,6 +65,13 @@ class ParallelContext {
   // if CPU, should do nothing.
   virtual void WaitComm(int ring_id) = 0;
 
+  // Runs task after the communication issued on ring_id before it. The
+  // contexts communicating on the host have no stream, they run it on a
+  // background thread of the ring so that it overlaps with the computation.
+  virtual void RunOnCommStream(int ring_id, std::function<void()> task) {
+    task();
+  }
+
   inline int GetNRings() const { return strategy_.nrings_; }
 
   inline int64_t GetNRanks() const { return strategy_.nranks_; }
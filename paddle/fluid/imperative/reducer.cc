@@ -28,7 +28,7 @@ namespace paddle {
 namespace imperative {
 
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL) || \
-    defined(PADDLE_WITH_XPU_BKCL)
+    defined(PADDLE_WITH_XPU_BKCL) || defined(PADDLE_WITH_GLOO)
 // div the nranks
 void Group::DivNRanks(const platform::DeviceContext &context, int64_t nranks) {
   framework::Tensor *tensor =
@@ -306,11 +306,15 @@ Reducer::Reducer(const std::vector<std::shared_ptr<imperative::VarBase>> &vars,
   for (size_t global_var_index = 0; global_var_index < vars_.size();
        ++global_var_index) {
     auto var = vars_[global_var_index];
+    // The groups are rebuilt in the order the gradients arrive, which must
+    // be the same on all the ranks, so the backward runs sequentially.
     var->SharedVar()->AddGradVarLeafBackwardHook(
         std::unique_ptr<LambdaGradAccumulatorPostHook>(
-            new LambdaGradAccumulatorPostHook([=](VariableWrapper *grad) {
-              this->AddDistHook(global_var_index);
-            })));
+            new LambdaGradAccumulatorPostHook(
+                [=](VariableWrapper *grad) {
+                  this->AddDistHook(global_var_index);
+                },
+                true)));
     var_index_map_[var->GradVarBase()->SharedVar().get()] = global_var_index;
   }
 }
@@ -645,6 +649,16 @@ void Reducer::MarkGroupReady(size_t group_index) {
     auto &group = groups_[next_group_];
     int run_order = next_group_ % nrings_;
 
+    if (platform::is_cpu_place(place_)) {
+      // There is no stream on CPU, the whole group is reduced on the
+      // communication thread of the ring while the backward pass goes on.
+      Group *p_group = &group;
+      parallel_ctx_->RunOnCommStream(run_order, [this, p_group, run_order] {
+        AllReduceGroupOnCPU(p_group, run_order);
+      });
+      continue;
+    }
+
     // For CUDA or XPU, compute_stream --> comm_stream.
     // For CPU, do nothing.
     // NOTE. Because concat uses the comm_stream,
@@ -693,6 +707,23 @@ void Reducer::MarkGroupReady(size_t group_index) {
   }
 }
 
+void Reducer::AllReduceGroupOnCPU(Group *group, int ring_id) {
+  auto *dev_ctx = parallel_ctx_->GetDeviceContext(ring_id);
+  if (group->is_sparse_) {
+    if (group->sparse_contents_ != nullptr) {
+      group->DivNRanks(*dev_ctx, nranks_);
+      parallel_ctx_->AllReduceByStream(
+          *group->sparse_contents_, group->sparse_contents_, ring_id, true);
+    }
+    return;
+  }
+  group->ConcatTensors(*dev_ctx);
+  group->DivNRanks(*dev_ctx, nranks_);
+  parallel_ctx_->AllReduceByStream(group->dense_contents_,
+                                   &(group->dense_contents_), ring_id, true);
+  group->SplitTensors(*dev_ctx);
+}
+
 std::vector<std::vector<size_t>> Reducer::RebuildGruops() {
   VLOG(3) << "The order of parameter arrival: "
           << string::join_strings(rebuild_var_indices_, ',');
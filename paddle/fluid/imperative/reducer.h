@@ -48,7 +48,7 @@ namespace paddle {
 namespace imperative {
 
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL) || \
-    defined(PADDLE_WITH_XPU_BKCL)
+    defined(PADDLE_WITH_XPU_BKCL) || defined(PADDLE_WITH_GLOO)
 
 template <typename T>
 struct DivNRanksFunctor {
@@ -160,6 +160,10 @@ class Reducer {
   inline bool NeedRebuildGroup() { return !has_rebuilt_group_; }
 
  private:
+  // Fuses, allreduces and splits the group on CPU, on the communication
+  // thread of ring_id.
+  void AllReduceGroupOnCPU(Group* group, int ring_id);
+
   std::vector<std::shared_ptr<imperative::VarBase>> vars_;
   std::vector<std::vector<size_t>> group_indices_;
   std::vector<Group> groups_;
@@ -0,0 +1,154 @@
+//   Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ftw.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/framework/selected_rows.h"
+#include "paddle/fluid/framework/variable.h"
+#include "paddle/fluid/imperative/gloo_context.h"
+#include "paddle/fluid/platform/port.h"
+
+namespace framework = paddle::framework;
+namespace imperative = paddle::imperative;
+namespace platform = paddle::platform;
+
+#if defined(PADDLE_WITH_GLOO)
+const int nranks = 3;
+
+double* FillTensor(framework::Tensor* tensor,
+                   const std::vector<int64_t>& dims, double value) {
+  auto* data = tensor->mutable_data<double>(framework::make_ddim(dims),
+                                            platform::CPUPlace());
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = value * i;
+  }
+  return data;
+}
+
+// Removes the files of the gloo file store and its directory.
+void RemoveStore(const std::string& store_path) {
+  nftw(store_path.c_str(),
+       [](const char* path, const struct stat*, int, struct FTW*) {
+         return std::remove(path);
+       },
+       16, FTW_DEPTH | FTW_PHYS);
+}
+
+void RunRank(const std::string& store_path, int rank) {
+  imperative::ParallelStrategy strategy;
+  strategy.nranks_ = nranks;
+  strategy.local_rank_ = rank;
+  strategy.nrings_ = 2;
+  platform::GlooParallelStrategy gloo_strategy;
+  gloo_strategy.rank = rank;
+  gloo_strategy.rank_num = nranks;
+  gloo_strategy.iface = "lo";
+  gloo_strategy.run_seconds = 60;
+  gloo_strategy.fs_path = store_path;
+  imperative::GlooParallelContext ctx(strategy, gloo_strategy);
+  ctx.Init();
+  // the sum of rank + 1 of all the ranks
+  double sum = nranks * (nranks + 1) / 2;
+
+  // in place on the calling thread
+  framework::Variable dense;
+  FillTensor(dense.GetMutable<framework::LoDTensor>(), {2, 3}, rank + 1);
+  ctx.AllReduceByStream(dense, &dense, 0, true);
+  auto& dense_tensor = dense.Get<framework::LoDTensor>();
+  EXPECT_EQ(dense_tensor.dims(), framework::make_ddim({2, 3}));
+  for (int64_t i = 0; i < dense_tensor.numel(); ++i) {
+    EXPECT_EQ(dense_tensor.data<double>()[i], sum * i);
+  }
+
+  // on the thread of ring 1, the tasks of a ring run in order
+  framework::Variable src, dst;
+  FillTensor(src.GetMutable<framework::LoDTensor>(), {100}, rank + 1);
+  ctx.AllReduceByStream(src, &dst, 1, false);
+  ctx.RunOnCommStream(1, [&] {
+    auto* tensor = dst.GetMutable<framework::LoDTensor>();
+    for (int64_t i = 0; i < tensor->numel(); ++i) {
+      tensor->data<double>()[i] /= nranks;
+    }
+  });
+  ctx.WaitComm(1);
+  auto& dst_tensor = dst.Get<framework::LoDTensor>();
+  ASSERT_EQ(dst_tensor.numel(), 100);
+  for (int64_t i = 0; i < dst_tensor.numel(); ++i) {
+    EXPECT_EQ(dst_tensor.data<double>()[i], sum / nranks * i);
+  }
+
+  // rank i has i + 1 rows
+  framework::Variable sparse;
+  auto* selected_rows = sparse.GetMutable<framework::SelectedRows>();
+  selected_rows->set_height(10);
+  std::vector<int64_t> rows;
+  for (int i = 0; i <= rank; ++i) {
+    rows.push_back(rank * 3 + i);
+  }
+  selected_rows->set_rows(rows);
+  FillTensor(selected_rows->mutable_value(), {rank + 1, 2}, rank + 1);
+  ctx.AllReduceByStream(sparse, &sparse, 0, true);
+  EXPECT_EQ(selected_rows->height(), 10);
+  ASSERT_EQ(selected_rows->rows().size(), static_cast<size_t>(sum));
+  auto& value = selected_rows->value();
+  ASSERT_EQ(value.dims(), framework::make_ddim({static_cast<int64_t>(sum), 2}));
+  size_t row = 0;
+  for (int i = 0; i < nranks; ++i) {
+    for (int j = 0; j <= i; ++j, ++row) {
+      EXPECT_EQ(selected_rows->rows()[row], i * 3 + j);
+      EXPECT_EQ(value.data<double>()[row * 2], (i + 1) * (j * 2));
+      EXPECT_EQ(value.data<double>()[row * 2 + 1], (i + 1) * (j * 2 + 1));
+    }
+  }
+}
+
+TEST(GlooParallelContext, AllReduceAcrossProcesses) {
+  std::string store_path =
+      "gloo_context_test_store_" + std::to_string(getpid());
+  MkDirRecursively(store_path.c_str());
+
+  int rank = 0;
+  std::vector<pid_t> children;
+  for (int i = 1; i < nranks; ++i) {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      rank = i;
+      break;
+    }
+    children.push_back(pid);
+  }
+
+  RunRank(store_path, rank);
+  if (rank != 0) {
+    _exit(testing::Test::HasFailure() ? 1 : 0);
+  }
+  for (auto pid : children) {
+    int status = 0;
+    EXPECT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+  }
+  RemoveStore(store_path);
+  EXPECT_FALSE(FileExists(store_path));
+}
+#endif
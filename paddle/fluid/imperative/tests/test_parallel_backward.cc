@@ -0,0 +1,243 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/imperative/basic_engine.h"
+#include "paddle/fluid/imperative/hooks.h"
+#include "paddle/fluid/imperative/parallel_context.h"
+#include "paddle/fluid/imperative/reducer.h"
+#include "paddle/fluid/imperative/tracer.h"
+#include "paddle/fluid/platform/timer.h"
+
+DECLARE_bool(sort_sum_gradient);
+DECLARE_int32(dygraph_backward_num_threads);
+
+namespace paddle {
+namespace imperative {
+
+using vb_vector = std::vector<std::shared_ptr<imperative::VarBase>>;
+using var_pair = std::pair<std::string, vb_vector>;
+
+namespace {
+
+constexpr int64_t kBatch = 64;
+constexpr int64_t kWidth = 256;
+constexpr int kNumTowers = 8;
+constexpr int kDepth = 4;
+
+std::shared_ptr<VarBase> CreateParam(const std::string& name, int64_t rows,
+                                     int64_t cols, int seed) {
+  std::shared_ptr<VarBase> var(new VarBase(true, name));
+  var->SetOverridedStopGradient(false);
+  auto* tensor = var->MutableVar()->GetMutable<framework::LoDTensor>();
+  tensor->Resize(framework::make_ddim({rows, cols}));
+  auto* data = tensor->mutable_data<float>(platform::CPUPlace());
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    data[i] = static_cast<float>((i * 7 + seed) % 13 - 6) / 32;
+  }
+  return var;
+}
+
+std::shared_ptr<VarBase> Trace(Tracer* tracer, const std::string& type,
+                               const std::shared_ptr<VarBase>& x,
+                               const std::shared_ptr<VarBase>& y,
+                               const std::string& out_name) {
+  std::shared_ptr<VarBase> out(new VarBase(true, out_name));
+  NameVarBaseMap ins = {var_pair("X", vb_vector(1, x)),
+                        var_pair("Y", vb_vector(1, y))};
+  NameVarBaseMap outs = {var_pair("Out", vb_vector(1, out))};
+  framework::AttributeMap attrs;
+  attrs["use_mkldnn"] = false;
+  tracer->TraceOp(type, ins, outs, attrs, platform::CPUPlace(), true);
+  return out;
+}
+
+// Traces a model of kNumTowers independent towers of kDepth mul ops on the
+// same input, whose outputs are summed, and returns the sum. params gets the
+// input and the weights.
+std::shared_ptr<VarBase> TraceWideModel(Tracer* tracer, vb_vector* params) {
+  auto x = CreateParam("x", kBatch, kWidth, 0);
+  params->assign(1, x);
+  std::shared_ptr<VarBase> loss;
+  for (int t = 0; t < kNumTowers; ++t) {
+    auto h = x;
+    for (int d = 0; d < kDepth; ++d) {
+      auto suffix = std::to_string(t) + "_" + std::to_string(d);
+      auto w = CreateParam("w_" + suffix, kWidth, kWidth, t * kDepth + d);
+      params->push_back(w);
+      h = Trace(tracer, "mul", h, w, "h_" + suffix);
+    }
+    loss = loss == nullptr ? h : Trace(tracer, "elementwise_add", loss, h,
+                                       "sum_" + std::to_string(t));
+  }
+  return loss;
+}
+
+std::vector<framework::LoDTensor> RunBackward(VarBase* loss,
+                                              const vb_vector& params,
+                                              int num_threads) {
+  FLAGS_dygraph_backward_num_threads = num_threads;
+  platform::Timer timer;
+  timer.Start();
+  BasicEngine engine;
+  engine.Init(loss);
+  engine.Execute();
+  LOG(INFO) << "Backward of " << kNumTowers << " towers on " << num_threads
+            << " threads takes " << timer.ElapsedMS() << "ms";
+  FLAGS_dygraph_backward_num_threads = 1;
+
+  std::vector<framework::LoDTensor> grads;
+  for (auto& param : params) {
+    grads.emplace_back(param->GradVar().Get<framework::LoDTensor>());
+  }
+  return grads;
+}
+
+// Runs the backward of the wide model and returns the gradients of the
+// input and of the weights.
+std::vector<framework::LoDTensor> RunWideModel(int num_threads,
+                                               int* num_x_hook_calls) {
+  Tracer tracer;
+  vb_vector params;
+  auto loss = TraceWideModel(&tracer, &params);
+  std::atomic<int> hook_calls{0};
+  params[0]->SharedVar()->AddGradVarLeafBackwardHook(
+      std::unique_ptr<LambdaGradAccumulatorPostHook>(
+          new LambdaGradAccumulatorPostHook(
+              [&hook_calls](VariableWrapper* grad) { ++hook_calls; })));
+
+  auto grads = RunBackward(loss.get(), params, num_threads);
+  *num_x_hook_calls = hook_calls;
+  return grads;
+}
+
+void ExpectSameGrads(const std::vector<framework::LoDTensor>& expected,
+                     const std::vector<framework::LoDTensor>& actual,
+                     float max_error) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected[i].numel(), actual[i].numel());
+    for (int64_t j = 0; j < expected[i].numel(); ++j) {
+      ASSERT_NEAR(expected[i].data<float>()[j], actual[i].data<float>()[j],
+                  max_error);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(TestParallelBackward, SortedSumIsDeterministic) {
+  FLAGS_sort_sum_gradient = true;
+  int sequential_hook_calls = 0;
+  int parallel_hook_calls = 0;
+  auto expected = RunWideModel(1, &sequential_hook_calls);
+  auto actual = RunWideModel(4, &parallel_hook_calls);
+  FLAGS_sort_sum_gradient = false;
+
+  // the gradient of x summed from all the towers is accumulated once
+  EXPECT_EQ(sequential_hook_calls, 1);
+  EXPECT_EQ(parallel_hook_calls, 1);
+  ExpectSameGrads(expected, actual, 0);
+}
+
+TEST(TestParallelBackward, EagerSum) {
+  int sequential_hook_calls = 0;
+  int parallel_hook_calls = 0;
+  auto expected = RunWideModel(1, &sequential_hook_calls);
+  for (int i = 0; i < 3; ++i) {
+    auto actual = RunWideModel(4, &parallel_hook_calls);
+    EXPECT_EQ(parallel_hook_calls, 1);
+    // the gradients of x are summed in the order the towers finish
+    ExpectSameGrads(expected, actual, 1e-4);
+  }
+}
+
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL) || \
+    defined(PADDLE_WITH_XPU_BKCL) || defined(PADDLE_WITH_GLOO)
+// A single rank, whose gradients are the reduced ones.
+class SingleRankContext : public ParallelContext {
+ public:
+  SingleRankContext()
+      : ParallelContext(ParallelStrategy(), platform::CPUPlace()) {}
+
+  void Init() override {}
+
+  void AllReduceByStream(const framework::Variable& src,
+                         framework::Variable* dst, int ring_id,
+                         bool use_calc_stream) override {
+    // the Reducer reduces in place
+    ASSERT_EQ(&src, dst);
+  }
+
+  platform::DeviceContext* GetDeviceContext(int ring_id) override {
+    return platform::DeviceContextPool::Instance().Get(platform::CPUPlace());
+  }
+
+  void WaitCompute(int ring_id) override {}
+
+  void WaitComm(int ring_id) override {}
+};
+
+TEST(TestParallelBackward, SequentialWithReducer) {
+  // the order the gradients of the parameters arrive in
+  auto run = [](int num_threads, std::vector<size_t>* order) {
+    Tracer tracer;
+    vb_vector params;
+    auto loss = TraceWideModel(&tracer, &params);
+    for (size_t i = 0; i < params.size(); ++i) {
+      params[i]->SharedVar()->AddGradVarLeafBackwardHook(
+          std::unique_ptr<LambdaGradAccumulatorPostHook>(
+              new LambdaGradAccumulatorPostHook(
+                  [order, i](VariableWrapper* grad) { order->push_back(i); })));
+    }
+    std::vector<bool> is_sparse(params.size(), false);
+    std::vector<size_t> group_size_limits = {1UL << 20};
+    auto group_indices =
+        AssignGroupBySize(params, is_sparse, group_size_limits);
+    EXPECT_GT(group_indices.size(), 1UL);
+    Reducer reducer(params, group_indices, is_sparse,
+                    std::make_shared<SingleRankContext>(), group_size_limits,
+                    false);
+    reducer.PrepareForBackward({loss});
+    return RunBackward(loss.get(), params, num_threads);
+  };
+
+  std::vector<size_t> expected_order;
+  auto expected = run(1, &expected_order);
+  ASSERT_EQ(expected_order.size(), 1UL + kNumTowers * kDepth);
+  for (int i = 0; i < 3; ++i) {
+    // the Reducer makes the backward run as with a single thread
+    std::vector<size_t> order;
+    auto actual = run(4, &order);
+    EXPECT_EQ(order, expected_order);
+    ExpectSameGrads(expected, actual, 0);
+  }
+}
+#endif
+
+}  // namespace imperative
+}  // namespace paddle
+
+USE_OP(mul);
+USE_OP(mul_grad);
+USE_OP(elementwise_add);
+USE_OP(elementwise_add_grad);
@@ -14,19 +14,26 @@
 
 #include "paddle/fluid/inference/api/analysis_predictor.h"
 #include <glog/logging.h>
+#include <xxhash.h>
 #include <algorithm>
+#include <cstdio>
 #include <fstream>
 #include <memory>
+#include <random>
 #include <set>
+#include <sstream>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include "paddle/fluid/framework/feed_fetch_method.h"
 #include "paddle/fluid/framework/feed_fetch_type.h"
 #include "paddle/fluid/framework/ir/fuse_pass_base.h"
+#include "paddle/fluid/framework/ir/gemm_weight_pack_pass.h"
 #include "paddle/fluid/framework/ir/pass.h"
 #include "paddle/fluid/framework/naive_executor.h"
 #include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/framework/var_type_traits.h"
 #include "paddle/fluid/framework/version.h"
 #include "paddle/fluid/inference/analysis/helper.h"
@@ -35,10 +42,13 @@
 #include "paddle/fluid/inference/api/paddle_inference_pass.h"
 #include "paddle/fluid/inference/utils/singleton.h"
 #include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/operators/math/gemm_pack.h"
 #include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/gpu_info.h"
+#include "paddle/fluid/platform/op_tracer.h"
 #include "paddle/fluid/platform/place.h"
+#include "paddle/fluid/platform/port.h"
 #include "paddle/fluid/platform/profiler.h"
 
 #ifdef PADDLE_WITH_MKLML
@@ -73,6 +83,38 @@ bool IsPersistable(const framework::VarDesc *var) {
   }
   return false;
 }
+
+bool ReadBinaryFile(const std::string &path, std::string *content) {
+  std::ifstream fin(path, std::ios::in | std::ios::binary);
+  if (!fin.is_open()) return false;
+  fin.seekg(0, std::ios::end);
+  content->resize(fin.tellg());
+  fin.seekg(0, std::ios::beg);
+  fin.read(&(*content)[0], content->size());
+  return static_cast<bool>(fin);
+}
+
+// Returns the size and modification time of the file at path, which stand
+// for its contents in the optim cache key without reading the whole file,
+// or an empty string if the file does not exist.
+std::string FileSignature(const std::string &path) {
+#if !defined(_WIN32)
+  struct stat statbuf;
+  if (stat(path.c_str(), &statbuf) != 0) return "";
+#else
+  struct _stat statbuf;
+  if (_stat(path.c_str(), &statbuf) != 0) return "";
+#endif
+  return std::to_string(statbuf.st_size) + ":" +
+         std::to_string(statbuf.st_mtime);
+}
+
+std::vector<std::string> SortedOptions(
+    const std::unordered_set<std::string> &options) {
+  std::vector<std::string> sorted(options.begin(), options.end());
+  std::sort(sorted.begin(), sorted.end());
+  return sorted;
+}
 }  // namespace
 
 bool PaddleTensorToLoDTensor(const PaddleTensor &pt, framework::LoDTensor *t,
@@ -150,7 +192,7 @@ bool AnalysisPredictor::Init(
     auto tracking_device = config_.use_gpu() ? platform::ProfilerState::kAll
                                              : platform::ProfilerState::kCPU;
     platform::EnableProfiler(tracking_device);
-  } else {
+  } else if (!parent_scope) {
     LOG(INFO) << "Profiler is deactivated, and no profiling report will be "
                  "generated.";
   }
@@ -215,19 +257,32 @@ bool AnalysisPredictor::PrepareProgram(
     const std::shared_ptr<framework::ProgramDesc> &program) {
   if (!program) {
     if (!LoadProgramDesc()) return false;
-    // If not cloned, the parameters should be loaded.
-    // If config_.ir_optim() is True, parameters is loaded in
-    // OptimizeInferenceProgram(), but other persistable variables
-    // (like RAW type var) are not created in scope.
-    // If config_.ir_optim() is False, parameters is loaded in LoadParameters(),
-    // still need to create other persistable variables.
-    // So in both case, create persistable variables at first.
-    executor_->CreateVariables(*inference_program_, 0, true, sub_scope_);
-
-    // if enable_ir_optim_ is false,
-    // the analysis pass(op fuse, graph analysis, trt subgraph, mkldnn etc) will
-    // not be executed.
-    OptimizeInferenceProgram();
+    // The program optimized for the same model and config before is loaded
+    // from the optim cache together with its persistables.
+    std::string optim_cache_key = OptimCacheKey();
+    if (optim_cache_key.empty() || !LoadOptimCache(optim_cache_key)) {
+      // If not cloned, the parameters should be loaded.
+      // If config_.ir_optim() is True, parameters is loaded in
+      // OptimizeInferenceProgram(), but other persistable variables
+      // (like RAW type var) are not created in scope.
+      // If config_.ir_optim() is False, parameters is loaded in
+      // LoadParameters(), still need to create other persistable variables.
+      // So in both case, create persistable variables at first.
+      executor_->CreateVariables(*inference_program_, 0, true, sub_scope_);
+
+      // if enable_ir_optim_ is false,
+      // the analysis pass(op fuse, graph analysis, trt subgraph, mkldnn etc)
+      // will not be executed.
+      OptimizeInferenceProgram();
+      if (!optim_cache_key.empty()) SaveOptimCache(optim_cache_key);
+    }
+    // All the passes have run, so the weights only read through their
+    // packed copies are not needed anymore, unless the optimized model is
+    // saved later. Clones share them.
+    if (config_.release_packed_gemm_weights()) {
+      framework::ir::ReleasePackedGemmWeights(*inference_program_,
+                                              scope_.get());
+    }
   } else {
     // If the program is passed from external, no need to optimize it, this
     // logic is used in the clone scenario.
@@ -235,9 +290,48 @@ bool AnalysisPredictor::PrepareProgram(
   }
 
   executor_->CreateVariables(*inference_program_, 0, false, sub_scope_);
+  ShadowMutablePersistables();
 
   return true;
 }
+
+void AnalysisPredictor::ShadowMutablePersistables() {
+  std::unordered_set<std::string> written;
+  for (size_t i = 0; i < inference_program_->Size(); ++i) {
+    for (auto *op : inference_program_->Block(i).AllOps()) {
+      if (op->Type() == "feed" || op->Type() == "fetch") continue;
+      for (auto &name : op->OutputArgumentNames()) {
+        written.insert(name);
+      }
+    }
+  }
+
+  const auto &global_block = inference_program_->Block(0);
+  int num_shadowed = 0;
+  for (auto &name : written) {
+    auto *var_desc = global_block.FindVar(name);
+    if (var_desc == nullptr || !IsPersistable(var_desc)) continue;
+    auto *shared = scope_->FindLocalVar(name);
+    if (shared == nullptr || sub_scope_->FindLocalVar(name) != nullptr) {
+      continue;
+    }
+    if (!shared->IsType<framework::LoDTensor>()) {
+      LOG(WARNING) << "Persistable variable " << name
+                   << " is written by the program but is not a LoDTensor, "
+                      "so it stays shared by all clones of the predictor.";
+      continue;
+    }
+    const auto &src = shared->Get<framework::LoDTensor>();
+    auto *dst = sub_scope_->Var(name)->GetMutable<framework::LoDTensor>();
+    if (src.IsInitialized()) {
+      framework::TensorCopySync(src, src.place(), dst);
+    }
+    dst->set_lod(src.lod());
+    ++num_shadowed;
+  }
+  VLOG(3) << "Shadowed " << num_shadowed
+          << " mutable persistable variables in the predictor scope.";
+}
 bool AnalysisPredictor::CreateExecutor() {
   if (config_.use_gpu()) {
     PADDLE_ENFORCE_EQ(config_.use_xpu(), false,
@@ -1110,6 +1204,16 @@ void AnalysisPredictor::SaveOptimModel(const std::string &dir) {
   std::vector<std::string> save_var_list;
   for (framework::VarDesc *var : global_block.AllVars()) {
     if (IsPersistable(var)) {
+      auto *scope_var = scope()->FindVar(var->Name());
+      PADDLE_ENFORCE_EQ(
+          scope_var == nullptr || !scope_var->IsType<framework::LoDTensor>() ||
+              scope_var->Get<framework::LoDTensor>().IsInitialized(),
+          true,
+          platform::errors::PreconditionNotMet(
+              "The weight %s was released after it was packed for GEMM, "
+              "turn off SwitchReleasePackedGemmWeights of the config to "
+              "save the optimized model.",
+              var->Name()));
       framework::VarDesc *new_var = save_block->Var(var->Name());
       new_var->SetShape(var->GetShape());
       new_var->SetDataType(var->GetDataType());
@@ -1132,6 +1236,188 @@ void AnalysisPredictor::SaveOptimModel(const std::string &dir) {
   exe.Run(save_program, scope(), 0, true, true);
 }
 
+std::string AnalysisPredictor::OptimCacheKey() {
+  // Only the optimization for CPU is cached, the engines of the other
+  // backends keep their own caches.
+  if (config_.opt_cache_dir_.empty() || !config_.ir_optim() ||
+      config_.use_gpu() || config_.use_xpu() ||
+      config_.lite_engine_enabled()) {
+    return "";
+  }
+#ifdef PADDLE_WITH_MKLDNN
+  // The quantizer analyzes the program again with argument_.
+  if (config_.mkldnn_quantizer_enabled()) return "";
+#endif
+
+  std::unique_ptr<XXH64_state_t, decltype(&XXH64_freeState)> state(
+      XXH64_createState(), &XXH64_freeState);
+  XXH64_reset(state.get(), 0);
+  auto update = [&state](const std::string &field) {
+    uint64_t size = field.size();
+    XXH64_update(state.get(), &size, sizeof(size));
+    XXH64_update(state.get(), field.data(), field.size());
+  };
+
+  update(get_version());
+  update(GetSerializedProgram());
+  if (config_.model_from_memory()) {
+    update(config_.params_file());
+  } else if (!config_.params_file().empty()) {
+    std::string params = FileSignature(config_.params_file());
+    if (params.empty()) return "";
+    update(params);
+  } else {
+    std::vector<std::string> names;
+    for (auto *var : inference_program_->Block(0).AllVars()) {
+      if (IsPersistable(var)) names.push_back(var->Name());
+    }
+    std::sort(names.begin(), names.end());
+    for (auto &name : names) {
+      update(name);
+      update(FileSignature(config_.model_dir() + "/" + name));
+    }
+  }
+
+  auto passes = config_.pass_builder()->AllPasses();
+  auto analysis_passes = config_.pass_builder()->AnalysisPasses();
+  passes.insert(passes.end(), analysis_passes.begin(), analysis_passes.end());
+  update(std::to_string(passes.size()));
+  for (auto &pass : passes) {
+    update(pass);
+  }
+
+  std::ostringstream options;
+  options << config_.mkldnn_enabled() << config_.mkldnn_bfloat16_enabled()
+          << config_.enable_memory_optim() << config_.use_fc_padding();
+  for (auto &type : SortedOptions(config_.mkldnn_enabled_op_types_)) {
+    options << " " << type;
+  }
+  options << ";";
+  for (auto &type : SortedOptions(config_.bfloat16_enabled_op_types_)) {
+    options << " " << type;
+  }
+  update(options.str());
+
+  std::ostringstream key;
+  key << std::hex << XXH64_digest(state.get());
+  return key.str();
+}
+
+bool AnalysisPredictor::LoadOptimCache(const std::string &key) {
+  std::string prefix = config_.opt_cache_dir_ + "/optim_" + key;
+  std::string content;
+  framework::proto::ProgramDesc proto;
+  if (!ReadBinaryFile(prefix + ".pdmodel", &content)) return false;
+  std::ifstream fin(prefix + ".pdiparams", std::ios::in | std::ios::binary);
+  if (!fin.is_open() || !proto.ParseFromString(content)) {
+    LOG(WARNING) << "Ignore the invalid optim cache " << prefix;
+    return false;
+  }
+
+  auto program = std::make_shared<framework::ProgramDesc>(proto);
+  try {
+    executor_->CreateVariables(*program, 0, true, sub_scope_);
+    auto &dev_ctx =
+        *platform::DeviceContextPool::Instance().Get(platform::CPUPlace());
+    uint64_t num_vars = 0;
+    fin.read(reinterpret_cast<char *>(&num_vars), sizeof(num_vars));
+    for (uint64_t i = 0; i < num_vars; ++i) {
+      uint64_t size = 0;
+      fin.read(reinterpret_cast<char *>(&size), sizeof(size));
+      std::string name(size, ' ');
+      fin.read(&name[0], size);
+      PADDLE_ENFORCE_EQ(static_cast<bool>(fin), true,
+                        platform::errors::InvalidArgument(
+                            "The optim cache %s is truncated.", prefix));
+      auto *var = scope_->FindLocalVar(name);
+      PADDLE_ENFORCE_NOT_NULL(
+          var, platform::errors::NotFound(
+                   "Variable %s of the optim cache %s is not in the program.",
+                   name, prefix));
+      framework::DeserializeFromStream(
+          fin, var->GetMutable<framework::LoDTensor>(), dev_ctx);
+    }
+  } catch (const std::exception &e) {
+    LOG(WARNING) << "Ignore the invalid optim cache " << prefix << ", "
+                 << e.what();
+    return false;
+  }
+
+  inference_program_ = program;
+  // the cache holds the weights before packing
+  framework::ir::PackGemmWeights(*inference_program_, scope_.get());
+  config_.PartiallyRelease();
+  LOG(INFO) << "Load the optimized program from the optim cache " << prefix;
+  return true;
+}
+
+void AnalysisPredictor::SaveOptimCache(const std::string &key) {
+  std::string prefix = config_.opt_cache_dir_ + "/optim_" + key;
+  // the files are written aside and renamed into place, the program last,
+  // so that a predictor started concurrently never reads a partial cache
+  std::string suffix = ".tmp" + std::to_string(std::random_device()());
+  try {
+    MkDirRecursively(config_.opt_cache_dir_.c_str());
+    std::vector<std::string> names;
+    for (auto *var : inference_program_->Block(0).AllVars()) {
+      auto *scope_var = scope_->FindLocalVar(var->Name());
+      // The packed GEMM weights depend on the ISA and the MKL version of
+      // the host, they are packed again after the cache is loaded.
+      if (var->Name().find(operators::math::kGemmPackedWeightSuffix) !=
+          std::string::npos) {
+        continue;
+      }
+      if (IsPersistable(var) && scope_var != nullptr &&
+          scope_var->IsType<framework::LoDTensor>() &&
+          scope_var->Get<framework::LoDTensor>().IsInitialized()) {
+        names.push_back(var->Name());
+      }
+    }
+    std::sort(names.begin(), names.end());
+
+    auto &dev_ctx =
+        *platform::DeviceContextPool::Instance().Get(platform::CPUPlace());
+    std::ofstream params(prefix + ".pdiparams" + suffix,
+                         std::ios::out | std::ios::binary);
+    uint64_t num_vars = names.size();
+    params.write(reinterpret_cast<const char *>(&num_vars), sizeof(num_vars));
+    for (auto &name : names) {
+      uint64_t size = name.size();
+      params.write(reinterpret_cast<const char *>(&size), sizeof(size));
+      params.write(name.data(), size);
+      framework::SerializeToStream(
+          params, scope_->FindLocalVar(name)->Get<framework::LoDTensor>(),
+          dev_ctx);
+    }
+    params.close();
+    std::ofstream model(prefix + ".pdmodel" + suffix,
+                        std::ios::out | std::ios::binary);
+    model << GetSerializedProgram();
+    model.close();
+    PADDLE_ENFORCE_EQ(
+        params.good() && model.good(), true,
+        platform::errors::Unavailable("Failed to write the optim cache %s.",
+                                      prefix));
+
+    for (std::string ext : {".pdiparams", ".pdmodel"}) {
+#if defined(_WIN32)
+      std::remove((prefix + ext).c_str());
+#endif
+      PADDLE_ENFORCE_EQ(
+          std::rename((prefix + ext + suffix).c_str(), (prefix + ext).c_str()),
+          0, platform::errors::Unavailable("Failed to publish %s.",
+                                           prefix + ext));
+    }
+    LOG(INFO) << "Save the optimized program of " << names.size()
+              << " persistables to the optim cache " << prefix;
+  } catch (const std::exception &e) {
+    std::remove((prefix + ".pdiparams" + suffix).c_str());
+    std::remove((prefix + ".pdmodel" + suffix).c_str());
+    LOG(WARNING) << "Failed to save the optim cache " << prefix << ", "
+                 << e.what();
+  }
+}
+
 template <>
 std::unique_ptr<PaddlePredictor> CreatePaddlePredictor<AnalysisConfig>(
     const AnalysisConfig &config) {
@@ -1265,6 +1551,14 @@ std::string UpdateDllFlag(const char *name, const char *value) {
   return paddle::UpdateDllFlag(name, value);
 }
 
+void SetOpTraceSamplingRate(double rate) {
+  paddle::platform::OpTracer::SetSamplingRate(rate);
+}
+
+void ExportOpTrace(const std::string &path) {
+  paddle::platform::OpTracer::Instance().ExportChromeTrace(path, true);
+}
+
 }  // namespace paddle_infer
 
 namespace paddle_infer {
@@ -213,6 +213,11 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   /// \brief Clone to get the new predictor. thread safe.
   ///
+  /// The clone shares the parameter scope and the optimized program with this
+  /// predictor and neither reloads nor re-optimizes the model. It only owns
+  /// its operators, its activations and a private copy of the persistable
+  /// variables the program writes.
+  ///
   /// \return get a new predictor
   ///
   std::unique_ptr<PaddlePredictor> Clone() override;
@@ -278,6 +283,16 @@ class AnalysisPredictor : public PaddlePredictor {
   /// \return Whether the function executed successfully
   ///
   bool PrepareExecutor();
+  ///
+  /// \brief Give this predictor a private copy of every persistable variable
+  /// that an op of the program writes.
+  ///
+  /// The parameters in scope_ are shared by all the clones of a predictor and
+  /// must stay read-only. The copies are created in sub_scope_, where they
+  /// shadow the shared variables, so only the (usually tiny) mutable state is
+  /// duplicated per predictor.
+  ///
+  void ShadowMutablePersistables();
 
   ///
   /// \brief Load model program.
@@ -291,6 +306,32 @@ class AnalysisPredictor : public PaddlePredictor {
   /// \return Whether the function executed successfully
   ///
   bool LoadParameters();
+  ///
+  /// \brief Compute the key of the optimized program cache, a hash of the
+  /// model program, the size and modification time of the parameter files,
+  /// the IR passes and the config options that change the optimized
+  /// program. The parameter files are not read, so a file rewritten with
+  /// the same size within the same second still hits the cache.
+  ///
+  /// \return The key, or an empty string if the cache is not used
+  ///
+  std::string OptimCacheKey();
+  ///
+  /// \brief Load the optimized program and its persistables saved in the
+  /// optim cache dir under the key.
+  ///
+  /// \param[in] key The key of the cache
+  /// \return Whether a valid cache was found and loaded
+  ///
+  bool LoadOptimCache(const std::string &key);
+  ///
+  /// \brief Save the optimized program and its persistables to the optim
+  /// cache dir under the key, so the next predictor of the same model and
+  /// config skips the analysis.
+  ///
+  /// \param[in] key The key of the cache
+  ///
+  void SaveOptimCache(const std::string &key);
 
   ///
   /// \brief Prepare input data, only used in Run()
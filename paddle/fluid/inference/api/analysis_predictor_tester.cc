@@ -15,9 +15,17 @@
 #include "paddle/fluid/inference/api/analysis_predictor.h"
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#ifdef __linux__
+#include <dirent.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <fstream>
 #include <thread>  // NOLINT
 #include "paddle/fluid/framework/ir/pass.h"
 #include "paddle/fluid/framework/tensor.h"
+#include "paddle/fluid/inference/analysis/helper.h"
 #include "paddle/fluid/inference/api/helper.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/tests/api/tester_helper.h"
@@ -195,6 +203,205 @@ TEST(AnalysisPredictor, Clone) {
   }
 }
 
+// Resident set size of the process in bytes, or 0 where it is unknown.
+static int64_t CurrentRSSBytes() {
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  int64_t total_pages = 0, resident_pages = 0;
+  if (statm >> total_pages >> resident_pages) {
+    return resident_pages * sysconf(_SC_PAGESIZE);
+  }
+#endif
+  return 0;
+}
+
+TEST(AnalysisPredictor, CloneSharesParameters) {
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.SwitchUseFeedFetchOps(true);
+  config.SwitchIrOptim(true);
+  auto main_predictor = CreatePaddlePredictor(config);
+
+  int64_t data[4] = {1, 2, 3, 4};
+  PaddleTensor tensor;
+  tensor.shape = std::vector<int>({4, 1});
+  tensor.data.Reset(data, sizeof(data));
+  tensor.dtype = PaddleDType::INT64;
+  std::vector<PaddleTensor> inputs(4, tensor);
+  std::vector<PaddleTensor> outputs;
+  ASSERT_TRUE(main_predictor->Run(inputs, &outputs));
+
+  const int num_clones = 8;
+  std::vector<std::unique_ptr<PaddlePredictor>> clones;
+  int64_t rss_before = CurrentRSSBytes();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_clones; ++i) {
+    clones.emplace_back(main_predictor->Clone());
+  }
+  auto end = std::chrono::steady_clock::now();
+  for (auto& clone : clones) {
+    ASSERT_TRUE(clone->Run(inputs, &outputs));
+  }
+  int64_t rss_after = CurrentRSSBytes();
+  double clone_ms =
+      std::chrono::duration<double, std::milli>(end - start).count() /
+      num_clones;
+  LOG(INFO) << "Clone latency: " << clone_ms << " ms per clone, RSS growth: "
+            << (rss_after - rss_before) / num_clones
+            << " bytes per clone after one run.";
+
+  // Every clone resolves the parameters to the single shared copy.
+  auto* main_analysis = static_cast<AnalysisPredictor*>(main_predictor.get());
+  framework::Scope* root_scope = main_analysis->scope();
+  int64_t param_bytes = 0;
+  std::vector<std::string> params;
+  for (auto* var : main_analysis->program().Block(0).AllVars()) {
+    auto* root_var = root_scope->FindLocalVar(var->Name());
+    if (var->Persistable() && root_var != nullptr &&
+        root_var->IsType<framework::LoDTensor>()) {
+      params.push_back(var->Name());
+      param_bytes += root_var->Get<framework::LoDTensor>().memory_size();
+    }
+  }
+  ASSERT_FALSE(params.empty());
+  for (auto& clone : clones) {
+    EXPECT_EQ(static_cast<AnalysisPredictor*>(clone.get())->scope(),
+              root_scope);
+  }
+  for (auto* kid : root_scope->kids()) {
+    for (auto& name : params) {
+      EXPECT_EQ(kid->FindLocalVar(name), nullptr) << name;
+    }
+  }
+  LOG(INFO) << "Shared parameter footprint: " << param_bytes << " bytes.";
+}
+
+#ifdef __linux__
+TEST(AnalysisPredictor, OptimCache) {
+  std::string cache_dir = "./optim_cache_test_" + std::to_string(getpid());
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.DisableGpu();
+  config.SwitchUseFeedFetchOps(true);
+  config.SwitchIrOptim(true);
+  config.SetOptimCacheDir(cache_dir);
+
+  int64_t data[4] = {1, 2, 3, 4};
+  PaddleTensor tensor;
+  tensor.shape = std::vector<int>({4, 1});
+  tensor.data.Reset(data, sizeof(data));
+  tensor.dtype = PaddleDType::INT64;
+  std::vector<PaddleTensor> inputs(4, tensor);
+
+  auto num_cached_programs = [&cache_dir]() {
+    int num = 0;
+    DIR* dir = opendir(cache_dir.c_str());
+    if (dir == nullptr) return num;
+    while (auto* entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if (name.size() > 8 && name.substr(name.size() - 8) == ".pdmodel") {
+        ++num;
+      }
+    }
+    closedir(dir);
+    return num;
+  };
+  std::vector<std::string> packed_weights;
+  auto create_and_run = [&](double* startup_ms,
+                            std::vector<PaddleTensor>* outputs) {
+    auto start = std::chrono::steady_clock::now();
+    auto predictor = CreatePaddlePredictor(config);
+    auto end = std::chrono::steady_clock::now();
+    *startup_ms =
+        std::chrono::duration<double, std::milli>(end - start).count();
+    EXPECT_TRUE(predictor->Run(inputs, outputs));
+    auto* analysis = static_cast<AnalysisPredictor*>(predictor.get());
+    packed_weights.clear();
+    for (auto& name : analysis->scope()->LocalVarNames()) {
+      if (name.find("@GEMM_PACKED") != std::string::npos) {
+        packed_weights.push_back(name);
+      }
+    }
+    std::sort(packed_weights.begin(), packed_weights.end());
+    return analysis->GetSerializedProgram();
+  };
+
+  double cold_ms, warm_ms;
+  std::vector<PaddleTensor> cold_outputs, warm_outputs;
+  std::string cold_program = create_and_run(&cold_ms, &cold_outputs);
+  auto cold_packed_weights = packed_weights;
+  EXPECT_EQ(num_cached_programs(), 1);
+  std::string warm_program = create_and_run(&warm_ms, &warm_outputs);
+  LOG(INFO) << "Predictor startup: " << cold_ms << " ms without the optim "
+            << "cache, " << warm_ms << " ms with it.";
+
+  // The cached predictor runs the same optimized program, with the weights
+  // packed again for the host instead of loaded from the cache.
+  EXPECT_EQ(cold_program, warm_program);
+  EXPECT_EQ(cold_packed_weights, packed_weights);
+  ASSERT_EQ(cold_outputs.size(), warm_outputs.size());
+  for (size_t i = 0; i < cold_outputs.size(); ++i) {
+    ASSERT_EQ(cold_outputs[i].data.length(), warm_outputs[i].data.length());
+    auto* cold = static_cast<float*>(cold_outputs[i].data.data());
+    auto* warm = static_cast<float*>(warm_outputs[i].data.data());
+    for (size_t j = 0; j < cold_outputs[i].data.length() / sizeof(float);
+         ++j) {
+      EXPECT_FLOAT_EQ(cold[j], warm[j]);
+    }
+  }
+
+  // The cache is reused, while another pass list misses it.
+  EXPECT_EQ(num_cached_programs(), 1);
+  config.pass_builder()->DeletePass("fc_fuse_pass");
+  double other_ms;
+  std::vector<PaddleTensor> other_outputs;
+  create_and_run(&other_ms, &other_outputs);
+  EXPECT_EQ(num_cached_programs(), 2);
+}
+
+TEST(AnalysisPredictor, ReleasePackedGemmWeights) {
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.DisableGpu();
+  config.SwitchUseFeedFetchOps(true);
+  config.SwitchIrOptim(true);
+  ASSERT_FALSE(config.release_packed_gemm_weights());
+
+  int64_t data[4] = {1, 2, 3, 4};
+  PaddleTensor tensor;
+  tensor.shape = std::vector<int>({4, 1});
+  tensor.data.Reset(data, sizeof(data));
+  tensor.dtype = PaddleDType::INT64;
+  std::vector<PaddleTensor> inputs(4, tensor);
+
+  // By default the weights packed for GEMM are kept, so the optimized model
+  // can be saved.
+  std::vector<PaddleTensor> kept_outputs;
+  auto predictor = CreatePaddlePredictor(config);
+  ASSERT_TRUE(predictor->Run(inputs, &kept_outputs));
+  std::string save_dir = "./release_packed_test_" + std::to_string(getpid());
+  ASSERT_EQ(MKDIR(save_dir.c_str()), 0);
+  static_cast<AnalysisPredictor*>(predictor.get())->SaveOptimModel(save_dir);
+
+  // Released on demand, the predictor computes the same outputs.
+  config.SwitchReleasePackedGemmWeights(true);
+  std::vector<PaddleTensor> released_outputs;
+  auto released = CreatePaddlePredictor(config);
+  ASSERT_TRUE(released->Run(inputs, &released_outputs));
+  ASSERT_EQ(kept_outputs.size(), released_outputs.size());
+  for (size_t i = 0; i < kept_outputs.size(); ++i) {
+    ASSERT_EQ(kept_outputs[i].data.length(),
+              released_outputs[i].data.length());
+    auto* kept = static_cast<float*>(kept_outputs[i].data.data());
+    auto* rel = static_cast<float*>(released_outputs[i].data.data());
+    for (size_t j = 0; j < kept_outputs[i].data.length() / sizeof(float);
+         ++j) {
+      EXPECT_FLOAT_EQ(kept[j], rel[j]);
+    }
+  }
+}
+#endif
+
 // This function is not released yet, will fail on some machine.
 // TODO(Superjomn) Turn on it latter.
 /*
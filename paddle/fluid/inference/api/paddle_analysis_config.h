@@ -524,6 +524,26 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool enable_memory_optim() const;
 
+  ///
+  /// \brief Control whether to release the weights that gemm_weight_pack_pass
+  /// packed for GEMM once the program is optimized. It saves the memory of
+  /// one copy of these weights, but then SaveOptimModel cannot save them.
+  ///
+  /// \param x Whether to release the packed GEMM weights.
+  ///
+  void SwitchReleasePackedGemmWeights(int x = true) {
+    release_packed_gemm_weights_ = x;
+  }
+  ///
+  /// \brief A boolean state telling whether the weights packed for GEMM are
+  /// released.
+  ///
+  /// \return bool Whether to release the packed GEMM weights.
+  ///
+  bool release_packed_gemm_weights() const {
+    return release_packed_gemm_weights_;
+  }
+
   ///
   /// \brief Turn on profiling report.
   /// If not turned on, no profiling report will be generated.
@@ -629,6 +649,7 @@ struct PD_INFER_DECL AnalysisConfig {
 
   // memory reuse related.
   bool enable_memory_optim_{false};
+  bool release_packed_gemm_weights_{false};
 
   bool use_mkldnn_{false};
   std::unordered_set<std::string> mkldnn_enabled_op_types_;
@@ -258,6 +258,19 @@ PD_INFER_DECL int GetNumBytesOfDataType(DataType dtype);
 PD_INFER_DECL std::string GetVersion();
 PD_INFER_DECL std::string UpdateDllFlag(const char* name, const char* value);
 
+///
+/// \brief Set the fraction of the outermost op spans of every thread kept by
+/// the op tracer, 0 disables it. The tracer is cheap enough to stay on while
+/// serving.
+///
+PD_INFER_DECL void SetOpTraceSamplingRate(double rate);
+
+///
+/// \brief Export the spans kept by the op tracer to a Chrome trace JSON file,
+/// which can be opened by chrome://tracing or Perfetto, and drop them.
+///
+PD_INFER_DECL void ExportOpTrace(const std::string& path);
+
 template <typename T>
 void Tensor::CopyFromCpu(const T* data) {
   tensor_->copy_from_cpu<T>(data);
@@ -289,7 +302,9 @@ namespace services {
 /// \brief PredictorPool is a simple encapsulation of Predictor, suitable for
 /// use in multi-threaded situations. According to the thread id, the
 /// corresponding Predictor is taken out from PredictorPool to complete the
-/// prediction.
+/// prediction. Except with TensorRT, whose engines are bound to a predictor,
+/// the predictors are clones of the first one and share its parameters and
+/// optimized program, so each extra predictor only costs its activations.
 ///
 class PD_INFER_DECL PredictorPool {
  public:
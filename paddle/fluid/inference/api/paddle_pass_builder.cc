@@ -119,6 +119,7 @@ GpuPassStrategy::GpuPassStrategy() : PassStrategy({}) {
   passes_.assign({
     //   "identity_scale_op_clean_pass",             //
     "is_test_pass",                                  //
+        "redundant_op_elimination_pass",             //
         "simplify_with_basic_ops_pass",              //
         "conv_affine_channel_fuse_pass",             //
         "conv_eltwiseadd_affine_channel_fuse_pass",  //
@@ -173,7 +174,9 @@ void GpuPassStrategy::EnableMkldnnBfloat16() {
 CpuPassStrategy::CpuPassStrategy() : PassStrategy({}) {
   // NOTE the large fusions should be located in the front, so that they will
   // not be damaged by smaller ones.
-  passes_.assign({"simplify_with_basic_ops_pass",  //
+  passes_.assign({"constant_folding_pass",          //
+                  "redundant_op_elimination_pass",  //
+                  "simplify_with_basic_ops_pass",   //
                   "layer_norm_fuse_pass",
                   "attention_lstm_fuse_pass",       //
                   "seqconv_eltadd_relu_fuse_pass",  //
@@ -197,6 +200,7 @@ CpuPassStrategy::CpuPassStrategy() : PassStrategy({}) {
                   "conv_eltwiseadd_bn_fuse_pass",            //
                   "conv_transpose_bn_fuse_pass",             //
                   "conv_transpose_eltwiseadd_bn_fuse_pass",  //
+                  "gemm_weight_pack_pass",                   //
                   "is_test_pass",                            //
                   // following pass should be located in the last, since
                   // it will work on all fused ops.
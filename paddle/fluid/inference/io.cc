@@ -23,10 +23,14 @@ limitations under the License. */
 #include "paddle/fluid/framework/version.h"
 #include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/pybind/pybind.h"
+#ifndef _WIN32
+#include "paddle/fluid/framework/mapped_params_loader.h"
+#endif
 
 DEFINE_string(devices, "", "The devices to be used which is joined by comma.");
 DEFINE_int32(math_num_threads, 1,
              "Number of threads used to run math functions.");
+DECLARE_bool(mmap_combined_params);
 
 namespace paddle {
 namespace inference {
@@ -107,9 +111,19 @@ void LoadPersistables(framework::Executor* executor, framework::Scope* scope,
     }
   }
 
+#ifndef _WIN32
+  // The CPU parameters share the pages of the mapped file.
+  bool mmap_params = FLAGS_mmap_combined_params && !param_filename.empty() &&
+                     !model_from_memory &&
+                     platform::is_cpu_place(executor->GetPlace());
+#else
+  bool mmap_params = false;
+#endif
   if (!param_filename.empty()) {
     // sort paramlist to have consistent ordering
     std::sort(paramlist.begin(), paramlist.end());
+  }
+  if (!param_filename.empty() && !mmap_params) {
     // append just the load_combine op
     framework::OpDesc* op = load_block->AppendOp();
     op->SetType("load_combine");
@@ -120,6 +134,15 @@ void LoadPersistables(framework::Executor* executor, framework::Scope* scope,
   }
 
   executor->Run(*load_program, scope, 0, true, true);
+#ifndef _WIN32
+  if (mmap_params) {
+    std::vector<framework::LoDTensor*> tensors;
+    for (auto& name : paramlist) {
+      tensors.push_back(scope->Var(name)->GetMutable<framework::LoDTensor>());
+    }
+    framework::LoadCombinedFromMappedFile(param_filename, tensors);
+  }
+#endif
 
   delete load_program;
 }
@@ -28,6 +28,11 @@ TEST(Analyzer_Transformer, fuse_statis) {
   auto predictor = CreatePaddlePredictor<AnalysisConfig>(cfg);
   auto fuse_statis = GetFuseStatis(
       static_cast<AnalysisPredictor *>(predictor.get()), &num_ops);
+  // the ops removed by common-subexpression and dead-op elimination
+  ASSERT_TRUE(fuse_statis.count("redundant_op_elimination_pass"));
+  LOG(INFO) << "redundant ops removed: "
+            << fuse_statis.at("redundant_op_elimination_pass") << ", "
+            << num_ops << " ops left";
 }
 
 }  // namespace transformer_tester
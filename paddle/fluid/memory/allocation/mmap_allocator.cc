@@ -19,6 +19,10 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
 #include <random>
 #include <string>
 
@@ -49,6 +53,12 @@ MemoryMapReaderAllocation::~MemoryMapReaderAllocation() {
   VLOG(3) << "~MemoryMapReaderAllocation: " << this->ipc_name();
 }
 
+MemoryMapFileAllocation::~MemoryMapFileAllocation() {
+  PADDLE_ENFORCE_NE(munmap(this->ptr(), this->size()), -1,
+                    platform::errors::Unavailable(
+                        "could not unmap the file %s", this->path()));
+}
+
 std::string GetIPCName() {
   static std::random_device rd;
   std::string handle = "/paddle_";
@@ -99,6 +109,33 @@ std::shared_ptr<MemoryMapReaderAllocation> RebuildMemoryMapReaderAllocation(
   return std::make_shared<MemoryMapReaderAllocation>(ptr, size, ipc_name);
 }
 
+std::shared_ptr<MemoryMapFileAllocation> AllocateMemoryMapFileAllocation(
+    const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  PADDLE_ENFORCE_NE(fd, -1, platform::errors::Unavailable(
+                                "Failed to open file %s, %s.", path,
+                                std::strerror(errno)));
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    close(fd);
+    PADDLE_THROW(platform::errors::Unavailable(
+        "Cannot map file %s, it is empty or its size is unknown.", path));
+  }
+  size_t size = static_cast<size_t>(file_stat.st_size);
+
+  // written pages are copied, so the file and the other mappings of it
+  // never see the changes
+  void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  PADDLE_ENFORCE_NE(ptr, MAP_FAILED,
+                    platform::errors::Unavailable(
+                        "Memory map failed for file %s, %s.", path,
+                        std::strerror(errno)));
+  // start reading the file ahead asynchronously
+  madvise(ptr, size, MADV_WILLNEED);
+  return std::make_shared<MemoryMapFileAllocation>(ptr, size, path);
+}
+
 MemoryMapFdSet &MemoryMapFdSet::Instance() {  // NOLINT
   static MemoryMapFdSet set;
   return set;
@@ -58,12 +58,44 @@ class MemoryMapReaderAllocation : public Allocation {
   std::string ipc_name_;
 };
 
+// A private copy-on-write mapping of a whole file. Its pages stay shared
+// with the page cache, and so with the other processes mapping the file,
+// until they are written.
+class MemoryMapFileAllocation : public Allocation {
+ public:
+  explicit MemoryMapFileAllocation(void *ptr, size_t size, std::string path)
+      : Allocation(ptr, size, platform::CPUPlace()), path_(std::move(path)) {}
+
+  inline const std::string &path() const { return path_; }
+
+  ~MemoryMapFileAllocation() override;
+
+ private:
+  std::string path_;
+};
+
+// A region of a mapped file, which keeps the mapping alive.
+class MemoryMapRegionAllocation : public Allocation {
+ public:
+  MemoryMapRegionAllocation(std::shared_ptr<MemoryMapFileAllocation> file,
+                            size_t offset, size_t size)
+      : Allocation(static_cast<uint8_t *>(file->ptr()) + offset, size,
+                   platform::CPUPlace()),
+        file_(std::move(file)) {}
+
+ private:
+  std::shared_ptr<MemoryMapFileAllocation> file_;
+};
+
 std::shared_ptr<MemoryMapWriterAllocation> AllocateMemoryMapWriterAllocation(
     size_t size);
 
 std::shared_ptr<MemoryMapReaderAllocation> RebuildMemoryMapReaderAllocation(
     const std::string &ipc_name, size_t size);
 
+std::shared_ptr<MemoryMapFileAllocation> AllocateMemoryMapFileAllocation(
+    const std::string &path);
+
 class MemoryMapFdSet {
  public:
   static MemoryMapFdSet &Instance();  // NOLINT
@@ -14,6 +14,8 @@ limitations under the License. */
 
 #include "paddle/fluid/operators/controlflow/conditional_block_op.h"
 
+DECLARE_bool(use_mkldnn);
+
 namespace paddle {
 namespace framework {
 class OpDesc;
@@ -68,15 +70,25 @@ class ConditionalBlockInferOp : public ConditionalOp {
                          "Scope must be set in ConditionalBlockInferOp."));
       auto *scopes = scope_var->GetMutable<std::vector<framework::Scope *>>();
       scopes->resize(1);
-      scopes->front() = &scope.NewScope();
+      // the sub scope and its variables are recycled across runs
+      bool created = false;
+      scopes->front() = step_scope_.Acquire(scope, &created);
       auto &cur_scope = *scopes->front();
+      if (!created) {
+        ResetStepScopeVars(cur_scope);
+      }
 
       framework::Executor exec(dev_place);
       auto *block = Attr<framework::BlockDesc *>("sub_block");
-      exec.Run(*block->Program(), &cur_scope, block->ID(), false);
-      scope.DeleteScope(scopes->front());
+      platform::RecordBlock b(block->ID());
+      auto ctx = prepared_block_.Get(&exec, *block, std::vector<std::string>(),
+                                     FLAGS_use_mkldnn);
+      exec.RunPreparedContext(ctx.get(), &cur_scope, false);
     }
   }
+
+  mutable PreparedBlockCache prepared_block_;
+  mutable StepScopeCache step_scope_;
 };
 
 }  // namespace operators
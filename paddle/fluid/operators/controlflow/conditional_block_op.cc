@@ -17,6 +17,8 @@ limitations under the License. */
 #include "paddle/fluid/operators/assign_op.h"
 #include "paddle/fluid/operators/math/math_function.h"
 
+DECLARE_bool(use_mkldnn);
+
 namespace paddle {
 namespace operators {
 
@@ -71,11 +73,15 @@ class ConditionalBlockOp : public ConditionalOp {
               << ", scope = " << &cur_scope;
       auto &skip_vars =
           Attr<std::vector<std::string>>(ConditionalOp::kSkipEagerDeletionVars);
-      exec.Run(*block->Program(), &cur_scope, block->ID(), false, true,
-               skip_vars, /* force_disable_gc */ false,
-               /* keep_kid_scopes */ true);
+      platform::RecordBlock b(block->ID());
+      auto ctx =
+          prepared_block_.Get(&exec, *block, skip_vars, FLAGS_use_mkldnn);
+      exec.RunPreparedContext(ctx.get(), &cur_scope, false, true,
+                              /* keep_kid_scopes */ true);
     }
   }
+
+  mutable PreparedBlockCache prepared_block_;
 };
 
 class ConditionalBlockInferShape : public framework::InferShapeBase {
@@ -138,9 +144,11 @@ class ConditionalBlockGradOp : public ConditionalOp {
 
       VLOG(3) << "Conditional Grad block.idx = " << block->ID()
               << ", scope = " << &cur_scope;
-      exec.Run(*block->Program(), &cur_scope, block->ID(), false, true,
-               inside_grads, /* force_disable_gc */ false,
-               /* keep_kid_scopes */ false);
+      platform::RecordBlock b(block->ID());
+      auto ctx =
+          prepared_block_.Get(&exec, *block, inside_grads, FLAGS_use_mkldnn);
+      exec.RunPreparedContext(ctx.get(), &cur_scope, false, true,
+                              /* keep_kid_scopes */ false);
 
       AssignLocalGradientToParentScope(dev_place, cur_scope, scope,
                                        inside_grads, outside_grads);
@@ -248,6 +256,8 @@ class ConditionalBlockGradOp : public ConditionalOp {
     math::set_constant(*dev_ctx, outside_tensor, 0.0f);
     outside_tensor->set_lod(input_tensor.lod());
   }
+
+  mutable PreparedBlockCache prepared_block_;
 };
 
 class ConditionalBlockGradInferShape : public framework::InferShapeBase {
@@ -22,6 +22,8 @@ limitations under the License. */
 #include "paddle/fluid/framework/executor.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/var_type.h"
+#include "paddle/fluid/operators/controlflow/prepared_block_cache.h"
+#include "paddle/fluid/platform/profiler.h"
 
 namespace paddle {
 namespace operators {
@@ -14,6 +14,8 @@ limitations under the License. */
 
 #include "paddle/fluid/operators/controlflow/conditional_block_op.h"
 
+#include <chrono>  // NOLINT
+
 #include "gtest/gtest.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/scope.h"
@@ -74,3 +76,86 @@ TEST(ConditionalBlockGrad, NoNeedRunLoDTensorArray) {
     }
   }
 }
+
+namespace {
+
+void AppendConditionalBlock(paddle::framework::BlockDesc* block,
+                            paddle::framework::BlockDesc* sub_block,
+                            const std::string& scope_var) {
+  auto* op = block->AppendOp();
+  op->SetType("conditional_block");
+  op->SetInput("Cond", {"condition"});
+  op->SetInput("Input", {});
+  op->SetOutput("Out", {});
+  op->SetOutput("Scope", {scope_var});
+  op->SetAttr("sub_block", sub_block);
+  op->SetAttr("is_scalar_condition", true);
+  block->Var(scope_var)->SetType(
+      paddle::framework::proto::VarType::STEP_SCOPES);
+}
+
+const std::vector<Scope*>& StepScopes(const Scope& scope,
+                                      const std::string& name) {
+  return scope.FindVar(name)->Get<std::vector<Scope*>>();
+}
+
+}  // namespace
+
+TEST(ConditionalBlock, CachedPreparedContext) {
+  Place place = paddle::platform::CPUPlace();
+  Scope scope;
+  LoDTensor* cond_tensor = scope.Var("condition")->GetMutable<LoDTensor>();
+  cond_tensor->mutable_data<bool>(paddle::framework::make_ddim({1}),
+                                  place)[0] = true;
+  scope.Var("step_scope");
+
+  // a decoder-like step block of many small ops, here nested blocks
+  const int kStepOps = 32;
+  paddle::framework::ProgramDesc program;
+  auto* global_block = program.MutableBlock(0);
+  auto* step_block = program.AppendBlock(*global_block);
+  auto* inner_block = program.AppendBlock(*step_block);
+  for (int i = 0; i < kStepOps; ++i) {
+    AppendConditionalBlock(step_block, inner_block,
+                           "inner_scope_" + std::to_string(i));
+  }
+  AppendConditionalBlock(global_block, step_block, "step_scope");
+  auto* op_desc = global_block->AllOps().back();
+
+  auto op = paddle::framework::OpRegistry::CreateOp(*op_desc);
+  op->Run(scope, place);
+  auto* step_scope = StepScopes(scope, "step_scope").front();
+  EXPECT_EQ(StepScopes(*step_scope, "inner_scope_0").size(), 1UL);
+  EXPECT_EQ(step_scope->FindLocalVar("added_scope"), nullptr);
+
+  // changing the step block prepares it again
+  AppendConditionalBlock(step_block, inner_block, "added_scope");
+  op->Run(scope, place);
+  step_scope = StepScopes(scope, "step_scope").front();
+  EXPECT_EQ(StepScopes(*step_scope, "added_scope").size(), 1UL);
+  scope.DropKids();
+
+  const int kRepeat = 1000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepeat; ++i) {
+    op->Run(scope, place);
+    scope.DropKids();
+  }
+  auto cached = std::chrono::steady_clock::now() - start;
+
+  // a new op instance per run prepares its block every time
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepeat; ++i) {
+    paddle::framework::OpRegistry::CreateOp(*op_desc)->Run(scope, place);
+    scope.DropKids();
+  }
+  auto uncached = std::chrono::steady_clock::now() - start;
+
+  using us = std::chrono::microseconds;
+  LOG(INFO) << "conditional_block of " << kStepOps + 1
+            << " ops, cached prepared context: "
+            << std::chrono::duration_cast<us>(cached).count() / kRepeat
+            << "us/run, prepared every run: "
+            << std::chrono::duration_cast<us>(uncached).count() / kRepeat
+            << "us/run";
+}
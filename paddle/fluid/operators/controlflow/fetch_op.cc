@@ -15,6 +15,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/data_layout_transform.h"
 #include "paddle/fluid/framework/feed_fetch_type.h"
 #include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/framework/op_version_registry.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/profiler.h"
 
@@ -54,6 +55,23 @@ static void DataCopy(const framework::LoDTensor &src_item,
   dst_item->set_lod(src_item.lod());
 }
 
+// Whether the fetched tensor can take the buffer of src_item, which is only
+// true for a CPU tensor in the layout of Paddle whose buffer is not shared
+// with another tensor, such as a parameter or a fed numpy array.
+static bool CanMove(const framework::LoDTensor &src_item) {
+  if (!src_item.IsInitialized() || src_item.numel() == 0 ||
+      !platform::is_cpu_place(src_item.place()) ||
+      src_item.Holder().use_count() != 1) {
+    return false;
+  }
+#ifdef PADDLE_WITH_MKLDNN
+  if (src_item.layout() == framework::DataLayout::kMKLDNN) {
+    return false;
+  }
+#endif
+  return true;
+}
+
 class FetchOp : public framework::OperatorBase {
  public:
   FetchOp(const std::string &type, const framework::VariableNameMap &inputs,
@@ -106,9 +124,18 @@ class FetchOp : public framework::OperatorBase {
     }
 
     if (fetch_var->IsType<framework::LoDTensor>()) {
-      auto &src_item = fetch_var->Get<framework::LoDTensor>();
+      auto *src_item = fetch_var->GetMutable<framework::LoDTensor>();
       auto *dst_item = &(BOOST_GET(framework::LoDTensor, fetch_list->at(col)));
-      DataCopy(src_item, fetch_var_name, dst_item);
+      if (Attr<bool>("move_cpu_data") && CanMove(*src_item)) {
+        VLOG(3) << "Move the data of " << fetch_var_name << " to column "
+                << col << " without copying it.";
+        dst_item->ShareDataWith(*src_item);
+        dst_item->set_lod(src_item->lod());
+        // the next run writes X to a new buffer instead of the fetched one
+        src_item->clear();
+      } else {
+        DataCopy(*src_item, fetch_var_name, dst_item);
+      }
     } else {
       auto &src_item = fetch_var->Get<framework::LoDTensorArray>();
       framework::LoDTensorArray tmp(src_item.size());
@@ -132,6 +159,13 @@ class FetchOpInfoMaker : public framework::OpProtoAndCheckerMaker {
               "(vector<LoDTensor>) A fetching list of LoDTensor which may have "
               "different dimension, shape and data type.");
     AddAttr<int>("col", "(int) The column index of fetching object.");
+    AddAttr<bool>("move_cpu_data",
+                  "(bool, default false) Whether the fetched LoDTensor takes "
+                  "the CPU buffer of X instead of copying it. X is cleared "
+                  "after it is fetched, so it should be a variable that is "
+                  "not used any more in this run and is written again in the "
+                  "next run.")
+        .SetDefault(false);
     AddComment(R"DOC(
 Fetch Operator.
 
@@ -148,3 +182,11 @@ REGISTER_OPERATOR(
     paddle::framework::EmptyGradOpMaker<paddle::framework::OpDesc>,
     paddle::framework::EmptyGradOpMaker<paddle::imperative::OpBase>,
     paddle::operators::FetchOpInfoMaker);
+
+REGISTER_OP_VERSION(fetch).AddCheckpoint(
+    R"ROC(
+      Upgrade fetch to add a new attribute [move_cpu_data].
+    )ROC",
+    paddle::framework::compatible::OpVersionDesc().NewAttr(
+        "move_cpu_data",
+        "In order to fetch a CPU LoDTensor without copying it", false));
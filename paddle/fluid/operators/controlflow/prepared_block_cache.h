@@ -0,0 +1,117 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/executor.h"
+#include "paddle/fluid/framework/garbage_collector.h"
+#include "paddle/fluid/framework/lod_tensor_array.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/fluid/framework/scope.h"
+
+namespace paddle {
+namespace operators {
+
+// Caches the ExecutorPrepareContext of the sub-block of one control flow op
+// instance, so that the ops of the block are not created again on every run.
+// The context is prepared again when the block, its op list, the skipped
+// vars or the eager deletion setting change. Attributes modified in place
+// on the OpDescs of the block after the first run are not detected.
+class PreparedBlockCache {
+ public:
+  std::shared_ptr<framework::ExecutorPrepareContext> Get(
+      framework::Executor *executor, const framework::BlockDesc &block,
+      const std::vector<std::string> &skip_vars,
+      bool enable_mkldnn = false) {
+    bool gc_enabled = framework::GetEagerDeletionThreshold() >= 0;
+    std::vector<framework::OpDesc *> ops = block.AllOps();
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (ctx_ == nullptr || block_ != &block || ops_ != ops ||
+        skip_vars_ != skip_vars || gc_enabled_ != gc_enabled) {
+      VLOG(3) << "Prepare block " << block.ID() << " of " << block.Program();
+      if (enable_mkldnn) {
+        executor->EnableMKLDNN(*block.Program());
+      }
+      ctx_ = framework::Executor::Prepare(*block.Program(), block.ID(),
+                                          skip_vars);
+      block_ = &block;
+      ops_ = std::move(ops);
+      skip_vars_ = skip_vars;
+      gc_enabled_ = gc_enabled;
+    }
+    return ctx_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::shared_ptr<framework::ExecutorPrepareContext> ctx_;
+  const framework::BlockDesc *block_{nullptr};
+  std::vector<framework::OpDesc *> ops_;
+  std::vector<std::string> skip_vars_;
+  bool gc_enabled_{false};
+};
+
+// Clears the LoD of all LoDTensors and the elements of all LoDTensorArrays
+// of a step scope that is run again, the memory of the tensors is kept.
+inline void ResetStepScopeVars(const framework::Scope &step_scope) {
+  for (auto &name : step_scope.LocalVarNames()) {
+    auto *var = step_scope.FindLocalVar(name);
+    if (var->IsType<framework::LoDTensor>()) {
+      // Clear all lod information for all lod_tensors.
+      auto *t = var->GetMutable<framework::LoDTensor>();
+      framework::LoD empty_lod;
+      t->set_lod(empty_lod);
+    } else if (var->IsType<framework::LoDTensorArray>()) {
+      // Clear elements of all tensor arrays.
+      auto *t = var->GetMutable<framework::LoDTensorArray>();
+      t->clear();
+    }
+  }
+}
+
+// Keeps the step scope of a control flow op in inference across runs, so
+// that its variables and their memory are recycled instead of being created
+// and released on every run. The scope is not recorded in the kids of the
+// parent and is released with the op.
+class StepScopeCache {
+ public:
+  // Returns the step scope under parent, created is set to true when the
+  // variables of the block still have to be created in it.
+  framework::Scope *Acquire(const framework::Scope &parent, bool *created) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    // compare the ID too, a released parent's address may be reused
+    *created = scope_ == nullptr || parent_ != &parent ||
+               parent_id_ != parent.ID();
+    if (*created) {
+      scope_ = parent.NewTmpScope();
+      parent_ = &parent;
+      parent_id_ = parent.ID();
+    }
+    return scope_.get();
+  }
+
+ private:
+  std::mutex mutex_;
+  const framework::Scope *parent_{nullptr};
+  uint64_t parent_id_{0};
+  std::unique_ptr<framework::Scope> scope_;
+};
+
+}  // namespace operators
+}  // namespace paddle
@@ -15,6 +15,7 @@
 #include "paddle/fluid/framework/executor.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/operators/controlflow/prepared_block_cache.h"
 #include "paddle/fluid/operators/controlflow/while_op_helper.h"
 
 namespace paddle {
@@ -109,7 +110,7 @@ class WhileOp : public framework::OperatorBase {
     auto &skip_vars = Attr<std::vector<std::string>>(kSkipEagerDeletionVars);
     VLOG(2) << GetSkipEagerDeletionVarsDebugString(skip_vars);
 
-    auto ctx = executor.Prepare(*program, block->ID(), skip_vars);
+    auto ctx = prepared_block_.Get(&executor, *block, skip_vars);
     if (!is_test) {
       while (cond_data) {
         auto &current_scope = scope.NewScope();
@@ -144,30 +145,24 @@ class WhileOp : public framework::OperatorBase {
             GetCondData(scope.FindVar(Input(kCondition))->Get<LoDTensor>());
       }
     } else {
-      auto &current_scope = scope.NewScope();
-      executor.CreateVariables(*program, &current_scope, block->ID());
+      // the step scope and its variables are recycled across runs
+      bool created = false;
+      auto &current_scope = *step_scope_.Acquire(scope, &created);
+      if (created) {
+        executor.CreateVariables(*program, &current_scope, block->ID());
+      }
       while (cond_data) {
-        for (auto &name : current_scope.LocalVarNames()) {
-          auto *var = current_scope.Var(name);
-          if (var->IsType<framework::LoDTensor>()) {
-            // Clear all lod information for all lod_tensors.
-            auto *t = var->GetMutable<framework::LoDTensor>();
-            framework::LoD empty_lod;
-            t->set_lod(empty_lod);
-          } else if (var->IsType<framework::LoDTensorArray>()) {
-            // Clear elements of all tensor arrays.
-            auto *t = var->GetMutable<framework::LoDTensorArray>();
-            t->clear();
-          }
-        }
+        ResetStepScopeVars(current_scope);
         executor.RunPreparedContext(ctx.get(), &current_scope, false, false,
                                     false);
         cond_data =
             GetCondData(scope.FindVar(Input(kCondition))->Get<LoDTensor>());
       }
-      scope.DeleteScope(&current_scope);
     }
   }
+
+  mutable PreparedBlockCache prepared_block_;
+  mutable StepScopeCache step_scope_;
 };
 
 class WhileOpMaker : public framework::OpProtoAndCheckerMaker {
@@ -227,7 +222,7 @@ class WhileGradOp : public framework::OperatorBase {
 
     auto &skip_vars = Attr<std::vector<std::string>>(kSkipEagerDeletionVars);
     VLOG(2) << GetSkipEagerDeletionVarsDebugString(skip_vars);
-    auto ctx = executor.Prepare(*program, block->ID(), skip_vars);
+    auto ctx = prepared_block_.Get(&executor, *block, skip_vars);
 
     auto *step_scopes =
         scope.FindVar(Input(kStepScopes))->GetMutable<StepScopeVar>();
@@ -406,6 +401,8 @@ class WhileGradOp : public framework::OperatorBase {
     }
     step_scopes->clear();
   }
+
+  mutable PreparedBlockCache prepared_block_;
 };
 
 template <typename T>
@@ -211,6 +211,15 @@ framework::OpKernelType ConvOp::GetKernelTypeForVar(
                                  tensor.place(), tensor.layout());
 }
 
+bool ConvOp::GetOpCost(const framework::ExecutionContext& ctx,
+                       framework::OpCost* cost) const {
+  // every output element is a dot product over one filter of a group
+  auto* filter = ctx.Input<Tensor>("Filter");
+  int64_t filter_size = filter->numel() / filter->dims()[0];
+  cost->flops = 2.0 * ctx.Output<Tensor>("Output")->numel() * filter_size;
+  return true;
+}
+
 void Conv2DOpMaker::Make() {
   AddAttr<bool>("is_test",
                 "(bool, default false) Set to true for inference only, false "
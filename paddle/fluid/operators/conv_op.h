@@ -188,6 +188,9 @@ class ConvOp : public framework::OperatorWithKernel {
   framework::OpKernelType GetKernelTypeForVar(
       const std::string& var_name, const Tensor& tensor,
       const framework::OpKernelType& expected_kernel_type) const override;
+
+  bool GetOpCost(const framework::ExecutionContext& ctx,
+                 framework::OpCost* cost) const override;
 };
 
 class ConvOpGrad : public framework::OperatorWithKernel {
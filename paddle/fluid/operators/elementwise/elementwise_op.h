@@ -131,6 +131,12 @@ class ElementwiseOp : public framework::OperatorWithKernel {
                                      tensor.place(), tensor.layout());
     }
   }
+
+  bool GetOpCost(const framework::ExecutionContext &ctx,
+                 framework::OpCost *cost) const override {
+    cost->flops = ctx.Output<framework::Tensor>("Out")->numel();
+    return true;
+  }
 };
 
 class ElementwiseOpInferVarType
@@ -127,6 +127,18 @@ class FCOp : public framework::OperatorWithKernel {
     return framework::OpKernelType(input_data_type, ctx.GetPlace(), layout,
                                    library, customized_type_value);
   }
+
+  bool GetOpCost(const framework::ExecutionContext& ctx,
+                 framework::OpCost* cost) const override {
+    auto in_dims = ctx.Input<framework::Tensor>("Input")->dims();
+    int in_num_col_dims = ctx.Attr<int>("in_num_col_dims");
+    int64_t k = framework::product(
+        framework::slice_ddim(in_dims, in_num_col_dims, in_dims.size()));
+    int64_t out_numel = ctx.Output<framework::Tensor>("Out")->numel();
+    cost->flops = 2.0 * out_numel * k;
+    if (ctx.HasInput("Bias")) cost->flops += out_numel;
+    return true;
+  }
 };
 
 class FCOpMaker : public framework::OpProtoAndCheckerMaker {
@@ -155,6 +167,11 @@ class FCOpMaker : public framework::OpProtoAndCheckerMaker {
         "(bool, default false) When padding weights in the fc fuse pass, "
         "the 'padding_weights' attribute is set as true.")
         .SetDefault(false);
+    AddAttr<std::string>(
+        "packed_weight",
+        "(string, default \"\") Name of the variable holding the pre-packed "
+        "form of W, set by gemm_weight_pack_pass for inference on CPU.")
+        .SetDefault("");
     AddAttr<bool>(framework::kAllKernelsMustComputeRuntimeShape,
                   "Skip calling InferShape() function in the runtime.")
         .SetDefault(true);
@@ -18,6 +18,7 @@ limitations under the License. */
 #include <vector>
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/operators/math/fc.h"
+#include "paddle/fluid/operators/math/gemm_pack.h"
 
 namespace paddle {
 namespace operators {
@@ -76,13 +77,15 @@ class FCOpKernel : public framework::OpKernel<T> {
     int M = framework::product(out_dims) / w_dims1;
 
     const T* input_data = input->data<T>();
-    const T* w_data = w->data<T>();
+    // W is released when it is only read through its packed copy
+    const T* packed_w = math::GetPackedGemmWeight<DeviceContext, T>(ctx);
+    const T* w_data = w->IsInitialized() ? w->data<T>() : nullptr;
     T* output_data = output->mutable_data<T>(ctx.GetPlace());
 
     auto& dev_ctx = ctx.template device_context<DeviceContext>();
     math::FCFunctor<DeviceContext, T> fc;
     fc(dev_ctx, M, w_dims1, w_dims0, input_data, w_data, output_data,
-       bias ? bias->data<T>() : NULL, with_relu, padding_weights);
+       bias ? bias->data<T>() : NULL, with_relu, padding_weights, packed_w);
   }
 };
 
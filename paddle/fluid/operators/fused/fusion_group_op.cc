@@ -72,7 +72,7 @@ class FusionGroupOp : public framework::OperatorWithKernel {
   framework::OpKernelType GetExpectedKernelType(
       const framework::ExecutionContext& ctx) const override {
     return framework::OpKernelType(framework::proto::VarType::FP32,
-                                   platform::CUDAPlace(0));
+                                   ctx.GetPlace());
   };
 };
 
@@ -94,11 +94,16 @@ class FusionGroupOpMaker : public framework::OpProtoAndCheckerMaker {
     AddAttr<int>("type", "Fusion type.").SetDefault(0);
     AddAttr<std::string>("func_name", "Name of the generated functions.")
         .SetDefault("");
+    AddAttr<std::string>("func_code",
+                         "The source code of the generated CPU function. It "
+                         "is compiled when the function does not exist in "
+                         "the process, e.g. after the program is loaded.")
+        .SetDefault("");
     AddComment(R"DOC(
 fusion_group Operator.
 
-It is used to execute a generated CUDA kernel which fuse the computation of
-multiple operators into one. It supports several types:
+It is used to execute a generated CUDA or CPU kernel which fuse the computation
+of multiple operators into one. It supports several types:
 0, fused computation of elementwise operations in which all the dims of inputs
     and outputs should be exactly the same.
 )DOC");
@@ -109,4 +114,8 @@ multiple operators into one. It supports several types:
 }  // namespace paddle
 
 namespace ops = paddle::operators;
+namespace plat = paddle::platform;
 REGISTER_OPERATOR(fusion_group, ops::FusionGroupOp, ops::FusionGroupOpMaker);
+REGISTER_OP_CPU_KERNEL(
+    fusion_group, ops::FusionGroupKernel<plat::CPUDeviceContext, float>,
+    ops::FusionGroupKernel<plat::CPUDeviceContext, double>);
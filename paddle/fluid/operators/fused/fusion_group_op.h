@@ -14,7 +14,9 @@ limitations under the License. */
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/platform/device_code.h"
@@ -36,6 +38,32 @@ static void MutableMultiTypeData(
   }
 }
 
+// The CPU functions are compiled again from the code saved in the op if they
+// do not exist in the process, e.g. the program is loaded from disk.
+static platform::DeviceCode* GetDeviceCode(
+    const framework::ExecutionContext& ctx, const platform::Place& place,
+    const std::string& func_name) {
+  if (platform::is_cpu_place(place)) {
+    auto& pool = platform::DeviceCodePool::Init({place});
+    const std::string& func_code = ctx.Attr<std::string>("func_code");
+    if (!pool.Has(place, func_name) && !func_code.empty()) {
+      std::unique_ptr<platform::CPUDeviceCode> dev_code(
+          new platform::CPUDeviceCode(place, func_name, func_code));
+      PADDLE_ENFORCE_EQ(
+          dev_code->Compile(), true,
+          platform::errors::Unavailable(
+              "Failed to compile the CPU function %s of fusion_group. "
+              "Please check FLAGS_cpu_jit_compiler and "
+              "FLAGS_cpu_jit_cache_dir.",
+              func_name));
+      // Another thread may have set the same function, which is kept.
+      pool.Set(std::move(dev_code));
+    }
+    return pool.Get(place, func_name);
+  }
+  return platform::DeviceCodePool::Instance().Get(place, func_name);
+}
+
 template <typename DeviceContext, typename T>
 class FusionGroupKernel : public framework::OpKernel<T> {
  public:
@@ -54,8 +82,7 @@ class FusionGroupKernel : public framework::OpKernel<T> {
     MutableMultiTypeData(&outs, outs_dtype, place);
 
     std::string func_name = ctx.Attr<std::string>("func_name");
-    platform::DeviceCode* dev_code =
-        platform::DeviceCodePool::Instance().Get(place, func_name);
+    platform::DeviceCode* dev_code = GetDeviceCode(ctx, place, func_name);
     VLOG(3) << "func_name: " << func_name;
 
     if (type == 0) {
@@ -57,7 +57,7 @@ framework::OpDesc* CreateFusionGroupOp(
     const std::vector<std::string>& input_names,
     const std::vector<std::vector<int64_t>>& input_shapes,
     const std::vector<std::string>& output_names, int type,
-    std::string func_name) {
+    std::string func_name, std::string func_code = "") {
   EXPECT_EQ(input_names.size(), input_shapes.size());
 
   std::vector<int> input_dtypes(input_names.size(),
@@ -85,19 +85,29 @@ framework::OpDesc* CreateFusionGroupOp(
   op->SetAttr("outs_dtype", output_dtypes);
   op->SetAttr("type", type);
   op->SetAttr("func_name", func_name);
+  op->SetAttr("func_code", func_code);
   op->SetAttr(framework::OpProtoAndCheckerMaker::OpRoleAttrName(),
               static_cast<int>(framework::OpRole::kForward));
   return op;
 }
 
 void PrepareDeviceCode(platform::Place place, std::string func_name,
-                       std::string cuda_kernel_str) {
+                       std::string kernel_str) {
   paddle::platform::DeviceCodePool& pool =
       paddle::platform::DeviceCodePool::Init({place});
 
-  std::unique_ptr<paddle::platform::DeviceCode> code(
-      new paddle::platform::CUDADeviceCode(place, func_name, cuda_kernel_str));
-  code->Compile();
+  std::unique_ptr<paddle::platform::DeviceCode> code;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (platform::is_gpu_place(place)) {
+    code.reset(
+        new paddle::platform::CUDADeviceCode(place, func_name, kernel_str));
+  }
+#endif
+  if (platform::is_cpu_place(place)) {
+    code.reset(
+        new paddle::platform::CPUDeviceCode(place, func_name, kernel_str));
+  }
+  EXPECT_EQ(code->Compile(), true);
   pool.Set(std::move(code));
 }
 
@@ -134,20 +144,26 @@ void CheckOutputs(framework::Scope* scope,
   }
 }
 
-void TestMain(const std::vector<std::string>& input_names,
+void TestMain(const platform::Place& place,
+              const std::vector<std::string>& input_names,
               const std::vector<std::vector<int64_t>>& input_shapes,
               const std::vector<std::string>& output_names, int type,
-              std::string func_name, std::string cuda_kernel_str,
-              CPUKernelFunc cpu_kernel_func) {
-  // Compile the device code
-  paddle::framework::InitDevices({0});
-  platform::CUDAPlace place = platform::CUDAPlace(0);
-  PrepareDeviceCode(place, func_name, cuda_kernel_str);
+              std::string func_name, std::string kernel_str,
+              CPUKernelFunc cpu_kernel_func, bool compile_in_op = false) {
+  // Compile the device code, or let the op compile it from its attribute as
+  // a program loaded in a new process does.
+  std::string func_code;
+  if (compile_in_op) {
+    func_code = kernel_str;
+  } else {
+    PrepareDeviceCode(place, func_name, kernel_str);
+  }
 
   // Create a ProgramDesc that has a fusion_group_op.
   framework::ProgramDesc program;
-  framework::OpDesc* op_desc = CreateFusionGroupOp(
-      &program, input_names, input_shapes, output_names, type, func_name);
+  framework::OpDesc* op_desc =
+      CreateFusionGroupOp(&program, input_names, input_shapes, output_names,
+                          type, func_name, func_code);
   auto fusion_group_op = framework::OpRegistry::CreateOp(*op_desc);
 
   framework::Scope scope;
@@ -177,6 +193,85 @@ void TestMain(const std::vector<std::string>& input_names,
                cpu_kernel_func);
 }
 
+void ElementwiseCPUKernel0(size_t n, std::vector<void*> args) {
+  float* x = static_cast<float*>(args[0]);
+  float* y = static_cast<float*>(args[1]);
+  float* z = static_cast<float*>(args[2]);
+  for (size_t i = 0; i < n; ++i) {
+    float tmp_0 = x[i];
+    float tmp_1 = y[i];
+    float tmp_2 = tmp_0 + tmp_1;
+    float tmp_3 = tmp_2 > 0 ? tmp_2 : 0;
+    z[i] = tmp_3;
+  }
+}
+
+TEST(FusionGroupOp, elementwise_cpu) {
+  paddle::framework::InitDevices();
+  platform::CPUPlace place;
+  platform::DeviceCodePool::Init({place});
+  if (!platform::CPUDeviceCode::IsAvailable()) {
+    return;
+  }
+
+  // z = relu(x + y)
+  std::vector<std::string> input_names = {"x", "y"};
+  std::vector<std::string> output_names = {"z"};
+  std::vector<std::vector<int64_t>> input_shapes = {{256, 256}, {256, 256}};
+  constexpr auto kernel = R"(
+#include <cstdint>
+
+extern "C" void elementwise_cpu_kernel_0(int64_t n, void** args) {
+  const float* __restrict__ x = static_cast<const float*>(args[0]);
+  const float* __restrict__ y = static_cast<const float*>(args[1]);
+  float* __restrict__ z = static_cast<float*>(args[2]);
+  for (int64_t idx = 0; idx < n; ++idx) {
+    float tmp_0 = x[idx];
+    float tmp_1 = y[idx];
+    float tmp_2 = tmp_0 + tmp_1;
+    z[idx] = tmp_2 > 0 ? tmp_2 : 0;
+  }
+})";
+
+  TestMain(place, input_names, input_shapes, output_names, 0,
+           "elementwise_cpu_kernel_0", kernel, ElementwiseCPUKernel0);
+}
+
+TEST(FusionGroupOp, elementwise_cpu_compile_in_op) {
+  paddle::framework::InitDevices();
+  platform::CPUPlace place;
+  platform::DeviceCodePool::Init({place});
+  if (!platform::CPUDeviceCode::IsAvailable()) {
+    return;
+  }
+
+  // z = relu(x + y), compiled by the op from the func_code attribute.
+  std::vector<std::string> input_names = {"x", "y"};
+  std::vector<std::string> output_names = {"z"};
+  std::vector<std::vector<int64_t>> input_shapes = {{128, 64}, {128, 64}};
+  constexpr auto kernel = R"(
+#include <cstdint>
+
+extern "C" void elementwise_cpu_kernel_1(int64_t n, void** args) {
+  const float* __restrict__ x = static_cast<const float*>(args[0]);
+  const float* __restrict__ y = static_cast<const float*>(args[1]);
+  float* __restrict__ z = static_cast<float*>(args[2]);
+  for (int64_t idx = 0; idx < n; ++idx) {
+    float tmp_2 = x[idx] + y[idx];
+    z[idx] = tmp_2 > 0 ? tmp_2 : 0;
+  }
+})";
+
+  EXPECT_FALSE(platform::DeviceCodePool::Instance().Has(
+      place, "elementwise_cpu_kernel_1"));
+  TestMain(place, input_names, input_shapes, output_names, 0,
+           "elementwise_cpu_kernel_1", kernel, ElementwiseCPUKernel0,
+           /* compile_in_op= */ true);
+  EXPECT_TRUE(platform::DeviceCodePool::Instance().Has(
+      place, "elementwise_cpu_kernel_1"));
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 TEST(FusionGroupOp, elementwise) {
   if (!platform::dynload::HasNVRTC() || !platform::dynload::HasCUDADriver()) {
     return;
@@ -203,25 +298,13 @@ void elementwise_cuda_kernel_0(size_t n, float *x, float* y, float* z) {
   }
 })";
 
-  auto elementwise_cpu_kernel_0 = [](size_t n,
-                                     std::vector<void*> args) -> void {
-    float* x = static_cast<float*>(args[0]);
-    float* y = static_cast<float*>(args[1]);
-    float* z = static_cast<float*>(args[2]);
-    for (size_t i = 0; i < n; ++i) {
-      float tmp_0 = x[i];
-      float tmp_1 = y[i];
-      float tmp_2 = tmp_0 + tmp_1;
-      float tmp_3 = tmp_2 > 0 ? tmp_2 : 0;
-      z[i] = tmp_3;
-    }
-  };
-
-  TestMain(input_names, input_shapes, output_names, 0,
-           "elementwise_cuda_kernel_0", kernel, elementwise_cpu_kernel_0);
+  paddle::framework::InitDevices({0});
+  TestMain(platform::CUDAPlace(0), input_names, input_shapes, output_names, 0,
+           "elementwise_cuda_kernel_0", kernel, ElementwiseCPUKernel0);
 }
+#endif
 
 }  // namespace operators
 }  // namespace paddle
 
-USE_CUDA_ONLY_OP(fusion_group);
+USE_OP(fusion_group);
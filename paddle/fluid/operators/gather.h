@@ -21,6 +21,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/eigen.h"
 #include "paddle/fluid/framework/tensor.h"
 #include "paddle/fluid/operators/math/math_function.h"
+#include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/place.h"
 
 namespace paddle {
@@ -70,10 +71,15 @@ void CPUGather(const platform::DeviceContext& ctx, const Tensor& src,
 
   const size_t slice_bytes = slice_size * sizeof(T);
 
-  for (int64_t i = 0; i < index_size; ++i) {
-    IndexT index_ = p_index[i];
-    memcpy(p_output + i * slice_size, p_src + index_ * slice_size, slice_bytes);
-  }
+  platform::ParallelFor(
+      0, index_size, platform::GetParallelForGrainSize(slice_size),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          IndexT index_ = p_index[i];
+          memcpy(p_output + i * slice_size, p_src + index_ * slice_size,
+                 slice_bytes);
+        }
+      });
 }
 
 template <typename T, typename IndexT = int>
@@ -104,26 +110,31 @@ void CPUGatherNd(const platform::DeviceContext& ctx, const Tensor& input,
   }
   const size_t slice_bytes = slice_size * sizeof(T);
 
-  for (int64_t i = 0; i < remain_numel; ++i) {
-    int64_t index_ = 0;
-    int64_t temp = 1;
-    for (int64_t j = end_size - 1; j >= 0; --j) {
-      IndexT index_value = p_index[i * end_size + j];
-      PADDLE_ENFORCE_LT(
-          index_value, input_dims[j],
-          platform::errors::InvalidArgument(
-              "Input(index[-1)] has wrong value, it is [%d]", index_value));
-      PADDLE_ENFORCE_GE(
-          index_value, 0UL,
-          platform::errors::InvalidArgument(
-              "The value of Input(index) must be no less than 0"));
-
-      index_ += (index_value * temp);
-      temp *= input_dims[j];
-    }
-    memcpy(p_output + i * slice_size, p_input + index_ * slice_size,
-           slice_bytes);
-  }
+  platform::ParallelFor(
+      0, remain_numel, platform::GetParallelForGrainSize(slice_size + end_size),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          int64_t index_ = 0;
+          int64_t temp = 1;
+          for (int64_t j = end_size - 1; j >= 0; --j) {
+            IndexT index_value = p_index[i * end_size + j];
+            PADDLE_ENFORCE_LT(
+                index_value, input_dims[j],
+                platform::errors::InvalidArgument(
+                    "Input(index[-1)] has wrong value, it is [%d]",
+                    index_value));
+            PADDLE_ENFORCE_GE(
+                index_value, 0UL,
+                platform::errors::InvalidArgument(
+                    "The value of Input(index) must be no less than 0"));
+
+            index_ += (index_value * temp);
+            temp *= input_dims[j];
+          }
+          memcpy(p_output + i * slice_size, p_input + index_ * slice_size,
+                 slice_bytes);
+        }
+      });
 }
 
 template <typename T, typename U, typename V>
@@ -173,17 +184,22 @@ void GatherV2Function(const Tensor* input, const Tensor* index,
   out->Resize(out_dim);
   auto* out_data = out->mutable_data<T>(place);
 
-  int out_index = 0;
-  for (int i = 0; i < inner_dim_size; i++) {
-    for (int j = 0; j < index_size; j++) {
-      for (int k = 0; k < outer_dim_size; k++) {
-        int index = k + index_data[j] * outer_dim_size +
-                    (i * input_size / inner_dim_size);
-        out_data[out_index] = input_data[index];
-        out_index++;
-      }
-    }
-  }
+  platform::ParallelFor(
+      0, inner_dim_size,
+      platform::GetParallelForGrainSize(index_size * outer_dim_size),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          int64_t out_index = i * index_size * outer_dim_size;
+          for (int j = 0; j < index_size; j++) {
+            for (int k = 0; k < outer_dim_size; k++) {
+              int index = k + index_data[j] * outer_dim_size +
+                          (i * input_size / inner_dim_size);
+              out_data[out_index] = input_data[index];
+              out_index++;
+            }
+          }
+        }
+      });
 }
 
 template <typename T, typename U, typename V>
@@ -358,6 +358,36 @@ void BenchKernelSgd() {
   }
 }
 
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelAdam() {
+  using T = typename KernelTuple::data_type;
+  const T beta1 = 0.9;
+  const T beta2 = 0.999;
+  const T lr = 0.001;
+  const T eps = 1e-8;
+  jit::adam_attr_t attr(beta1, beta2);
+  // dense tables of the parameter server are updated in shards of this scale
+  for (int64_t numel : {1 << 10, 1 << 16, 1 << 20}) {
+    Tensor grad, mom1, mom2, param;
+    grad.Resize({numel});
+    mom1.Resize({numel});
+    mom2.Resize({numel});
+    param.Resize({numel});
+    T* grad_data = grad.mutable_data<T>(PlaceType());
+    T* mom1_data = mom1.mutable_data<T>(PlaceType());
+    T* mom2_data = mom2.mutable_data<T>(PlaceType());
+    T* param_data = param.mutable_data<T>(PlaceType());
+    RandomVec<T>(numel, grad_data, -2.f, 2.f);
+    RandomVec<T>(numel, mom1_data, -2.f, 2.f);
+    RandomVec<T>(numel, mom2_data, 0.f, 2.f);
+    RandomVec<T>(numel, param_data, -2.f, 2.f);
+    // only benchmark inplace
+    BenchAllImpls<KernelTuple, PlaceType>(
+        attr, beta1, beta2, lr, eps, numel, grad_data, mom1_data, mom2_data,
+        param_data, mom1_data, mom2_data, param_data);
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void BenchKernelMatMul() {
   using T = typename KernelTuple::data_type;
@@ -554,6 +584,7 @@ BENCH_FP32_CPU(SeqPool);
 BENCH_FP32_CPU(EmbSeqPool);
 BENCH_FP32_CPU(MatMul);
 BENCH_FP32_CPU(Softmax);
+BENCH_FP32_CPU(Adam);
 BENCH_FP32_CPU(Sgd);
 BENCH_FP32_CPU(VBroadcast);
 
@@ -62,6 +62,7 @@ const char* to_string(KernelType kt) {
     ONE_CASE(kStrideASum);
     ONE_CASE(kSoftmax);
     ONE_CASE(kEmbSeqPool);
+    ONE_CASE(kAdam);
     ONE_CASE(kSgd);
     default:
       PADDLE_THROW(platform::errors::Unimplemented(
@@ -50,6 +50,7 @@ typedef enum {
   kVMul,
   kVRelu,
   kVScal,
+  kAdam,
   kSgd,
   kVSigmoid,
   kVSquare,
@@ -269,6 +270,24 @@ struct SgdTuple {
                             const sgd_attr_t*);
 };
 
+typedef struct adam_attr_s {
+  float beta1, beta2;
+  adam_attr_s() = default;
+  explicit adam_attr_s(float beta1_, float beta2_)
+      : beta1(beta1_), beta2(beta2_) {}
+} adam_attr_t;
+
+template <typename T>
+struct AdamTuple {
+  static constexpr KernelType kernel_type = kAdam;
+  typedef T data_type;
+  typedef adam_attr_t attr_type;
+  // beta1, beta2, lr, eps, numel, grad, mom1, mom2, param,
+  // mom1_out, mom2_out, param_out
+  typedef void (*func_type)(T, T, T, T, int64_t, const T*, const T*, const T*,
+                            const T*, T*, T*, T*);
+};
+
 typedef struct matmul_attr_s {
   int m, n, k;
   void* packed_weight{nullptr};
@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/operators/jit/kernel_key.h"
 #include <xxhash.h>  // XXH64: 13.8 GB/s
+#include <cstring>
 
 namespace paddle {
 namespace operators {
@@ -63,6 +64,15 @@ int64_t JitCodeKey<sgd_attr_t>(const sgd_attr_t& attr) {
   return attr.grad_width;
 }
 
+template <>
+int64_t JitCodeKey<adam_attr_t>(const adam_attr_t& attr) {
+  uint32_t beta1_bits, beta2_bits;
+  std::memcpy(&beta1_bits, &attr.beta1, sizeof(beta1_bits));
+  std::memcpy(&beta2_bits, &attr.beta2, sizeof(beta2_bits));
+  return static_cast<int64_t>((static_cast<uint64_t>(beta1_bits) << 32) |
+                              beta2_bits);
+}
+
 }  // namespace jit
 }  // namespace operators
 }  // namespace paddle
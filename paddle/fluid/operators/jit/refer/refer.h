@@ -552,6 +552,25 @@ void Sgd(const T* lr, const T* param, const T* grad, const int64_t* rows,
   }
 }
 
+// Fused Adam step in one pass, the bias correction is expected to be folded
+// into lr and eps by the caller:
+//   mom1_out = beta1 * mom1 + (1 - beta1) * grad
+//   mom2_out = beta2 * mom2 + (1 - beta2) * grad * grad
+//   param_out = param - lr * mom1_out / (sqrt(mom2_out) + eps)
+template <typename T>
+void Adam(T beta1, T beta2, T lr, T eps, int64_t numel, const T* grad,
+          const T* mom1, const T* mom2, const T* param, T* mom1_out,
+          T* mom2_out, T* param_out) {
+  for (int64_t i = 0; i < numel; ++i) {
+    T g = grad[i];
+    T m1 = beta1 * mom1[i] + (1 - beta1) * g;
+    T m2 = beta2 * mom2[i] + (1 - beta2) * g * g;
+    mom1_out[i] = m1;
+    mom2_out[i] = m2;
+    param_out[i] = param[i] - lr * (m1 / (std::sqrt(m2) + eps));
+  }
+}
+
 #define DECLARE_REFER_KERNEL(name)                          \
   template <typename T>                                     \
   class name##Kernel : public ReferKernel<name##Tuple<T>> { \
@@ -603,6 +622,7 @@ DECLARE_REFER_KERNEL(SeqPool);
 DECLARE_REFER_KERNEL(MatMul);
 DECLARE_REFER_KERNEL(Softmax);
 DECLARE_REFER_KERNEL(EmbSeqPool);
+DECLARE_REFER_KERNEL(Adam);
 DECLARE_REFER_KERNEL(Sgd);
 DECLARE_REFER_KERNEL(VBroadcast);
 
@@ -936,6 +936,51 @@ void TestKernelSgd() {
   }
 }
 
+template <typename KernelTuple, typename PlaceType>
+void TestKernelAdam() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  const T beta1 = 0.9;
+  const T beta2 = 0.999;
+  const T lr = 0.001;
+  const T eps = 1e-8;
+  jit::adam_attr_t attr(beta1, beta2);
+  for (int d : TestSizes()) {
+    std::vector<T> grad(d), mom1(d), mom2(d), param(d);
+    RandomVec<T>(d, grad.data(), -2.f, 2.f);
+    RandomVec<T>(d, mom1.data(), -2.f, 2.f);
+    RandomVec<T>(d, mom2.data(), 0.f, 2.f);
+    RandomVec<T>(d, param.data(), -2.f, 2.f);
+
+    auto ref = jit::GetReferFunc<KernelTuple>();
+    EXPECT_TRUE(ref != nullptr);
+    std::vector<T> mom1_ref(d), mom2_ref(d), param_ref(d);
+    ref(beta1, beta2, lr, eps, d, grad.data(), mom1.data(), mom2.data(),
+        param.data(), mom1_ref.data(), mom2_ref.data(), param_ref.data());
+
+    auto verifier = [](
+        const typename KernelTuple::func_type tgt, const T beta1,
+        const T beta2, const T lr, const T eps, const std::vector<T>& grad,
+        const std::vector<T>& mom1, const std::vector<T>& mom2,
+        const std::vector<T>& param, const std::vector<T>& mom1_ref,
+        const std::vector<T>& mom2_ref, const std::vector<T>& param_ref) {
+      EXPECT_TRUE(tgt != nullptr);
+      const int d = grad.size();
+      // the optimizers always update in place
+      std::vector<T> mom1_out(mom1), mom2_out(mom2), param_out(param);
+      tgt(beta1, beta2, lr, eps, d, grad.data(), mom1_out.data(),
+          mom2_out.data(), param_out.data(), mom1_out.data(), mom2_out.data(),
+          param_out.data());
+      ExpectEQ<T>(mom1_out.data(), mom1_ref.data(), d);
+      ExpectEQ<T>(mom2_out.data(), mom2_ref.data(), d);
+      ExpectEQ<T>(param_out.data(), param_ref.data(), d);
+    };
+    TestAllImpls<KernelTuple, PlaceType>(attr, verifier, beta1, beta2, lr, eps,
+                                         grad, mom1, mom2, param, mom1_ref,
+                                         mom2_ref, param_ref);
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void TestKernelVBroadcast() {
   using T = typename KernelTuple::data_type;
@@ -1143,10 +1188,11 @@ TEST(JITKernel_helper, attr) {
       << jit::to_string(jit::kVBroadcast) << jit::to_string(jit::kVCopy)
       << jit::to_string(jit::kVExp) << jit::to_string(jit::kVIdentity)
       << jit::to_string(jit::kVMul) << jit::to_string(jit::kVRelu)
-      << jit::to_string(jit::kVScal) << jit::to_string(jit::kSgd)
-      << jit::to_string(jit::kVSigmoid) << jit::to_string(jit::kVSquare)
-      << jit::to_string(jit::kVSub) << jit::to_string(jit::kVTanh);
-  EXPECT_EQ(out.str().size(), 234UL);
+      << jit::to_string(jit::kVScal) << jit::to_string(jit::kAdam)
+      << jit::to_string(jit::kSgd) << jit::to_string(jit::kVSigmoid)
+      << jit::to_string(jit::kVSquare) << jit::to_string(jit::kVSub)
+      << jit::to_string(jit::kVTanh);
+  EXPECT_EQ(out.str().size(), 239UL);
 
   // SeqPoolTypes
   out.str("");
@@ -1293,6 +1339,23 @@ TEST(JITKernel_key, emb_seq_pool) {
   EXPECT_TRUE(key4 != key5);
 }
 
+TEST(JITKernel_key, adam) {
+  jit::adam_attr_t attr1(0.9f, 0.999f);
+  jit::adam_attr_t attr2(0.9f, 0.999f);
+  jit::adam_attr_t attr3(0.99f, 0.9f);
+  jit::adam_attr_t attr4(0.999f, 0.9f);
+
+  auto key1 = jit::JitCodeKey<jit::adam_attr_t>(attr1);
+  auto key2 = jit::JitCodeKey<jit::adam_attr_t>(attr2);
+  auto key3 = jit::JitCodeKey<jit::adam_attr_t>(attr3);
+  auto key4 = jit::JitCodeKey<jit::adam_attr_t>(attr4);
+
+  EXPECT_TRUE(key1 == key2);
+  EXPECT_TRUE(key2 != key3);
+  EXPECT_TRUE(key2 != key4);
+  EXPECT_TRUE(key3 != key4);
+}
+
 TEST(JITKernel_key, sgd) {
   jit::sgd_attr_t attr1(1, 2, 3, 4, 5);
   jit::sgd_attr_t attr2(1, 2, 3, 4, 5);
@@ -1380,6 +1443,7 @@ TEST_CPU_KERNEL(SeqPool);
 TEST_CPU_KERNEL(EmbSeqPool);
 TEST_CPU_KERNEL(MatMul);
 TEST_CPU_KERNEL(Softmax);
+TEST_CPU_KERNEL(Adam);
 TEST_CPU_KERNEL(Sgd);
 TEST_CPU_KERNEL(VBroadcast);
 
@@ -134,6 +134,13 @@ class LayerNormOp : public framework::OperatorWithKernel {
     return framework::OpKernelType(input_data_type, ctx.GetPlace(), layout,
                                    library);
   }
+
+  bool GetOpCost(const framework::ExecutionContext& ctx,
+                 framework::OpCost* cost) const override {
+    // mean, variance, normalization, scale and bias of every element
+    cost->flops = 8.0 * ctx.Input<framework::Tensor>("X")->numel();
+    return true;
+  }
 };
 
 class LayerNormOpMaker : public framework::OpProtoAndCheckerMaker {
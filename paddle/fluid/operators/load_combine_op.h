@@ -18,11 +18,14 @@ limitations under the License. */
 #include <string>
 #include <vector>
 
+#include "paddle/fluid/framework/async_checkpointer.h"
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/data_type_transform.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/platform/device_context.h"
 
+DECLARE_bool(async_save_combine);
+
 namespace paddle {
 namespace operators {
 template <typename DeviceContext, typename T>
@@ -41,6 +44,10 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
                           "it to be greater than 0.",
                           out_var_names.size()));
     if (!model_from_memory) {
+      // the file may still be written by an asynchronous save_combine
+      if (FLAGS_async_save_combine) {
+        framework::AsyncCheckpointer::Instance().Wait(filename);
+      }
       std::ifstream fin(filename, std::ios::binary);
       PADDLE_ENFORCE_EQ(
           static_cast<bool>(fin), true,
@@ -22,6 +22,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/selected_rows.h"
 #include "paddle/fluid/operators/math/blas.h"
+#include "paddle/fluid/platform/cpu_helper.h"
 
 namespace paddle {
 namespace operators {
@@ -59,28 +60,32 @@ class LookupTableKernel : public framework::OpKernel<T> {
       auto *table = table_t->data<T>();
       auto *output = output_t->mutable_data<T>(context.GetPlace());
 
-      for (int64_t i = 0; i < ids_numel; ++i) {
-        if (padding_idx != kNoPadding && ids[i] == padding_idx) {
-          memset(output + i * row_width, 0, row_width * sizeof(T));
-        } else {
-          PADDLE_ENFORCE_LT(
-              ids[i], row_number,
-              platform::errors::InvalidArgument(
-                  "Variable value (input) of OP(fluid.layers.embedding) "
-                  "expected >= 0 and < %ld, but got %ld. Please check input "
-                  "value.",
-                  row_number, ids[i]));
-          PADDLE_ENFORCE_GE(
-              ids[i], 0,
-              platform::errors::InvalidArgument(
-                  "Variable value (input) of OP(fluid.layers.embedding) "
-                  "expected >= 0 and < %ld, but got %ld. Please check input "
-                  "value.",
-                  row_number, ids[i]));
-          memcpy(output + i * row_width, table + ids[i] * row_width,
-                 row_width * sizeof(T));
-        }
-      }
+      platform::ParallelFor(
+          0, ids_numel, platform::GetParallelForGrainSize(row_width),
+          [&](int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; ++i) {
+              if (padding_idx != kNoPadding && ids[i] == padding_idx) {
+                memset(output + i * row_width, 0, row_width * sizeof(T));
+              } else {
+                PADDLE_ENFORCE_LT(
+                    ids[i], row_number,
+                    platform::errors::InvalidArgument(
+                        "Variable value (input) of OP(fluid.layers.embedding) "
+                        "expected >= 0 and < %ld, but got %ld. Please check "
+                        "input value.",
+                        row_number, ids[i]));
+                PADDLE_ENFORCE_GE(
+                    ids[i], 0,
+                    platform::errors::InvalidArgument(
+                        "Variable value (input) of OP(fluid.layers.embedding) "
+                        "expected >= 0 and < %ld, but got %ld. Please check "
+                        "input value.",
+                        row_number, ids[i]));
+                memcpy(output + i * row_width, table + ids[i] * row_width,
+                       row_width * sizeof(T));
+              }
+            }
+          });
 
     } else if (table_var->IsType<SelectedRows>()) {
       const auto &table_t = table_var->Get<SelectedRows>();
@@ -66,6 +66,17 @@ class LookupTableV2Op : public framework::OperatorWithKernel {
     auto data_type = OperatorWithKernel::IndicateVarDataType(ctx, "W");
     return framework::OpKernelType(data_type, ctx.device_context());
   }
+
+  bool GetOpCost(const framework::ExecutionContext& ctx,
+                 framework::OpCost* cost) const override {
+    // only the looked up rows of W are read, not the whole table
+    auto* ids = ctx.Input<framework::Tensor>("Ids");
+    auto* out = ctx.Output<framework::Tensor>("Out");
+    cost->flops = 0;
+    cost->bytes = ids->numel() * framework::SizeOfType(ids->type()) +
+                  2.0 * out->numel() * framework::SizeOfType(out->type());
+    return true;
+  }
 };
 
 class LookupTableV2OpMaker : public framework::OpProtoAndCheckerMaker {
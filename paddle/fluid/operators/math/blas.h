@@ -117,6 +117,11 @@ class Blas {
                     const int lda, const T* B, const int ldb, T beta, T* C,
                     const int ldc) const;
 
+  // Returns the size in bytes of the buffer GEMM_PACK needs for the matrix.
+  template <typename T>
+  size_t GEMM_PACK_GET_SIZE(const CBLAS_IDENTIFIER id, const int M,
+                            const int N, const int K) const;
+
   template <typename T>
   void GEMM_FREE(T* data) const;
 
@@ -278,6 +283,11 @@ class BlasT : private Blas<DeviceContext> {
     Base()->template GEMM_COMPUTE<T>(args...);
   }
 
+  template <typename... ARGS>
+  size_t GEMM_PACK_GET_SIZE(ARGS... args) const {
+    return Base()->template GEMM_PACK_GET_SIZE<T>(args...);
+  }
+
   template <typename... ARGS>
   void GEMM_FREE(ARGS... args) const {
     Base()->template GEMM_FREE<T>(args...);
@@ -63,6 +63,11 @@ struct CBlas<float> {
     platform::dynload::cblas_sgemm_compute(args...);
   }
 
+  template <typename... ARGS>
+  static size_t GEMM_PACK_GET_SIZE(ARGS... args) {
+    return platform::dynload::cblas_sgemm_pack_get_size(args...);
+  }
+
   template <typename... ARGS>
   static void GEMM_FREE(ARGS... args) {
     platform::dynload::cblas_sgemm_free(args...);
@@ -189,6 +194,11 @@ struct CBlas<double> {
     platform::dynload::cblas_dgemm_compute(args...);
   }
 
+  template <typename... ARGS>
+  static size_t GEMM_PACK_GET_SIZE(ARGS... args) {
+    return platform::dynload::cblas_dgemm_pack_get_size(args...);
+  }
+
   template <typename... ARGS>
   static void GEMM_FREE(ARGS... args) {
     platform::dynload::cblas_dgemm_free(args...);
@@ -758,6 +768,13 @@ void Blas<platform::CPUDeviceContext>::GEMM_COMPUTE(
                          beta, C, ldc);
 }
 
+template <>
+template <typename T>
+size_t Blas<platform::CPUDeviceContext>::GEMM_PACK_GET_SIZE(
+    const CBLAS_IDENTIFIER id, const int M, const int N, const int K) const {
+  return CBlas<T>::GEMM_PACK_GET_SIZE(id, M, N, K);
+}
+
 template <>
 template <typename T>
 void Blas<platform::CPUDeviceContext>::GEMM_FREE(T *data) const {
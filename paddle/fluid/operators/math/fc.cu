@@ -80,7 +80,7 @@ class FCFunctor<platform::CUDADeviceContext, T> {
   void operator()(const platform::CUDADeviceContext& context, const int M,
                   const int N, const int K, const T* X, const T* W, T* Y,
                   const T* B = nullptr, bool relu = false,
-                  bool padding_weights = false) {
+                  bool padding_weights = false, const T* packed_W = nullptr) {
     PADDLE_ENFORCE_EQ(
         padding_weights, false,
         platform::errors::PermissionDenied(
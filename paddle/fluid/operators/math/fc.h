@@ -21,13 +21,15 @@ namespace paddle {
 namespace operators {
 namespace math {
 
+// Y = X * W (+ B, then relu). When packed_W is given, it must be W packed
+// by PackGemmWeight and is used instead of W (CPU only).
 template <typename DeviceContext, typename T>
 class FCFunctor {
  public:
   void operator()(const DeviceContext& context, const int M, const int N,
                   const int K, const T* X, const T* W, T* Y,
                   const T* B = nullptr, bool relu = false,
-                  bool weight_pass = false);
+                  bool weight_pass = false, const T* packed_W = nullptr);
 };
 
 }  // namespace math
@@ -0,0 +1,93 @@
+/* Copyright (c) 2016 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/operators/math/gemm_pack.h"
+
+#include "paddle/fluid/operators/math/blas.h"
+
+namespace paddle {
+namespace operators {
+namespace math {
+
+bool GemmPackSupported() {
+#ifdef PADDLE_WITH_MKLML
+  return true;
+#else
+  return false;
+#endif
+}
+
+template <typename T>
+void PackGemmWeight(const platform::CPUDeviceContext& context,
+                    const framework::Tensor& w, bool trans_w, T alpha,
+                    framework::Tensor* packed) {
+  PADDLE_ENFORCE_EQ(
+      GemmPackSupported(), true,
+      platform::errors::Unavailable(
+          "Packing GEMM weights requires Paddle to be compiled with MKLML."));
+  PADDLE_ENFORCE_EQ(w.dims().size(), 2,
+                    platform::errors::InvalidArgument(
+                        "The weight to pack must be a matrix, but received a "
+                        "tensor of rank %d.",
+                        w.dims().size()));
+#ifdef PADDLE_WITH_MKLML
+  const int K = trans_w ? w.dims()[1] : w.dims()[0];
+  const int N = trans_w ? w.dims()[0] : w.dims()[1];
+  auto blas = GetBlas<platform::CPUDeviceContext, T>(context);
+  // The packed layout of the B matrix does not depend on the number of rows
+  // of A, so pack for a single row and reuse it for any batch size.
+  size_t bytes = blas.GEMM_PACK_GET_SIZE(CblasBMatrix, 1, N, K);
+  int64_t numel = (bytes + sizeof(T) - 1) / sizeof(T);
+  T* dst = packed->mutable_data<T>({numel}, platform::CPUPlace());
+  blas.GEMM_PACK(CblasBMatrix, trans_w ? CblasTrans : CblasNoTrans, 1, N, K,
+                 alpha, w.data<T>(), trans_w ? K : N, dst);
+#endif
+}
+
+template <typename T>
+static void PackedGemmImpl(const platform::CPUDeviceContext& context, int M,
+                           int N, int K, const T* X, const T* packed_w, T* Y) {
+#ifdef PADDLE_WITH_MKLML
+  auto blas = GetBlas<platform::CPUDeviceContext, T>(context);
+  blas.GEMM_COMPUTE(CblasNoTrans, CblasPacked, M, N, K, X, K, packed_w, N,
+                    static_cast<T>(0), Y, N);
+#else
+  PADDLE_THROW(platform::errors::Unavailable(
+      "PackedGemm requires Paddle to be compiled with MKLML."));
+#endif
+}
+
+template void PackGemmWeight<float>(const platform::CPUDeviceContext&,
+                                    const framework::Tensor&, bool, float,
+                                    framework::Tensor*);
+template void PackGemmWeight<double>(const platform::CPUDeviceContext&,
+                                     const framework::Tensor&, bool, double,
+                                     framework::Tensor*);
+
+template <>
+void PackedGemm<float>(const platform::CPUDeviceContext& context, int M, int N,
+                       int K, const float* X, const float* packed_w, float* Y) {
+  PackedGemmImpl<float>(context, M, N, K, X, packed_w, Y);
+}
+
+template <>
+void PackedGemm<double>(const platform::CPUDeviceContext& context, int M,
+                        int N, int K, const double* X, const double* packed_w,
+                        double* Y) {
+  PackedGemmImpl<double>(context, M, N, K, X, packed_w, Y);
+}
+
+}  // namespace math
+}  // namespace operators
+}  // namespace paddle
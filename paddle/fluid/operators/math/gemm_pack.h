@@ -0,0 +1,84 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+#include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/platform/device_context.h"
+
+namespace paddle {
+namespace operators {
+namespace math {
+
+// Name of the op attribute holding the scope variable of the packed weight,
+// set by framework/ir/gemm_weight_pack_pass for fc, mul and matmul.
+constexpr char kPackedWeightAttr[] = "packed_weight";
+// Suffix of the scope variable holding the packed form of a GEMM weight.
+constexpr char kGemmPackedWeightSuffix[] = "@GEMM_PACKED";
+
+// Whether this build can pack GEMM weights, i.e. whether it links MKL.
+bool GemmPackSupported();
+
+// Packs the constant right hand side W of Y = alpha * X * op(W) into
+// `packed`, where op(W) is a K x N matrix, so that it can be multiplied
+// by PackedGemm with any number of rows of X. W is N x K when trans_w is
+// true and K x N otherwise.
+template <typename T>
+void PackGemmWeight(const platform::CPUDeviceContext& context,
+                    const framework::Tensor& w, bool trans_w, T alpha,
+                    framework::Tensor* packed);
+
+// Y = X * packed_w, where X is M x K and packed_w was built by
+// PackGemmWeight for a K x N weight. Only float and double are supported.
+template <typename T>
+void PackedGemm(const platform::CPUDeviceContext& context, int M, int N,
+                int K, const T* X, const T* packed_w, T* Y) {
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "PackedGemm only supports float and double."));
+}
+
+template <>
+void PackedGemm<float>(const platform::CPUDeviceContext& context, int M, int N,
+                       int K, const float* X, const float* packed_w, float* Y);
+template <>
+void PackedGemm<double>(const platform::CPUDeviceContext& context, int M,
+                        int N, int K, const double* X, const double* packed_w,
+                        double* Y);
+
+// Returns the packed weight attached to the op of `ctx`, or nullptr when the
+// op is not tagged, the packed variable was not built (e.g. the program was
+// saved and reloaded without running the pass) or the kernel is not a float
+// CPU kernel.
+template <typename DeviceContext, typename T>
+const T* GetPackedGemmWeight(const framework::ExecutionContext& ctx) {
+  if (!std::is_same<DeviceContext, platform::CPUDeviceContext>::value ||
+      !(std::is_same<T, float>::value || std::is_same<T, double>::value)) {
+    return nullptr;
+  }
+  const auto& name = ctx.Attr<std::string>(kPackedWeightAttr);
+  if (name.empty()) return nullptr;
+  auto* var = ctx.scope().FindVar(name);
+  if (var == nullptr || !var->IsType<framework::LoDTensor>()) {
+    return nullptr;
+  }
+  return var->Get<framework::LoDTensor>().data<T>();
+}
+
+}  // namespace math
+}  // namespace operators
+}  // namespace paddle
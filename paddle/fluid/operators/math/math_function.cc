@@ -27,6 +27,7 @@ limitations under the License. */
 #include <vector>
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/operators/math/math_function_impl.h"
+#include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/float16.h"
 #include "unsupported/Eigen/CXX11/Tensor"
 
@@ -107,7 +108,10 @@ struct TransposeNormal<platform::CPUDeviceContext, T> {
         out_ptr[out_idx] = in_ptr[in_idx];
       }
     };
-    transpose_helper(0, out->numel());
+    // Each output element costs about `rank` divisions to locate its input.
+    platform::ParallelFor(0, out->numel(),
+                          platform::GetParallelForGrainSize(rank),
+                          transpose_helper);
   }
 };
 
@@ -12,12 +12,16 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <algorithm>
+#include <cmath>
 #include <string>
+#include <vector>
 
 #include "paddle/fluid/operators/jit/kernels.h"
 #include "paddle/fluid/operators/math/blas.h"
 #include "paddle/fluid/operators/math/math_function.h"
 #include "paddle/fluid/operators/math/sequence_pooling.h"
+#include "paddle/fluid/platform/cpu_helper.h"
 
 namespace paddle {
 namespace operators {
@@ -32,6 +36,44 @@ template <typename T, int MajorType = Eigen::RowMajor,
           typename IndexType = Eigen::DenseIndex>
 using EigenMatrix = framework::EigenMatrix<T, MajorType, IndexType>;
 
+// Max pooling walks through the items of a sequence block by block, so that
+// the partial maximums and indices of a block stay in L1 cache.
+static constexpr int64_t kMaxPoolBlockSize = 512;
+
+// Split the sequences into contiguous parts holding roughly the same number
+// of elements, so that the threads are balanced when the lengths of
+// sequences vary a lot. Each sequence is weighted by its length plus one, for
+// an empty sequence still costs one item of padding. Returns the boundaries
+// of the parts in sequence indices.
+static std::vector<int64_t> PartitionSeqsByLength(const size_t* lod,
+                                                  int64_t num_seq,
+                                                  int64_t item_size) {
+  std::vector<int64_t> bounds(1, 0);
+  if (num_seq <= 0) {
+    bounds.push_back(0);
+    return bounds;
+  }
+  int64_t total = static_cast<int64_t>(lod[num_seq] - lod[0]) + num_seq;
+  // Sequences holding less elements than kParallelForMinWorkPerThread in
+  // total are pooled on one thread, for which forking is not worthwhile.
+  int64_t num_parts = std::min<int64_t>(
+      platform::GetIntraOpNumThreads(),
+      total * item_size / platform::kParallelForMinWorkPerThread);
+  num_parts = std::max<int64_t>(std::min(num_parts, num_seq), 1);
+  int64_t acc = 0;
+  for (int64_t i = 0; i < num_seq; ++i) {
+    acc += static_cast<int64_t>(lod[i + 1] - lod[i]) + 1;
+    int64_t k = static_cast<int64_t>(bounds.size());
+    if (k < num_parts && acc * num_parts >= total * k) {
+      bounds.push_back(i + 1);
+    }
+  }
+  if (bounds.back() != num_seq) {
+    bounds.push_back(num_seq);
+  }
+  return bounds;
+}
+
 template <typename T, bool is_test>
 class MaxSeqPoolFunctor {
  public:
@@ -67,34 +109,47 @@ class MaxSeqPoolFunctor {
             idx_dims, out_dims, idx_dims, out_dims));
 
     auto lod_level = input.lod().size();
-    auto starts = input.lod()[lod_level - 1];
+    const size_t* starts = input.lod()[lod_level - 1].data();
     const T* in_data = input.data<T>();
     T* out_data = output->data<T>();
     int* max_index = index->data<int>();
 
     int64_t num_seq = out_dims[0];
     int64_t dim = output->numel() / num_seq;
-    for (int64_t i = 0; i < num_seq; ++i) {
-      if (starts[i] == starts[i + 1]) {
-        for (int64_t k = 0; k < dim; ++k) {
-          out_data[i * dim + k] = pad_value;
-          max_index[i * dim + k] = -1;
-        }
-        continue;
-      }
-      for (int64_t k = 0; k < dim; ++k) {
-        out_data[i * dim + k] = in_data[starts[i] * dim + k];
-        max_index[i * dim + k] = starts[i];
-      }
-      for (size_t j = starts[i] + 1; j < starts[i + 1]; ++j) {
-        for (int64_t k = 0; k < dim; ++k) {
-          if (in_data[j * dim + k] > out_data[i * dim + k]) {
-            out_data[i * dim + k] = in_data[j * dim + k];
-            max_index[i * dim + k] = j;
+    auto parts = PartitionSeqsByLength(starts, num_seq, dim);
+    int64_t num_parts = static_cast<int64_t>(parts.size()) - 1;
+    platform::ParallelFor(0, num_parts, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; ++p) {
+        for (int64_t i = parts[p]; i < parts[p + 1]; ++i) {
+          T* out_pos = out_data + i * dim;
+          int* idx_pos = max_index + i * dim;
+          if (starts[i] == starts[i + 1]) {
+            for (int64_t k = 0; k < dim; ++k) {
+              out_pos[k] = pad_value;
+              idx_pos[k] = -1;
+            }
+            continue;
+          }
+          for (int64_t k0 = 0; k0 < dim; k0 += kMaxPoolBlockSize) {
+            int64_t k1 = std::min(k0 + kMaxPoolBlockSize, dim);
+            const T* in_pos = in_data + starts[i] * dim;
+            for (int64_t k = k0; k < k1; ++k) {
+              out_pos[k] = in_pos[k];
+              idx_pos[k] = starts[i];
+            }
+            for (size_t j = starts[i] + 1; j < starts[i + 1]; ++j) {
+              in_pos = in_data + j * dim;
+              for (int64_t k = k0; k < k1; ++k) {
+                if (in_pos[k] > out_pos[k]) {
+                  out_pos[k] = in_pos[k];
+                  idx_pos[k] = j;
+                }
+              }
+            }
           }
         }
       }
-    }
+    });
   }
 };
 // Instantisation of Max Sequence Pooling for test phase eg. no need to fill
@@ -127,29 +182,39 @@ class MaxSeqPoolFunctor<T, true> {
     }
 
     auto lod_level = input.lod().size();
-    auto starts = input.lod()[lod_level - 1];
+    const size_t* starts = input.lod()[lod_level - 1].data();
     const T* in_data = input.data<T>();
     T* out_data = output->data<T>();
 
     int64_t num_seq = out_dims[0];
     int64_t dim = output->numel() / num_seq;
-    for (int64_t i = 0; i < num_seq; ++i) {
-      if (starts[i] == starts[i + 1]) {
-        for (int64_t k = 0; k < dim; ++k) {
-          out_data[i * dim + k] = pad_value;
-        }
-        continue;
-      }
-      std::memcpy(&out_data[i * dim], &in_data[starts[i] * dim],
-                  dim * sizeof(T));
-      for (size_t j = starts[i] + 1; j < starts[i + 1]; ++j) {
-        for (int64_t k = 0; k < dim; ++k) {
-          if (in_data[j * dim + k] > out_data[i * dim + k]) {
-            out_data[i * dim + k] = in_data[j * dim + k];
+    auto parts = PartitionSeqsByLength(starts, num_seq, dim);
+    int64_t num_parts = static_cast<int64_t>(parts.size()) - 1;
+    platform::ParallelFor(0, num_parts, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; ++p) {
+        for (int64_t i = parts[p]; i < parts[p + 1]; ++i) {
+          T* out_pos = out_data + i * dim;
+          if (starts[i] == starts[i + 1]) {
+            for (int64_t k = 0; k < dim; ++k) {
+              out_pos[k] = pad_value;
+            }
+            continue;
+          }
+          for (int64_t k0 = 0; k0 < dim; k0 += kMaxPoolBlockSize) {
+            int64_t k1 = std::min(k0 + kMaxPoolBlockSize, dim);
+            std::memcpy(out_pos + k0, in_data + starts[i] * dim + k0,
+                        (k1 - k0) * sizeof(T));
+            for (size_t j = starts[i] + 1; j < starts[i + 1]; ++j) {
+              const T* in_pos = in_data + j * dim;
+              // Branch-free so that it can be vectorized by the compiler.
+              for (int64_t k = k0; k < k1; ++k) {
+                out_pos[k] = in_pos[k] > out_pos[k] ? in_pos[k] : out_pos[k];
+              }
+            }
           }
         }
       }
-    }
+    });
   }
 };
 template <typename T>
@@ -191,17 +256,26 @@ class MaxSeqPoolGradFunctor {
     const int* max_index = index.data<int>();
     T* ig_data = in_grad->data<T>();
 
-    SetConstant<platform::CPUDeviceContext, T> set_zero;
-    set_zero(context, in_grad, static_cast<T>(0.0));
+    auto lod_level = in_grad->lod().size();
+    const size_t* lod = in_grad->lod()[lod_level - 1].data();
     int64_t num_seq = og_dims[0];
     int64_t dim = out_grad.numel() / num_seq;
-    for (int64_t i = 0; i < num_seq; ++i) {
-      for (int64_t j = 0; j < dim; ++j) {
-        int step_id = max_index[i * dim + j];
-        if (step_id == -1) continue;
-        ig_data[step_id * dim + j] = og_data[i * dim + j];
+    auto parts = PartitionSeqsByLength(lod, num_seq, dim);
+    int64_t num_parts = static_cast<int64_t>(parts.size()) - 1;
+    // Every sequence zeros and scatters to its own rows of input@Grad.
+    platform::ParallelFor(0, num_parts, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; ++p) {
+        for (int64_t i = parts[p]; i < parts[p + 1]; ++i) {
+          std::memset(ig_data + lod[i] * dim, 0,
+                      (lod[i + 1] - lod[i]) * dim * sizeof(T));
+          for (int64_t j = 0; j < dim; ++j) {
+            int step_id = max_index[i * dim + j];
+            if (step_id == -1) continue;
+            ig_data[step_id * dim + j] = og_data[i * dim + j];
+          }
+        }
       }
-    }
+    });
   }
 };
 
@@ -215,26 +289,31 @@ class LastSeqPoolFunctor {
     auto* in_data = input.data<T>();
     auto* out_data = output->data<T>();
 
-    // Calculate the size of each item in sequence
-    int64_t item_size = input.numel() / input.dims()[0];
+    // Calculate the size of each item in sequence, which is not derived from
+    // numel since the input holds no item when all sequences are empty.
+    int64_t item_size = framework::flatten_to_2d(input.dims(), 1)[1];
     auto lod_level = input.lod().size();
-    auto lod = input.lod()[lod_level - 1];
-    int seq_num = static_cast<int>(lod.size()) - 1;
-    for (int i = 0; i < seq_num; ++i) {
-      // Calculate the length of each sequence
-      int64_t seq_len = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      if (seq_len == 0) {
-        for (int j = 0; j < item_size; ++j) {
-          out_data[j] = pad_value;
+    auto& lod_vec = input.lod()[lod_level - 1];
+    const size_t* lod = lod_vec.data();
+    int64_t seq_num = static_cast<int64_t>(lod_vec.size()) - 1;
+    auto parts = PartitionSeqsByLength(lod, seq_num, 1);
+    int64_t num_parts = static_cast<int64_t>(parts.size()) - 1;
+    platform::ParallelFor(0, num_parts, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; ++p) {
+        for (int64_t i = parts[p]; i < parts[p + 1]; ++i) {
+          T* out_pos = out_data + i * item_size;
+          if (lod[i] == lod[i + 1]) {
+            for (int64_t j = 0; j < item_size; ++j) {
+              out_pos[j] = pad_value;
+            }
+          } else {
+            // Copy the last item of sequence to output
+            std::memcpy(out_pos, in_data + (lod[i + 1] - 1) * item_size,
+                        item_size * sizeof(T));
+          }
         }
-      } else {
-        // Point to the begin of next sequence
-        in_data += seq_len * item_size;
-        // Copy the last item of sequence to output
-        std::memcpy(out_data, (in_data - item_size), item_size * sizeof(T));
       }
-      out_data += item_size;
-    }
+    });
   }
 };
 
@@ -248,39 +327,49 @@ class FirstSeqPoolFunctor {
     auto* in_data = input.data<T>();
     auto* out_data = output->data<T>();
 
-    // Calculate the size of each item in sequence
-    int64_t item_size = input.numel() / input.dims()[0];
+    // Calculate the size of each item in sequence, which is not derived from
+    // numel since the input holds no item when all sequences are empty.
+    int64_t item_size = framework::flatten_to_2d(input.dims(), 1)[1];
     auto lod_level = input.lod().size();
-    auto lod = input.lod()[lod_level - 1];
-    int seq_num = static_cast<int>(lod.size()) - 1;
-    for (int i = 0; i < seq_num; ++i) {
-      // Calculate the length of each sequence
-      int64_t seq_len = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      if (seq_len == 0) {
-        for (int j = 0; j < item_size; ++j) {
-          out_data[j] = pad_value;
+    auto& lod_vec = input.lod()[lod_level - 1];
+    const size_t* lod = lod_vec.data();
+    int64_t seq_num = static_cast<int64_t>(lod_vec.size()) - 1;
+    auto parts = PartitionSeqsByLength(lod, seq_num, 1);
+    int64_t num_parts = static_cast<int64_t>(parts.size()) - 1;
+    platform::ParallelFor(0, num_parts, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; ++p) {
+        for (int64_t i = parts[p]; i < parts[p + 1]; ++i) {
+          T* out_pos = out_data + i * item_size;
+          if (lod[i] == lod[i + 1]) {
+            for (int64_t j = 0; j < item_size; ++j) {
+              out_pos[j] = pad_value;
+            }
+          } else {
+            // Copy the first item of sequence to output
+            std::memcpy(out_pos, in_data + lod[i] * item_size,
+                        item_size * sizeof(T));
+          }
         }
-      } else {
-        // Copy the first item of sequence to output
-        std::memcpy(out_data, in_data, item_size * sizeof(T));
-        // Point to the next sequence
-        in_data += seq_len * item_size;
       }
-      out_data += item_size;
-    }
+    });
   }
 };
 
+// Backward of SUM, AVERAGE, SQRT, LAST and FIRST pooling, in which every item
+// of a sequence gets the scaled output@Grad, or only the last/first item gets
+// it and the others are zero.
 template <typename T>
-class SumSeqPoolGradFunctor {
+class SeqPoolGradFunctor {
  public:
   void operator()(const platform::CPUDeviceContext& context,
+                  const std::string& pooltype,
                   const framework::LoDTensor& out_grad,
                   framework::LoDTensor* in_grad) {
     auto lod_level = in_grad->lod().size();
-    auto lod = in_grad->lod()[lod_level - 1];
+    auto& lod_vec = in_grad->lod()[lod_level - 1];
+    const size_t* lod = lod_vec.data();
     int64_t out_w = out_grad.numel() / out_grad.dims()[0];
-    int64_t in_w = in_grad->numel() / in_grad->dims()[0];
+    int64_t in_w = framework::flatten_to_2d(in_grad->dims(), 1)[1];
     PADDLE_ENFORCE_EQ(in_w, out_w,
                       platform::errors::InvalidArgument(
                           "The feature size of input@Grad and output@Grad "
@@ -289,17 +378,39 @@ class SumSeqPoolGradFunctor {
                           in_w, out_w, in_w, out_w));
     const T* out_g_data = out_grad.data<T>();
     T* in_g_data = in_grad->mutable_data<T>(context.GetPlace());
-    auto blas = math::GetBlas<platform::CPUDeviceContext, T>(context);
-    for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
-      int64_t h = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      if (h == 0) continue;
-      int64_t in_offset = lod[i] * in_w;
-      const T* out_pos = out_g_data + i * out_w;
-      T* in_pos = in_g_data + in_offset;
-      for (int r = 0; r != h; ++r) {
-        blas.VCOPY(in_w, out_pos, in_pos + r * in_w);
+    auto vscal =
+        jit::KernelFuncs<jit::VScalTuple<T>, platform::CPUPlace>::Cache().At(
+            static_cast<int>(in_w));
+    int64_t seq_num = static_cast<int64_t>(lod_vec.size()) - 1;
+    auto parts = PartitionSeqsByLength(lod, seq_num, in_w);
+    int64_t num_parts = static_cast<int64_t>(parts.size()) - 1;
+    platform::ParallelFor(0, num_parts, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; ++p) {
+        for (int64_t i = parts[p]; i < parts[p + 1]; ++i) {
+          int64_t h = static_cast<int64_t>(lod[i + 1] - lod[i]);
+          if (h == 0) continue;
+          const T* out_pos = out_g_data + i * out_w;
+          T* in_pos = in_g_data + lod[i] * in_w;
+          if (pooltype == "LAST" || pooltype == "FIRST") {
+            std::memset(in_pos, 0, h * in_w * sizeof(T));
+            int64_t r = pooltype == "LAST" ? h - 1 : 0;
+            std::memcpy(in_pos + r * in_w, out_pos, in_w * sizeof(T));
+          } else if (pooltype == "SUM") {
+            for (int64_t r = 0; r < h; ++r) {
+              std::memcpy(in_pos + r * in_w, out_pos, in_w * sizeof(T));
+            }
+          } else {
+            T scalar = pooltype == "AVERAGE"
+                           ? static_cast<T>(1) / static_cast<T>(h)
+                           : static_cast<T>(1) / std::sqrt(static_cast<T>(h));
+            for (int64_t r = 0; r < h; ++r) {
+              vscal(&scalar, out_pos, in_pos + r * in_w,
+                    static_cast<int>(in_w));
+            }
+          }
+        }
       }
-    }
+    });
   }
 };
 
@@ -332,63 +443,67 @@ class SequencePoolFunctor<platform::CPUDeviceContext, T> {
       first_pool(context, input, pad_value, output);
       return;
     }
+    jit::SeqPoolType type = jit::SeqPoolType::kSum;
+    if (pooltype == "AVERAGE") {
+      type = jit::SeqPoolType::kAvg;
+    } else if (pooltype == "SQRT") {
+      type = jit::SeqPoolType::kSqrt;
+    } else if (pooltype != "SUM") {
+      PADDLE_THROW(platform::errors::InvalidArgument(
+          "unsupported pooling pooltype: %s. Only support \"AVERAGE\" and "
+          "\"SQRT\"",
+          pooltype));
+    }
+    auto place = context.GetPlace();
+    PADDLE_ENFORCE_EQ(
+        platform::is_cpu_place(place), true,
+        platform::errors::InvalidArgument(
+            "Sequence_pool should run on CPU Device when pooltype is %s",
+            pooltype));
     auto lod_level = input.lod().size();
-    auto lod = input.lod()[lod_level - 1];
-    if (pooltype == "SUM") {
-      auto place = context.GetPlace();
-      PADDLE_ENFORCE_EQ(
-          platform::is_cpu_place(place), true,
-          platform::errors::InvalidArgument(
-              "Sequence_pool should run on CPU Device when pooltype is SUM"));
-      const T* src = input.data<T>();
-      T* dst = output->mutable_data<T>(place);
-      jit::seq_pool_attr_t attr(
-          static_cast<int>(input.numel() / input.dims()[0]),
-          jit::SeqPoolType::kSum);
-      auto seqpool =
-          jit::KernelFuncs<jit::SeqPoolTuple<T>, platform::CPUPlace>::Cache()
-              .At(attr);
-      for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
-        attr.h = static_cast<int>(lod[i + 1] - lod[i]);
-        if (attr.h == 0) {
-          for (int j = 0; j < attr.w; ++j) {
-            dst[j] = pad_value;
+    auto& lod_vec = input.lod()[lod_level - 1];
+    const size_t* lod = lod_vec.data();
+    const T* src = input.data<T>();
+    T* dst = output->mutable_data<T>(place);
+    // The generated kAvg and kSqrt kernels keep the scale of the current
+    // sequence in the kernel object, so they cannot be shared by threads.
+    // The sequences are summed by the kSum kernel, and scaled afterwards.
+    const jit::seq_pool_attr_t attr(
+        static_cast<int>(framework::flatten_to_2d(input.dims(), 1)[1]),
+        jit::SeqPoolType::kSum);
+    auto seqpool =
+        jit::KernelFuncs<jit::SeqPoolTuple<T>, platform::CPUPlace>::Cache().At(
+            attr);
+    auto vscal =
+        jit::KernelFuncs<jit::VScalTuple<T>, platform::CPUPlace>::Cache().At(
+            attr.w);
+    int64_t seq_num = static_cast<int64_t>(lod_vec.size()) - 1;
+    auto parts = PartitionSeqsByLength(lod, seq_num, attr.w);
+    int64_t num_parts = static_cast<int64_t>(parts.size()) - 1;
+    platform::ParallelFor(0, num_parts, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; ++p) {
+        // Each thread holds its own attr, in which h differs among sequences.
+        jit::seq_pool_attr_t seq_attr(attr.w, jit::SeqPoolType::kSum);
+        for (int64_t i = parts[p]; i < parts[p + 1]; ++i) {
+          T* dst_pos = dst + i * attr.w;
+          seq_attr.h = static_cast<int>(lod[i + 1] - lod[i]);
+          if (seq_attr.h == 0) {
+            for (int j = 0; j < attr.w; ++j) {
+              dst_pos[j] = pad_value;
+            }
+            continue;
+          }
+          seqpool(src + lod[i] * attr.w, dst_pos, &seq_attr);
+          if (type != jit::SeqPoolType::kSum) {
+            T h = static_cast<T>(seq_attr.h);
+            T scalar = type == jit::SeqPoolType::kAvg
+                           ? static_cast<T>(1) / h
+                           : static_cast<T>(1) / std::sqrt(h);
+            vscal(&scalar, dst_pos, dst_pos, attr.w);
           }
-        } else {
-          seqpool(src, dst, &attr);
-        }
-        dst += attr.w;
-        src += attr.h * attr.w;
-      }
-      return;
-    }
-    auto& place = *context.eigen_device();
-    for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
-      Tensor out_t = output->Slice(i, i + 1);
-      int64_t w = input.numel() / input.dims()[0];
-      if (lod[i] == lod[i + 1]) {
-        for (int j = 0; j < w; ++j) {
-          out_t.data<T>()[j] = pad_value;
         }
-        continue;
       }
-      Tensor in_t =
-          input.Slice(static_cast<int>(lod[i]), static_cast<int>(lod[i + 1]));
-      int64_t h = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      auto in_e = EigenMatrix<T>::From(in_t, framework::make_ddim({h, w}));
-      auto out_e = EigenVector<T>::Flatten(out_t);
-      if (pooltype == "AVERAGE") {
-        out_e.device(place) = in_e.mean(Eigen::array<int, 1>({{0}}));
-      } else if (pooltype == "SQRT") {
-        out_e.device(place) = in_e.sum(Eigen::array<int, 1>({{0}})) /
-                              std::sqrt(static_cast<T>(h));
-      } else {
-        PADDLE_THROW(platform::errors::InvalidArgument(
-            "unsupported pooling pooltype: %s. Only support \"AVERAGE\" and "
-            "\"SQRT\"",
-            pooltype));
-      }
-    }
+    });
   }
 };
 
@@ -407,49 +522,17 @@ class SequencePoolGradFunctor<platform::CPUDeviceContext, T> {
       return;
     }
 
-    if (pooltype == "LAST" || pooltype == "FIRST") {
-      // set X@Grad be zero at first when pooltype is LAST/FIRST
-      math::SetConstant<platform::CPUDeviceContext, T> functor;
-      functor(context, in_grad, 0);
-    }
-
-    if (pooltype == "SUM") {
-      math::SumSeqPoolGradFunctor<T> sum_pool_grad;
-      sum_pool_grad(context, out_grad, in_grad);
+    if (pooltype == "SUM" || pooltype == "AVERAGE" || pooltype == "SQRT" ||
+        pooltype == "LAST" || pooltype == "FIRST") {
+      math::SeqPoolGradFunctor<T> pool_grad;
+      pool_grad(context, pooltype, out_grad, in_grad);
       return;
     }
 
-    auto lod_level = in_grad->lod().size();
-    auto lod = in_grad->lod()[lod_level - 1];
-    auto& place = *context.eigen_device();
-    for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
-      if (lod[i] == lod[i + 1]) continue;
-      auto in_g_t = in_grad->Slice(static_cast<int>(lod[i]),
-                                   static_cast<int>(lod[i + 1]));
-      auto out_g_t = out_grad.Slice(i, i + 1);
-      int64_t h = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      int64_t w = in_grad->numel() / in_grad->dims()[0];
-      auto in_g_e = EigenMatrix<T>::From(in_g_t, {h, w});
-      auto out_g_e = EigenMatrix<T>::From(out_g_t, {1, w});
-      auto out_g_e_v = EigenVector<T>::Flatten(out_g_t);
-      Eigen::DSizes<int, 2> bcast(h, 1);
-
-      if (pooltype == "AVERAGE") {
-        in_g_e.device(place) = (out_g_e / static_cast<T>(h)).broadcast(bcast);
-      } else if (pooltype == "SQRT") {
-        in_g_e.device(place) =
-            (out_g_e / std::sqrt(static_cast<T>(h))).broadcast(bcast);
-      } else if (pooltype == "LAST") {
-        in_g_e.chip(h - 1, 0).device(place) = out_g_e_v;
-      } else if (pooltype == "FIRST") {
-        in_g_e.chip(0, 0).device(place) = out_g_e_v;
-      } else {
-        PADDLE_THROW(platform::errors::InvalidArgument(
-            "unsupported pooling pooltype: %s. Only support \"AVERAGE\", "
-            "\"SQRT\", \"LAST\" and \"FIRST\"",
-            pooltype));
-      }
-    }
+    PADDLE_THROW(platform::errors::InvalidArgument(
+        "unsupported pooling pooltype: %s. Only support \"AVERAGE\", "
+        "\"SQRT\", \"LAST\" and \"FIRST\"",
+        pooltype));
   }
 };
 
@@ -14,6 +14,10 @@ limitations under the License. */
 
 #include "paddle/fluid/operators/math/sequence_pooling.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "paddle/fluid/platform/cpu_helper.h"
 
 template <typename DeviceContext, typename T>
 void TestSequencePoolingSum(const DeviceContext &context,
@@ -123,6 +127,193 @@ TEST(SequencePoolingGrad, CPU_SUM) {
                                                                     lod2, 128);
 }
 
+template <typename T>
+void TestSequencePoolingCPU(const std::string &pooltype, bool is_test,
+                            const paddle::framework::LoD &lod,
+                            const int64_t second_dim) {
+  auto place = paddle::platform::CPUPlace();
+  auto *context = static_cast<paddle::platform::CPUDeviceContext *>(
+      paddle::platform::DeviceContextPool::Instance().Get(place));
+
+  const int64_t num_seq = static_cast<int64_t>(lod[0].size()) - 1;
+  const int64_t num_items = static_cast<int64_t>(lod[0].back());
+  paddle::framework::LoDTensor input;
+  T *in_data = input.mutable_data<T>(
+      paddle::framework::make_ddim({num_items, second_dim}), place);
+  for (int64_t i = 0; i < input.numel(); ++i) {
+    in_data[i] = static_cast<T>((i * 7919) % 1000) / static_cast<T>(100);
+  }
+  input.set_lod(lod);
+
+  paddle::framework::LoDTensor output;
+  output.mutable_data<T>(paddle::framework::make_ddim({num_seq, second_dim}),
+                         place);
+  paddle::framework::Tensor index;
+  index.mutable_data<int>(paddle::framework::make_ddim({num_seq, second_dim}),
+                          place);
+
+  const T pad_value = static_cast<T>(-1);
+  paddle::operators::math::SequencePoolFunctor<
+      paddle::platform::CPUDeviceContext, T>()(
+      *context, pooltype, pad_value, input, &output, is_test, &index);
+
+  // Check the output with a naive implementation.
+  const T *out_data = output.data<T>();
+  for (int64_t i = 0; i < num_seq; ++i) {
+    int64_t begin = lod[0][i];
+    int64_t end = lod[0][i + 1];
+    for (int64_t k = 0; k < second_dim; ++k) {
+      T expect = pad_value;
+      if (end > begin) {
+        T sum = 0;
+        T max = in_data[begin * second_dim + k];
+        for (int64_t j = begin; j < end; ++j) {
+          sum += in_data[j * second_dim + k];
+          max = std::max(max, in_data[j * second_dim + k]);
+        }
+        if (pooltype == "SUM") {
+          expect = sum;
+        } else if (pooltype == "AVERAGE") {
+          expect = sum / static_cast<T>(end - begin);
+        } else if (pooltype == "SQRT") {
+          expect = sum / std::sqrt(static_cast<T>(end - begin));
+        } else if (pooltype == "MAX") {
+          expect = max;
+        } else if (pooltype == "LAST") {
+          expect = in_data[(end - 1) * second_dim + k];
+        } else if (pooltype == "FIRST") {
+          expect = in_data[begin * second_dim + k];
+        }
+      }
+      EXPECT_NEAR(out_data[i * second_dim + k], expect, 1e-3);
+    }
+  }
+}
+
+template <typename T>
+void TestSequencePoolingGradCPU(const std::string &pooltype,
+                                const paddle::framework::LoD &lod,
+                                const int64_t second_dim) {
+  auto place = paddle::platform::CPUPlace();
+  auto *context = static_cast<paddle::platform::CPUDeviceContext *>(
+      paddle::platform::DeviceContextPool::Instance().Get(place));
+
+  const int64_t num_seq = static_cast<int64_t>(lod[0].size()) - 1;
+  const int64_t num_items = static_cast<int64_t>(lod[0].back());
+  paddle::framework::LoDTensor input;
+  T *in_data = input.mutable_data<T>(
+      paddle::framework::make_ddim({num_items, second_dim}), place);
+  for (int64_t i = 0; i < input.numel(); ++i) {
+    in_data[i] = static_cast<T>((i * 7919) % 1000) / static_cast<T>(100);
+  }
+  input.set_lod(lod);
+
+  // The forward pass is run to get the index of MAX pooling.
+  paddle::framework::LoDTensor output;
+  output.mutable_data<T>(paddle::framework::make_ddim({num_seq, second_dim}),
+                         place);
+  paddle::framework::Tensor index;
+  index.mutable_data<int>(paddle::framework::make_ddim({num_seq, second_dim}),
+                          place);
+  paddle::operators::math::SequencePoolFunctor<
+      paddle::platform::CPUDeviceContext, T>()(
+      *context, pooltype, static_cast<T>(0), input, &output, false, &index);
+
+  paddle::framework::LoDTensor out_grad;
+  T *og_data = out_grad.mutable_data<T>(
+      paddle::framework::make_ddim({num_seq, second_dim}), place);
+  for (int64_t i = 0; i < out_grad.numel(); ++i) {
+    og_data[i] = static_cast<T>((i * 131) % 97) / static_cast<T>(10);
+  }
+
+  // input@Grad is filled with garbage to check that every item is written.
+  paddle::framework::LoDTensor in_grad;
+  in_grad.set_lod(lod);
+  T *ig_data = in_grad.mutable_data<T>(
+      paddle::framework::make_ddim({num_items, second_dim}), place);
+  std::fill(ig_data, ig_data + in_grad.numel(), static_cast<T>(123));
+
+  paddle::operators::math::SequencePoolGradFunctor<
+      paddle::platform::CPUDeviceContext, T>()(*context, pooltype, out_grad,
+                                               &in_grad, &index);
+
+  // Check input@Grad with a naive implementation.
+  for (int64_t i = 0; i < num_seq; ++i) {
+    int64_t begin = lod[0][i];
+    int64_t end = lod[0][i + 1];
+    T h = static_cast<T>(end - begin);
+    for (int64_t k = 0; k < second_dim; ++k) {
+      T og = og_data[i * second_dim + k];
+      int64_t max_j = begin;
+      for (int64_t j = begin + 1; j < end; ++j) {
+        if (in_data[j * second_dim + k] > in_data[max_j * second_dim + k]) {
+          max_j = j;
+        }
+      }
+      for (int64_t j = begin; j < end; ++j) {
+        T expect = 0;
+        if (pooltype == "SUM") {
+          expect = og;
+        } else if (pooltype == "AVERAGE") {
+          expect = og / h;
+        } else if (pooltype == "SQRT") {
+          expect = og / std::sqrt(h);
+        } else if (pooltype == "MAX") {
+          expect = j == max_j ? og : 0;
+        } else if (pooltype == "LAST") {
+          expect = j == end - 1 ? og : 0;
+        } else if (pooltype == "FIRST") {
+          expect = j == begin ? og : 0;
+        }
+        EXPECT_NEAR(ig_data[j * second_dim + k], expect, 1e-5)
+            << pooltype << " sequence " << i << " item " << j;
+      }
+    }
+  }
+}
+
+// Sequences of various lengths, including empty ones, so that the sequences
+// are split into several parts when running with multi-threads.
+static paddle::framework::LoD VariousLengthLoD() {
+  paddle::framework::LoD lod;
+  lod.push_back(std::vector<size_t>{0});
+  for (size_t i = 0; i < 500; ++i) {
+    lod[0].push_back(lod[0].back() + (i * 37) % 23);
+  }
+  return lod;
+}
+
+TEST(SequencePooling, CPU) {
+  paddle::platform::SetIntraOpNumThreads(4);
+  paddle::framework::LoD lod = VariousLengthLoD();
+  for (auto pooltype : {"SUM", "AVERAGE", "SQRT", "MAX", "LAST", "FIRST"}) {
+    TestSequencePoolingCPU<float>(pooltype, false, lod, 96);
+  }
+  TestSequencePoolingCPU<float>("MAX", true, lod, 1030);
+  TestSequencePoolingCPU<double>("MAX", false, lod, 1030);
+  paddle::platform::SetIntraOpNumThreads(1);
+}
+
+TEST(SequencePoolingGrad, CPU) {
+  paddle::platform::SetIntraOpNumThreads(4);
+  paddle::framework::LoD lod = VariousLengthLoD();
+  for (auto pooltype : {"SUM", "AVERAGE", "SQRT", "MAX", "LAST", "FIRST"}) {
+    TestSequencePoolingGradCPU<float>(pooltype, lod, 96);
+    TestSequencePoolingGradCPU<double>(pooltype, lod, 1030);
+  }
+
+  // Only empty sequences, and an empty sequence at both ends.
+  paddle::framework::LoD empty_lod;
+  empty_lod.push_back(std::vector<size_t>{0, 0, 0});
+  paddle::framework::LoD edge_lod;
+  edge_lod.push_back(std::vector<size_t>{0, 0, 3, 4, 4});
+  for (auto pooltype : {"SUM", "AVERAGE", "SQRT", "MAX", "LAST", "FIRST"}) {
+    TestSequencePoolingGradCPU<float>(pooltype, empty_lod, 8);
+    TestSequencePoolingGradCPU<float>(pooltype, edge_lod, 8);
+  }
+  paddle::platform::SetIntraOpNumThreads(1);
+}
+
 #ifdef PADDLE_WITH_CUDA
 TEST(SequencePoolingGrad, CUDA_SUM) {
   auto place = paddle::platform::CUDAPlace(0);
@@ -18,6 +18,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/op_version_registry.h"
 #include "paddle/fluid/operators/math/blas.h"
+#include "paddle/fluid/operators/math/gemm_pack.h"
 #ifdef PADDLE_WITH_MKLDNN
 #include "paddle/fluid/platform/mkldnn_helper.h"
 #endif
@@ -82,6 +83,19 @@ class MatMulKernel : public framework::OpKernel<T> {
 
     const auto &x_dims = x.dims();
     const auto &y_dims = y.dims();
+    // A packed Y (see GemmWeightPackPass) is always 2-D and built for
+    // alpha = 1 and X not transposed, so all leading dimensions of X fold
+    // into the rows. A pass run after the packing may have changed them.
+    const T *packed_y = math::GetPackedGemmWeight<DeviceContext, T>(context);
+    if (packed_y != nullptr && head_number <= 1 && scale == static_cast<T>(1) &&
+        !context.Attr<bool>("transpose_X")) {
+      int K = mat_dim_a.width_;
+      math::PackedGemm<T>(
+          context.template device_context<platform::CPUDeviceContext>(),
+          x.numel() / K, mat_dim_b.width_, K, x.data<T>(), packed_y,
+          out->data<T>());
+      return;
+    }
     if (head_number <= 1 && x_dims.size() == 3 && y_dims.size() <= 2) {
       // the transpose_X must be false, if is true, the transpose cost much time
       if (!context.Attr<bool>("transpose_X")) {
@@ -656,8 +670,13 @@ class MatMulOp : public framework::OperatorWithKernel {
 
   framework::OpKernelType GetExpectedKernelType(
       const framework::ExecutionContext &ctx) const override {
+    // Y may be released when it is only read through its packed copy, see
+    // ReleasePackedGemmWeights.
+    auto *y = ctx.Input<framework::Tensor>("Y");
     auto input_data_type =
-        OperatorWithKernel::IndicateOrPromoteVarDataTypes(ctx, "X", "Y");
+        y != nullptr && !y->IsInitialized()
+            ? OperatorWithKernel::IndicateVarDataType(ctx, "X")
+            : OperatorWithKernel::IndicateOrPromoteVarDataTypes(ctx, "X", "Y");
 
 #ifdef PADDLE_WITH_MKLDNN
     using mkldnn::memory;
@@ -682,6 +701,16 @@ class MatMulOp : public framework::OperatorWithKernel {
                                      tensor.place(), tensor.layout());
     }
   }
+
+  bool GetOpCost(const framework::ExecutionContext& ctx,
+                 framework::OpCost* cost) const override {
+    auto x_dims = ctx.Input<framework::Tensor>("X")->dims();
+    int rank = x_dims.size();
+    int64_t k = x_dims[rank - 1];
+    if (rank > 1 && ctx.Attr<bool>("transpose_X")) k = x_dims[rank - 2];
+    cost->flops = 2.0 * ctx.Output<framework::Tensor>("Out")->numel() * k;
+    return true;
+  }
 };
 
 class MatMulOpMaker : public framework::OpProtoAndCheckerMaker {
@@ -725,6 +754,11 @@ class MatMulOpMaker : public framework::OpProtoAndCheckerMaker {
         R"DOC(When MKLDNN MatMul_transpose_reshape fuse activated, "
               "it's a axis atribute of fused transpose for `Out` output.)DOC")
         .SetDefault({});
+    AddAttr<std::string>(
+        "packed_weight",
+        "(string, default \"\") Name of the variable holding the pre-packed "
+        "form of Y, set by gemm_weight_pack_pass for inference on CPU.")
+        .SetDefault("");
     AddAttr<bool>(
         "use_quantizer",
         "(bool, default false) "
@@ -120,6 +120,16 @@ class MulOp : public framework::OperatorWithKernel {
     return framework::OpKernelType(input_data_type, ctx.GetPlace(), layout,
                                    library, customized_type_value);
   }
+
+  bool GetOpCost(const framework::ExecutionContext& ctx,
+                 framework::OpCost* cost) const override {
+    auto x_dims = ctx.Input<framework::Tensor>("X")->dims();
+    int x_num_col_dims = ctx.Attr<int>("x_num_col_dims");
+    int64_t k = framework::product(
+        framework::slice_ddim(x_dims, x_num_col_dims, x_dims.size()));
+    cost->flops = 2.0 * ctx.Output<framework::Tensor>("Out")->numel() * k;
+    return true;
+  }
 };
 
 class MulOpMaker : public framework::OpProtoAndCheckerMaker {
@@ -161,6 +171,11 @@ class MulOpMaker : public framework::OpProtoAndCheckerMaker {
         )DOC")
         .SetDefault(1)
         .EqualGreaterThan(1);
+    AddAttr<std::string>(
+        "packed_weight",
+        "(string, default \"\") Name of the variable holding the pre-packed "
+        "form of Y, set by gemm_weight_pack_pass for inference on CPU.")
+        .SetDefault("");
     AddAttr<float>(
         "scale_x",
         "scale_x to be used for int8 mul input data x. scale_x has the"
@@ -17,6 +17,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/operators/math/blas.h"
+#include "paddle/fluid/operators/math/gemm_pack.h"
 #include "paddle/fluid/operators/math/math_function.h"
 
 namespace paddle {
@@ -50,9 +51,16 @@ class MulKernel : public framework::OpKernel<T> {
       z->Resize({x_matrix.dims()[0], y_matrix.dims()[1]});
     }
 
-    auto blas = math::GetBlas<DeviceContext, T>(context);
-
-    blas.MatMul(x_matrix, y_matrix, z);
+    const T* packed_y = math::GetPackedGemmWeight<DeviceContext, T>(context);
+    if (packed_y != nullptr) {
+      math::PackedGemm<T>(
+          context.template device_context<platform::CPUDeviceContext>(),
+          x_matrix.dims()[0], y_matrix.dims()[1], x_matrix.dims()[1],
+          x_matrix.data<T>(), packed_y, z->data<T>());
+    } else {
+      auto blas = math::GetBlas<DeviceContext, T>(context);
+      blas.MatMul(x_matrix, y_matrix, z);
+    }
     if (z_dim.size() != 2) {
       z->Resize(z_dim);
     }
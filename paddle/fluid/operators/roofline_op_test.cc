@@ -0,0 +1,99 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/platform/profiler.h"
+#include "paddle/fluid/platform/roofline.h"
+
+USE_CPU_ONLY_OP(mul);
+USE_CPU_ONLY_OP(conv2d);
+
+namespace paddle {
+namespace operators {
+
+namespace {
+
+void CreateInput(framework::Scope* scope, const std::string& name,
+                 const std::vector<int64_t>& dims) {
+  auto* tensor = scope->Var(name)->GetMutable<framework::LoDTensor>();
+  float* data = tensor->mutable_data<float>(framework::make_ddim(dims),
+                                            platform::CPUPlace());
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = static_cast<float>(i % 7);
+  }
+}
+
+}  // namespace
+
+// The kernels run while profiling with the roofline report are timed and
+// recorded with the FLOPs reported by GetOpCost and the bytes of their
+// inputs and outputs.
+TEST(RooflineReport, RecordOpCost) {
+  framework::Scope scope;
+  platform::CPUPlace place;
+  // mul: [4, 6] x [6, 5]
+  CreateInput(&scope, "x", {4, 6});
+  CreateInput(&scope, "y", {6, 5});
+  scope.Var("mul_out")->GetMutable<framework::LoDTensor>();
+  auto mul = framework::OpRegistry::CreateOp(
+      "mul", {{"X", {"x"}}, {"Y", {"y"}}}, {{"Out", {"mul_out"}}}, {});
+  // conv2d: [1, 2, 5, 5] with 3 filters of [2, 3, 3], the output is
+  // [1, 3, 3, 3]
+  CreateInput(&scope, "input", {1, 2, 5, 5});
+  CreateInput(&scope, "filter", {3, 2, 3, 3});
+  scope.Var("conv_out")->GetMutable<framework::LoDTensor>();
+  auto conv = framework::OpRegistry::CreateOp(
+      "conv2d", {{"Input", {"input"}}, {"Filter", {"filter"}}},
+      {{"Output", {"conv_out"}}}, {});
+
+  auto& recorder = platform::RooflineRecorder::Instance();
+  platform::EnableProfiler(platform::ProfilerState::kCPU);
+  platform::EnableRooflineReport(true);
+  ASSERT_TRUE(platform::IsRooflineReportEnabled());
+  mul->Run(scope, place);
+  mul->Run(scope, place);
+  conv->Run(scope, place);
+
+  auto mul_item = recorder.GetItem("mul");
+  EXPECT_EQ(mul_item.calls, 2);
+  EXPECT_EQ(mul_item.costed_ms, mul_item.total_ms);
+  EXPECT_EQ(mul_item.flops, 2 * (2.0 * 4 * 5 * 6));
+  EXPECT_EQ(mul_item.bytes, 2.0 * (4 * 6 + 6 * 5 + 4 * 5) * sizeof(float));
+
+  auto conv_item = recorder.GetItem("conv2d");
+  EXPECT_EQ(conv_item.calls, 1);
+  EXPECT_EQ(conv_item.flops, 2.0 * (3 * 3 * 3) * (2 * 3 * 3));
+  EXPECT_EQ(conv_item.bytes,
+            (2.0 * 5 * 5 + 3 * 2 * 3 * 3 + 3 * 3 * 3) * sizeof(float));
+
+  testing::internal::CaptureStdout();
+  platform::DisableProfiler(platform::EventSortingKey::kDefault,
+                            "roofline_op_test_profile");
+  std::string report = testing::internal::GetCapturedStdout();
+  EXPECT_NE(report.find("Roofline Report"), std::string::npos);
+  EXPECT_NE(report.find("conv2d"), std::string::npos);
+  EXPECT_GT(platform::RooflineRecorder::PeakGflops(), 0);
+
+  // not recorded once the profiler stops
+  EXPECT_FALSE(platform::IsRooflineReportEnabled());
+  mul->Run(scope, place);
+  EXPECT_EQ(recorder.GetItem("mul").calls, 0);
+}
+
+}  // namespace operators
+}  // namespace paddle
@@ -15,11 +15,14 @@ limitations under the License. */
 #pragma once
 
 #include <stdint.h>
+#include <deque>
 #include <fstream>
 #include <numeric>
 #include <sstream>
 #include <string>
+#include <vector>
 
+#include "paddle/fluid/framework/async_checkpointer.h"
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/data_type_transform.h"
 #include "paddle/fluid/framework/framework.pb.h"
@@ -28,6 +31,8 @@ limitations under the License. */
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/port.h"
 
+DECLARE_bool(async_save_combine);
+
 namespace paddle {
 namespace operators {
 template <typename DeviceContext, typename T>
@@ -41,6 +46,10 @@ class SaveCombineOpKernel : public framework::OpKernel<T> {
     auto save_to_memory = ctx.Attr<bool>("save_to_memory");
     auto output = ctx.Output<std::string>("Y");
 
+    // a pending asynchronous write creates the file, check after it
+    if (FLAGS_async_save_combine && !overwrite && !save_to_memory) {
+      framework::AsyncCheckpointer::Instance().Wait(filename);
+    }
     bool is_present = FileExists(filename);
     if (is_present && !overwrite) {
       PADDLE_THROW(platform::errors::PreconditionNotMet(
@@ -62,6 +71,12 @@ class SaveCombineOpKernel : public framework::OpKernel<T> {
     platform::DeviceContextPool &pool = platform::DeviceContextPool::Instance();
     auto &dev_ctx = *pool.Get(place);
 
+    // the tensors to write in the background, converted ones are kept alive
+    // until they are copied
+    bool async_save = FLAGS_async_save_combine && !save_to_memory;
+    std::vector<const framework::LoDTensor *> async_tensors;
+    std::deque<framework::LoDTensor> converted_tensors;
+
     for (size_t i = 0; i < inp_var_names.size(); i++) {
       PADDLE_ENFORCE_NOT_NULL(
           inp_vars[i],
@@ -88,15 +103,30 @@ class SaveCombineOpKernel : public framework::OpKernel<T> {
       if (in_dtype != out_dtype) {
         auto in_kernel_type = framework::OpKernelType(in_dtype, place);
         auto out_kernel_type = framework::OpKernelType(out_dtype, place);
-        framework::LoDTensor out;
+        converted_tensors.emplace_back();
+        framework::LoDTensor &out = converted_tensors.back();
         // copy LoD info to the new tensor
         out.set_lod(tensor.lod());
         framework::TransDataType(in_kernel_type, out_kernel_type, tensor, &out);
-        framework::SerializeToStream(ss, out, dev_ctx);
+        if (async_save) {
+          async_tensors.push_back(&out);
+        } else {
+          framework::SerializeToStream(ss, out, dev_ctx);
+          converted_tensors.clear();
+        }
       } else {
-        framework::SerializeToStream(ss, tensor, dev_ctx);
+        if (async_save) {
+          async_tensors.push_back(&tensor);
+        } else {
+          framework::SerializeToStream(ss, tensor, dev_ctx);
+        }
       }
     }
+    if (async_save) {
+      framework::AsyncCheckpointer::Instance().SaveCombine(
+          filename, inp_var_names, async_tensors, dev_ctx);
+      return;
+    }
     if (save_to_memory) {
       PADDLE_ENFORCE_NE(output, nullptr,
                         platform::errors::InvalidArgument(
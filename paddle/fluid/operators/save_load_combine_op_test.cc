@@ -12,13 +12,17 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <cstdio>
 #include <iostream>
 #include <string>
 #include <vector>
 #include "gtest/gtest.h"
+#include "paddle/fluid/framework/async_checkpointer.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/platform/float16.h"
 
+DECLARE_bool(async_save_combine);
+
 USE_CPU_ONLY_OP(save_combine);
 USE_CPU_ONLY_OP(load_combine);
 
@@ -344,3 +348,29 @@ TEST(SaveLoadTestWithCombineOp, CPU) {
     }
   }
 }
+
+// A pending asynchronous write counts as an existing file for a save that
+// must not overwrite it.
+TEST(SaveCombineOp, AsyncNoOverwrite) {
+  paddle::framework::Scope scope;
+  paddle::platform::CPUPlace place;
+  paddle::framework::LoD expect_lod;
+  CreateForSaveCombineOp<int, int>(10, 10, {0, 10}, "test_var", place, &scope,
+                                   &expect_lod);
+  std::string filename = "check_async_no_overwrite.ls";
+  std::remove(filename.c_str());
+
+  FLAGS_async_save_combine = true;
+  paddle::framework::AttributeMap attrs;
+  attrs.insert({"file_path", filename});
+  auto save_op = paddle::framework::OpRegistry::CreateOp(
+      "save_combine", {{"X", {"test_var"}}}, {}, attrs);
+  save_op->Run(scope, place);
+
+  attrs["overwrite"] = false;
+  auto no_overwrite_op = paddle::framework::OpRegistry::CreateOp(
+      "save_combine", {{"X", {"test_var"}}}, {}, attrs);
+  EXPECT_ANY_THROW(no_overwrite_op->Run(scope, place));
+  FLAGS_async_save_combine = false;
+  paddle::framework::AsyncCheckpointer::Instance().Wait();
+}
@@ -13,13 +13,16 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #pragma once
+#include <algorithm>
 #include <cstring>
+#include <functional>
 #include <string>
 
 #include "paddle/fluid/framework/ddim.h"
 #include "paddle/fluid/framework/eigen.h"
 #include "paddle/fluid/framework/tensor.h"
 #include "paddle/fluid/operators/math/blas.h"
+#include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/place.h"
 #include "unordered_set"
 
@@ -63,6 +66,28 @@ elementwise_inner_add(const framework::ExecutionContext& ctx,
 
   eigen_dist += eigen_src;
 }
+
+/**
+ * Run func(col_begin, col_end) over the columns [0, slice_size) of the slices
+ * in parallel. The columns are split in blocks of whole cache lines, and each
+ * thread gets enough blocks to copy at least kParallelForMinWorkPerThread
+ * elements of all index_size slices, so that threads never interleave the
+ * columns of a row at a finer granularity than a cache line.
+ */
+template <typename T>
+void ParallelForSliceColumns(
+    int64_t slice_size, int64_t index_size,
+    const std::function<void(int64_t, int64_t)>& func) {
+  const int64_t block = std::max<int64_t>(
+      platform::kCacheLineSize / static_cast<int64_t>(sizeof(T)), 1);
+  const int64_t num_blocks = (slice_size + block - 1) / block;
+  platform::ParallelFor(
+      0, num_blocks, platform::GetParallelForGrainSize(index_size * block),
+      [&](int64_t begin, int64_t end) {
+        func(begin * block, std::min(end * block, slice_size));
+      });
+}
+
 /**
  * Return an updated tensor from source tensor, scattered according to index:
  * dst[i] = src[index[i]]
@@ -110,12 +135,18 @@ void ScatterAssign(const platform::DeviceContext& ctx, const Tensor& src,
   size_t slice_size = 1;
   for (int i = 1; i < src_dims.size(); ++i) slice_size *= src_dims[i];
 
-  const size_t slice_bytes = slice_size * sizeof(T);
-
-  for (int i = 0; i < index_size; ++i) {
-    IndexT index_ = p_index[i];
-    memcpy(p_output + index_ * slice_size, p_src + i * slice_size, slice_bytes);
-  }
+  // Duplicated indices make the result depend on the order of the copies
+  // (the last one wins), so the work is split along the columns of the
+  // slices and every thread still walks the indices in order.
+  ParallelForSliceColumns<T>(
+      slice_size, index_size, [&](int64_t begin, int64_t end) {
+        const size_t bytes = (end - begin) * sizeof(T);
+        for (int i = 0; i < index_size; ++i) {
+          IndexT index_ = p_index[i];
+          memcpy(p_output + index_ * slice_size + begin,
+                 p_src + i * slice_size + begin, bytes);
+        }
+      });
 }
 
 template <typename T, typename IndexT = int>
@@ -182,11 +213,16 @@ void CPUScatterGradForX(const platform::DeviceContext& ctx, const Tensor& index,
   T* p_output = output->data<T>();
   size_t slice_size = 1;
   for (int i = 1; i < dst_dims.size(); ++i) slice_size *= dst_dims[i];
-  const size_t slice_bytes = slice_size * sizeof(T);
-  for (int i = 0; i < index_size; ++i) {
-    const IndexT& index_ = p_index[i];
-    memset(p_output + slice_size * index_, 0, slice_bytes);
-  }
+  // Split along the columns so that duplicated indices never make two
+  // threads write the same row.
+  ParallelForSliceColumns<T>(
+      slice_size, index_size, [&](int64_t begin, int64_t end) {
+        const size_t bytes = (end - begin) * sizeof(T);
+        for (int i = 0; i < index_size; ++i) {
+          const IndexT& index_ = p_index[i];
+          memset(p_output + slice_size * index_ + begin, 0, bytes);
+        }
+      });
 }
 
 template <typename T, typename IndexT = int>
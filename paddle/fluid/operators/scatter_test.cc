@@ -55,3 +55,46 @@ TEST(scatter, ScatterUpdate) {
   for (size_t i = 8; i < 16; ++i) EXPECT_EQ(p_output[i], 0.0f);
   for (size_t i = 8; i < 16; ++i) EXPECT_EQ(output.data<float>()[i], 0.0f);
 }
+
+TEST(scatter, ScatterUpdateParallelDuplicatedIndex) {
+  // Wide slices whose width is not a multiple of a cache line, so that they
+  // are split among threads with a partial block at the end, and duplicated
+  // indices of which the last one must win.
+  const int64_t index_size = 64;
+  const int64_t slice_size = 100003;
+  paddle::framework::Tensor src;
+  paddle::framework::Tensor index;
+  paddle::framework::Tensor output;
+  auto* p_src = src.mutable_data<float>(
+      paddle::framework::make_ddim({index_size, slice_size}),
+      paddle::platform::CPUPlace());
+  auto* p_index = index.mutable_data<int>(
+      paddle::framework::make_ddim({index_size}), paddle::platform::CPUPlace());
+  for (int64_t i = 0; i < src.numel(); ++i) {
+    p_src[i] = static_cast<float>(i);
+  }
+  for (int64_t i = 0; i < index_size; ++i) {
+    p_index[i] = static_cast<int>(i % 4);
+  }
+  auto* p_output = output.mutable_data<float>(
+      paddle::framework::make_ddim({5, slice_size}),
+      paddle::platform::CPUPlace());
+  for (int64_t i = 0; i < output.numel(); ++i) {
+    p_output[i] = -1;
+  }
+
+  paddle::platform::SetIntraOpNumThreads(4);
+  paddle::platform::CPUDeviceContext ctx(paddle::platform::CPUPlace{});
+  paddle::operators::ScatterAssign<float>(ctx, src, index, &output);
+  paddle::platform::SetIntraOpNumThreads(1);
+
+  for (int64_t r = 0; r < 4; ++r) {
+    int64_t last = index_size - 4 + r;
+    for (int64_t k = 0; k < slice_size; ++k) {
+      ASSERT_EQ(p_output[r * slice_size + k], p_src[last * slice_size + k]);
+    }
+  }
+  for (int64_t k = 0; k < slice_size; ++k) {
+    ASSERT_EQ(p_output[4 * slice_size + k], -1.0f);
+  }
+}
@@ -18,6 +18,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/memory/memcpy.h"
 #include "paddle/fluid/operators/math/math_function.h"
+#include "paddle/fluid/platform/cpu_helper.h"
 
 namespace paddle {
 namespace operators {
@@ -52,31 +53,41 @@ struct SequenceExpandFunctor<platform::CPUDeviceContext, T> {
       const framework::Vector<size_t>& x_lod,   /*expand source lod*/
       const framework::Vector<size_t>& ref_lod, /*expand referenced lod*/
       LoDTensor* out) {
-    int out_offset = 0;
     int x_item_length = x.numel() / x.dims()[0];
     auto out_data = out->data<T>();
     auto x_data = x.data<T>();
-    for (size_t i = 1; i < ref_lod.size(); ++i) {
-      int repeat_num = ref_lod[i] - ref_lod[i - 1];
-      int x_start = x_lod[i - 1];
-      int x_end = x_lod[i];
-      int x_seq_len = x_end - x_start;
-      if (repeat_num > 0) {
-        int out_start = out_offset;
-        if (out->lod().size() == 1) {
-          out_start = out->lod()[0][out_offset];
-        }
-        for (int j = 0; j < repeat_num; j++) {
-          for (int k = 0; k < x_seq_len; k++) {
-            for (int l = 0; l < x_item_length; l++) {
-              out_data[(out_start + j * x_seq_len + k) * x_item_length + l] =
-                  x_data[(x_start + k) * x_item_length + l];
+    const size_t* out_lod =
+        out->lod().size() == 1 ? out->lod()[0].data() : nullptr;
+    const size_t* x_lod_data = x_lod.data();
+    const size_t* ref_lod_data = ref_lod.data();
+    int64_t num_seq = static_cast<int64_t>(ref_lod.size()) - 1;
+    int64_t cost_per_seq =
+        num_seq > 0 ? out->numel() / num_seq + 1 : out->numel();
+    platform::ParallelFor(
+        0, num_seq, platform::GetParallelForGrainSize(cost_per_seq),
+        [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin + 1; i <= end; ++i) {
+            int repeat_num = ref_lod_data[i] - ref_lod_data[i - 1];
+            int x_start = x_lod_data[i - 1];
+            int x_end = x_lod_data[i];
+            int x_seq_len = x_end - x_start;
+            if (repeat_num > 0) {
+              int out_offset = ref_lod_data[i - 1] - ref_lod_data[0];
+              int out_start = out_offset;
+              if (out_lod != nullptr) {
+                out_start = out_lod[out_offset];
+              }
+              for (int j = 0; j < repeat_num; j++) {
+                for (int k = 0; k < x_seq_len; k++) {
+                  for (int l = 0; l < x_item_length; l++) {
+                    out_data[(out_start + j * x_seq_len + k) * x_item_length +
+                             l] = x_data[(x_start + k) * x_item_length + l];
+                  }
+                }
+              }
             }
           }
-        }
-      }
-      out_offset += repeat_num;
-    }
+        });
   }
 };
 
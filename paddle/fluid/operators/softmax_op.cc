@@ -88,6 +88,13 @@ class SoftmaxOp : public framework::OperatorWithKernel {
     return framework::OpKernelType(input_data_type, ctx.GetPlace(), layout_,
                                    library_);
   }
+
+  bool GetOpCost(const framework::ExecutionContext& ctx,
+                 framework::OpCost* cost) const override {
+    // max, subtract, exp, sum and divide of every element
+    cost->flops = 5.0 * ctx.Input<framework::Tensor>("X")->numel();
+    return true;
+  }
 };
 
 class SoftmaxOpMaker : public framework::OpProtoAndCheckerMaker {
@@ -14,6 +14,14 @@ limitations under the License. */
 
 #include "paddle/fluid/platform/cpu_helper.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+#include "gflags/gflags.h"
+#include "paddle/fluid/platform/enforce.h"
+
 #ifdef PADDLE_WITH_MKLML
 #include <omp.h>
 
@@ -24,10 +32,109 @@ limitations under the License. */
 #include <cblas.h>
 #endif
 
+DECLARE_int32(intra_op_parallelism_budget);
+
 namespace paddle {
 namespace platform {
 
+namespace {
+
+thread_local int intra_op_num_threads = 1;
+
+#ifdef PADDLE_WITH_MKLML
+// Set while the current thread runs a chunk of ParallelFor, so that nested
+// calls execute serially instead of spawning threads recursively.
+thread_local bool in_parallel_for = false;
+// Number of helper threads currently lent out by ParallelFor.
+std::atomic<int> busy_helper_threads{0};
+
+int IntraOpParallelismBudget() {
+  if (FLAGS_intra_op_parallelism_budget > 0) {
+    return FLAGS_intra_op_parallelism_budget;
+  }
+  int hw = static_cast<int>(std::thread::hardware_concurrency());
+  return hw > 0 ? hw : 1;
+}
+
+// Reserve up to `wanted` helper threads from the process wide budget and
+// return how many were granted.
+int AcquireHelperThreads(int wanted) {
+  int budget = IntraOpParallelismBudget();
+  int busy = busy_helper_threads.load(std::memory_order_relaxed);
+  while (true) {
+    // The calling thread itself is always counted as one busy thread.
+    int granted = std::min(wanted, budget - 1 - busy);
+    if (granted <= 0) return 0;
+    if (busy_helper_threads.compare_exchange_weak(busy, busy + granted)) {
+      return granted;
+    }
+  }
+}
+
+void ReleaseHelperThreads(int num) {
+  if (num > 0) busy_helper_threads.fetch_sub(num);
+}
+#endif
+
+}  // namespace
+
+void SetIntraOpNumThreads(int num_threads) {
+  intra_op_num_threads = num_threads > 1 ? num_threads : 1;
+}
+
+int GetIntraOpNumThreads() { return intra_op_num_threads; }
+
+void ParallelFor(int64_t begin, int64_t end, int64_t grain_size,
+                 const std::function<void(int64_t, int64_t)>& func) {
+  if (begin >= end) return;
+  if (grain_size < 1) grain_size = 1;
+  int64_t range = end - begin;
+  int64_t max_chunks = (range + grain_size - 1) / grain_size;
+  int num_threads =
+      static_cast<int>(std::min<int64_t>(intra_op_num_threads, max_chunks));
+#ifdef PADDLE_WITH_MKLML
+  if (num_threads > 1 && !in_parallel_for && !omp_in_parallel()) {
+    num_threads = 1 + AcquireHelperThreads(num_threads - 1);
+  } else {
+    num_threads = 1;
+  }
+#else
+  num_threads = 1;
+#endif
+  if (num_threads == 1) {
+    func(begin, end);
+    return;
+  }
+
+#ifdef PADDLE_WITH_MKLML
+  std::exception_ptr eptr = nullptr;
+  std::atomic_flag has_error = ATOMIC_FLAG_INIT;
+#pragma omp parallel num_threads(num_threads)
+  {
+    // The runtime may grant fewer threads than requested, so the chunks are
+    // computed from the actual team size.
+    int team_size = omp_get_num_threads();
+    int64_t chunk = (range + team_size - 1) / team_size;
+    int64_t chunk_begin = begin + omp_get_thread_num() * chunk;
+    int64_t chunk_end = std::min(end, chunk_begin + chunk);
+    if (chunk_begin < chunk_end) {
+      bool prev = in_parallel_for;
+      in_parallel_for = true;
+      try {
+        func(chunk_begin, chunk_end);
+      } catch (...) {
+        if (!has_error.test_and_set()) eptr = std::current_exception();
+      }
+      in_parallel_for = prev;
+    }
+  }
+  ReleaseHelperThreads(num_threads - 1);
+  if (eptr) std::rethrow_exception(eptr);
+#endif
+}
+
 void SetNumThreads(int num_threads) {
+  SetIntraOpNumThreads(num_threads);
 #ifdef PADDLE_USE_OPENBLAS
 // windows has no support for openblas multi-thread
 // please refer to: https://github.com/PaddlePaddle/Paddle/issues/7234
@@ -15,6 +15,9 @@ limitations under the License. */
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
 
 namespace paddle {
 namespace platform {
@@ -22,5 +25,41 @@ namespace platform {
 //! Set the number of threads in use.
 void SetNumThreads(int num_threads);
 
+//! The size of a cache line in bytes, by which the chunks of ParallelFor that
+//! write adjacent memory are aligned to avoid false sharing.
+constexpr int64_t kCacheLineSize = 64;
+
+//! The minimal amount of work (roughly, element operations) a thread should
+//! get in ParallelFor, below which spawning it costs more than it saves.
+constexpr int64_t kParallelForMinWorkPerThread = 32768;
+
+//! Set/get the number of threads the calling thread may use to run a single
+//! operator kernel. It is thread local so that every predictor or trainer
+//! thread keeps its own setting, and defaults to 1 (no intra-op threading).
+//! SetNumThreads updates it as well.
+void SetIntraOpNumThreads(int num_threads);
+int GetIntraOpNumThreads();
+
+//! Returns the grain size for ParallelFor given the approximate cost of one
+//! iteration, so that each thread gets at least kParallelForMinWorkPerThread.
+inline int64_t GetParallelForGrainSize(int64_t cost_per_item) {
+  if (cost_per_item <= 0) cost_per_item = 1;
+  int64_t grain = kParallelForMinWorkPerThread / cost_per_item;
+  return grain > 0 ? grain : 1;
+}
+
+//! Run func(chunk_begin, chunk_end) over contiguous chunks of [begin, end)
+//! with at most GetIntraOpNumThreads() threads, each chunk holding at least
+//! grain_size iterations. The chunks never overlap, so func only has to be
+//! safe for disjoint ranges.
+//!
+//! The call degrades to a single serial func(begin, end) when the range is
+//! too small, when it is nested inside another parallel region, or when the
+//! process wide thread budget (FLAGS_intra_op_parallelism_budget) is used up
+//! by other callers, so concurrent predictors never oversubscribe the cores.
+//! An exception thrown by func is rethrown on the calling thread.
+void ParallelFor(int64_t begin, int64_t end, int64_t grain_size,
+                 const std::function<void(int64_t, int64_t)>& func);
+
 }  // namespace platform
 }  // namespace paddle
@@ -14,9 +14,48 @@ limitations under the License. */
 
 #include "paddle/fluid/platform/cpu_helper.h"
 
+#include <stdexcept>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 TEST(CpuHelper, SetNumThread) {
   paddle::platform::SetNumThreads(1);
   paddle::platform::SetNumThreads(4);
 }
+
+TEST(CpuHelper, ParallelFor) {
+  paddle::platform::SetIntraOpNumThreads(4);
+  EXPECT_EQ(paddle::platform::GetIntraOpNumThreads(), 4);
+
+  const int64_t n = 100003;
+  std::vector<int> visited(n, 0);
+  paddle::platform::ParallelFor(0, n, 1000, [&](int64_t begin, int64_t end) {
+    EXPECT_LT(begin, end);
+    for (int64_t i = begin; i < end; ++i) {
+      ++visited[i];
+    }
+    // Nested calls must run serially and still cover their whole range.
+    int64_t nested = 0;
+    paddle::platform::ParallelFor(0, 10, 1, [&](int64_t b, int64_t e) {
+      nested += e - b;
+    });
+    EXPECT_EQ(nested, 10);
+  });
+  for (int64_t i = 0; i < n; ++i) {
+    ASSERT_EQ(visited[i], 1) << "index " << i;
+  }
+
+  // Empty ranges never invoke the function.
+  paddle::platform::ParallelFor(5, 5, 1, [](int64_t, int64_t) { FAIL(); });
+
+  // Exceptions thrown in a chunk reach the caller.
+  EXPECT_THROW(paddle::platform::ParallelFor(
+                   0, n, 1,
+                   [](int64_t begin, int64_t end) {
+                     throw std::runtime_error("error in ParallelFor");
+                   }),
+               std::runtime_error);
+
+  paddle::platform::SetIntraOpNumThreads(1);
+}
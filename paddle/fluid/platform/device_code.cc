@@ -12,9 +12,17 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <dlfcn.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
 #include <set>
+#include <sstream>
 #include <utility>
 
 #include "paddle/fluid/platform/device_code.h"
@@ -22,15 +30,40 @@ limitations under the License. */
 
 DECLARE_string(cuda_dir);
 
+DEFINE_string(cpu_jit_compiler, "c++",
+              "The host C++ compiler used for JIT compiling of CPU code, "
+              "such as the kernels generated by fusion_group_pass.");
+DEFINE_string(cpu_jit_cache_dir, "",
+              "The directory to cache the shared libraries compiled from "
+              "the JIT generated CPU code. Processes sharing the directory "
+              "reuse the libraries of the same source code. It defaults to "
+              "$HOME/.cache/paddle/cpu_jit, and must be owned by the current "
+              "user and not writable by others, because the libraries in it "
+              "are loaded into the process.");
+
 namespace paddle {
 namespace platform {
 
 DeviceCodePool* DeviceCodePool::pool = nullptr;
 
+DeviceCodePool& DeviceCodePool::Init(
+    const std::vector<platform::Place>& places) {
+  static std::mutex init_mutex;
+  std::lock_guard<std::mutex> guard(init_mutex);
+  if (pool == nullptr) {
+    pool = new DeviceCodePool(places);
+  } else {
+    std::lock_guard<std::mutex> pool_guard(pool->mtx_);
+    pool->AddPlaces(places);
+  }
+  return *pool;
+}
+
 void DeviceCodePool::Set(std::unique_ptr<DeviceCode>&& code) {
   Place place = code->GetPlace();
   std::string name = code->GetName();
 
+  std::lock_guard<std::mutex> guard(mtx_);
   auto iter = device_codes_.find(place);
   if (iter == device_codes_.end()) {
     PADDLE_THROW(platform::errors::NotFound(
@@ -43,6 +76,7 @@ void DeviceCodePool::Set(std::unique_ptr<DeviceCode>&& code) {
 
 platform::DeviceCode* DeviceCodePool::Get(const platform::Place& place,
                                           const std::string& name) {
+  std::lock_guard<std::mutex> guard(mtx_);
   auto iter = device_codes_.find(place);
   if (iter == device_codes_.end()) {
     PADDLE_THROW(platform::errors::NotFound(
@@ -60,17 +94,46 @@ platform::DeviceCode* DeviceCodePool::Get(const platform::Place& place,
   return code_iter->second.get();
 }
 
+bool DeviceCodePool::Has(const platform::Place& place,
+                         const std::string& name) const {
+  std::lock_guard<std::mutex> guard(mtx_);
+  auto iter = device_codes_.find(place);
+  return iter != device_codes_.end() &&
+         iter->second.find(name) != iter->second.end();
+}
+
+size_t DeviceCodePool::size(const platform::Place& place) const {
+  std::lock_guard<std::mutex> guard(mtx_);
+  auto iter = device_codes_.find(place);
+  if (iter == device_codes_.end()) {
+    return 0;
+  }
+  return iter->second.size();
+}
+
 DeviceCodePool::DeviceCodePool(const std::vector<platform::Place>& places) {
   PADDLE_ENFORCE_GT(places.size(), 0,
                     errors::InvalidArgument(
                         "Expected the number of places >= 1. But received %d.",
                         places.size()));
+  AddPlaces(places);
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  CUDADeviceCode::CheckAvailableStatus();
+#endif
+  CPUDeviceCode::CheckAvailableStatus();
+}
+
+void DeviceCodePool::AddPlaces(const std::vector<platform::Place>& places) {
   // Remove the duplicated places
   std::set<Place> set;
   for (auto& p : places) {
     set.insert(p);
   }
   for (auto& p : set) {
+    if (device_codes_.find(p) != device_codes_.end()) {
+      continue;
+    }
     if (is_gpu_place(p)) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
       device_codes_.emplace(p, DeviceCodeMap());
@@ -79,12 +142,188 @@ DeviceCodePool::DeviceCodePool(const std::vector<platform::Place>& places) {
           "CUDAPlace or HIPPlace is not supported, please re-compile with "
           "WITH_GPU=ON or WITH_ROCM=ON."));
 #endif
+    } else if (is_cpu_place(p)) {
+      device_codes_.emplace(p, DeviceCodeMap());
     }
   }
+}
+
+bool CPUDeviceCode::available_ = false;
+void CPUDeviceCode::CheckAvailableStatus() {
+  std::string cmd = FLAGS_cpu_jit_compiler + " --version > /dev/null 2>&1";
+  available_ = std::system(cmd.c_str()) == 0;
+  if (!available_) {
+    LOG_FIRST_N(WARNING, 1) << "Cannot find the host compiler "
+                            << FLAGS_cpu_jit_compiler
+                            << ", which is needed for JIT compiling of CPU "
+                               "code. Please specify it by export "
+                               "FLAGS_cpu_jit_compiler=xxx.";
+  }
+}
 
-#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-  CUDADeviceCode::CheckAvailableStatus();
-#endif
+// Shared libraries loaded in this process, keyed on the library path. They
+// are never closed because the kernel functions may be used until exit.
+static std::mutex cpu_lib_mutex;
+static std::unordered_map<std::string, void*> cpu_lib_handles;
+
+CPUDeviceCode::CPUDeviceCode(const Place& place, const std::string& name,
+                             const std::string& kernel) {
+  if (!is_cpu_place(place)) {
+    PADDLE_THROW(platform::errors::PermissionDenied(
+        "CPUDeviceCode can only launch on CPU place."));
+  }
+
+  place_ = place;
+  name_ = name;
+  kernel_ = kernel;
+}
+
+static std::string GetCPUJitCacheDir() {
+  if (!FLAGS_cpu_jit_cache_dir.empty()) {
+    return FLAGS_cpu_jit_cache_dir;
+  }
+  const char* home = std::getenv("HOME");
+  if (home != nullptr && home[0] != '\0') {
+    return std::string(home) + "/.cache/paddle/cpu_jit";
+  }
+  return "/tmp/paddle_cpu_jit_cache_" + std::to_string(geteuid());
+}
+
+// Only files owned by the current user and not writable by anyone else are
+// trusted, since the libraries are loaded into the process.
+static bool IsPrivate(const struct stat& st) {
+  return st.st_uid == geteuid() && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+// Creates the missing directories of dir with mode 0700, and checks that dir
+// is a private directory of the current user.
+static bool PrepareCPUJitCacheDir(const std::string& dir) {
+  for (size_t pos = dir.find('/', 1); pos != std::string::npos;
+       pos = dir.find('/', pos + 1)) {
+    std::string parent = dir.substr(0, pos);
+    if (mkdir(parent.c_str(), 0700) != 0 && errno != EEXIST) {
+      break;
+    }
+  }
+  if (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) {
+    LOG(WARNING) << "Cannot create the cache directory " << dir
+                 << " for JIT compiling of CPU code.";
+    return false;
+  }
+  struct stat st;
+  if (lstat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) ||
+      !IsPrivate(st)) {
+    LOG(WARNING) << "The cache directory " << dir
+                 << " for JIT compiling of CPU code must be a directory "
+                    "owned by the current user and not writable by others. "
+                    "Please fix its permission or specify another one by "
+                    "export FLAGS_cpu_jit_cache_dir=xxx.";
+    return false;
+  }
+  return true;
+}
+
+std::string CPUDeviceCode::GetLibraryPath() const {
+  std::string signature = FLAGS_cpu_jit_compiler + "\n" + kernel_;
+  std::ostringstream path;
+  path << GetCPUJitCacheDir() << "/" << name_ << "_" << std::hex
+       << std::hash<std::string>()(signature) << ".so";
+  return path.str();
+}
+
+bool CPUDeviceCode::Compile(bool include_path) {
+  is_compiled_ = false;
+  if (!available_) {
+    LOG_FIRST_N(WARNING, 1)
+        << "A host compiler is needed for JIT compiling of CPU code.";
+    return false;
+  }
+
+  std::string lib_path = GetLibraryPath();
+  std::lock_guard<std::mutex> guard(cpu_lib_mutex);
+  void* handle = nullptr;
+  auto iter = cpu_lib_handles.find(lib_path);
+  if (iter != cpu_lib_handles.end()) {
+    handle = iter->second;
+  } else {
+    if (!PrepareCPUJitCacheDir(GetCPUJitCacheDir())) {
+      return false;
+    }
+    // A cached library is reused only if it is a regular file of the current
+    // user in the private cache directory, otherwise it is compiled again.
+    struct stat st;
+    if (lstat(lib_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode) ||
+        !IsPrivate(st)) {
+      // Compile to a temporary file and rename it, so that the processes
+      // sharing the same cache directory never see a partial library.
+      std::string tmp_suffix = "." + std::to_string(getpid());
+      std::string src_path = lib_path + tmp_suffix + ".cc";
+      std::string tmp_lib_path = lib_path + tmp_suffix;
+      {
+        std::ofstream src(src_path);
+        src << kernel_;
+        if (!src.good()) {
+          LOG(WARNING) << "Cannot write the source code to " << src_path;
+          return false;
+        }
+      }
+      std::string cmd = FLAGS_cpu_jit_compiler +
+                        " -std=c++11 -O3 -march=native -fPIC -shared -o '" +
+                        tmp_lib_path + "' '" + src_path + "' 2>&1";
+      std::string log;
+      FILE* pipe = popen(cmd.c_str(), "r");
+      if (pipe != nullptr) {
+        char buffer[256];
+        while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+          log += buffer;
+        }
+      }
+      bool is_succeed = pipe != nullptr && pclose(pipe) == 0;
+      std::remove(src_path.c_str());
+      if (!is_succeed ||
+          std::rename(tmp_lib_path.c_str(), lib_path.c_str()) != 0) {
+        std::remove(tmp_lib_path.c_str());
+        LOG(WARNING) << "JIT compiling of CPU code failed:"
+                     << "\n  Kernel name: " << name_ << "\n  Kernel body:\n"
+                     << kernel_ << "\n  Compiling log: " << log;
+        return false;
+      }
+    }
+
+    handle = dlopen(lib_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr) {
+      LOG(WARNING) << "Fail to load " << lib_path << ": " << dlerror();
+      return false;
+    }
+    cpu_lib_handles.emplace(lib_path, handle);
+  }
+
+  function_ = reinterpret_cast<KernelFunc>(dlsym(handle, name_.c_str()));
+  if (function_ == nullptr) {
+    LOG(WARNING) << "Cannot find the kernel " << name_ << " in " << lib_path;
+    return false;
+  }
+  is_compiled_ = true;
+  return true;
+}
+
+void CPUDeviceCode::Launch(const size_t n, std::vector<void*>* args) const {
+  PADDLE_ENFORCE_EQ(
+      is_compiled_, true,
+      errors::PreconditionNotMet(
+          "Please compile the code before launching the kernel."));
+  PADDLE_ENFORCE_GE(
+      args->size(), 1UL,
+      errors::InvalidArgument("Expected the number of arguments >= 1, the "
+                              "first of which is the number of elements."));
+
+  // Keep the same arguments as CUDADeviceCode: args[0] points to the number
+  // of elements and args[i] points to the i-th data pointer.
+  std::vector<void*> ptrs(args->size() - 1);
+  for (size_t i = 1; i < args->size(); ++i) {
+    ptrs[i - 1] = *reinterpret_cast<void**>((*args)[i]);
+  }
+  function_(static_cast<int64_t>(n), ptrs.data());
 }
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -88,6 +89,34 @@ class CUDADeviceCode : public DeviceCode {
 };
 #endif
 
+// DeviceCode for CPU, the kernel is written in C++ and compiled to a shared
+// library by the host compiler specified by FLAGS_cpu_jit_compiler. The
+// compiled libraries are cached on disk and in the process, keyed on the
+// hash of the source code, so that identical kernels are compiled only once.
+class CPUDeviceCode : public DeviceCode {
+ public:
+  // The signature of the kernel function is
+  //   extern "C" void name(int64_t n, void** args);
+  // where args holds the data pointers of all inputs and outputs.
+  using KernelFunc = void (*)(int64_t, void**);
+
+  explicit CPUDeviceCode(const Place& place, const std::string& name,
+                         const std::string& kernel);
+  bool Compile(bool include_path = false) override;
+  void Launch(const size_t n, std::vector<void*>* args) const override;
+
+  static void CheckAvailableStatus();
+  static bool IsAvailable() { return available_; }
+
+ private:
+  std::string GetLibraryPath() const;
+
+  static bool available_;
+
+  bool is_compiled_{false};
+  KernelFunc function_{nullptr};
+};
+
 class DeviceCodePool {
  public:
   using DeviceCodeMap =
@@ -103,28 +132,25 @@ class DeviceCodePool {
     return *pool;
   }
 
-  static DeviceCodePool& Init(const std::vector<platform::Place>& places) {
-    if (pool == nullptr) {
-      pool = new DeviceCodePool(places);
-    }
-    return *pool;
-  }
+  static DeviceCodePool& Init(const std::vector<platform::Place>& places);
 
+  // Set, Get, Has and size may be called from several predictors or
+  // executors at the same time. The codes are never removed, so the pointer
+  // returned by Get stays valid after the lock is released.
   void Set(std::unique_ptr<DeviceCode>&& code);
 
+  bool Has(const platform::Place& place, const std::string& name) const;
+
   platform::DeviceCode* Get(const platform::Place& place,
                             const std::string& name);
 
-  size_t size(const platform::Place& place) const {
-    auto iter = device_codes_.find(place);
-    if (iter == device_codes_.end()) {
-      return 0;
-    }
-    return iter->second.size();
-  }
+  size_t size(const platform::Place& place) const;
 
  private:
+  void AddPlaces(const std::vector<platform::Place>& places);
+
   static DeviceCodePool* pool;
+  mutable std::mutex mtx_;
   std::map<Place, DeviceCodeMap> device_codes_;
   DISABLE_COPY_AND_ASSIGN(DeviceCodePool);
 };
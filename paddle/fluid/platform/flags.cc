@@ -543,6 +543,178 @@ DEFINE_int32(
     "less FLAGS_max_inplace_grad_add, than it will be use several grad_add"
     "instead of sum. Default is 0.");
 
+/**
+ * Performance related FLAG
+ * Name: intra_op_parallelism_budget
+ * Since Version: 2.1.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_intra_op_parallelism_budget=16
+ * Note: The maximal number of threads that all platform::ParallelFor calls of
+ * the process may use at the same time. 0 means the number of hardware
+ * threads. Calls that find the budget used up by other predictors or trainer
+ * threads run serially instead of oversubscribing the cores.
+ */
+DEFINE_int32(intra_op_parallelism_budget, 0,
+             "The maximal number of threads that all ParallelFor calls of "
+             "the process may use at the same time. 0 means the number of "
+             "hardware threads.");
+
+/**
+ * Performance related FLAG
+ * Name: cache_runtime_context
+ * Since Version: 2.1.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_cache_runtime_context=true
+ * Note: If True, Executor, NaiveExecutor and HogwildWorker resolve the
+ * variables of every operator and of eager deletion once per scope instead
+ * of looking them up by name on every run. Helps programs of many small
+ * operators run repeatedly in the same scope. Creating, erasing or renaming
+ * a variable in the scope or one of its ancestors makes the operators
+ * resolve their variables again, so programs that create variables in that
+ * scope on every run gain nothing.
+ */
+DEFINE_bool(cache_runtime_context, false,
+            "Resolve the variables of operators once per scope.");
+
+/**
+ * Performance related FLAG
+ * Name: use_work_stealing_executor
+ * Since Version: 2.1.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_use_work_stealing_executor=true
+ * Note: If True, FastThreadedSSAGraphExecutor schedules the ready operators
+ * on per-thread queues with work stealing instead of one shared queue. Helps
+ * graphs of many small operators run with multiple CPU threads.
+ */
+DEFINE_bool(use_work_stealing_executor, false,
+            "Schedule the operators of FastThreadedSSAGraphExecutor with "
+            "work stealing.");
+
+/**
+ * Performance related FLAG
+ * Name: use_critical_path_priority
+ * Since Version: 2.1.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_use_critical_path_priority=true
+ * Note: If True, ThreadedSSAGraphExecutor and FastThreadedSSAGraphExecutor
+ * run the ready operators with the longest path to the end of the graph
+ * first. The operators are timed while running to estimate the paths. Helps
+ * graphs whose branches take very different time.
+ */
+DEFINE_bool(use_critical_path_priority, false,
+            "Run the ready operators on the critical path of the graph "
+            "first.");
+
+/**
+ * Performance related FLAG
+ * Name: async_save_combine
+ * Since Version: 2.1.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_async_save_combine=true
+ * Note: If True, save_combine only copies the variables to host memory and
+ * writes the file in a background thread, so training continues during the
+ * write. The file is renamed into place when complete and a manifest
+ * "<file>.manifest" is published after it. load_combine and later saves of
+ * the same file wait for the write. Call
+ * paddle.fluid.core._wait_async_save() to wait for all pending writes, which
+ * Executor.close() and the exit of the interpreter also do. The error of a
+ * failed write is raised by the next save of any file or the next wait.
+ */
+DEFINE_bool(async_save_combine, false,
+            "Write the files of save_combine in a background thread.");
+
+/**
+ * Performance related FLAG
+ * Name: async_save_fsync
+ * Since Version: 2.1.0
+ * Value Range: bool, default=true
+ * Example: FLAGS_async_save_fsync=false
+ * Note: If True, the files written asynchronously by save_combine are
+ * synced to disk before being renamed into place.
+ */
+DEFINE_bool(async_save_fsync, true,
+            "Sync the files written asynchronously by save_combine to disk.");
+
+/**
+ * Performance related FLAG
+ * Name: mmap_combined_params
+ * Since Version: 2.1.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_mmap_combined_params=true
+ * Note: If True, inference maps the combined parameter file into memory and
+ * the CPU parameters share its pages instead of being read into new buffers.
+ * The file must not be modified in place while it is loaded.
+ */
+DEFINE_bool(mmap_combined_params, false,
+            "Load the combined parameters of inference by mapping the file.");
+
+/**
+ * Performance related FLAG
+ * Name: op_trace_sampling_rate
+ * Since Version: 2.1.0
+ * Value Range: double, [0.0, 1.0], default=0.0
+ * Example: FLAGS_op_trace_sampling_rate=0.01
+ * Note: The fraction of the outermost RecordEvent spans of every thread that
+ * the op tracer keeps, together with the spans and allocations nested in
+ * them. The trace is exported with paddle.fluid.profiler.export_op_trace or
+ * paddle_infer::ExportOpTrace. 0 disables the op tracer.
+ */
+DEFINE_double(op_trace_sampling_rate, 0.0,
+              "The fraction of the spans kept by the op tracer, 0 to disable.");
+
+/**
+ * Performance related FLAG
+ * Name: roofline_peak_gflops
+ * Since Version: 2.1.0
+ * Value Range: double, default=0.0
+ * Example: FLAGS_roofline_peak_gflops=1500
+ * Note: The peak GFLOP/s of the CPU in the roofline report of the profiler.
+ * When it is 0, the peak is measured by a large sgemm of the math library on
+ * its threads.
+ */
+DEFINE_double(roofline_peak_gflops, 0.0,
+              "The peak GFLOP/s of the CPU, 0 to measure it.");
+
+/**
+ * Performance related FLAG
+ * Name: roofline_peak_gbps
+ * Since Version: 2.1.0
+ * Value Range: double, default=0.0
+ * Example: FLAGS_roofline_peak_gbps=100
+ * Note: The peak memory bandwidth in GB/s in the roofline report of the
+ * profiler. When it is 0, the peak is measured on FLAGS_paddle_num_threads
+ * threads.
+ */
+DEFINE_double(roofline_peak_gbps, 0.0,
+              "The peak memory bandwidth in GB/s, 0 to measure it.");
+
+/**
+ * Performance related FLAG
+ * Name: dygraph_backward_num_threads
+ * Since Version: 2.1.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_dygraph_backward_num_threads=4
+ * Note: The number of threads running the ready grad ops of a dygraph
+ * backward on CPU. With 1, the grad ops run one after another. Set
+ * FLAGS_sort_sum_gradient as well to keep the gradients deterministic.
+ */
+DEFINE_int32(dygraph_backward_num_threads, 1,
+             "The number of threads running the dygraph backward on CPU.");
+
+/**
+ * Performance related FLAG
+ * Name: executor_zero_copy_feed_fetch
+ * Since Version: 2.1.0
+ * Value Range: bool, default=true
+ * Example: FLAGS_executor_zero_copy_feed_fetch=false
+ * Note: If True, Executor.run shares the memory of the numpy arrays fed to
+ * CPUPlace that no operator writes, and the fetched CPU tensors take the
+ * buffers of the non-persistable variables computed in the run instead of
+ * copying them.
+ */
+DEFINE_bool(executor_zero_copy_feed_fetch, true,
+            "Feed numpy arrays and fetch CPU tensors without copying them.");
+
 /**
  * Debug related FLAG
  * Name: tracer_mkldnn_ops_on
@@ -30,6 +30,9 @@ struct GlooParallelStrategy {
   std::string ip_address;
   int ip_port;
   std::string scope{"worker"};
+  // the directory of a gloo file store to rendezvous through instead of the
+  // http store, used by the dygraph data parallel context on CPU
+  std::string fs_path;
 };
 
 class GlooParallelContext {
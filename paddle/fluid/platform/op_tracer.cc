@@ -0,0 +1,365 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/op_tracer.h"
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "gflags/gflags.h"
+#include "paddle/fluid/platform/enforce.h"
+
+DECLARE_double(op_trace_sampling_rate);
+
+namespace paddle {
+namespace platform {
+
+namespace {
+
+// The records kept for every thread, 256KB per thread.
+constexpr uint64_t kRingBufferSize = 8192;
+
+uint64_t NowInNsec() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int ProcessId() {
+#if defined(_WIN32)
+  return _getpid();
+#else
+  return getpid();
+#endif
+}
+
+const char* CategoryName(TraceCategory category) {
+  switch (category) {
+    case TraceCategory::kOperator:
+      return "operator";
+    case TraceCategory::kDataFeed:
+      return "data_feed";
+    case TraceCategory::kCommunication:
+      return "communication";
+    case TraceCategory::kMemory:
+      return "memory";
+  }
+  return "unknown";
+}
+
+std::string EscapeJson(const std::string& str) {
+  std::string result;
+  result.reserve(str.size());
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+      result += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      result += buf;
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+struct OpTracer::Record {
+  uint64_t start_ns;
+  // equal to start_ns for the instant events
+  uint64_t end_ns;
+  // the allocated bytes of the kMemory records
+  uint64_t bytes;
+  uint32_t name;
+  TraceCategory category;
+};
+
+// A ring buffer written by one thread and read by the exporter. The writer
+// never waits, the reader drops the records overwritten while it copies.
+// The slots are copied field by field through relaxed atomics, so that a
+// record read while it is overwritten is a dropped record instead of a data
+// race.
+class OpTracer::RingBuffer {
+ public:
+  explicit RingBuffer(int thread_id)
+      : thread_id_(thread_id), slots_(new Slot[kRingBufferSize]()) {}
+
+  int thread_id() const { return thread_id_; }
+
+  void Push(const Record& record) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    // the previous head is published before the oldest record is overwritten
+    std::atomic_thread_fence(std::memory_order_release);
+    slots_[head % kRingBufferSize].Store(record);
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  // Copies the records not cleared yet, and clears them when clear is set.
+  // The records pushed during the copy are kept for the next snapshot.
+  std::vector<Record> Snapshot(bool clear) {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t begin = std::max(FirstValid(head),
+                              cleared_.load(std::memory_order_relaxed));
+    std::vector<Record> records;
+    for (uint64_t i = begin; i < head; ++i) {
+      records.push_back(slots_[i % kRingBufferSize].Load());
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // drops the records the writer has overwritten in the meantime
+    uint64_t valid = FirstValid(head_.load(std::memory_order_relaxed));
+    if (valid > begin) {
+      records.erase(records.begin(),
+                    records.begin() + std::min<uint64_t>(valid - begin,
+                                                         records.size()));
+    }
+    if (clear) ClearUntil(head);
+    return records;
+  }
+
+  void Clear() { ClearUntil(head_.load(std::memory_order_acquire)); }
+
+ private:
+  struct Slot {
+    void Store(const Record& record) {
+      start_ns.store(record.start_ns, std::memory_order_relaxed);
+      end_ns.store(record.end_ns, std::memory_order_relaxed);
+      bytes.store(record.bytes, std::memory_order_relaxed);
+      name_and_category.store(
+          static_cast<uint64_t>(record.name) << 8 |
+              static_cast<uint8_t>(record.category),
+          std::memory_order_relaxed);
+    }
+
+    Record Load() const {
+      uint64_t name = name_and_category.load(std::memory_order_relaxed);
+      return {start_ns.load(std::memory_order_relaxed),
+              end_ns.load(std::memory_order_relaxed),
+              bytes.load(std::memory_order_relaxed),
+              static_cast<uint32_t>(name >> 8),
+              static_cast<TraceCategory>(name & 0xff)};
+    }
+
+    std::atomic<uint64_t> start_ns;
+    std::atomic<uint64_t> end_ns;
+    std::atomic<uint64_t> bytes;
+    std::atomic<uint64_t> name_and_category;
+  };
+
+  // The first record not overwritten when head records are pushed, the
+  // writer may be overwriting the record at head - kRingBufferSize.
+  static uint64_t FirstValid(uint64_t head) {
+    return head >= kRingBufferSize ? head - kRingBufferSize + 1 : 0;
+  }
+
+  // Drops the records before head. Never moves back, a concurrent clear may
+  // have dropped more already.
+  void ClearUntil(uint64_t head) {
+    uint64_t cleared = cleared_.load(std::memory_order_relaxed);
+    while (cleared < head &&
+           !cleared_.compare_exchange_weak(cleared, head,
+                                           std::memory_order_relaxed)) {
+    }
+  }
+
+  const int thread_id_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> cleared_{0};
+};
+
+struct OpTracer::ThreadState {
+  struct OpenSpan {
+    uint32_t name;
+    TraceCategory category;
+    uint64_t start_ns;
+  };
+
+  // Decides whether the next outermost span or allocation is traced.
+  bool Sample() {
+    double rate = FLAGS_op_trace_sampling_rate;
+    if (rate <= 0 || --countdown > 0) return false;
+    countdown = rate >= 1 ? 1 : static_cast<int64_t>(1 / rate + 0.5);
+    return true;
+  }
+
+  // the open spans, traced or not
+  int depth{0};
+  // whether the outermost open span is traced
+  bool sampled{false};
+  int64_t countdown{0};
+  // the traced open spans
+  std::vector<OpenSpan> spans;
+  // the names interned by this thread
+  std::unordered_map<std::string, uint32_t> name_ids;
+  // created when the thread records its first event
+  std::shared_ptr<RingBuffer> buffer;
+};
+
+OpTracer& OpTracer::Instance() {
+  static OpTracer instance;
+  return instance;
+}
+
+bool OpTracer::IsEnabled() { return FLAGS_op_trace_sampling_rate > 0; }
+
+void OpTracer::SetSamplingRate(double rate) {
+  PADDLE_ENFORCE_EQ(rate >= 0 && rate <= 1, true,
+                    platform::errors::InvalidArgument(
+                        "The sampling rate of the op tracer should be in "
+                        "[0, 1], but received %f.",
+                        rate));
+  FLAGS_op_trace_sampling_rate = rate;
+}
+
+OpTracer::ThreadState& OpTracer::GetThreadState() {
+  static thread_local ThreadState state;
+  return state;
+}
+
+uint32_t OpTracer::InternName(ThreadState* state, const std::string& name) {
+  auto it = state->name_ids.find(name);
+  if (it != state->name_ids.end()) return it->second;
+  uint32_t id;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto result = name_ids_.emplace(name, names_.size());
+    if (result.second) names_.push_back(name);
+    id = result.first->second;
+  }
+  state->name_ids.emplace(name, id);
+  return id;
+}
+
+void OpTracer::Push(ThreadState* state, const Record& record) {
+  if (state->buffer == nullptr) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    state->buffer = std::make_shared<RingBuffer>(buffers_.size());
+    buffers_.push_back(state->buffer);
+  }
+  state->buffer->Push(record);
+}
+
+void OpTracer::BeginSpan(const std::string& name, TraceCategory category) {
+  auto& state = GetThreadState();
+  if (state.depth++ == 0) {
+    state.sampled = state.Sample();
+  }
+  if (state.sampled) {
+    state.spans.push_back({InternName(&state, name), category, NowInNsec()});
+  }
+}
+
+void OpTracer::EndSpan() {
+  auto& state = GetThreadState();
+  PADDLE_ENFORCE_GT(state.depth, 0,
+                    platform::errors::PreconditionNotMet(
+                        "EndSpan is called without an open span."));
+  --state.depth;
+  if (!state.sampled) return;
+  auto& span = state.spans.back();
+  Push(&state, {span.start_ns, NowInNsec(), 0, span.name, span.category});
+  state.spans.pop_back();
+  if (state.depth == 0) state.sampled = false;
+}
+
+void OpTracer::RecordAllocation(const Place& place, size_t bytes) {
+  auto& state = GetThreadState();
+  if (state.depth > 0 ? !state.sampled : !state.Sample()) return;
+  std::ostringstream name;
+  name << "Alloc " << place;
+  uint64_t now = NowInNsec();
+  Push(&state, {now, now, bytes, InternName(&state, name.str()),
+                TraceCategory::kMemory});
+}
+
+void OpTracer::ExportChromeTrace(const std::string& path, bool clear) {
+  // opened first, so that nothing is cleared when it fails
+  std::ofstream fout(path);
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fout), true,
+                    platform::errors::Unavailable(
+                        "Cannot open %s to export the op trace.", path));
+  std::vector<std::shared_ptr<RingBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    buffers = buffers_;
+  }
+  std::vector<std::vector<Record>> records(buffers.size());
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    records[i] = buffers[i]->Snapshot(clear);
+  }
+  // the names are interned before the records using them are pushed, so
+  // copying them after the records covers all of them
+  std::vector<std::string> names;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    names = names_;
+  }
+
+  int pid = ProcessId();
+  size_t num_events = 0;
+  fout << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    for (auto& record : records[i]) {
+      if (record.name >= names.size()) {
+        LOG(WARNING) << "Skip a traced event of unknown name " << record.name;
+        continue;
+      }
+      fout << (num_events++ == 0 ? "\n" : ",\n");
+      char ts[32];
+      snprintf(ts, sizeof(ts), "%.3f", record.start_ns / 1000.0);
+      fout << "{\"name\": \"" << EscapeJson(names[record.name])
+           << "\", \"cat\": \"" << CategoryName(record.category)
+           << "\", \"pid\": " << pid << ", \"tid\": " << buffers[i]->thread_id()
+           << ", \"ts\": " << ts;
+      if (record.category == TraceCategory::kMemory) {
+        fout << ", \"ph\": \"i\", \"s\": \"t\", \"args\": {\"bytes\": "
+             << record.bytes << "}}";
+      } else {
+        char dur[32];
+        snprintf(dur, sizeof(dur), "%.3f",
+                 (record.end_ns - record.start_ns) / 1000.0);
+        fout << ", \"ph\": \"X\", \"dur\": " << dur << "}";
+      }
+    }
+  }
+  fout << "\n]}\n";
+  fout.close();
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fout), true,
+                    platform::errors::Unavailable(
+                        "Failed to write the op trace to %s.", path));
+  VLOG(3) << "Exported " << num_events << " events of " << buffers.size()
+          << " threads to " << path;
+}
+
+void OpTracer::Clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& buffer : buffers_) {
+    buffer->Clear();
+  }
+}
+
+}  // namespace platform
+}  // namespace paddle
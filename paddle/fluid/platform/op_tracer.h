@@ -0,0 +1,91 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/platform/macros.h"
+#include "paddle/fluid/platform/place.h"
+
+namespace paddle {
+namespace platform {
+
+enum class TraceCategory : uint8_t {
+  kOperator,       // ops, op handles and the stages of running them
+  kDataFeed,       // reading and parsing the training data
+  kCommunication,  // RPCs and collective communication
+  kMemory,         // allocations
+};
+
+// OpTracer keeps a sample of the RecordEvent spans and the allocations of
+// every thread, cheap enough to stay on in production, and exports them in
+// the Chrome trace format read by chrome://tracing and Perfetto.
+//
+// One out of every 1 / FLAGS_op_trace_sampling_rate outermost spans of a
+// thread is traced together with all the spans and allocations nested in
+// it, the others only cost a counter decrement. The names are interned, and
+// every thread writes fixed-size records to its own ring buffer without
+// locks, overwriting its oldest records when the buffer is full.
+class OpTracer {
+ public:
+  static OpTracer& Instance();
+
+  // Whether FLAGS_op_trace_sampling_rate is positive.
+  static bool IsEnabled();
+  // Sets FLAGS_op_trace_sampling_rate, 0 disables the tracer.
+  static void SetSamplingRate(double rate);
+
+  // Begins a span of the current thread, which must be ended by EndSpan on
+  // the same thread, also after the tracer is disabled.
+  void BeginSpan(const std::string& name, TraceCategory category);
+  void EndSpan();
+  // Records an allocation of bytes on place as an instant event.
+  void RecordAllocation(const Place& place, size_t bytes);
+
+  // Writes the records of all threads to path as Chrome trace JSON, and
+  // drops the written records when clear is set. The records taken during
+  // the export are kept for the next one.
+  void ExportChromeTrace(const std::string& path, bool clear = false);
+  // Drops the records taken so far.
+  void Clear();
+
+ private:
+  struct Record;
+  class RingBuffer;
+  struct ThreadState;
+
+  OpTracer() = default;
+
+  static ThreadState& GetThreadState();
+  uint32_t InternName(ThreadState* state, const std::string& name);
+  void Push(ThreadState* state, const Record& record);
+
+  std::mutex mutex_;
+  // the interned names, indexed by their ids
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, uint32_t> name_ids_;
+  // the buffers of all threads, kept after the threads exit
+  std::vector<std::shared_ptr<RingBuffer>> buffers_;
+
+  DISABLE_COPY_AND_ASSIGN(OpTracer);
+};
+
+}  // namespace platform
+}  // namespace paddle
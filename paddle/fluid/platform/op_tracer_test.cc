@@ -0,0 +1,164 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/op_tracer.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace platform {
+
+namespace {
+
+std::string ExportTrace(const std::string& path, bool clear = false) {
+  OpTracer::Instance().ExportChromeTrace(path, clear);
+  std::ifstream fin(path);
+  std::stringstream content;
+  content << fin.rdbuf();
+  return content.str();
+}
+
+size_t Count(const std::string& str, const std::string& pattern) {
+  size_t count = 0;
+  for (size_t pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + pattern.size())) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(OpTracer, SampleOutermostSpans) {
+  auto& tracer = OpTracer::Instance();
+  tracer.Clear();
+  OpTracer::SetSamplingRate(0.25);
+  // a new thread starts sampling from its first span
+  std::thread([&] {
+    for (int i = 0; i < 100; ++i) {
+      tracer.BeginSpan("outer", TraceCategory::kOperator);
+      tracer.BeginSpan("inner \"op\"", TraceCategory::kDataFeed);
+      tracer.RecordAllocation(CPUPlace(), 64);
+      tracer.EndSpan();
+      tracer.EndSpan();
+    }
+  }).join();
+  OpTracer::SetSamplingRate(0);
+  EXPECT_FALSE(OpTracer::IsEnabled());
+
+  auto trace = ExportTrace("op_tracer_test_sample.json");
+  EXPECT_EQ(trace.find("{\"displayTimeUnit\": \"ns\", \"traceEvents\": ["), 0);
+  EXPECT_EQ(Count(trace, "\"name\": \"outer\", \"cat\": \"operator\""), 25UL);
+  EXPECT_EQ(Count(trace, "\"name\": \"inner \\\"op\\\"\""), 25UL);
+  EXPECT_EQ(Count(trace, "\"cat\": \"data_feed\""), 25UL);
+  EXPECT_EQ(Count(trace, "\"ph\": \"i\""), 25UL);
+  EXPECT_EQ(Count(trace, "\"args\": {\"bytes\": 64}"), 25UL);
+
+  tracer.Clear();
+  trace = ExportTrace("op_tracer_test_sample.json");
+  EXPECT_EQ(Count(trace, "\"name\""), 0UL);
+  EXPECT_ANY_THROW(OpTracer::SetSamplingRate(2));
+}
+
+TEST(OpTracer, KeepLatestRecordsOfEveryThread) {
+  auto& tracer = OpTracer::Instance();
+  tracer.Clear();
+  OpTracer::SetSamplingRate(1);
+  const int num_threads = 4;
+  const int num_spans = 20000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i] {
+      std::string name = "thread" + std::to_string(i);
+      for (int j = 0; j < num_spans; ++j) {
+        tracer.BeginSpan(name, TraceCategory::kOperator);
+        tracer.EndSpan();
+      }
+    });
+  }
+  // exports while the threads are writing
+  ExportTrace("op_tracer_test_threads.json");
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  OpTracer::SetSamplingRate(0);
+
+  auto trace = ExportTrace("op_tracer_test_threads.json");
+  for (int i = 0; i < num_threads; ++i) {
+    size_t count =
+        Count(trace, "\"name\": \"thread" + std::to_string(i) + "\"");
+    EXPECT_GT(count, 8000UL);
+    EXPECT_LE(count, 8192UL);
+  }
+}
+
+TEST(OpTracer, ExportAndClearWhileWriting) {
+  auto& tracer = OpTracer::Instance();
+  tracer.Clear();
+  OpTracer::SetSamplingRate(1);
+  // fewer than the records kept, so that none is overwritten
+  const int num_spans = 8000;
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    for (int i = 0; i < num_spans; ++i) {
+      // a new name per span, interned while the exports run
+      tracer.BeginSpan("span" + std::to_string(i), TraceCategory::kOperator);
+      tracer.EndSpan();
+    }
+    done = true;
+  });
+  // every span is exported exactly once by the clearing exports
+  size_t num_exported = 0;
+  while (!done) {
+    num_exported +=
+        Count(ExportTrace("op_tracer_test_clear.json", true), "\"name\"");
+  }
+  writer.join();
+  OpTracer::SetSamplingRate(0);
+  num_exported +=
+      Count(ExportTrace("op_tracer_test_clear.json", true), "\"name\"");
+  EXPECT_EQ(num_exported, static_cast<size_t>(num_spans));
+}
+
+TEST(OpTracer, Overhead) {
+  auto& tracer = OpTracer::Instance();
+  const int num_spans = 1000000;
+  auto run = [&](double rate) {
+    OpTracer::SetSamplingRate(rate);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_spans; ++i) {
+      tracer.BeginSpan("op", TraceCategory::kOperator);
+      tracer.EndSpan();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           num_spans;
+  };
+  double sampled_ns = run(0.01);
+  double all_ns = run(1);
+  OpTracer::SetSamplingRate(0);
+  LOG(INFO) << "A span costs " << sampled_ns << "ns at sampling rate 0.01, "
+            << all_ns << "ns when every span is traced";
+}
+
+}  // namespace platform
+}  // namespace paddle
@@ -12,6 +12,9 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
 #include <mutex>  // NOLINT
 #include <random>
 #include <string>
@@ -20,6 +23,7 @@ limitations under the License. */
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/profiler.h"
 #include "paddle/fluid/platform/profiler_helper.h"
+#include "paddle/fluid/platform/roofline.h"
 #ifdef PADDLE_WITH_CUDA
 #include "paddle/fluid/platform/dynload/nvtx.h"
 #endif
@@ -31,6 +35,15 @@ namespace platform {
 
 MemEvenRecorder MemEvenRecorder::recorder;
 
+static bool g_roofline_report = false;
+static bool g_memory_report = false;
+// the index of the memory record log of the current thread
+static thread_local int64_t g_mem_log_thread_id = 0;
+// the number of buckets of the profiled time in the memory report, and the
+// number of sites of allocations printed for every place
+constexpr size_t kMemTimelineBuckets = 20;
+constexpr size_t kMemReportTopSites = 10;
+
 Event::Event(EventType type, std::string name, uint32_t thread_id,
              EventRole role)
     : type_(type), name_(name), thread_id_(thread_id), role_(role) {
@@ -52,7 +65,8 @@ double Event::CudaElapsedMs(const Event &e) const {
 #endif
 }
 
-RecordEvent::RecordEvent(const std::string &name, const EventRole role) {
+RecordEvent::RecordEvent(const std::string &name, const EventRole role,
+                         const TraceCategory category) {
 #ifndef _WIN32
 #ifdef PADDLE_WITH_CUDA
   if (g_enable_nvprof_hook) {
@@ -61,6 +75,10 @@ RecordEvent::RecordEvent(const std::string &name, const EventRole role) {
   }
 #endif
 #endif
+  if (OpTracer::IsEnabled() && !name.empty()) {
+    OpTracer::Instance().BeginSpan(name, category);
+    is_traced_ = true;
+  }
   if (g_state == ProfilerState::kDisabled || name.empty()) return;
 
   // do some initialization
@@ -82,6 +100,9 @@ RecordEvent::~RecordEvent() {
   }
 #endif
 #endif
+  if (is_traced_) {
+    OpTracer::Instance().EndSpan();
+  }
   if (g_state == ProfilerState::kDisabled || !is_enabled_) return;
   // lock is not needed, the code below is thread-safe
   DeviceTracer *tracer = GetDeviceTracer();
@@ -93,58 +114,265 @@ RecordEvent::~RecordEvent() {
   PopEvent(name_, role_);
 }
 
+MemEvenRecorder::MemRecord::MemRecord(const void *ptr, const Place &place,
+                                      size_t bytes, bool is_alloc,
+                                      int64_t thread_id,
+                                      std::string &&annotation)
+    : ptr_(ptr),
+      place_(place),
+      bytes_(bytes),
+      ns_(PosixInNsec()),
+      is_alloc_(is_alloc),
+      thread_id_(thread_id),
+      annotation_(std::move(annotation)) {}
+
+MemEvenRecorder::MemLog &MemEvenRecorder::ThreadLog() {
+  static thread_local std::shared_ptr<MemLog> log;
+  if (!log) {
+    log = std::make_shared<MemLog>();
+    std::lock_guard<std::mutex> guard(mtx_);
+    g_mem_log_thread_id = logs_.size();
+    logs_.emplace_back(log);
+  }
+  return *log;
+}
+
 void MemEvenRecorder::PushMemRecord(const void *ptr, const Place &place,
                                     size_t size) {
   if (g_state == ProfilerState::kDisabled) return;
-  std::lock_guard<std::mutex> guard(mtx_);
-  auto &events = address_memevent_[place];
-  PADDLE_ENFORCE_EQ(events.count(ptr), 0,
-                    platform::errors::InvalidArgument(
-                        "The Place can't exist in the stage of PushMemRecord"));
-  events.emplace(ptr, std::unique_ptr<RecordMemEvent>(
-                          new MemEvenRecorder::RecordMemEvent(place, size)));
+  auto &log = ThreadLog();
+  auto annotation = CurAnnotationName();
+  std::lock_guard<std::mutex> guard(log.mtx);
+  log.records.Record(ptr, place, size, true, g_mem_log_thread_id,
+                     std::move(annotation));
 }
 
 void MemEvenRecorder::PopMemRecord(const void *ptr, const Place &place) {
   if (g_state == ProfilerState::kDisabled) return;
-  std::lock_guard<std::mutex> guard(mtx_);
-  auto &events = address_memevent_[place];
-  auto iter = events.find(ptr);
-  // The ptr maybe not in address_memevent
-  if (iter != events.end()) {
-    events.erase(iter);
-  }
+  auto &log = ThreadLog();
+  auto annotation = CurAnnotationName();
+  std::lock_guard<std::mutex> guard(log.mtx);
+  log.records.Record(ptr, place, 0, false, g_mem_log_thread_id,
+                     std::move(annotation));
 }
 
 void MemEvenRecorder::Flush() {
-  std::lock_guard<std::mutex> guard(mtx_);
-  address_memevent_.clear();
-}
+  std::vector<MemRecord> records;
+  {
+    std::lock_guard<std::mutex> guard(mtx_);
+    for (auto &log : logs_) {
+      // the threads may still be recording
+      std::lock_guard<std::mutex> log_guard(log->mtx);
+      auto thread_records = log->records.Reduce();
+      records.insert(records.end(),
+                     std::make_move_iterator(thread_records.begin()),
+                     std::make_move_iterator(thread_records.end()));
+    }
+  }
+  // the records of every thread are already in time order
+  std::stable_sort(records.begin(), records.end(),
+                   [](const MemRecord &a, const MemRecord &b) {
+                     return a.ns_ < b.ns_;
+                   });
 
-MemEvenRecorder::RecordMemEvent::RecordMemEvent(const Place &place,
-                                                size_t bytes)
-    : place_(place),
-      bytes_(bytes),
-      start_ns_(PosixInNsec()),
-      alloc_in_(CurAnnotationName()) {
-  PushMemEvent(start_ns_, end_ns_, bytes_, place_, alloc_in_);
+  DeviceTracer *tracer = GetDeviceTracer();
+  auto free_record = [&](const MemRecord &alloc, uint64_t end_ns,
+                         const std::string &free_in) {
+    if (tracer) {
+      tracer->AddMemInfoRecord(alloc.ns_, end_ns, alloc.bytes_, alloc.place_,
+                               alloc.annotation_, free_in, alloc.thread_id_);
+    }
+    PopMemEvent(alloc.ns_, end_ns, alloc.bytes_, alloc.place_, free_in);
+  };
+  // the index of the allocation record of every live address
+  std::map<Place, std::unordered_map<const void *, size_t>> live;
+  for (size_t i = 0; i < records.size(); ++i) {
+    auto &record = records[i];
+    auto &addresses = live[record.place_];
+    auto iter = addresses.find(record.ptr_);
+    if (record.is_alloc_) {
+      PushMemEvent(record.ns_, 0, record.bytes_, record.place_,
+                   record.annotation_);
+      if (iter != addresses.end()) {
+        // the free of the address was recorded by another thread in the
+        // same nanosecond
+        free_record(records[iter->second], record.ns_, record.annotation_);
+        iter->second = i;
+      } else {
+        addresses.emplace(record.ptr_, i);
+      }
+    } else if (iter != addresses.end()) {
+      // The ptr maybe not in the addresses if it is allocated before the
+      // profiler is enabled
+      free_record(records[iter->second], record.ns_, record.annotation_);
+      addresses.erase(iter);
+    }
+  }
+  uint64_t now = PosixInNsec();
+  auto free_in = CurAnnotationName();
+  for (auto &place_addresses : live) {
+    for (auto &address : place_addresses.second) {
+      free_record(records[address.second], now, free_in);
+    }
+  }
+
+  if (g_memory_report) {
+    BuildReport(records);
+  }
 }
 
-MemEvenRecorder::RecordMemEvent::~RecordMemEvent() {
-  DeviceTracer *tracer = GetDeviceTracer();
-  end_ns_ = PosixInNsec();
+void MemEvenRecorder::BuildReport(const std::vector<MemRecord> &records) {
+  std::lock_guard<std::mutex> guard(mtx_);
+  reports_.clear();
+  if (records.empty()) return;
+  report_start_ns_ = records.front().ns_;
+  report_end_ns_ = records.back().ns_;
+  uint64_t duration = report_end_ns_ - report_start_ns_ + 1;
+
+  // the bytes allocated on every place, the last bucket of the timeline
+  // with a record and the live allocations
+  std::map<Place, size_t> allocated;
+  std::map<Place, size_t> last_bucket;
+  std::map<Place, std::unordered_map<const void *, size_t>> live;
+  for (size_t i = 0; i < records.size(); ++i) {
+    auto &record = records[i];
+    auto &addresses = live[record.place_];
+    auto iter = addresses.find(record.ptr_);
+    if (!record.is_alloc_ && iter == addresses.end()) continue;
+    auto &report = reports_[record.place_];
+    auto &size = allocated[record.place_];
+    if (report.timeline.empty()) {
+      report.timeline.resize(kMemTimelineBuckets, 0);
+      last_bucket[record.place_] = 0;
+    }
 
-  auto annotation_free = CurAnnotationName();
-  if (tracer) {
-    tracer->AddMemInfoRecord(start_ns_, end_ns_, bytes_, place_, alloc_in_,
-                             annotation_free, g_mem_thread_id);
+    size_t bucket =
+        (record.ns_ - report_start_ns_) * kMemTimelineBuckets / duration;
+    auto &last = last_bucket[record.place_];
+    // the buckets without records hold the bytes allocated before them
+    for (; last < bucket; ++last) {
+      report.timeline[last + 1] = size;
+    }
+
+    if (iter != addresses.end()) {
+      size -= records[iter->second].bytes_;
+      addresses.erase(iter);
+    }
+    if (record.is_alloc_) {
+      size += record.bytes_;
+      addresses.emplace(record.ptr_, i);
+      auto &site = report.sites[record.annotation_];
+      ++site.alloc_times;
+      site.alloc_size += record.bytes_;
+    }
+    report.timeline[bucket] = std::max(report.timeline[bucket], size);
+    if (size > report.peak_size) {
+      report.peak_size = size;
+      report.peak_ns = record.ns_;
+      report.peak_index = i;
+    }
+  }
+
+  for (auto &place_report : reports_) {
+    auto &place = place_report.first;
+    auto &report = place_report.second;
+    for (size_t i = last_bucket[place] + 1; i < kMemTimelineBuckets; ++i) {
+      report.timeline[i] = allocated[place];
+    }
+    if (report.peak_size == 0) continue;
+    // replay the records of the place until the peak to find the sites of
+    // the memory held at the peak
+    std::unordered_map<const void *, const MemRecord *> addresses;
+    for (size_t i = 0; i <= report.peak_index; ++i) {
+      auto &record = records[i];
+      if (!is_same_place(record.place_, place)) continue;
+      if (record.is_alloc_) {
+        addresses[record.ptr_] = &record;
+      } else {
+        addresses.erase(record.ptr_);
+      }
+    }
+    for (auto &address : addresses) {
+      report.sites[address.second->annotation_].peak_size +=
+          address.second->bytes_;
+    }
   }
-  PopMemEvent(start_ns_, end_ns_, bytes_, place_, annotation_free);
+}
+
+void MemEvenRecorder::PrintReport() {
+  std::lock_guard<std::mutex> guard(mtx_);
+  if (reports_.empty()) return;
+  const double kMB = 1024.0 * 1024.0;
+  const size_t name_width = 55;
+  const size_t data_width = 18;
+  double bucket_ms =
+      (report_end_ns_ - report_start_ns_ + 1) / 1e6 / kMemTimelineBuckets;
+
+  std::cout << "\n------------------------->"
+            << "    Memory Report     "
+            << "<-------------------------\n\n";
+  std::cout.setf(std::ios::left);
+  for (auto &place_report : reports_) {
+    auto &report = place_report.second;
+    std::cout << "Place: " << place_report.first << "\n";
+    std::cout << "Peak allocated size(MB): " << report.peak_size / kMB
+              << " at " << (report.peak_ns - report_start_ns_) / 1e6
+              << " ms\n\n";
+
+    std::cout << std::setw(data_width) << "Time(ms)"
+              << std::setw(data_width) << "Allocated(MB)"
+              << "\n";
+    for (size_t i = 0; i < report.timeline.size(); ++i) {
+      std::cout << std::setw(data_width) << i * bucket_ms
+                << std::setw(data_width) << report.timeline[i] / kMB << "\n";
+    }
+    std::cout << "\n";
+
+    std::vector<std::pair<std::string, SiteReport>> sites(
+        report.sites.begin(), report.sites.end());
+    std::sort(sites.begin(), sites.end(),
+              [](const std::pair<std::string, SiteReport> &a,
+                 const std::pair<std::string, SiteReport> &b) {
+                if (a.second.peak_size != b.second.peak_size) {
+                  return a.second.peak_size > b.second.peak_size;
+                }
+                return a.second.alloc_size > b.second.alloc_size;
+              });
+    if (sites.size() > kMemReportTopSites) {
+      sites.resize(kMemReportTopSites);
+    }
+    std::cout << std::setw(name_width) << "Allocated in"
+              << std::setw(data_width) << "Size at Peak(MB)"
+              << std::setw(data_width) << "Alloc Calls"
+              << std::setw(data_width) << "Alloc Size(MB)"
+              << "\n";
+    for (auto &site : sites) {
+      std::cout << std::setw(name_width)
+                << (site.first.empty() ? "(none)" : site.first)
+                << std::setw(data_width) << site.second.peak_size / kMB
+                << std::setw(data_width) << site.second.alloc_times
+                << std::setw(data_width) << site.second.alloc_size / kMB
+                << "\n";
+    }
+    std::cout << "\n";
+  }
+  std::cout << std::endl;
+  reports_.clear();
 }
 
 RecordRPCEvent::RecordRPCEvent(const std::string &name) {
   if (FLAGS_enable_rpc_profiler) {
-    event_.reset(new platform::RecordEvent(name));
+    event_.reset(new platform::RecordEvent(name, EventRole::kOrdinary,
+                                           TraceCategory::kCommunication));
+  } else if (OpTracer::IsEnabled() && !name.empty()) {
+    OpTracer::Instance().BeginSpan(name, TraceCategory::kCommunication);
+    is_traced_ = true;
+  }
+}
+
+RecordRPCEvent::~RecordRPCEvent() {
+  if (is_traced_) {
+    OpTracer::Instance().EndSpan();
   }
 }
 
@@ -231,6 +459,7 @@ void ResetProfiler() {
        it != g_all_mem_event_lists.end(); ++it) {
     (*it)->Clear();
   }
+  RooflineRecorder::Instance().Clear();
 }
 
 void DisableProfiler(EventSortingKey sorted_key,
@@ -259,10 +488,18 @@ void DisableProfiler(EventSortingKey sorted_key,
     std::vector<std::vector<MemEvent>> all_mem_events = GetMemEvents();
     ParseMemEvents(all_mem_events);
   }
+  if (g_roofline_report) {
+    RooflineRecorder::Instance().PrintReport();
+  }
+  if (g_memory_report) {
+    MemEvenRecorder::Instance().PrintReport();
+  }
 
   ResetProfiler();
   g_state = ProfilerState::kDisabled;
   g_tracer_option = TracerOption::kDefault;
+  g_roofline_report = false;
+  g_memory_report = false;
   should_send_profile_state = true;
 }
 
@@ -306,6 +543,20 @@ void SetTracerOption(TracerOption option) {
 
 platform::TracerOption GetTracerOption() { return g_tracer_option; }
 
+void EnableRooflineReport(bool enable) {
+  std::lock_guard<std::mutex> l(profiler_mu);
+  g_roofline_report = enable;
+}
+
+bool IsRooflineReportEnabled() {
+  return g_roofline_report && g_state != ProfilerState::kDisabled;
+}
+
+void EnableMemoryReport(bool enable) {
+  std::lock_guard<std::mutex> l(profiler_mu);
+  g_memory_report = enable;
+}
+
 void SetProfileListener() {
   std::mt19937 rng;
   rng.seed(std::random_device()());
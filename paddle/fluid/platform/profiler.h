@@ -27,6 +27,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/type_defs.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/event.h"
+#include "paddle/fluid/platform/op_tracer.h"
 #include "paddle/fluid/platform/place.h"
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 #include "paddle/fluid/platform/gpu_info.h"
@@ -95,43 +96,17 @@ struct OverHead {
   std::vector<EventItem> sub_memcpy_items;
 };
 
-struct MemEvenRecorder {
- public:
-  void PushMemRecord(const void* ptr, const Place& place, size_t size);
-  void PopMemRecord(const void* ptr, const Place& place);
-  void Flush();
-  static MemEvenRecorder& Instance() { return recorder; }
-
- private:
-  struct RecordMemEvent {
-    RecordMemEvent(const Place& place, size_t bytes);
-    ~RecordMemEvent();
-
-    Place place_;
-    size_t bytes_;
-    uint64_t start_ns_;
-    uint64_t end_ns_;
-    std::string alloc_in_;
-    std::string free_in_;
-  };
-
-  static MemEvenRecorder recorder;
-  std::map<Place,
-           std::unordered_map<const void*, std::unique_ptr<RecordMemEvent>>>
-      address_memevent_;
-  std::mutex mtx_;
-  MemEvenRecorder() {}
-  DISABLE_COPY_AND_ASSIGN(MemEvenRecorder);
-};
-
 struct RecordEvent {
   RecordEvent(const std::string& name,
-              const EventRole role = EventRole::kOrdinary);
+              const EventRole role = EventRole::kOrdinary,
+              const TraceCategory category = TraceCategory::kOperator);
 
   ~RecordEvent();
 
   bool is_enabled_{false};
   bool is_pushed_{false};
+  // whether the event is a span of the OpTracer
+  bool is_traced_{false};
   uint64_t start_ns_;
   // Event name
   std::string name_;
@@ -144,10 +119,11 @@ struct RecordEvent {
 class RecordRPCEvent {
  public:
   explicit RecordRPCEvent(const std::string& name);
-  ~RecordRPCEvent() {}
+  ~RecordRPCEvent();
 
  private:
   std::unique_ptr<RecordEvent> event_;
+  bool is_traced_{false};
 };
 
 struct RecordBlock {
@@ -195,6 +171,76 @@ struct EventList {
   std::forward_list<std::vector<T>> event_blocks;
 };
 
+// MemEvenRecorder records the allocations and frees of the allocators while
+// the profiler is enabled. Every thread appends its records to a log of its
+// own, whose mutex is only contended by a flush, and the logs are merged in
+// time order when the profiler is flushed, which pairs every free with its
+// allocation even if they happen on different threads.
+struct MemEvenRecorder {
+ public:
+  void PushMemRecord(const void* ptr, const Place& place, size_t size);
+  void PopMemRecord(const void* ptr, const Place& place);
+  // Merges the records of all threads into the memory events of the profiler
+  // and the device tracer, and clears them. The allocations that are not
+  // freed yet are reported as freed now.
+  void Flush();
+  // Prints the timeline of the bytes allocated on every place and the ops
+  // holding the most memory at the peak, collected by the last Flush with
+  // the memory report enabled.
+  void PrintReport();
+  static MemEvenRecorder& Instance() { return recorder; }
+
+ private:
+  struct MemRecord {
+    MemRecord(const void* ptr, const Place& place, size_t bytes,
+              bool is_alloc, int64_t thread_id, std::string&& annotation);
+
+    const void* ptr_;
+    Place place_;
+    // 0 for a free
+    size_t bytes_;
+    uint64_t ns_;
+    bool is_alloc_;
+    int64_t thread_id_;
+    std::string annotation_;
+  };
+
+  struct SiteReport {
+    size_t alloc_times{0};
+    size_t alloc_size{0};
+    size_t peak_size{0};
+  };
+
+  struct PlaceReport {
+    // the most bytes allocated in every bucket of the profiled time
+    std::vector<size_t> timeline;
+    size_t peak_size{0};
+    uint64_t peak_ns{0};
+    // the records of the place until the peak is reached
+    size_t peak_index{0};
+    std::unordered_map<std::string, SiteReport> sites;
+  };
+
+  struct MemLog {
+    // taken by the thread of the log for every record and by Flush
+    std::mutex mtx;
+    EventList<MemRecord> records;
+  };
+
+  MemLog& ThreadLog();
+  void BuildReport(const std::vector<MemRecord>& records);
+
+  static MemEvenRecorder recorder;
+  std::mutex mtx_;
+  // the logs of all threads
+  std::list<std::shared_ptr<MemLog>> logs_;
+  std::map<Place, PlaceReport> reports_;
+  uint64_t report_start_ns_{0};
+  uint64_t report_end_ns_{0};
+  MemEvenRecorder() {}
+  DISABLE_COPY_AND_ASSIGN(MemEvenRecorder);
+};
+
 void Mark(const std::string& name);
 void PushMemEvent(uint64_t start_ns, uint64_t end_ns, size_t bytes,
                   const Place& place, const std::string& annotation);
@@ -220,6 +266,14 @@ std::string OpName(const framework::VariableNameMap& name_map,
                    const std::string& type_name);
 void SetTracerOption(TracerOption option);
 platform::TracerOption GetTracerOption();
+// Enable the roofline report of the CPU ops, which is printed when the
+// profiler is disabled. See RooflineRecorder.
+void EnableRooflineReport(bool enable);
+// Whether the profiler is enabled with the roofline report.
+bool IsRooflineReportEnabled();
+// Enable the report of the allocated memory, which is printed when the
+// profiler is disabled. See MemEvenRecorder.
+void EnableMemoryReport(bool enable);
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 void DummyKernelAndEvent();
 #endif
@@ -14,7 +14,11 @@ limitations under the License. */
 
 #include "paddle/fluid/platform/profiler.h"
 
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -137,6 +141,86 @@ TEST(RecordEvent, RecordEvent) {
   DisableProfiler(EventSortingKey::kTotal, "/tmp/profiler");
 }
 
+TEST(MemEvenRecorder, FreeOnAnotherThread) {
+  using paddle::platform::CPUPlace;
+  using paddle::platform::EventSortingKey;
+  using paddle::platform::MemEvenRecorder;
+  using paddle::platform::ProfilerState;
+  using paddle::platform::RecordEvent;
+  auto &recorder = MemEvenRecorder::Instance();
+  const size_t kMB = 1024 * 1024;
+  auto FakePtr = [](int thread, int i) {
+    return reinterpret_cast<const void *>(
+        static_cast<uintptr_t>((thread * 16 + i + 1) * 4096));
+  };
+
+  paddle::platform::EnableProfiler(ProfilerState::kCPU);
+  paddle::platform::EnableMemoryReport(true);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      RecordEvent record_event("alloc_op_" + std::to_string(t));
+      for (int i = 0; i < 2; ++i) {
+        recorder.PushMemRecord(FakePtr(t, i), CPUPlace(), (t + 1) * kMB);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  {
+    RecordEvent record_event("free_op");
+    // the allocations of the other threads are freed here
+    for (int t = 0; t < 4; ++t) {
+      for (int i = 0; i < 2; ++i) {
+        recorder.PopMemRecord(FakePtr(t, i), CPUPlace());
+      }
+    }
+    // not allocated while profiling
+    recorder.PopMemRecord(FakePtr(8, 0), CPUPlace());
+  }
+
+  testing::internal::CaptureStdout();
+  paddle::platform::DisableProfiler(EventSortingKey::kTotal, "/tmp/profiler");
+  std::string report = testing::internal::GetCapturedStdout();
+  EXPECT_NE(report.find("Memory Report"), std::string::npos);
+  EXPECT_NE(report.find("Peak allocated size(MB): 20 "), std::string::npos);
+  for (int t = 0; t < 4; ++t) {
+    EXPECT_NE(report.find("alloc_op_" + std::to_string(t)), std::string::npos);
+  }
+}
+
+TEST(MemEvenRecorder, FlushWhileRecording) {
+  using paddle::platform::CPUPlace;
+  using paddle::platform::EventSortingKey;
+  using paddle::platform::MemEvenRecorder;
+  using paddle::platform::ProfilerState;
+  auto &recorder = MemEvenRecorder::Instance();
+
+  paddle::platform::EnableProfiler(ProfilerState::kCPU);
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      auto *ptr = reinterpret_cast<const void *>(
+          static_cast<uintptr_t>((t + 1) * 4096));
+      while (!stop) {
+        recorder.PushMemRecord(ptr, CPUPlace(), 1024);
+        recorder.PopMemRecord(ptr, CPUPlace());
+      }
+    });
+  }
+  // the logs are flushed while the threads keep appending to them
+  for (int i = 0; i < 100; ++i) {
+    recorder.Flush();
+  }
+  stop = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  paddle::platform::DisableProfiler(EventSortingKey::kTotal, "/tmp/profiler");
+}
+
 #ifdef PADDLE_WITH_CUDA
 TEST(TMP, stream_wait) {
   cudaStream_t stream;
@@ -0,0 +1,223 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/roofline.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#ifdef PADDLE_WITH_MKLML
+#include "paddle/fluid/platform/dynload/mklml.h"
+#else
+#include <cblas.h>
+#endif
+
+DECLARE_double(roofline_peak_gflops);
+DECLARE_double(roofline_peak_gbps);
+DECLARE_int32(paddle_num_threads);
+
+namespace paddle {
+namespace platform {
+
+namespace {
+
+// keeps the results of the measurements from being optimized away
+volatile float g_sink;
+
+double ElapsedNs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// The GFLOP/s of a large single precision GEMM of the math library. It uses
+// the widest vectors and FMA the CPU supports on the math threads, which is
+// the peak the mul, fc and conv kernels can reach.
+double MeasureGemmGflops() {
+  constexpr int kSize = 1024;
+  constexpr int kRepeat = 3;
+  std::vector<float> a(kSize * kSize, 1.0f);
+  std::vector<float> b(kSize * kSize, 1.0f);
+  std::vector<float> c(kSize * kSize);
+  double best_ns = 0;
+  // the first run warms up the math library
+  for (int i = 0; i <= kRepeat; ++i) {
+    auto start = std::chrono::steady_clock::now();
+#ifdef PADDLE_WITH_MKLML
+    dynload::cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, kSize,
+                         kSize, kSize, 1.0f, a.data(), kSize, b.data(), kSize,
+                         0.0f, c.data(), kSize);
+#else
+    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, kSize, kSize,
+                kSize, 1.0f, a.data(), kSize, b.data(), kSize, 0.0f, c.data(),
+                kSize);
+#endif
+    double elapsed_ns = ElapsedNs(start);
+    if (i > 0 && (best_ns == 0 || elapsed_ns < best_ns)) {
+      best_ns = elapsed_ns;
+    }
+  }
+  g_sink = c[0];
+  return 2.0 * kSize * kSize * kSize / best_ns;
+}
+
+// The GB/s of reading a buffer much larger than the caches.
+double MeasureGBpsOnThread() {
+  constexpr size_t kNumel = 32 << 20;
+  constexpr int kLanes = 16;
+  std::vector<float> data(kNumel, 1.0f);
+  float acc[kLanes] = {0};
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < kNumel; i += kLanes) {
+    for (int j = 0; j < kLanes; ++j) {
+      acc[j] += data[i + j];
+    }
+  }
+  double elapsed_ns = ElapsedNs(start);
+  g_sink = std::accumulate(acc, acc + kLanes, 0.0f);
+  return kNumel * sizeof(float) / elapsed_ns;
+}
+
+// Runs measure on the math threads at the same time, and returns the sum of
+// the best of two rounds of every thread.
+double MeasurePeak(double (*measure)()) {
+  int num_threads = std::max(FLAGS_paddle_num_threads, 1);
+  std::vector<double> results(num_threads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i] {
+      double first = measure();
+      results[i] = std::max(first, measure());
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return std::accumulate(results.begin(), results.end(), 0.0);
+}
+
+}  // namespace
+
+RooflineRecorder& RooflineRecorder::Instance() {
+  static RooflineRecorder instance;
+  return instance;
+}
+
+double RooflineRecorder::PeakGflops() {
+  static double peak = FLAGS_roofline_peak_gflops > 0
+                           ? FLAGS_roofline_peak_gflops
+                           : MeasureGemmGflops();
+  return peak;
+}
+
+double RooflineRecorder::PeakGBps() {
+  static double peak = FLAGS_roofline_peak_gbps > 0
+                           ? FLAGS_roofline_peak_gbps
+                           : MeasurePeak(MeasureGBpsOnThread);
+  return peak;
+}
+
+void RooflineRecorder::Record(const std::string& op_type, double elapsed_ms,
+                              double flops, double bytes) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& item = items_[op_type];
+  ++item.calls;
+  item.total_ms += elapsed_ms;
+  if (flops >= 0 && bytes >= 0) {
+    item.costed_ms += elapsed_ms;
+    item.flops += flops;
+    item.bytes += bytes;
+  }
+}
+
+RooflineRecorder::Item RooflineRecorder::GetItem(const std::string& op_type) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = items_.find(op_type);
+  return it == items_.end() ? Item() : it->second;
+}
+
+void RooflineRecorder::Clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  items_.clear();
+}
+
+void RooflineRecorder::PrintReport() {
+  std::vector<std::pair<std::string, Item>> items;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    items.assign(items_.begin(), items_.end());
+  }
+  if (items.empty()) return;
+  std::sort(items.begin(), items.end(),
+            [](const std::pair<std::string, Item>& a,
+               const std::pair<std::string, Item>& b) {
+              return a.second.total_ms > b.second.total_ms;
+            });
+  double peak_gflops = PeakGflops();
+  double peak_gbps = PeakGBps();
+  // the arithmetic intensity where an op becomes compute-bound
+  double ridge = peak_gflops / peak_gbps;
+
+  std::cout << "\n------------------------->"
+            << "    Roofline Report     "
+            << "<-------------------------\n\n";
+  std::cout << "Peak: " << peak_gflops << " GFLOP/s, " << peak_gbps
+            << " GB/s, ridge point " << ridge << " FLOP/Byte\n";
+  std::cout << "The ops not reporting their FLOPs and bytes are marked by "
+               "-\n\n";
+
+  const int name_width = 24;
+  const int data_width = 12;
+  std::cout.setf(std::ios::left);
+  std::cout << std::setw(name_width) << "Event" << std::setw(data_width)
+            << "Calls" << std::setw(data_width) << "Total(ms)"
+            << std::setw(data_width) << "GFLOP/s" << std::setw(data_width)
+            << "GB/s" << std::setw(data_width) << "FLOP/Byte"
+            << std::setw(data_width) << "Compute%" << std::setw(data_width)
+            << "Memory%"
+            << "Bound" << std::endl;
+  for (auto& pair : items) {
+    auto& item = pair.second;
+    std::cout << std::setw(name_width) << pair.first << std::setw(data_width)
+              << item.calls << std::setw(data_width) << item.total_ms;
+    if (item.costed_ms <= 0) {
+      std::cout << std::setw(data_width) << "-" << std::setw(data_width) << "-"
+                << std::setw(data_width) << "-" << std::setw(data_width) << "-"
+                << std::setw(data_width) << "-"
+                << "-" << std::endl;
+      continue;
+    }
+    // FLOPs per ns are GFLOP/s
+    double gflops = item.flops / (item.costed_ms * 1e6);
+    double gbps = item.bytes / (item.costed_ms * 1e6);
+    double intensity = item.bytes > 0 ? item.flops / item.bytes : 0;
+    std::cout << std::setw(data_width) << gflops << std::setw(data_width)
+              << gbps << std::setw(data_width) << intensity
+              << std::setw(data_width) << 100 * gflops / peak_gflops
+              << std::setw(data_width) << 100 * gbps / peak_gbps
+              << (intensity >= ridge ? "compute" : "memory") << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+}  // namespace platform
+}  // namespace paddle
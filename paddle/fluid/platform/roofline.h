@@ -0,0 +1,73 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+
+#include "paddle/fluid/platform/macros.h"
+
+namespace paddle {
+namespace platform {
+
+// RooflineRecorder accumulates the analytic FLOPs and bytes and the time of
+// the CPU ops run while profiling, and reports the achieved GFLOP/s and GB/s
+// of every op type against the peaks of the machine, which tells whether the
+// op is compute-bound or memory-bound.
+//
+// The peaks are FLAGS_roofline_peak_gflops and FLAGS_roofline_peak_gbps, or
+// measured once when they are 0, by a large sgemm of the math library and by
+// a streaming read on FLAGS_paddle_num_threads threads.
+class RooflineRecorder {
+ public:
+  static RooflineRecorder& Instance();
+
+  // Records a run of op_type. flops and bytes are negative when the op does
+  // not report its cost.
+  void Record(const std::string& op_type, double elapsed_ms, double flops,
+              double bytes);
+  // Prints the report of the ops recorded so far, sorted by their time.
+  void PrintReport();
+  void Clear();
+
+  // The peak GFLOP/s and GB/s of the machine.
+  static double PeakGflops();
+  static double PeakGBps();
+
+  struct Item {
+    int calls{0};
+    double total_ms{0};
+    // the time of the runs reporting their cost
+    double costed_ms{0};
+    double flops{0};
+    double bytes{0};
+  };
+
+  // The runs of op_type recorded so far, all 0 when there are none.
+  Item GetItem(const std::string& op_type);
+
+ private:
+
+  RooflineRecorder() = default;
+
+  std::mutex mutex_;
+  std::map<std::string, Item> items_;
+
+  DISABLE_COPY_AND_ASSIGN(RooflineRecorder);
+};
+
+}  // namespace platform
+}  // namespace paddle
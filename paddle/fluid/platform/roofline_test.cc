@@ -0,0 +1,66 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/roofline.h"
+
+#include <string>
+
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+
+DECLARE_double(roofline_peak_gflops);
+DECLARE_double(roofline_peak_gbps);
+
+namespace paddle {
+namespace platform {
+
+TEST(RooflineRecorder, Report) {
+  FLAGS_roofline_peak_gflops = 100;
+  FLAGS_roofline_peak_gbps = 10;
+  EXPECT_EQ(RooflineRecorder::PeakGflops(), 100);
+  EXPECT_EQ(RooflineRecorder::PeakGBps(), 10);
+
+  auto& recorder = RooflineRecorder::Instance();
+  recorder.Clear();
+  // 50 GFLOP/s at 100 FLOP/Byte
+  recorder.Record("mul", 2, 1e8, 1e6);
+  recorder.Record("mul", 2, 1e8, 1e6);
+  // 5 GB/s at 0.1 FLOP/Byte
+  recorder.Record("elementwise_add", 1, 5e5, 5e6);
+  recorder.Record("reshape2", 1, -1, -1);
+
+  testing::internal::CaptureStdout();
+  recorder.PrintReport();
+  std::string report = testing::internal::GetCapturedStdout();
+  auto mul = report.find("mul");
+  auto add = report.find("elementwise_add");
+  auto reshape = report.find("reshape2");
+  ASSERT_NE(mul, std::string::npos);
+  ASSERT_NE(add, std::string::npos);
+  ASSERT_NE(reshape, std::string::npos);
+  // sorted by time
+  EXPECT_LT(mul, add);
+  EXPECT_NE(report.find("compute", mul), std::string::npos);
+  EXPECT_LT(report.find("compute", mul), add);
+  EXPECT_NE(report.find("memory", add), std::string::npos);
+  EXPECT_NE(report.find("-", reshape), std::string::npos);
+
+  recorder.Clear();
+  testing::internal::CaptureStdout();
+  recorder.PrintReport();
+  EXPECT_TRUE(testing::internal::GetCapturedStdout().empty());
+}
+
+}  // namespace platform
+}  // namespace paddle
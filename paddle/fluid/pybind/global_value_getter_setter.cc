@@ -65,6 +65,18 @@ DECLARE_bool(use_system_allocator);
 DECLARE_bool(benchmark);
 DECLARE_int32(inner_op_parallelism);
 DECLARE_int32(max_inplace_grad_add);
+DECLARE_int32(intra_op_parallelism_budget);
+DECLARE_bool(cache_runtime_context);
+DECLARE_bool(use_work_stealing_executor);
+DECLARE_bool(use_critical_path_priority);
+DECLARE_bool(async_save_combine);
+DECLARE_bool(async_save_fsync);
+DECLARE_bool(mmap_combined_params);
+DECLARE_double(op_trace_sampling_rate);
+DECLARE_double(roofline_peak_gflops);
+DECLARE_double(roofline_peak_gbps);
+DECLARE_int32(dygraph_backward_num_threads);
+DECLARE_bool(executor_zero_copy_feed_fetch);
 DECLARE_string(tracer_profile_fname);
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 // cudnn
@@ -352,7 +364,13 @@ static void RegisterGlobalVarGetterSetter() {
       FLAGS_memory_fraction_of_eager_deletion, FLAGS_use_pinned_memory,
       FLAGS_benchmark, FLAGS_inner_op_parallelism, FLAGS_tracer_profile_fname,
       FLAGS_paddle_num_threads, FLAGS_use_mkldnn, FLAGS_max_inplace_grad_add,
-      FLAGS_tracer_mkldnn_ops_on, FLAGS_tracer_mkldnn_ops_off);
+      FLAGS_tracer_mkldnn_ops_on, FLAGS_tracer_mkldnn_ops_off,
+      FLAGS_intra_op_parallelism_budget, FLAGS_cache_runtime_context,
+      FLAGS_use_work_stealing_executor, FLAGS_use_critical_path_priority,
+      FLAGS_async_save_combine, FLAGS_async_save_fsync,
+      FLAGS_mmap_combined_params, FLAGS_op_trace_sampling_rate,
+      FLAGS_roofline_peak_gflops, FLAGS_roofline_peak_gbps,
+      FLAGS_dygraph_backward_num_threads, FLAGS_executor_zero_copy_feed_fetch);
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   REGISTER_PUBLIC_GLOBAL_VAR(
@@ -89,7 +89,21 @@ void BindGlooContext(py::module *m) {
                     },
                     [](platform::GlooParallelStrategy &self, int ip_port) {
                       self.ip_port = ip_port;
-                    });
+                    })
+      .def_property(
+          "fs_path",
+          [](const platform::GlooParallelStrategy &self) {
+            return self.fs_path;
+          },
+          [](platform::GlooParallelStrategy &self, const std::string &fs_path) {
+            self.fs_path = fs_path;
+          })
+      .def_property(
+          "scope",
+          [](const platform::GlooParallelStrategy &self) { return self.scope; },
+          [](platform::GlooParallelStrategy &self, const std::string &scope) {
+            self.scope = scope;
+          });
 
   py::class_<platform::GlooParallelContext> gloo_ctx(*m, "GlooParallelContext");
   gloo_ctx.def(py::init<const platform::GlooParallelStrategy &>())
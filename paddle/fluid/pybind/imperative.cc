@@ -34,6 +34,7 @@ limitations under the License. */
 #include "paddle/fluid/imperative/basic_engine.h"
 #include "paddle/fluid/imperative/bkcl_context.h"
 #include "paddle/fluid/imperative/data_loader.h"
+#include "paddle/fluid/imperative/gloo_context.h"
 #include "paddle/fluid/imperative/layer.h"
 #include "paddle/fluid/imperative/nccl_context.h"
 #include "paddle/fluid/imperative/partial_grad_engine.h"
@@ -1413,7 +1414,7 @@ void BindImperative(py::module *m_ptr) {
       py::call_guard<py::gil_scoped_release>());
 
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL) || \
-    defined(PADDLE_WITH_XPU_BKCL)
+    defined(PADDLE_WITH_XPU_BKCL) || defined(PADDLE_WITH_GLOO)
   py::class_<imperative::ParallelContext,
              std::shared_ptr<imperative::ParallelContext>>(m,
                                                            "ParallelContext");
@@ -1452,6 +1453,16 @@ void BindImperative(py::module *m_ptr) {
                     const platform::XPUPlace &>())
       .def("init", [](imperative::BKCLParallelContext &self) { self.Init(); });
 #endif
+
+#if defined(PADDLE_WITH_GLOO)
+  // named apart from the GlooParallelContext initializing the gloo of fleet
+  py::class_<imperative::GlooParallelContext, imperative::ParallelContext,
+             std::shared_ptr<imperative::GlooParallelContext>>(
+      m, "GlooDataParallelContext")
+      .def(py::init<const imperative::ParallelStrategy &,
+                    const platform::GlooParallelStrategy &>())
+      .def("init", [](imperative::GlooParallelContext &self) { self.Init(); });
+#endif
 }
 
 }  // namespace pybind
@@ -481,6 +481,10 @@ void BindAnalysisConfig(py::module *m) {
            py::arg("x") = true)
       .def("ir_optim", &AnalysisConfig::ir_optim)
       .def("enable_memory_optim", &AnalysisConfig::EnableMemoryOptim)
+      .def("switch_release_packed_gemm_weights",
+           &AnalysisConfig::SwitchReleasePackedGemmWeights, py::arg("x") = true)
+      .def("release_packed_gemm_weights",
+           &AnalysisConfig::release_packed_gemm_weights)
       .def("enable_profile", &AnalysisConfig::EnableProfile)
       .def("disable_glog_info", &AnalysisConfig::DisableGlogInfo)
       .def("glog_info_disabled", &AnalysisConfig::glog_info_disabled)
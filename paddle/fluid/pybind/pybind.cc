@@ -24,6 +24,7 @@ limitations under the License. */
 #include <utility>
 #include <vector>
 
+#include "paddle/fluid/framework/async_checkpointer.h"
 #include "paddle/fluid/framework/custom_operator.h"
 #include "paddle/fluid/framework/data_layout.h"
 #include "paddle/fluid/framework/executor.h"
@@ -436,6 +437,12 @@ PYBIND11_MODULE(core_noavx, m) {
           LoadStaticNameListFromDisk(str_file_name, vec_name_list, scope);
         });
 
+  m.def("_wait_async_save",
+        [](const std::string &file_path) {
+          framework::AsyncCheckpointer::Instance().Wait(file_path);
+        },
+        py::arg("file_path") = "", py::call_guard<py::gil_scoped_release>());
+
   m.def("_create_loaded_parameter",
         [](const py::handle &vec_var_list, const Scope &scope,
            const Executor *executor) {
@@ -2015,10 +2022,18 @@ All parameter, weight, gradient are variables in Paddle.
       .export_values();
 
   m.def("set_tracer_option", platform::SetTracerOption);
+  m.def("enable_roofline_report", platform::EnableRooflineReport);
+  m.def("enable_memory_report", platform::EnableMemoryReport);
   m.def("enable_profiler", platform::EnableProfiler);
   m.def("disable_profiler", platform::DisableProfiler);
   m.def("is_profiler_enabled", platform::IsProfileEnabled);
   m.def("reset_profiler", platform::ResetProfiler);
+  m.def("export_op_trace",
+        [](const std::string &path, bool clear) {
+          platform::OpTracer::Instance().ExportChromeTrace(path, clear);
+        },
+        py::arg("path"), py::arg("clear") = false);
+  m.def("clear_op_trace", [] { platform::OpTracer::Instance().Clear(); });
   m.def("get_pass", [](const std::string &pass_type) {
     auto pass = framework::ir::PassRegistry::Instance().Get(pass_type);
     return std::shared_ptr<framework::ir::Pass>(std::move(pass));
@@ -2539,6 +2554,35 @@ All parameter, weight, gradient are variables in Paddle.
                         build_strategy = static.BuildStrategy()
                         build_strategy.fuse_elewise_add_act_ops = True
                      )DOC")
+      .def_property(
+          "eliminate_redundant_ops",
+          [](const BuildStrategy &self) {
+            return self.eliminate_redundant_ops_;
+          },
+          [](BuildStrategy &self, bool b) {
+            PADDLE_ENFORCE_NE(self.IsFinalized(), true,
+                              platform::errors::PreconditionNotMet(
+                                  "BuildStrategy has been finlaized, cannot be "
+                                  "configured again."));
+            self.eliminate_redundant_ops_ = b;
+          },
+          R"DOC((bool, optional): eliminate_redundant_ops indicate whether
+                to merge the forward operators of the same type and
+                attributes reading the same inputs, so that their results
+                are computed only once. The outputs of the removed operators
+                cannot be fetched. Default is False.
+
+                Examples:
+                    .. code-block:: python
+
+                        import paddle
+                        import paddle.static as static
+
+                        paddle.enable_static()
+
+                        build_strategy = static.BuildStrategy()
+                        build_strategy.eliminate_redundant_ops = True
+                     )DOC")
       .def_property(
           "fuse_bn_act_ops",
           [](const BuildStrategy &self) { return self.fuse_bn_act_ops_; },
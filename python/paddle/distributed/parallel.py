@@ -60,6 +60,10 @@ def init_parallel_env():
 
     .. note::
         Now initialize both `NCCL` and `GLOO` contexts for communication.
+        In the CPU-only version, the gradients are all-reduced over `GLOO`.
+        The trainers rendezvous through the gloo file store in the directory
+        of the environment variable ``PADDLE_GLOO_FS_PATH`` if it is set, and
+        through the http store on the first trainer endpoint otherwise.
 
     Returns:
         None
@@ -120,12 +124,15 @@ def init_parallel_env():
         )
         return
 
-    # 1. gpu xpu check, must be gpu or xpu
-    if not core.is_compiled_with_cuda() and not core.is_compiled_with_xpu():
+    # 1. gpu xpu check, cpu must be compiled with gloo
+    is_cpu = not core.is_compiled_with_cuda() and not core.is_compiled_with_xpu(
+    )
+    if is_cpu and not hasattr(core, "GlooDataParallelContext"):
         raise NotImplementedError(
-            "Cannot initialize parallel environment in CPU-only version, now only "
-            "supports initializing the GPU and XPU parallel environment. Please recompile "
-            "or reinstall paddle with GPU or XPU support.")
+            "Cannot initialize parallel environment in CPU-only version without "
+            "GLOO, now only supports initializing the GPU and XPU parallel "
+            "environment, or the CPU one with GLOO. Please recompile or "
+            "reinstall paddle with GPU, XPU or GLOO support.")
 
     # 2. check env
     def _check_var_exists(var_name):
@@ -147,16 +154,27 @@ def init_parallel_env():
 
     # 3: init gloo context (step 1: httpsever start)
     init_gloo = int(os.getenv("PADDLE_WITH_GLOO", "0"))
-    if init_gloo:
-        ep_rank_0 = parallel_env.trainer_endpoints[0].split(":")
+    gloo_fs_path = os.getenv("PADDLE_GLOO_FS_PATH", "")
+    # the data parallel context on CPU rendezvous through the same http store
+    cpu_http_store = is_cpu and not gloo_fs_path
+    ep_rank_0 = parallel_env.trainer_endpoints[0].split(":")
+    default_init_timeout_seconds = 3600
+    default_run_timeout_seconds = 9999999
+    if init_gloo or cpu_http_store:
         ep_rank = parallel_env.trainer_endpoints[parallel_env.rank].split(":")
         manager = Manager()
         # glboal dict to store status
         http_server_d = manager.dict()
         http_server_d["running"] = False
         if parallel_env.rank == 0:
-            # The scope for worker used by http server is '_worker'
-            size = {'_worker': parallel_env.world_size}
+            # The http server stops once every rank has finalized its store
+            # in every scope: '_worker' for the gloo of fleet and
+            # '_data_parallel' for the data parallel context on CPU
+            size = {}
+            if init_gloo:
+                size['_worker'] = parallel_env.world_size
+            if cpu_http_store:
+                size['_data_parallel'] = parallel_env.world_size
             http_server = Process(
                 target=_start_kv_server,
                 args=(int(ep_rank_0[1]), http_server_d, size))
@@ -184,15 +202,33 @@ def init_parallel_env():
         place = core.CUDAPlace(parallel_env.device_id)
     elif core.is_compiled_with_xpu():
         place = core.XPUPlace(parallel_env.device_id)
+    else:
+        place = core.CPUPlace()
     _set_expected_place(place)
 
-    # init nccl or bkcl context
+    # init nccl, bkcl or gloo context
     if core.is_compiled_with_cuda():
         parallel_helper._set_parallel_ctx(
             core.NCCLParallelContext(strategy, place))
     elif core.is_compiled_with_xpu():
         parallel_helper._set_parallel_ctx(
             core.BKCLParallelContext(strategy, place))
+    else:
+        gloo_strategy = core.GlooParallelStrategy()
+        gloo_strategy.rank = parallel_env.rank
+        gloo_strategy.rank_num = parallel_env.world_size
+        gloo_strategy.init_seconds = default_init_timeout_seconds
+        gloo_strategy.run_seconds = default_run_timeout_seconds
+        if gloo_fs_path:
+            gloo_strategy.fs_path = gloo_fs_path
+        else:
+            wait_server_ready([parallel_env.trainer_endpoints[0]])
+            gloo_strategy.ip_address = ep_rank_0[0]
+            gloo_strategy.ip_port = int(ep_rank_0[1])
+            # apart from the keys of the gloo of fleet in the same store
+            gloo_strategy.scope = "data_parallel"
+        parallel_helper._set_parallel_ctx(
+            core.GlooDataParallelContext(strategy, gloo_strategy))
     parallel_helper._init_parallel_ctx()
 
     # 5: init gloo context (step 2: gloo init)
@@ -207,15 +243,13 @@ def init_parallel_env():
         gloo_strategy.rank_num = parallel_env.world_size
         gloo_strategy.ip_address = ep_rank_0[0]
         gloo_strategy.ip_port = int(ep_rank_0[1])
-        default_init_timeout_seconds = 3600
-        default_run_timeout_seconds = 9999999
         gloo_strategy.init_seconds = default_init_timeout_seconds
         gloo_strategy.run_seconds = default_run_timeout_seconds
         gloo = core.GlooParallelContext(gloo_strategy)
         gloo.init()
-        if parallel_env.rank == 0:
-            http_server_d["running"] = False
-            http_server.join()
+    if (init_gloo or cpu_http_store) and parallel_env.rank == 0:
+        http_server_d["running"] = False
+        http_server.join()
 
 
 def get_rank():
@@ -204,6 +204,18 @@ def __bootstrap__():
         'call_stack_level',
         'sort_sum_gradient',
         'max_inplace_grad_add',
+        'intra_op_parallelism_budget',
+        'cache_runtime_context',
+        'use_work_stealing_executor',
+        'use_critical_path_priority',
+        'async_save_combine',
+        'async_save_fsync',
+        'mmap_combined_params',
+        'op_trace_sampling_rate',
+        'roofline_peak_gflops',
+        'roofline_peak_gbps',
+        'dygraph_backward_num_threads',
+        'executor_zero_copy_feed_fetch',
     ]
     if 'Darwin' not in sysstr:
         read_env_flags.append('use_pinned_memory')
@@ -103,6 +103,12 @@ class Hogwild(DeviceWorker):
         if not opt_info:
             return
 
+        if opt_info.get("worker_pipeline_depth", 0) > 0:
+            trainer_desc.hogwild_param.pipeline_depth = opt_info[
+                "worker_pipeline_depth"]
+            trainer_desc.hogwild_param.pipeline_pull_ops.extend(
+                opt_info.get("worker_pipeline_pull_ops", []))
+
         from paddle.fluid.incubate.fleet.parameter_server import version
 
         if version.is_transpiler() and "fleet_desc" not in opt_info:
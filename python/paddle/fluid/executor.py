@@ -14,6 +14,7 @@
 
 from __future__ import print_function
 
+import atexit
 import logging
 import os
 import multiprocessing
@@ -41,6 +42,16 @@ InferNativeConfig = core.NativeConfig
 InferAnalysisConfig = core.AnalysisConfig
 
 
+def _wait_async_saves():
+    # waits for the files written in the background by save_combine and
+    # raises the errors of the failed writes not reported yet
+    if core.globals()['FLAGS_async_save_combine']:
+        core._wait_async_save()
+
+
+atexit.register(_wait_async_saves)
+
+
 def global_scope():
     """
     :api_attr: Static Graph
@@ -326,6 +337,36 @@ def has_fetch_operators(block, fetch_targets, fetch_holder_name):
     return fetch_count > 0
 
 
+def _vars_written_by_ops(program):
+    """
+    Returns the names of the variables written by the operators of program
+    other than feed.
+    """
+    names = set()
+    for block in program.blocks:
+        for op in block.ops:
+            if op.type != 'feed':
+                names.update(op.output_arg_names)
+    return names
+
+
+def _vars_written_before_read(block):
+    """
+    Returns the names of the variables that an operator of block writes
+    before any operator of block reads them. The values of the
+    non-persistable ones do not outlive a run of the block.
+    """
+    read_or_written = set()
+    names = set()
+    for op in block.ops:
+        read_or_written.update(op.input_arg_names)
+        for name in op.output_arg_names:
+            if name not in read_or_written:
+                names.add(name)
+                read_or_written.add(name)
+    return names
+
+
 def _fetch_var(name, scope=None, return_numpy=True):
     """
     Fetch the value of the variable with the given name from the
@@ -398,7 +439,7 @@ def _get_program_cache_key(feed, fetch_list):
     return str(feed_var_names + fetch_var_names)
 
 
-def _as_lodtensor(data, place, dtype=None):
+def _as_lodtensor(data, place, dtype=None, zero_copy=False):
     """
         Convert numpy.ndarray to Tensor, its only support Tensor without LoD information.
         For higher dimensional sequence data, please use LoDTensor directly.
@@ -415,6 +456,7 @@ def _as_lodtensor(data, place, dtype=None):
             data(numpy.ndarray|list|tuple|scalar): a instance of array, scalar, list or tuple
             data(core.Place): the place of created tensor
             dtype(core.VarDesc.VarType|str): the expected data type of created tensor
+            zero_copy(bool): whether the tensor shares the memory of data on CPUPlace
 
         Returns:
             LoDTensor
@@ -442,7 +484,7 @@ def _as_lodtensor(data, place, dtype=None):
 
     # convert numpy.ndarray to tensor
     tensor = core.LoDTensor()
-    tensor.set(data, place)
+    tensor.set(data, place, zero_copy)
     return tensor
 
 
@@ -598,8 +640,13 @@ class Executor(object):
     def _add_scope_cache(self, scope_cache_key, scope):
         self.scope_caches[scope_cache_key] = scope
 
-    def _add_feed_fetch_ops(self, program, feed, fetch_list, feed_var_name,
-                            fetch_var_name):
+    def _add_feed_fetch_ops(self,
+                            program,
+                            feed,
+                            fetch_list,
+                            feed_var_name,
+                            fetch_var_name,
+                            zero_copy=False):
         tmp_program = program.clone()
 
         global_block = tmp_program.global_block()
@@ -620,6 +667,23 @@ class Executor(object):
                 type=core.VarDesc.VarType.FETCH_LIST,
                 persistable=True)
 
+        # NOTE: With zero_copy, a CPU feed tensor shares the memory of its
+        # numpy array unless an operator may write the variable, and a fetched
+        # LoDTensor takes the CPU buffer of a non-persistable variable which
+        # is computed in every run and not fed, instead of copying it.
+        zero_copy_feed_names = set()
+        movable_fetch_names = set()
+        if zero_copy:
+            written_names = _vars_written_by_ops(tmp_program)
+            zero_copy_feed_names = set(
+                name for name in feed if name not in written_names)
+            for name in _vars_written_before_read(global_block):
+                var = global_block._find_var_recursive(name)
+                if var is not None and not var.persistable and \
+                        name not in feed:
+                    movable_fetch_names.add(name)
+        tmp_program._zero_copy_feed_names = zero_copy_feed_names
+
         # prepend feed operators
         if not has_feed_operators(global_block, feed, feed_var_name):
             for i, name in enumerate(feed):
@@ -640,24 +704,35 @@ class Executor(object):
                 assert isinstance(var, Variable) or isinstance(
                     var, six.string_types), (
                         "Wrong type for fetch_list[%s]: %s" % (i, type(var)))
+            fetch_names = [_to_name_str(var) for var in fetch_list]
+            for i, var in enumerate(fetch_list):
+                # only the last fetch of a variable can take its buffer
+                move_cpu_data = fetch_names[i] in movable_fetch_names and \
+                        fetch_names[i] not in fetch_names[i + 1:]
                 global_block.append_op(
                     type='fetch',
                     inputs={'X': [var]},
                     outputs={'Out': [fetch_var]},
-                    attrs={'col': i})
+                    attrs={'col': i,
+                           'move_cpu_data': move_cpu_data})
 
         return tmp_program
 
     def _feed_data(self, program, feed, feed_var_name, scope):
         # feed var to framework
         global_block = program.global_block()
+        zero_copy_feed_names = getattr(program, '_zero_copy_feed_names', ())
         for op in global_block.ops:
             if op.desc.type() == 'feed':
                 feed_target_name = op.desc.output('Out')[0]
                 cur_feed = feed[feed_target_name]
                 var = global_block.var(feed_target_name)
                 if not isinstance(cur_feed, core.LoDTensor):
-                    cur_feed = _as_lodtensor(cur_feed, self.place, var.dtype)
+                    cur_feed = _as_lodtensor(
+                        cur_feed,
+                        self.place,
+                        var.dtype,
+                        zero_copy=feed_target_name in zero_copy_feed_names)
                 check_feed_shape_type(var, cur_feed)
                 idx = op.desc.attr('col')
                 core.set_feed_variable(scope, cur_feed, feed_var_name, idx)
@@ -850,6 +925,7 @@ class Executor(object):
               exe.close()
         """
         if not self._closed:
+            _wait_async_saves()
             self._default_executor.close()
             self._closed = True
 
@@ -1275,8 +1351,12 @@ class Executor(object):
                 "The name of fetch variable requires string as its Parameter. But you passed in %s"
                 % (type(fetch_var_name)))
 
+        zero_copy = core.globals()['FLAGS_executor_zero_copy_feed_fetch']
         if use_program_cache:
-            cache_key = _get_strong_program_cache_key(program, feed, fetch_list)
+            # the feed and fetch ops of the cached program copy or not
+            # depending on the flag when they are added
+            cache_key = _get_strong_program_cache_key(
+                program, feed, fetch_list) + '_zero_copy_' + str(zero_copy)
             cached_program = self._get_program_cache(cache_key)
             cached_ctx = self._get_ctx_cache(cache_key)
             cached_scope = self._get_scope_cache(cache_key)
@@ -1286,7 +1366,8 @@ class Executor(object):
                     feed=feed,
                     fetch_list=fetch_list,
                     feed_var_name=feed_var_name,
-                    fetch_var_name=fetch_var_name)
+                    fetch_var_name=fetch_var_name,
+                    zero_copy=zero_copy)
                 self._add_program_cache(cache_key, cached_program)
                 fetch_list_str = list(map(_to_name_str, fetch_list))
                 cached_ctx = self._default_executor.prepare(
@@ -1310,7 +1391,8 @@ class Executor(object):
                 feed=feed,
                 fetch_list=fetch_list,
                 feed_var_name=feed_var_name,
-                fetch_var_name=fetch_var_name)
+                fetch_var_name=fetch_var_name,
+                zero_copy=zero_copy)
 
         self._feed_data(program, feed, feed_var_name, scope)
         if hasattr(program, 'lr_sheduler'):
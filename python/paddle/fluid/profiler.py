@@ -21,7 +21,7 @@ import six
 
 __all__ = [
     'cuda_profiler', 'reset_profiler', 'profiler', 'start_profiler',
-    'stop_profiler'
+    'stop_profiler', 'export_op_trace'
 ]
 
 NVPROF_CONFIG = [
@@ -128,7 +128,42 @@ def reset_profiler():
     core.reset_profiler()
 
 
-def start_profiler(state, tracer_option='Default'):
+def export_op_trace(path, clear=True):
+    """
+    Export the spans sampled by the op tracer to a Chrome trace file, which
+    can be opened by chrome://tracing or https://ui.perfetto.dev.
+
+    Unlike `fluid.profiler.profiler`, the op tracer is cheap enough to stay
+    on while training or serving. It is enabled by setting the flag
+    `FLAGS_op_trace_sampling_rate` to the fraction of the outermost spans of
+    every thread to keep, e.g. 0.01. The ops, the data feed stages, the RPCs
+    of the communicator and the allocations nested in a kept span are traced,
+    and every thread keeps its latest 8192 records.
+
+    Args:
+        path (str): The path of the Chrome trace JSON file.
+        clear (bool, optional): Whether to drop the records taken so far
+            after exporting them, so that the next export only contains the
+            newer records. Default is True.
+
+    Examples:
+
+        .. code-block:: python
+
+            import paddle
+            import paddle.fluid.profiler as profiler
+
+            paddle.set_flags({'FLAGS_op_trace_sampling_rate': 0.01})
+            # ... train or infer
+            profiler.export_op_trace('/tmp/op_trace.json')
+    """
+    core.export_op_trace(path, clear)
+
+
+def start_profiler(state,
+                   tracer_option='Default',
+                   roofline=False,
+                   memory=False):
     """
     Enable the profiler. Uers can use `fluid.profiler.start_profiler` and
     `fluid.profiler.stop_profiler` to profile, which is equal to the usage 
@@ -144,6 +179,16 @@ def start_profiler(state, tracer_option='Default'):
             the different Op type profiling result and the `OpDetail` option print the detail profiling 
             result of different op types such as compute and data transform, `AllOpDetail` option 
             print the detail profiling result of different op name same as `OpDetail`.
+        roofline (bool, optional) : If True, the ops running on CPU are also
+            reported with their achieved GFLOP/s and GB/s versus the peak of
+            the machine, computed from the FLOPs and bytes counted from the
+            shapes of their inputs. The peaks are measured when the report is
+            printed unless FLAGS_roofline_peak_gflops and
+            FLAGS_roofline_peak_gbps are set. Default is False.
+        memory (bool, optional) : If True, a report of the memory allocated
+            while profiling is also printed, with the allocated size of every
+            place over time and the ops holding the most memory at its peak.
+            Default is False.
 
     Raises:
         ValueError: If `state` is not in ['CPU', 'GPU', 'All'] or `tracer_option` 
@@ -192,6 +237,8 @@ def start_profiler(state, tracer_option='Default'):
         prof_tracer_option = core.TracerOption.kAllOpDetail
 
     core.set_tracer_option(prof_tracer_option)
+    core.enable_roofline_report(roofline)
+    core.enable_memory_report(memory)
     core.enable_profiler(prof_state)
 
 
@@ -255,7 +302,9 @@ def stop_profiler(sorted_key=None, profile_path='/tmp/profile'):
 def profiler(state,
              sorted_key=None,
              profile_path='/tmp/profile',
-             tracer_option='Default'):
+             tracer_option='Default',
+             roofline=False,
+             memory=False):
     """
     The profiler interface. Different from `fluid.profiler.cuda_profiler`, 
     this profiler can be used to profile both CPU and GPU program.
@@ -281,6 +330,16 @@ def profiler(state,
             the different Op type profiling result and the `OpDetail` option print the detail profiling 
             result of different op types such as compute and data transform, `AllOpDetail` option 
             print the detail profiling result of different op name same as `OpDetail`.
+        roofline (bool, optional) : If True, the ops running on CPU are also
+            reported with their achieved GFLOP/s and GB/s versus the peak of
+            the machine, computed from the FLOPs and bytes counted from the
+            shapes of their inputs. The peaks are measured when the report is
+            printed unless FLAGS_roofline_peak_gflops and
+            FLAGS_roofline_peak_gbps are set. Default is False.
+        memory (bool, optional) : If True, a report of the memory allocated
+            while profiling is also printed, with the allocated size of every
+            place over time and the ops holding the most memory at its peak.
+            Default is False.
 
     Raises:
         ValueError: If `state` is not in ['CPU', 'GPU', 'All']. If `sorted_key` is
@@ -346,7 +405,7 @@ def profiler(state,
             thread0::conv2d             8           7.93456     0.291385    5.63342     0.99182     0.795243
             thread0::elementwise_add    8           1.96555     0.191884    0.518004    0.245693    0.196998
     """
-    start_profiler(state, tracer_option)
+    start_profiler(state, tracer_option, roofline, memory)
     try:
         yield
     finally:
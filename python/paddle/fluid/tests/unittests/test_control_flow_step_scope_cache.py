@@ -0,0 +1,141 @@
+#   Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from __future__ import print_function
+
+import unittest
+
+import numpy as np
+import paddle
+import paddle.fluid as fluid
+import paddle.fluid.core as core
+import paddle.fluid.layers as layers
+
+paddle.enable_static()
+
+
+def append_to_local_array(x):
+    """
+    Appends x to an array created in the current block, and returns the
+    length of the array, which is 1 when the array is reset on every run.
+    """
+    arr = layers.create_array('float32')
+    layers.array_write(x, i=layers.array_length(arr), array=arr)
+    return layers.array_length(arr)
+
+
+def lod_tensor(data, seq_lens):
+    tensor = core.LoDTensor()
+    tensor.set(np.array(data, dtype='float32').reshape([-1, 1]),
+               fluid.CPUPlace())
+    tensor.set_recursive_sequence_lengths([seq_lens])
+    return tensor
+
+
+class TestStepScopeCache(unittest.TestCase):
+    """
+    while with is_test and conditional_block_infer keep their step scope
+    across the runs of a cached program. Each run gives the same outputs as
+    the first, with the LoD of its own input and freshly reset arrays.
+    """
+
+    def setUp(self):
+        self.inputs = [
+            ([1, 2, 3], [2, 1]),
+            ([4, 5, 6, 7], [1, 3]),
+            ([8, 9], [2]),
+        ]
+
+    def run_program(self, program, fetch_list, feed=None):
+        exe = fluid.Executor(fluid.CPUPlace())
+        feed = dict(feed or {})
+        for data, seq_lens in self.inputs:
+            feed['x'] = lod_tensor(data, seq_lens)
+            yield (data, seq_lens), exe.run(program,
+                                            feed=feed,
+                                            fetch_list=fetch_list,
+                                            return_numpy=False,
+                                            use_program_cache=True)
+
+    def test_while_is_test(self):
+        main_program = fluid.Program()
+        startup_program = fluid.Program()
+        with fluid.program_guard(main_program, startup_program):
+            x = fluid.data(name='x', shape=[None, 1], dtype='float32',
+                           lod_level=1)
+            i = layers.fill_constant(shape=[1], dtype='int64', value=0)
+            n = layers.fill_constant(shape=[1], dtype='int64', value=3)
+            acc = layers.scale(x, scale=0.0)
+            arr_len = layers.fill_constant(shape=[1], dtype='int64', value=0)
+            cond = layers.less_than(x=i, y=n)
+            while_op = layers.While(cond=cond, is_test=True)
+            with while_op.block():
+                # y is a variable of the step scope
+                y = layers.scale(x, scale=2.0)
+                layers.assign(layers.elementwise_add(acc, y), acc)
+                layers.assign(append_to_local_array(y), arr_len)
+                layers.increment(x=i, value=1, in_place=True)
+                layers.less_than(x=i, y=n, cond=cond)
+
+        fluid.Executor(fluid.CPUPlace()).run(startup_program)
+        for (data, seq_lens), outs in self.run_program(
+                main_program, fetch_list=[acc, arr_len]):
+            acc_out, length = outs
+            # 3 steps of adding 2 * x
+            self.assertTrue(
+                np.allclose(
+                    np.array(acc_out).flatten(),
+                    np.array(data, dtype='float32') * 6))
+            self.assertEqual(acc_out.recursive_sequence_lengths(), [seq_lens])
+            self.assertEqual(np.array(length)[0], 1)
+
+    def test_conditional_block_infer(self):
+        main_program = fluid.Program()
+        startup_program = fluid.Program()
+        with fluid.program_guard(main_program, startup_program):
+            x = fluid.data(name='x', shape=[None, 1], dtype='float32',
+                           lod_level=1)
+            pred = fluid.data(name='pred', shape=[1], dtype='bool')
+
+            def true_fn():
+                y = layers.scale(x, scale=2.0)
+                return y, append_to_local_array(y)
+
+            def false_fn():
+                y = layers.scale(x, scale=-1.0)
+                return y, layers.fill_constant(
+                    shape=[1], dtype='int64', value=0)
+
+            out, arr_len = layers.cond(pred, true_fn, false_fn)
+        for op in main_program.global_block().ops:
+            if op.type == 'conditional_block':
+                op.desc.set_type('conditional_block_infer')
+
+        fluid.Executor(fluid.CPUPlace()).run(startup_program)
+        for pred_value in [True, False, True]:
+            feed = {'pred': np.array([pred_value])}
+            for (data, seq_lens), outs in self.run_program(
+                    main_program, fetch_list=[out, arr_len], feed=feed):
+                y, length = outs
+                scale = 2.0 if pred_value else -1.0
+                self.assertTrue(
+                    np.allclose(
+                        np.array(y).flatten(),
+                        np.array(data, dtype='float32') * scale))
+                self.assertEqual(y.recursive_sequence_lengths(), [seq_lens])
+                self.assertEqual(np.array(length)[0], 1 if pred_value else 0)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,164 @@
+#   Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from __future__ import print_function
+
+import time
+import unittest
+
+import numpy as np
+import paddle
+import paddle.fluid as fluid
+from paddle.fluid.executor import _as_lodtensor
+
+paddle.enable_static()
+
+
+class TestExecutorZeroCopyFeedFetch(unittest.TestCase):
+    def setUp(self):
+        self.place = fluid.CPUPlace()
+        self.main_program = fluid.Program()
+        self.startup_program = fluid.Program()
+        with fluid.program_guard(self.main_program, self.startup_program):
+            self.x = fluid.data(name='x', shape=[None, 4], dtype='float32')
+            self.w = fluid.layers.create_parameter(
+                shape=[4, 4],
+                dtype='float32',
+                name='w',
+                default_initializer=fluid.initializer.Constant(0.5))
+            self.y = fluid.layers.matmul(self.x, self.w)
+        self.scope = fluid.Scope()
+        self.exe = fluid.Executor(self.place)
+        with fluid.scope_guard(self.scope):
+            self.exe.run(self.startup_program)
+
+    def run_program(self, feed, fetch_list, use_program_cache=True):
+        with fluid.scope_guard(self.scope):
+            return self.exe.run(self.main_program,
+                                feed=feed,
+                                fetch_list=fetch_list,
+                                use_program_cache=use_program_cache)
+
+    def test_feed_shares_memory(self):
+        data = np.random.random((2, 4)).astype('float32')
+        tensor = _as_lodtensor(data, self.place, zero_copy=True)
+        self.assertTrue(np.shares_memory(np.array(tensor, copy=False), data))
+        tensor = _as_lodtensor(data, self.place)
+        self.assertFalse(np.shares_memory(np.array(tensor, copy=False), data))
+
+    def test_fetch_is_not_overwritten(self):
+        for use_program_cache in [True, False]:
+            x1 = np.ones((2, 4), dtype='float32')
+            x2 = np.ones((2, 4), dtype='float32') * 2
+            y1, = self.run_program({'x': x1}, [self.y], use_program_cache)
+            y2, = self.run_program({'x': x2}, [self.y], use_program_cache)
+            self.assertTrue(np.allclose(y1, np.ones((2, 4)) * 2))
+            self.assertTrue(np.allclose(y2, np.ones((2, 4)) * 4))
+            self.assertFalse(np.shares_memory(y1, y2))
+
+    def test_fetch_twice(self):
+        x = np.ones((2, 4), dtype='float32')
+        y1, y2 = self.run_program({'x': x}, [self.y, self.y])
+        self.assertTrue(np.allclose(y1, np.ones((2, 4)) * 2))
+        self.assertTrue(np.allclose(y2, np.ones((2, 4)) * 2))
+
+    def test_fetch_persistable_and_fed_var(self):
+        x = np.ones((2, 4), dtype='float32')
+        fetched_x, w, _ = self.run_program({'x': x},
+                                           [self.x, self.w, self.y])
+        self.assertFalse(np.shares_memory(fetched_x, x))
+        # the fetched parameter keeps its value after the parameter changes
+        with fluid.scope_guard(self.scope):
+            fluid.global_scope().find_var('w').get_tensor().set(
+                np.zeros((4, 4), dtype='float32'), self.place)
+        self.assertTrue(np.allclose(w, np.ones((4, 4)) * 0.5))
+        w, = self.run_program({'x': x}, [self.w])
+        self.assertTrue(np.allclose(w, np.zeros((4, 4))))
+
+    def test_flag_change_with_program_cache(self):
+        def movable_fetches(program):
+            return [
+                op.attr('move_cpu_data')
+                for op in program.global_block().ops if op.type == 'fetch'
+            ]
+
+        x = np.ones((2, 4), dtype='float32')
+        try:
+            for zero_copy in [True, False, True]:
+                paddle.set_flags({
+                    'FLAGS_executor_zero_copy_feed_fetch': zero_copy
+                })
+                y, = self.run_program({'x': x}, [self.y])
+                self.assertTrue(np.allclose(y, np.ones((2, 4)) * 2))
+        finally:
+            paddle.set_flags({'FLAGS_executor_zero_copy_feed_fetch': True})
+        # a program is cached for each value of the flag
+        programs = list(self.exe.program_caches.values())
+        self.assertEqual(len(programs), 2)
+        self.assertEqual(
+            sorted(movable_fetches(program) for program in programs),
+            [[False], [True]])
+
+    def test_written_feed_is_copied(self):
+        main_program = fluid.Program()
+        with fluid.program_guard(main_program, fluid.Program()):
+            counter = fluid.data(name='counter', shape=[1], dtype='float32')
+            fluid.layers.increment(counter, value=1.0, in_place=True)
+        counter_data = np.zeros((1, ), dtype='float32')
+        with fluid.scope_guard(fluid.Scope()):
+            out, = self.exe.run(main_program,
+                                feed={'counter': counter_data},
+                                fetch_list=[counter])
+        self.assertEqual(out[0], 1.0)
+        self.assertEqual(counter_data[0], 0.0)
+
+
+class TestExecutorFeedFetchOverhead(unittest.TestCase):
+    def run_overhead(self, numel, zero_copy, repeat=20):
+        paddle.set_flags({'FLAGS_executor_zero_copy_feed_fetch': zero_copy})
+        main_program = fluid.Program()
+        with fluid.program_guard(main_program, fluid.Program()):
+            x = fluid.data(name='x', shape=[numel], dtype='float32')
+            y = fluid.layers.scale(x, scale=2.0)
+        data = np.ones((numel, ), dtype='float32')
+        exe = fluid.Executor(fluid.CPUPlace())
+        with fluid.scope_guard(fluid.Scope()):
+            out, = exe.run(main_program,
+                           feed={'x': data},
+                           fetch_list=[y],
+                           use_program_cache=True)
+            start = time.time()
+            for _ in range(repeat):
+                out, = exe.run(main_program,
+                               feed={'x': data},
+                               fetch_list=[y],
+                               use_program_cache=True)
+            elapsed_ms = (time.time() - start) * 1000 / repeat
+        self.assertTrue(np.allclose(out, data * 2))
+        return elapsed_ms
+
+    def test_overhead(self):
+        try:
+            for numel in [1 << 10, 1 << 16, 1 << 22]:
+                copy_ms = self.run_overhead(numel, False)
+                zero_copy_ms = self.run_overhead(numel, True)
+                print("Feed and fetch {} floats: {:.3f} ms per run with "
+                      "copies, {:.3f} ms without copies".format(
+                          numel, copy_ms, zero_copy_ms))
+        finally:
+            paddle.set_flags({'FLAGS_executor_zero_copy_feed_fetch': True})
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,124 @@
+#   Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from __future__ import print_function
+
+import os
+import unittest
+
+import numpy as np
+import paddle
+import paddle.fluid as fluid
+
+paddle.enable_static()
+
+
+class TestHogwildPipeline(unittest.TestCase):
+    """
+    Training with batches read ahead of the computing one gives the same
+    parameters as training one batch after another.
+    """
+
+    def setUp(self):
+        self.filename = "test_hogwild_pipeline_%d.txt" % os.getpid()
+        rng = np.random.RandomState(0)
+        with open(self.filename, "w") as f:
+            for _ in range(64):
+                x = rng.uniform(-1, 1, size=3)
+                ids = rng.randint(0, 16, size=2)
+                y = 0.5 * x[0] - x[1] + 2 * x[2] + 0.1 * (ids[0] - ids[1])
+                f.write("1 %f 1 %f 1 %f 2 %d %d 1 %f\n" %
+                        (x[0], x[1], x[2], ids[0], ids[1], y))
+
+    def tearDown(self):
+        if os.path.exists(self.filename):
+            os.remove(self.filename)
+
+    def train(self, pipeline_depth, pull_ops=None):
+        main_program = fluid.Program()
+        startup_program = fluid.Program()
+        scope = fluid.Scope()
+        with fluid.program_guard(main_program, startup_program):
+            slots = []
+            for name in ["x0", "x1", "x2", "ids", "y"]:
+                slots.append(
+                    fluid.layers.data(
+                        name=name,
+                        shape=[1],
+                        dtype="int64" if name == "ids" else "float32",
+                        lod_level=1))
+            # The embedding is not trained, so prefetching its lookup like a
+            # pull op reads the same values as running it in order.
+            emb = fluid.layers.embedding(
+                input=slots[3],
+                size=[16, 2],
+                param_attr=fluid.ParamAttr(
+                    name="emb",
+                    trainable=False,
+                    initializer=fluid.initializer.Uniform(seed=1)))
+            emb = fluid.layers.sequence_pool(input=emb, pool_type="sum")
+            x = fluid.layers.concat(slots[:3] + [emb], axis=1)
+            pred = fluid.layers.fc(
+                input=x,
+                size=1,
+                param_attr=fluid.ParamAttr(
+                    name="w", initializer=fluid.initializer.Constant(0.1)),
+                bias_attr=fluid.ParamAttr(
+                    name="b", initializer=fluid.initializer.Constant(0.0)))
+            loss = fluid.layers.mean(
+                fluid.layers.square_error_cost(
+                    input=pred, label=slots[4]))
+            fluid.optimizer.SGD(learning_rate=0.1).minimize(loss)
+
+        if pipeline_depth > 0:
+            main_program._fleet_opt = {
+                "trainer": "MultiTrainer",
+                "device_worker": "Hogwild",
+                "worker_pipeline_depth": pipeline_depth,
+                "worker_pipeline_pull_ops": pull_ops or [],
+            }
+        dataset = paddle.distributed.QueueDataset()
+        dataset.init(
+            batch_size=4, thread_num=1, pipe_command="cat", use_var=slots)
+        dataset.set_filelist([self.filename])
+
+        exe = fluid.Executor(fluid.CPUPlace())
+        with fluid.scope_guard(scope):
+            exe.run(startup_program)
+            exe.train_from_dataset(main_program, dataset)
+            return [
+                np.array(scope.find_var(name).get_tensor())
+                for name in ["w", "b"]
+            ]
+
+    def test_pipeline_matches_sequential(self):
+        expected = self.train(0)
+        # the parameters are trained
+        self.assertFalse(np.allclose(expected[0], 0.1))
+        for depth in [1, 3]:
+            params = self.train(depth)
+            for param, expected_param in zip(params, expected):
+                self.assertTrue(np.allclose(param, expected_param))
+
+    def test_hoisted_pull_matches_sequential(self):
+        expected = self.train(0)
+        for depth in [1, 3]:
+            # the lookup runs in the prefetch thread on the slot of its batch
+            params = self.train(depth, pull_ops=["lookup_table"])
+            for param, expected_param in zip(params, expected):
+                self.assertTrue(np.allclose(param, expected_param))
+
+
+if __name__ == '__main__':
+    unittest.main()